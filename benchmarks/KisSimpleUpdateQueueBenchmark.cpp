@@ -0,0 +1,143 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSimpleUpdateQueueBenchmark.h"
+
+#include <simpletest.h>
+
+#include <cmath>
+#include <random>
+
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_image.h"
+#include "kis_paint_layer.h"
+#include "kis_simple_update_queue.h"
+#include "kis_updater_context.h"
+
+
+namespace {
+
+const int IMAGE_SIZE = 8000;
+const int NUM_UPDATES = 100000;
+
+struct QueueBenchmarkData {
+    QueueBenchmarkData()
+    {
+        const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+        image = new KisImage(0, IMAGE_SIZE, IMAGE_SIZE, cs, "queue benchmark");
+        layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8);
+
+        image->barrierLock();
+        image->addNode(layer);
+        image->unlock();
+    }
+
+    /**
+     * Small rects scattered over the whole image, like the updates
+     * produced by a script painting random dabs
+     */
+    QVector<QRect> randomRects() const {
+        std::mt19937 generator(1234);
+        std::uniform_int_distribution<int> position(0, IMAGE_SIZE - 64);
+        std::uniform_int_distribution<int> size(4, 64);
+
+        QVector<QRect> rects;
+        rects.reserve(NUM_UPDATES);
+
+        for (int i = 0; i < NUM_UPDATES; i++) {
+            rects << QRect(position(generator), position(generator),
+                           size(generator), size(generator));
+        }
+
+        return rects;
+    }
+
+    /**
+     * Small rects grouped around a stroke path, like the updates
+     * produced by a spray brush
+     */
+    QVector<QRect> sprayRects() const {
+        std::mt19937 generator(1234);
+        std::normal_distribution<qreal> offset(0.0, 50.0);
+        std::uniform_int_distribution<int> size(2, 16);
+
+        QVector<QRect> rects;
+        rects.reserve(NUM_UPDATES);
+
+        for (int i = 0; i < NUM_UPDATES; i++) {
+            const qreal t = qreal(i) / NUM_UPDATES;
+            const QPointF center(100 + t * (IMAGE_SIZE - 200),
+                                 IMAGE_SIZE / 2 + (IMAGE_SIZE / 4) * std::sin(6.0 * M_PI * t));
+            const QPointF dabOffset(offset(generator), offset(generator));
+
+            rects << QRect((center + dabOffset).toPoint(),
+                           QSize(size(generator), size(generator)));
+        }
+
+        return rects;
+    }
+
+    KisImageSP image;
+    KisPaintLayerSP layer;
+};
+
+void feedQueue(KisSimpleUpdateQueue &queue, KisNodeSP node,
+               const QVector<QRect> &rects, const QRect &cropRect)
+{
+    Q_FOREACH (const QRect &rc, rects) {
+        queue.addUpdateJob(node, rc, cropRect, 0);
+    }
+}
+
+}
+
+void KisSimpleUpdateQueueBenchmark::benchmarkRandomUpdates()
+{
+    QueueBenchmarkData data;
+    const QVector<QRect> rects = data.randomRects();
+
+    QBENCHMARK_ONCE {
+        KisTestableSimpleUpdateQueue queue;
+        feedQueue(queue, data.layer, rects, data.image->bounds());
+
+        qDebug() << "Walkers left after coalescing:" << queue.getWalkersList().size();
+    }
+}
+
+void KisSimpleUpdateQueueBenchmark::benchmarkSprayUpdates()
+{
+    QueueBenchmarkData data;
+    const QVector<QRect> rects = data.sprayRects();
+
+    QBENCHMARK_ONCE {
+        KisTestableSimpleUpdateQueue queue;
+        feedQueue(queue, data.layer, rects, data.image->bounds());
+
+        qDebug() << "Walkers left after coalescing:" << queue.getWalkersList().size();
+    }
+}
+
+void KisSimpleUpdateQueueBenchmark::benchmarkProcessQueue()
+{
+    QueueBenchmarkData data;
+    const QVector<QRect> rects = data.randomRects();
+
+    KisTestableSimpleUpdateQueue queue;
+    feedQueue(queue, data.layer, rects, data.image->bounds());
+
+    // the testable context doesn't execute the jobs, it only takes them
+    KisTestableUpdaterContext context(16);
+
+    QBENCHMARK_ONCE {
+        while (!queue.isEmpty()) {
+            queue.processQueue(context);
+            context.clear();
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisSimpleUpdateQueueBenchmark)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSIMPLEUPDATEQUEUEBENCHMARK_H
+#define KISSIMPLEUPDATEQUEUEBENCHMARK_H
+
+#include <QtTest>
+
+class KisSimpleUpdateQueueBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkRandomUpdates();
+    void benchmarkSprayUpdates();
+    void benchmarkProcessQueue();
+};
+
+#endif // KISSIMPLEUPDATEQUEUEBENCHMARK_H
@@ -28,6 +28,9 @@
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpRegistry.h>
+#include <KoColorSpaceBlendingPolicy.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -407,6 +410,325 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     return compareResult;
 }
 
+/**
+ * Creates the scalar version of the separable op, the same
+ * functions as in AddGeneralOps
+ */
+template<class Traits>
+KoCompositeOp* createLegacyGenericSCOp(const KoColorSpace *cs, const QString &id)
+{
+    using T = typename Traits::channels_type;
+    using Policy = KoAdditiveBlendingPolicy<Traits>;
+
+    if (id == COMPOSITE_MULT) return new KoCompositeOpGenericSC<Traits, &cfMultiply<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SCREEN) return new KoCompositeOpGenericSC<Traits, &cfScreen<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_OVERLAY) return new KoCompositeOpGenericSC<Traits, &cfOverlay<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_HARD_LIGHT) return new KoCompositeOpGenericSC<Traits, &cfHardLight<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) return new KoCompositeOpGenericSC<Traits, &cfSoftLight<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SOFT_LIGHT_SVG) return new KoCompositeOpGenericSC<Traits, &cfSoftLightSvg<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_DODGE) return new KoCompositeOpGenericSC<Traits, &cfColorDodge<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_BURN) return new KoCompositeOpGenericSC<Traits, &cfColorBurn<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_LINEAR_BURN) return new KoCompositeOpGenericSC<Traits, &cfLinearBurn<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_LINEAR_LIGHT) return new KoCompositeOpGenericSC<Traits, &cfLinearLight<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_ADD) return new KoCompositeOpGenericSC<Traits, &cfAddition<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SUBTRACT) return new KoCompositeOpGenericSC<Traits, &cfSubtract<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_DARKEN) return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_LIGHTEN) return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_DIFF) return new KoCompositeOpGenericSC<Traits, &cfDifference<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_EXCLUSION) return new KoCompositeOpGenericSC<Traits, &cfExclusion<T>, Policy>(cs, id, QString());
+
+    return nullptr;
+}
+
+const QStringList separableOpIds({
+    COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_OVERLAY, COMPOSITE_HARD_LIGHT,
+    COMPOSITE_SOFT_LIGHT_PHOTOSHOP, COMPOSITE_SOFT_LIGHT_SVG, COMPOSITE_DODGE,
+    COMPOSITE_BURN, COMPOSITE_LINEAR_BURN, COMPOSITE_LINEAR_LIGHT, COMPOSITE_ADD,
+    COMPOSITE_SUBTRACT, COMPOSITE_DARKEN, COMPOSITE_LIGHTEN, COMPOSITE_DIFF,
+    COMPOSITE_EXCLUSION});
+
+/**
+ * Compares the optimized separable ops against the scalar ones.
+ *
+ * The optimized ops blend the vector pixels in floating point and
+ * round only the final values, while the scalar integer op rounds
+ * every intermediate product, so the integer results are not
+ * bit-exact. The colors are compared premultiplied by alpha, which
+ * keeps the division by a tiny alpha from amplifying the rounding
+ * error. Floating point values are compared relative to their
+ * magnitude.
+ */
+template<class Traits>
+bool compareGenericSCOps(const KoColorSpace *cs,
+                         bool haveMask,
+                         KoCompositeOp* (*createOptimizedOp)(const KoColorSpace*, const QString&, const QString&),
+                         const QStringList &ids,
+                         float prec)
+{
+    using channels_type = typename Traits::channels_type;
+    using namespace Arithmetic;
+
+    /**
+     * The width is not a multiple of any vector size, so the
+     * tail of every row is checked as well
+     */
+    const int cols = 61;
+    const int rows = 17;
+    const int numTestPixels = cols * rows;
+    const int pixelSize = Traits::pixelSize;
+
+    boost::mt11213b rnd(1);
+    boost::uniform_real<float> channelRnd(0.0f, 1.0f);
+    boost::uniform_smallint<int> maskRnd(0, 255);
+
+    QVector<channels_type> src(numTestPixels * 4);
+    QVector<channels_type> dst(numTestPixels * 4);
+    QVector<quint8> mask(numTestPixels);
+
+    for (int i = 0; i < numTestPixels; i++) {
+        channels_type *s = src.data() + 4 * i;
+        channels_type *d = dst.data() + 4 * i;
+
+        for (int c = 0; c < 4; c++) {
+            s[c] = scale<channels_type>(channelRnd(rnd));
+            d[c] = scale<channels_type>(channelRnd(rnd));
+        }
+
+        /**
+         * Check the special cases of color dodge and burn. The floating
+         * point ops clamp them to the maximum float value, which is not
+         * something that could be compared in a sane way.
+         */
+        if (std::numeric_limits<channels_type>::is_integer && i % 13 == 0) {
+            s[0] = unitValue<channels_type>();
+            s[1] = zeroValue<channels_type>();
+        }
+
+        // check transparent pixels
+        if (i % 11 == 0) {
+            d[3] = zeroValue<channels_type>();
+        }
+
+        mask[i] = maskRnd(rnd);
+    }
+
+    bool result = true;
+
+    Q_FOREACH (const QString &id, ids) {
+        QScopedPointer<KoCompositeOp> opAct(createOptimizedOp(cs, id, QString()));
+        QScopedPointer<KoCompositeOp> opExp(createLegacyGenericSCOp<Traits>(cs, id));
+
+        if (!opAct) {
+            qDebug() << "No optimized version of" << id << "(vectorization is disabled?)";
+            continue;
+        }
+
+        QVector<channels_type> dstAct = dst;
+        QVector<channels_type> dstExp = dst;
+
+        KoCompositeOp::ParameterInfo params;
+        params.srcRowStart   = reinterpret_cast<const quint8*>(src.constData());
+        params.srcRowStride  = cols * pixelSize;
+        params.maskRowStart  = haveMask ? mask.constData() : 0;
+        params.maskRowStride = cols;
+        params.dstRowStride  = cols * pixelSize;
+        params.rows          = rows;
+        params.cols          = cols;
+        params.opacity       = 0.75f;
+        params.channelFlags  = QBitArray();
+
+        params.dstRowStart = reinterpret_cast<quint8*>(dstAct.data());
+        opAct->composite(params);
+
+        params.dstRowStart = reinterpret_cast<quint8*>(dstExp.data());
+        opExp->composite(params);
+
+        for (int i = 0; i < numTestPixels * 4; i++) {
+            const int alphaIndex = i - i % 4 + 3;
+
+            const float actAlpha = scale<float>(dstAct[alphaIndex]);
+            const float expAlpha = scale<float>(dstExp[alphaIndex]);
+
+            const float act = i == alphaIndex ? actAlpha : scale<float>(dstAct[i]) * actAlpha;
+            const float exp = i == alphaIndex ? expAlpha : scale<float>(dstExp[i]) * expAlpha;
+
+            if (qAbs(act - exp) > prec * qMax(1.0f, qAbs(exp))) {
+                qDebug() << "Failed op:" << id << "pixel:" << i / 4 << "channel:" << i % 4;
+                qDebug() << "Act:" << act << "Exp:" << exp;
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Creates the scalar version of the non-separable op, the same
+ * functions as in AddRGBOps
+ */
+template<class Traits>
+KoCompositeOp* createLegacyGenericHSLOp(const KoColorSpace *cs, const QString &id)
+{
+    if (id == COMPOSITE_COLOR) return new KoCompositeOpGenericHSL<Traits, &cfColor<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_HUE) return new KoCompositeOpGenericHSL<Traits, &cfHue<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_SATURATION) return new KoCompositeOpGenericHSL<Traits, &cfSaturation<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_SATURATION) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseSaturation<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_SATURATION) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseSaturation<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_LUMINIZE) return new KoCompositeOpGenericHSL<Traits, &cfLightness<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_LUMINOSITY) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseLightness<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_LUMINOSITY) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseLightness<HSYType, float>>(cs, id, QString());
+    if (id == COMPOSITE_COLOR_HSI) return new KoCompositeOpGenericHSL<Traits, &cfColor<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_HUE_HSI) return new KoCompositeOpGenericHSL<Traits, &cfHue<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_SATURATION_HSI) return new KoCompositeOpGenericHSL<Traits, &cfSaturation<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_SATURATION_HSI) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseSaturation<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_SATURATION_HSI) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseSaturation<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INTENSITY) return new KoCompositeOpGenericHSL<Traits, &cfLightness<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_INTENSITY) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseLightness<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_INTENSITY) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseLightness<HSIType, float>>(cs, id, QString());
+    if (id == COMPOSITE_COLOR_HSL) return new KoCompositeOpGenericHSL<Traits, &cfColor<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_HUE_HSL) return new KoCompositeOpGenericHSL<Traits, &cfHue<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_SATURATION_HSL) return new KoCompositeOpGenericHSL<Traits, &cfSaturation<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_SATURATION_HSL) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseSaturation<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_SATURATION_HSL) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseSaturation<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_LIGHTNESS) return new KoCompositeOpGenericHSL<Traits, &cfLightness<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_LIGHTNESS) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseLightness<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_LIGHTNESS) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseLightness<HSLType, float>>(cs, id, QString());
+    if (id == COMPOSITE_COLOR_HSV) return new KoCompositeOpGenericHSL<Traits, &cfColor<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_HUE_HSV) return new KoCompositeOpGenericHSL<Traits, &cfHue<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_SATURATION_HSV) return new KoCompositeOpGenericHSL<Traits, &cfSaturation<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_SATURATION_HSV) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseSaturation<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_SATURATION_HSV) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseSaturation<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_VALUE) return new KoCompositeOpGenericHSL<Traits, &cfLightness<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_INC_VALUE) return new KoCompositeOpGenericHSL<Traits, &cfIncreaseLightness<HSVType, float>>(cs, id, QString());
+    if (id == COMPOSITE_DEC_VALUE) return new KoCompositeOpGenericHSL<Traits, &cfDecreaseLightness<HSVType, float>>(cs, id, QString());
+
+    return nullptr;
+}
+
+const QStringList nonSeparableOpIds({
+    COMPOSITE_COLOR, COMPOSITE_HUE, COMPOSITE_SATURATION, COMPOSITE_INC_SATURATION,
+    COMPOSITE_DEC_SATURATION, COMPOSITE_LUMINIZE, COMPOSITE_INC_LUMINOSITY, COMPOSITE_DEC_LUMINOSITY,
+    COMPOSITE_COLOR_HSI, COMPOSITE_HUE_HSI, COMPOSITE_SATURATION_HSI, COMPOSITE_INC_SATURATION_HSI,
+    COMPOSITE_DEC_SATURATION_HSI, COMPOSITE_INTENSITY, COMPOSITE_INC_INTENSITY, COMPOSITE_DEC_INTENSITY,
+    COMPOSITE_COLOR_HSL, COMPOSITE_HUE_HSL, COMPOSITE_SATURATION_HSL, COMPOSITE_INC_SATURATION_HSL,
+    COMPOSITE_DEC_SATURATION_HSL, COMPOSITE_LIGHTNESS, COMPOSITE_INC_LIGHTNESS, COMPOSITE_DEC_LIGHTNESS,
+    COMPOSITE_COLOR_HSV, COMPOSITE_HUE_HSV, COMPOSITE_SATURATION_HSV, COMPOSITE_INC_SATURATION_HSV,
+    COMPOSITE_DEC_SATURATION_HSV, COMPOSITE_VALUE, COMPOSITE_INC_VALUE, COMPOSITE_DEC_VALUE});
+
+/**
+ * Compares the optimized non-separable ops against the scalar ones.
+ *
+ * The optimized ops do exactly the same math as the scalar ones,
+ * so the difference may come from FMA-contraction of the vector
+ * code only. It means that the integer channels may differ by one
+ * step at most and the floating point ones by a few ULPs.
+ */
+template<class Traits>
+bool compareGenericHSLOps(const KoColorSpace *cs,
+                          bool haveMask,
+                          KoCompositeOp* (*createOptimizedOp)(const KoColorSpace*, const QString&, const QString&))
+{
+    using channels_type = typename Traits::channels_type;
+    using namespace Arithmetic;
+
+    /**
+     * The width is not a multiple of any vector size, so the
+     * tail of every row is checked as well
+     */
+    const int cols = 61;
+    const int rows = 17;
+    const int numTestPixels = cols * rows;
+    const int pixelSize = Traits::pixelSize;
+
+    boost::mt11213b rnd(1);
+    boost::uniform_real<float> channelRnd(0.0f, 1.0f);
+    boost::uniform_smallint<int> maskRnd(0, 255);
+
+    QVector<channels_type> src(numTestPixels * 4);
+    QVector<channels_type> dst(numTestPixels * 4);
+    QVector<quint8> mask(numTestPixels);
+
+    for (int i = 0; i < numTestPixels; i++) {
+        channels_type *s = src.data() + 4 * i;
+        channels_type *d = dst.data() + 4 * i;
+
+        for (int c = 0; c < 4; c++) {
+            s[c] = scale<channels_type>(channelRnd(rnd));
+            d[c] = scale<channels_type>(channelRnd(rnd));
+        }
+
+        // check the ties in the sorting of the channels
+        if (i % 5 == 0) {
+            s[1] = s[0];
+            d[2] = d[1];
+        }
+
+        // check gray colors
+        if (i % 7 == 0) {
+            s[2] = s[1] = s[0];
+            d[2] = d[1] = d[0];
+        }
+
+        // check transparent pixels
+        if (i % 11 == 0) {
+            d[3] = zeroValue<channels_type>();
+        }
+
+        mask[i] = maskRnd(rnd);
+    }
+
+    const float prec = std::numeric_limits<channels_type>::is_integer ?
+        1.5f / float(unitValue<channels_type>()) : 1e-5f;
+
+    bool result = true;
+
+    Q_FOREACH (const QString &id, nonSeparableOpIds) {
+        QScopedPointer<KoCompositeOp> opAct(createOptimizedOp(cs, id, QString()));
+        QScopedPointer<KoCompositeOp> opExp(createLegacyGenericHSLOp<Traits>(cs, id));
+
+        if (!opAct) {
+            qDebug() << "No optimized version of" << id << "(vectorization is disabled?)";
+            continue;
+        }
+
+        QVector<channels_type> dstAct = dst;
+        QVector<channels_type> dstExp = dst;
+
+        KoCompositeOp::ParameterInfo params;
+        params.srcRowStart   = reinterpret_cast<const quint8*>(src.constData());
+        params.srcRowStride  = cols * pixelSize;
+        params.maskRowStart  = haveMask ? mask.constData() : 0;
+        params.maskRowStride = cols;
+        params.dstRowStride  = cols * pixelSize;
+        params.rows          = rows;
+        params.cols          = cols;
+        params.opacity       = 0.75f;
+        params.channelFlags  = QBitArray();
+
+        params.dstRowStart = reinterpret_cast<quint8*>(dstAct.data());
+        opAct->composite(params);
+
+        params.dstRowStart = reinterpret_cast<quint8*>(dstExp.data());
+        opExp->composite(params);
+
+        for (int i = 0; i < numTestPixels * 4; i++) {
+            const float act = scale<float>(dstAct[i]);
+            const float exp = scale<float>(dstExp[i]);
+
+            if (qAbs(act - exp) > prec * qMax(1.0f, qAbs(exp))) {
+                qDebug() << "Failed op:" << id << "pixel:" << i / 4 << "channel:" << i % 4;
+                qDebug() << "Act:" << act << "Exp:" << exp;
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
 QString getTestName(bool haveMask,
                     const int srcAlignmentShift,
                     const int dstAlignmentShift,
@@ -885,6 +1207,96 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+namespace {
+/**
+ * Every rounding of the scalar integer op (the source alpha, three
+ * products of the blending, the blend function and the division by
+ * the new alpha) may add half a step to the premultiplied color
+ */
+template<typename channels_type>
+float separableOpsIntegerPrecision()
+{
+    return 4.0f / float(KoColorSpaceMathsTraits<channels_type>::unitValue);
+}
+}
+
+void KisCompositionBenchmark::compareGenericSCOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVERIFY(compareGenericSCOps<KoBgrU8Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericSCOp32,
+                                               separableOpIds, separableOpsIntegerPrecision<quint8>()));
+}
+
+void KisCompositionBenchmark::compareGenericSCOpsNoMask()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVERIFY(compareGenericSCOps<KoBgrU8Traits>(cs, false, &KoOptimizedCompositeOpFactory::createGenericSCOp32,
+                                               separableOpIds, separableOpsIntegerPrecision<quint8>()));
+}
+
+void KisCompositionBenchmark::compareRgbU16GenericSCOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    QVERIFY(compareGenericSCOps<KoBgrU16Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericSCOpU64,
+                                                separableOpIds, separableOpsIntegerPrecision<quint16>()));
+}
+
+void KisCompositionBenchmark::compareRgbF32GenericSCOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+
+    QStringList ids = separableOpIds;
+    ids.removeAll(COMPOSITE_DODGE);
+    ids.removeAll(COMPOSITE_BURN);
+
+    QVERIFY(compareGenericSCOps<KoRgbF32Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericSCOp128, ids, 1e-5f));
+
+    /**
+     * Color dodge and burn divide by (1 - src) and src, so with the
+     * source close to the singularity the results grow up to ~1e7
+     * and the scalar op, which divides in double, and the vector one,
+     * which divides in float, lose a few more bits. The values are
+     * compared relative to their magnitude, so a looser bound still
+     * catches any real difference.
+     */
+    QVERIFY(compareGenericSCOps<KoRgbF32Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericSCOp128,
+                                                {COMPOSITE_DODGE, COMPOSITE_BURN}, 1e-4f));
+}
+
+void KisCompositionBenchmark::compareGenericHSLOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVERIFY(compareGenericHSLOps<KoBgrU8Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericHSLOp32));
+}
+
+void KisCompositionBenchmark::compareGenericHSLOpsNoMask()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVERIFY(compareGenericHSLOps<KoBgrU8Traits>(cs, false, &KoOptimizedCompositeOpFactory::createGenericHSLOp32));
+}
+
+void KisCompositionBenchmark::compareRgbU16GenericHSLOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    QVERIFY(compareGenericHSLOps<KoBgrU16Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericHSLOpU64));
+}
+
+void KisCompositionBenchmark::compareRgbF16GenericHSLOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    QVERIFY(compareGenericHSLOps<KoRgbF16Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericHSLOpF16));
+#else
+    QSKIP("Krita is built without OpenEXR support");
+#endif
+}
+
+void KisCompositionBenchmark::compareRgbF32GenericHSLOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    QVERIFY(compareGenericHSLOps<KoRgbF32Traits>(cs, true, &KoOptimizedCompositeOpFactory::createGenericHSLOp128));
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
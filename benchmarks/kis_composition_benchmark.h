@@ -47,6 +47,17 @@ private Q_SLOTS:
     void compareRgbU16CopyOps();
     void compareRgbF32CopyOps();
 
+    void compareGenericSCOps();
+    void compareGenericSCOpsNoMask();
+    void compareRgbU16GenericSCOps();
+    void compareRgbF32GenericSCOps();
+
+    void compareGenericHSLOps();
+    void compareGenericHSLOpsNoMask();
+    void compareRgbU16GenericHSLOps();
+    void compareRgbF16GenericHSLOps();
+    void compareRgbF32GenericHSLOps();
+
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
 
@@ -10,10 +10,24 @@
 #include <simpletest.h>
 #include <kis_datamanager.h>
 
+#include "config-tile-size.h"
+
 // RGBA
 #define PIXEL_SIZE 4
 //#define CYCLES 100
 
+void KisDatamanagerBenchmark::initTestCase_data()
+{
+    /**
+     * The results depend on the size of the tiles, which is selected
+     * with KRITA_TILE_SIZE option at build time. The global data row
+     * adds the size to the tag of every result, so the results of
+     * the builds with different tile sizes can be compared directly.
+     */
+    QTest::addColumn<int>("tileSize");
+    QTest::newRow("tile" QT_STRINGIFY(KRITA_TILE_SIZE)) << KRITA_TILE_SIZE;
+}
+
 void KisDatamanagerBenchmark::initTestCase()
 {
     // To make sure all the first-time startup costs are done
@@ -186,5 +200,55 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+void KisDatamanagerBenchmark::benchmarkDabTransactions_data()
+{
+    QTest::addColumn<int>("dabSize");
+
+    QTest::newRow("16") << 16;
+    QTest::newRow("32") << 32;
+    QTest::newRow("64") << 64;
+    QTest::newRow("128") << 128;
+    QTest::newRow("256") << 256;
+}
+
+void KisDatamanagerBenchmark::benchmarkDabTransactions()
+{
+    /**
+     * Emulates a brush stroke: every dab is written in its own
+     * transaction, so the cost of copying-on-write of the tiles
+     * (and the size of the mementos) depends on the tile size
+     */
+    QFETCH(int, dabSize);
+
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    {
+        quint8 *bytes = new quint8[PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT];
+        memset(bytes, 120, PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT);
+        dm.writeBytes(bytes, 0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+        delete[] bytes;
+    }
+
+    quint8 *dab = new quint8[PIXEL_SIZE * dabSize * dabSize];
+    memset(dab, 200, PIXEL_SIZE * dabSize * dabSize);
+
+    const int numDabs = 1000;
+    const int step = qMax(1, dabSize / 4);
+
+    QBENCHMARK {
+        for (int i = 0; i < numDabs; i++) {
+            const int x = (i * step) % (TEST_IMAGE_WIDTH - dabSize);
+            const int y = ((i * step) / (TEST_IMAGE_WIDTH - dabSize) * dabSize) % (TEST_IMAGE_HEIGHT - dabSize);
+
+            KisMementoSP memento = dm.getMemento();
+            dm.writeBytes(dab, x, y, dabSize, dabSize);
+            dm.commit();
+        }
+    }
+
+    delete[] dab;
+}
 
 SIMPLE_TEST_MAIN(KisDatamanagerBenchmark)
@@ -15,6 +15,7 @@ class KisDatamanagerBenchmark : public QObject
 
 private Q_SLOTS:
 
+    void initTestCase_data();
     void initTestCase();
     void benchmarkCreation();
     void benchmarkWriteBytes();
@@ -24,6 +25,8 @@ private Q_SLOTS:
     void benchmarkExtent();
     void benchmarkClear();
     void benchmarkMemCpy();
+    void benchmarkDabTransactions_data();
+    void benchmarkDabTransactions();
 };
 
 #endif
@@ -15,8 +15,17 @@
 
 #include <simpletest.h>
 
+#include "config-tile-size.h"
+
 #include "kis_iterator_ng.h"
 
+void KisHLineIteratorBenchmark::initTestCase_data()
+{
+    // tag the results with the tile size the benchmark was built with
+    QTest::addColumn<int>("tileSize");
+    QTest::newRow("tile" QT_STRINGIFY(KRITA_TILE_SIZE)) << KRITA_TILE_SIZE;
+}
+
 void KisHLineIteratorBenchmark::initTestCase()
 {
     m_colorSpace = KoColorSpaceRegistry::instance()->rgb8();
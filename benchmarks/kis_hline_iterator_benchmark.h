@@ -24,6 +24,7 @@ private:
     KoColor * m_color;
 private Q_SLOTS:
     
+    void initTestCase_data();
     void initTestCase();
     void cleanupTestCase();
     
@@ -19,6 +19,7 @@
 #include <kis_paint_layer.h>
 #include "kis_paint_device.h"
 #include "kis_painter.h"
+#include "kis_iterator_ng.h"
 
 #include <brushengine/kis_paint_information.h>
 #include <brushengine/kis_paintop_registry.h>
@@ -219,4 +220,85 @@ void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
                       2000, 600, 500, 0);
 }
 
+/**
+ * Swaps out a big noisy device and reads it back with an hline
+ * iterator. The "stall time" is the time the iterator spends
+ * switching to the next row of tiles, that is, waiting for the
+ * tiles to be swapped in.
+ */
+void KisLowMemoryBenchmark::benchmarkSwappedRead(bool usePrefetching)
+{
+    const int deviceSize = 4096;
+
+    KisImageConfig config(false);
+    const bool oldPrefetching = config.tilesPrefetching();
+    config.setTilesPrefetching(usePrefetching);
+    KisTileDataStore::instance()->testingRereadConfig();
+
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(colorSpace);
+
+    {
+        qsrand(10);
+        QVector<quint8> row(deviceSize * colorSpace->pixelSize());
+
+        for (int y = 0; y < deviceSize; y++) {
+            for (int i = 0; i < row.size(); i++) {
+                row[i] = qrand() % 256;
+            }
+            dev->writeBytes(row.data(), 0, y, deviceSize, 1);
+        }
+    }
+
+    KisTileDataStore::instance()->debugSwapAll();
+
+    QElapsedTimer totalTime;
+    QElapsedTimer stallTimer;
+    qint64 stallTime = 0;
+    quint64 checksum = 0;
+
+    totalTime.start();
+
+    stallTimer.start();
+    KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(0, 0, deviceSize);
+    stallTime += stallTimer.nsecsElapsed();
+
+    for (int y = 0; y < deviceSize; y++) {
+        do {
+            // emulate some work done by the user of the iterator
+            checksum += *it->rawDataConst();
+        } while (it->nextPixel());
+
+        const bool crossesTileRow = !((y + 1) % KisTileData::HEIGHT);
+
+        if (crossesTileRow) {
+            stallTimer.restart();
+        }
+
+        it->nextRow();
+
+        if (crossesTileRow) {
+            stallTime += stallTimer.nsecsElapsed();
+        }
+    }
+
+    qInfo() << (usePrefetching ? "With prefetching:" : "Without prefetching:")
+            << "total" << totalTime.elapsed() << "ms"
+            << "stall" << stallTime / 1000000 << "ms"
+            << "(checksum" << checksum << ")";
+
+    config.setTilesPrefetching(oldPrefetching);
+    KisTileDataStore::instance()->testingRereadConfig();
+}
+
+void KisLowMemoryBenchmark::swappedReadStallNoPrefetching()
+{
+    benchmarkSwappedRead(false);
+}
+
+void KisLowMemoryBenchmark::swappedReadStallPrefetching()
+{
+    benchmarkSwappedRead(true);
+}
+
 SIMPLE_TEST_MAIN(KisLowMemoryBenchmark)
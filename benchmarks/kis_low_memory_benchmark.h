@@ -19,6 +19,9 @@ private Q_SLOTS:
 
     void memory2000History100Pool500HugeBrush();
 
+    void swappedReadStallNoPrefetching();
+    void swappedReadStallPrefetching();
+
 private:
     void benchmarkWideArea(const QString presetFileName,
                            const QRectF &rect, qreal vstep,
@@ -28,6 +31,8 @@ private:
                            int softLimitMiB,
                            int poolLimitMiB,
                            int index);
+
+    void benchmarkSwappedRead(bool usePrefetching);
 };
 
 #endif /* __KIS_LOW_MEMORY_BENCHMARK_H */
@@ -8,6 +8,9 @@
 #include "kis_projection_benchmark.h"
 #include "kis_benchmark_values.h"
 
+#include <QElapsedTimer>
+#include <QThread>
+
 #include <KoColor.h>
 
 #include <kis_group_layer.h>
@@ -46,5 +49,55 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+void KisProjectionBenchmark::benchmarkProjectionScaling()
+{
+    const int numRuns = 3;
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->loadNativeFormat(QString(FILES_DATA_DIR) + '/' + "load_test.kra");
+
+    KisImageSP image = doc->image();
+    const int originalThreadsLimit = image->workingThreadsLimit();
+
+    qint64 singleThreadTime = 0;
+
+    for (int numThreads = 1; numThreads <= QThread::idealThreadCount(); numThreads *= 2) {
+        image->setWorkingThreadsLimit(numThreads);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < numRuns; i++) {
+            image->refreshGraph();
+        }
+
+        const qint64 syncTime = timer.restart() / numRuns;
+
+        for (int i = 0; i < numRuns; i++) {
+            image->refreshGraphAsync();
+            image->waitForDone();
+        }
+
+        const qint64 asyncTime = timer.elapsed() / numRuns;
+
+        if (numThreads == 1) {
+            singleThreadTime = qMax(qint64(1), syncTime);
+        }
+
+        qDebug() << "Threads:" << numThreads
+                 << "Full refresh:" << syncTime << "ms"
+                 << "Async refresh:" << asyncTime << "ms"
+                 << "Speedup:" << qreal(singleThreadTime) / qMax(qint64(1), syncTime);
+
+        if (numThreads < QThread::idealThreadCount() &&
+            numThreads * 2 > QThread::idealThreadCount()) {
+
+            numThreads = QThread::idealThreadCount() / 2;
+        }
+    }
+
+    image->setWorkingThreadsLimit(originalThreadsLimit);
+    delete doc;
+}
 
 SIMPLE_TEST_MAIN(KisProjectionBenchmark)
@@ -16,6 +16,15 @@
 #include <simpletest.h>
 #include <kis_random_accessor_ng.h>
 
+#include "config-tile-size.h"
+
+
+void KisRandomIteratorBenchmark::initTestCase_data()
+{
+    // tag the results with the tile size the benchmark was built with
+    QTest::addColumn<int>("tileSize");
+    QTest::newRow("tile" QT_STRINGIFY(KRITA_TILE_SIZE)) << KRITA_TILE_SIZE;
+}
 
 void KisRandomIteratorBenchmark::initTestCase()
 {
@@ -23,6 +23,7 @@ private:
     KisPaintDevice * m_device;        
     KoColor * m_color;
 private Q_SLOTS:
+    void initTestCase_data();
     void initTestCase();
     void cleanupTestCase();
     
@@ -0,0 +1,128 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_compression_benchmark.h"
+
+#include <simpletest.h>
+#include <QElapsedTimer>
+
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
+#include "tiles3/swap/kis_tile_compressor_2.h"
+
+#define NUM_CYCLES 10
+
+/**
+ * Compresses and decompresses all the tiles of a real image with
+ * every codec of KisCompressionRegistry and reports the compression
+ * ratio and the throughput (in MiB/s of uncompressed data).
+ */
+
+void KisTileCompressionBenchmark::benchmarkCodecs_data()
+{
+    QTest::addColumn<int>("codec");
+    QTest::addColumn<QString>("depth");
+
+    const QStringList depths({Integer8BitsColorDepthID.id(),
+                              Integer16BitsColorDepthID.id(),
+                              Float32BitsColorDepthID.id()});
+
+    Q_FOREACH (const QString &depth, depths) {
+        Q_FOREACH (const QString &name, KisCompressionRegistry::codecNames()) {
+            QTest::newRow(QString("%1-%2").arg(name).arg(depth).toLatin1())
+                << KisCompressionRegistry::codecByName(name)
+                << depth;
+        }
+    }
+}
+
+void KisTileCompressionBenchmark::benchmarkCodecs()
+{
+    QFETCH(int, codec);
+    QFETCH(QString, depth);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depth, 0);
+
+    QImage image(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->convertFromQImage(image, 0, 0, 0);
+
+    KisDataManagerSP dm = dev->dataManager();
+
+    const QRect extent = dm->extent();
+    const int firstCol = extent.left() / KisTileData::WIDTH;
+    const int firstRow = extent.top() / KisTileData::HEIGHT;
+    const int lastCol = extent.right() / KisTileData::WIDTH;
+    const int lastRow = extent.bottom() / KisTileData::HEIGHT;
+
+    QVector<KisTileSP> tiles;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            tiles << dm->getTile(col, row, false);
+        }
+    }
+
+    KisTileCompressor2 compressor((KisCompressionRegistry::Codec(codec)));
+
+    const qint32 bufferSize = compressor.tileDataBufferSize(tiles.first()->tileData());
+    QVector<QByteArray> buffers(tiles.size(), QByteArray(bufferSize, 0));
+    QVector<qint32> compressedSizes(tiles.size());
+
+    /**
+     * Decompress into a separate tile to keep the source untouched
+     */
+    KisDataManager scratchDm(cs->pixelSize(), dm->defaultPixel());
+    KisTileSP scratchTile = scratchDm.getTile(0, 0, true);
+
+    QElapsedTimer timer;
+
+    qint64 compressionTime = 0;
+    qint64 decompressionTime = 0;
+
+    for (int cycle = 0; cycle < NUM_CYCLES; cycle++) {
+        timer.start();
+        for (int i = 0; i < tiles.size(); i++) {
+            tiles[i]->lockForRead();
+            compressor.compressTileData(tiles[i]->tileData(),
+                                        (quint8*)buffers[i].data(), bufferSize,
+                                        compressedSizes[i]);
+            tiles[i]->unlockForRead();
+        }
+        compressionTime += timer.nsecsElapsed();
+
+        scratchTile->lockForWrite();
+        timer.start();
+        for (int i = 0; i < tiles.size(); i++) {
+            compressor.decompressTileData((quint8*)buffers[i].data(), compressedSizes[i],
+                                          scratchTile->tileData());
+        }
+        decompressionTime += timer.nsecsElapsed();
+        scratchTile->unlockForWrite();
+    }
+
+    qint64 uncompressedBytes = 0;
+    qint64 compressedBytes = 0;
+
+    for (int i = 0; i < tiles.size(); i++) {
+        uncompressedBytes += KisTileData::WIDTH * KisTileData::HEIGHT * cs->pixelSize();
+        compressedBytes += compressedSizes[i];
+    }
+
+    const qreal totalMiB = qreal(uncompressedBytes) * NUM_CYCLES / (1024 * 1024);
+
+    qDebug() << qPrintable(KisCompressionRegistry::codecName(codec))
+             << qPrintable(depth)
+             << "tiles:" << tiles.size()
+             << "ratio:" << qreal(compressedBytes) / uncompressedBytes
+             << "compression MiB/s:" << totalMiB / (compressionTime * 1e-9)
+             << "decompression MiB/s:" << totalMiB / (decompressionTime * 1e-9);
+}
+
+SIMPLE_TEST_MAIN(KisTileCompressionBenchmark)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_TILE_COMPRESSION_BENCHMARK_H
+#define KIS_TILE_COMPRESSION_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisTileCompressionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkCodecs_data();
+    void benchmarkCodecs();
+};
+
+#endif /* KIS_TILE_COMPRESSION_BENCHMARK_H */
@@ -15,6 +15,15 @@
 #include <kis_iterator_ng.h>
 #include <simpletest.h>
 
+#include "config-tile-size.h"
+
+
+void KisVLineIteratorBenchmark::initTestCase_data()
+{
+    // tag the results with the tile size the benchmark was built with
+    QTest::addColumn<int>("tileSize");
+    QTest::newRow("tile" QT_STRINGIFY(KRITA_TILE_SIZE)) << KRITA_TILE_SIZE;
+}
 
 void KisVLineIteratorBenchmark::initTestCase()
 {
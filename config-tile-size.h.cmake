@@ -0,0 +1,3 @@
+/* config-tile-size.h.  Generated by cmake from config-tile-size.h.cmake */
+
+#define KRITA_TILE_SIZE @KRITA_TILE_SIZE@
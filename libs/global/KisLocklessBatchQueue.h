@@ -0,0 +1,110 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISLOCKLESSBATCHQUEUE_H
+#define KISLOCKLESSBATCHQUEUE_H
+
+#include <QAtomicPointer>
+#include <QtGlobal>
+
+/**
+ * A multiple-producers-single-consumer queue. The producers push
+ * the items one by one without any locks, the consumer takes all
+ * the pushed items at once and processes them in FIFO order.
+ *
+ * Internally it is a linked stack. The consumer detaches the whole
+ * stack with a single atomic exchange and reverses it, so unlike
+ * KisLocklessStack it needs neither delete blockers nor a list of
+ * free nodes: a producer never dereferences the nodes it hasn't
+ * created, so the ABA problem is harmless here.
+ *
+ * takeAll() must not be called from several threads simultaneously
+ * (e.g. it should be guarded by the consumer's mutex).
+ */
+template<class T>
+class KisLocklessBatchQueue
+{
+private:
+    struct Node {
+        Node *next = nullptr;
+        T data;
+    };
+
+public:
+    KisLocklessBatchQueue() { }
+    ~KisLocklessBatchQueue() {
+        freeList(m_top.fetchAndStoreOrdered(0));
+    }
+
+    void push(const T &data) {
+        Node *newNode = new Node();
+        newNode->data = data;
+
+        Node *top;
+
+        do {
+            top = m_top.loadAcquire();
+            newNode->next = top;
+        } while (!m_top.testAndSetRelease(top, newNode));
+    }
+
+    /**
+     * A fast check without any write operations
+     */
+    bool isEmpty() const {
+        return !m_top.loadAcquire();
+    }
+
+    /**
+     * Takes all the items pushed so far and calls \p func for each
+     * of them in the order they were pushed. Returns the number of
+     * processed items.
+     */
+    template <typename Func>
+    int takeAll(Func func) {
+        // a fast-path without write ops
+        if (!m_top.loadAcquire()) return 0;
+
+        Node *top = m_top.fetchAndStoreAcquire(0);
+
+        Node *head = 0;
+        while (top) {
+            Node *next = top->next;
+            top->next = head;
+            head = top;
+            top = next;
+        }
+
+        int numItems = 0;
+
+        while (head) {
+            Node *next = head->next;
+            func(head->data);
+            delete head;
+            head = next;
+            numItems++;
+        }
+
+        return numItems;
+    }
+
+private:
+    void freeList(Node *first) {
+        Node *next;
+        while (first) {
+            next = first->next;
+            delete first;
+            first = next;
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(KisLocklessBatchQueue)
+
+    QAtomicPointer<Node> m_top;
+};
+
+#endif // KISLOCKLESSBATCHQUEUE_H
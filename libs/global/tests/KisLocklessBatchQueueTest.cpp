@@ -0,0 +1,84 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisLocklessBatchQueueTest.h"
+
+#include <QThread>
+
+#include "KisLocklessBatchQueue.h"
+
+
+void KisLocklessBatchQueueTest::testOrder()
+{
+    KisLocklessBatchQueue<int> queue;
+    QVERIFY(queue.isEmpty());
+
+    for (int i = 0; i < 10; i++) {
+        queue.push(i);
+    }
+
+    QVERIFY(!queue.isEmpty());
+
+    QVector<int> result;
+    QCOMPARE(queue.takeAll([&result] (int value) { result.append(value); }), 10);
+
+    QCOMPARE(result, QVector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    QVERIFY(queue.isEmpty());
+
+    QCOMPARE(queue.takeAll([&result] (int value) { result.append(value); }), 0);
+    QCOMPARE(result.size(), 10);
+
+    // the destructor frees the items that were not taken
+    queue.push(11);
+    queue.push(12);
+}
+
+void KisLocklessBatchQueueTest::testConcurrentProducers()
+{
+    const int numProducers = 4;
+    const int numItems = 100000;
+
+    KisLocklessBatchQueue<QPair<int, int>> queue;
+
+    QVector<QThread*> producers;
+    for (int producer = 0; producer < numProducers; producer++) {
+        producers << QThread::create(
+            [&queue, producer, numItems] () {
+                for (int i = 0; i < numItems; i++) {
+                    queue.push(qMakePair(producer, i));
+                }
+            });
+    }
+
+    Q_FOREACH (QThread *thread, producers) {
+        thread->start();
+    }
+
+    QVector<int> lastItems(numProducers, -1);
+    int numTakenItems = 0;
+    bool orderIsCorrect = true;
+
+    auto consumer =
+        [&lastItems, &orderIsCorrect] (const QPair<int, int> &item) {
+            // the items of every producer must come in the order they were pushed
+            orderIsCorrect &= item.second == lastItems[item.first] + 1;
+            lastItems[item.first] = item.second;
+        };
+
+    while (numTakenItems < numProducers * numItems) {
+        numTakenItems += queue.takeAll(consumer);
+    }
+
+    Q_FOREACH (QThread *thread, producers) {
+        thread->wait();
+        delete thread;
+    }
+
+    QVERIFY(orderIsCorrect);
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(lastItems, QVector<int>(numProducers, numItems - 1));
+}
+
+QTEST_MAIN(KisLocklessBatchQueueTest)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISLOCKLESSBATCHQUEUETEST_H
+#define KISLOCKLESSBATCHQUEUETEST_H
+
+#include <QtTest>
+#include <QObject>
+
+
+class KisLocklessBatchQueueTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testOrder();
+    void testConcurrentProducers();
+};
+
+#endif // KISLOCKLESSBATCHQUEUETEST_H
@@ -0,0 +1,132 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAdaptiveLodController.h"
+
+#include <QMutexLocker>
+
+#include "kis_assert.h"
+
+namespace {
+
+/**
+ * The weight of a new sample in the moving average
+ */
+const qreal SMOOTHING_FACTOR = 0.125;
+
+/**
+ * Each level of detail makes the number of pixels to process
+ * four times smaller
+ */
+const qreal WORK_RATIO_PER_LEVEL = 4.0;
+
+}
+
+
+KisAdaptiveLodController::KisAdaptiveLodController()
+{
+}
+
+void KisAdaptiveLodController::setEnabled(bool value)
+{
+    QMutexLocker l(&m_lock);
+
+    if (m_enabled == value) return;
+
+    m_enabled = value;
+    m_lodOffset = 0;
+    m_numSamples = 0;
+    m_averageLatency = 0.0;
+}
+
+bool KisAdaptiveLodController::isEnabled() const
+{
+    QMutexLocker l(&m_lock);
+    return m_enabled;
+}
+
+void KisAdaptiveLodController::setLatencyBudget(int msec)
+{
+    KIS_SAFE_ASSERT_RECOVER(msec > 0) {
+        msec = 1;
+    }
+
+    QMutexLocker l(&m_lock);
+    m_latencyBudget = msec;
+}
+
+int KisAdaptiveLodController::latencyBudget() const
+{
+    QMutexLocker l(&m_lock);
+    return m_latencyBudget;
+}
+
+void KisAdaptiveLodController::setMaxLodOffset(int value)
+{
+    QMutexLocker l(&m_lock);
+    m_maxLodOffset = qMax(0, value);
+    m_lodOffset = qMin(m_lodOffset, m_maxLodOffset);
+}
+
+int KisAdaptiveLodController::maxLodOffset() const
+{
+    QMutexLocker l(&m_lock);
+    return m_maxLodOffset;
+}
+
+bool KisAdaptiveLodController::reportLatency(qint64 msec)
+{
+    QMutexLocker l(&m_lock);
+
+    if (!m_enabled) return false;
+
+    m_averageLatency = !m_numSamples ?
+        msec : (1.0 - SMOOTHING_FACTOR) * m_averageLatency + SMOOTHING_FACTOR * msec;
+    m_numSamples++;
+
+    if (m_numSamples < minSamples) return false;
+
+    int newLodOffset = m_lodOffset;
+
+    if (m_averageLatency > m_latencyBudget) {
+        newLodOffset = qMin(m_lodOffset + 1, m_maxLodOffset);
+    } else if (m_averageLatency * WORK_RATIO_PER_LEVEL < m_latencyBudget) {
+        newLodOffset = qMax(m_lodOffset - 1, 0);
+    }
+
+    if (newLodOffset == m_lodOffset) return false;
+
+    /**
+     * The samples measured on the old level of detail are
+     * useless for the new one
+     */
+    m_lodOffset = newLodOffset;
+    m_numSamples = 0;
+    m_averageLatency = 0.0;
+
+    return true;
+}
+
+int KisAdaptiveLodController::lodOffset() const
+{
+    QMutexLocker l(&m_lock);
+    return m_enabled ? m_lodOffset : 0;
+}
+
+qreal KisAdaptiveLodController::averageLatency() const
+{
+    QMutexLocker l(&m_lock);
+    return m_averageLatency;
+}
+
+void KisAdaptiveLodController::reset()
+{
+    QMutexLocker l(&m_lock);
+
+    m_lodOffset = 0;
+    m_numSamples = 0;
+    m_averageLatency = 0.0;
+}
@@ -0,0 +1,86 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISADAPTIVELODCONTROLLER_H
+#define KISADAPTIVELODCONTROLLER_H
+
+#include "kritaimage_export.h"
+
+#include <QMutex>
+
+/**
+ * Chooses an additional level of detail for the strokes depending
+ * on the measured latency of the canvas updates.
+ *
+ * The scheduler reports the latency of every merge job, that is, the
+ * time between the moment the update was requested and the moment its
+ * result has been merged into the projection. The controller averages
+ * the values and, when the average exceeds the latency budget, suggests
+ * to increase the level of detail by one. Every level of detail makes
+ * the amount of work four times smaller, so the level is decreased back
+ * only when the average latency multiplied by four still fits into the
+ * budget. It prevents the controller from oscillating between two levels.
+ *
+ * The level of detail of a stroke cannot be changed while the stroke is
+ * running, so the suggested offset is applied by the canvas (through
+ * KisImage::setLodPreferences()) and is picked up by the next stroke.
+ */
+class KRITAIMAGE_EXPORT KisAdaptiveLodController
+{
+public:
+    KisAdaptiveLodController();
+
+    void setEnabled(bool value);
+    bool isEnabled() const;
+
+    /**
+     * The desired latency of the updates in milliseconds
+     */
+    void setLatencyBudget(int msec);
+    int latencyBudget() const;
+
+    /**
+     * The maximum number of levels the controller may add to
+     * the level of detail chosen by the zoom
+     */
+    void setMaxLodOffset(int value);
+    int maxLodOffset() const;
+
+    /**
+     * Reports the latency of a single update. Returns true if
+     * the suggested offset has changed.
+     */
+    bool reportLatency(qint64 msec);
+
+    /**
+     * The number of levels that should be added to the level of
+     * detail chosen by the zoom. Always zero if the controller
+     * is disabled.
+     */
+    int lodOffset() const;
+
+    qreal averageLatency() const;
+
+    void reset();
+
+    /**
+     * The number of updates needed for the controller to make a decision
+     */
+    static const int minSamples = 16;
+
+private:
+    mutable QMutex m_lock;
+
+    bool m_enabled = false;
+    int m_latencyBudget = 40;
+    int m_maxLodOffset = 2;
+
+    int m_lodOffset = 0;
+    int m_numSamples = 0;
+    qreal m_averageLatency = 0.0;
+};
+
+#endif // KISADAPTIVELODCONTROLLER_H
@@ -0,0 +1,217 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBelowLayersCache.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
+#include <QSet>
+#include <QVector>
+
+#include <KoColorSpace.h>
+
+#include "kis_node.h"
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_projection_leaf.h"
+
+
+namespace {
+QAtomicInt s_cacheEnabled(false);
+
+/**
+ * The sequence numbers of the projections of all the leaves lying
+ * below \p splitLeaf. The number of a device changes on every write
+ * into it, so the cache can notice the changes that bypassed the
+ * update walkers of the group.
+ */
+QVector<int> belowLeavesSequenceNumbers(KisProjectionLeafSP splitLeaf)
+{
+    QVector<int> result;
+
+    for (KisProjectionLeafSP leaf = splitLeaf->prevSibling(); leaf; leaf = leaf->prevSibling()) {
+        KisPaintDeviceSP projection = leaf->projection();
+        result.append(projection ? projection->sequenceNumber() : -1);
+    }
+
+    return result;
+}
+}
+
+struct KisBelowLayersCache::Private
+{
+    mutable QMutex lock;
+
+    KisPaintDeviceSP device;
+    KisProjectionLeafWSP splitLeaf;
+
+    /**
+     * The leaves whose composition is stored in the device. The pointers
+     * are used for comparison only, they are valid as long as the graph
+     * sequence number stays the same.
+     */
+    QSet<const KisProjectionLeaf*> belowLeaves;
+    QVector<int> belowLeavesSequenceNumbers;
+    int graphSequenceNumber = -1;
+
+    QRegion validRegion;
+
+    /**
+     * Incremented on every reset of the device, so the data written
+     * concurrently with a reset would not be marked as valid
+     */
+    int generation = 0;
+
+    QAtomicInt hasData;
+
+    void resetLocked() {
+        device = 0;
+        splitLeaf.clear();
+        belowLeaves.clear();
+        belowLeavesSequenceNumbers.clear();
+        graphSequenceNumber = -1;
+        validRegion = QRegion();
+        generation++;
+        hasData.storeRelease(false);
+    }
+
+    bool isValidFor(KisProjectionLeafSP leaf, KisPaintDeviceSP dst) const {
+        return device &&
+            splitLeaf.toStrongRef() == leaf &&
+            graphSequenceNumber == leaf->node()->graphSequenceNumber() &&
+            *device->colorSpace() == *dst->colorSpace() &&
+            device->x() == dst->x() && device->y() == dst->y() &&
+            belowLeavesSequenceNumbers == ::belowLeavesSequenceNumbers(leaf);
+    }
+};
+
+
+KisBelowLayersCache::KisBelowLayersCache()
+    : m_d(new Private)
+{
+}
+
+KisBelowLayersCache::~KisBelowLayersCache()
+{
+}
+
+void KisBelowLayersCache::setEnabled(bool value)
+{
+    s_cacheEnabled.storeRelease(value);
+}
+
+bool KisBelowLayersCache::isEnabled()
+{
+    return s_cacheEnabled.loadAcquire();
+}
+
+bool KisBelowLayersCache::read(KisProjectionLeafSP splitLeaf, const QRect &rect, KisPaintDeviceSP dst)
+{
+    if (!m_d->hasData.loadAcquire()) return false;
+
+    KisPaintDeviceSP device;
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        if (!m_d->isValidFor(splitLeaf, dst) ||
+            !(QRegion(rect) - m_d->validRegion).isEmpty()) {
+
+            return false;
+        }
+
+        device = m_d->device;
+    }
+
+    /**
+     * The update jobs that can run concurrently never access the same
+     * area of the image, so the copying can be done without the lock.
+     * Even if the cache is reset in the meantime, the data of the
+     * (now detached) device is still valid for our split leaf.
+     */
+    KisPainter::copyAreaOptimized(rect.topLeft(), device, dst, rect);
+
+    return true;
+}
+
+void KisBelowLayersCache::write(KisProjectionLeafSP splitLeaf, const QRect &rect, KisPaintDeviceSP src)
+{
+    const int graphSequenceNumber = splitLeaf->node()->graphSequenceNumber();
+
+    // the nodes not connected to any image cannot track their graph changes
+    if (graphSequenceNumber < 0) return;
+
+    KisPaintDeviceSP device;
+    int generation = 0;
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        if (!m_d->isValidFor(splitLeaf, src)) {
+            m_d->resetLocked();
+
+            m_d->device = new KisPaintDevice(src->colorSpace());
+            m_d->device->prepareClone(src);
+            m_d->splitLeaf = splitLeaf;
+            m_d->graphSequenceNumber = graphSequenceNumber;
+
+            for (KisProjectionLeafSP leaf = splitLeaf->prevSibling(); leaf; leaf = leaf->prevSibling()) {
+                m_d->belowLeaves.insert(leaf.data());
+            }
+            m_d->belowLeavesSequenceNumbers = belowLeavesSequenceNumbers(splitLeaf);
+        }
+
+        device = m_d->device;
+        generation = m_d->generation;
+    }
+
+    KisPainter::copyAreaOptimized(rect.topLeft(), src, device, rect);
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        if (m_d->generation == generation) {
+            m_d->validRegion += rect;
+            m_d->hasData.storeRelease(true);
+        }
+    }
+}
+
+void KisBelowLayersCache::invalidate(KisProjectionLeafSP changedLeaf, const QRect &rect)
+{
+    if (!m_d->hasData.loadAcquire()) return;
+
+    QMutexLocker l(&m_d->lock);
+
+    if (!m_d->device) return;
+
+    if (m_d->graphSequenceNumber != changedLeaf->node()->graphSequenceNumber()) {
+        m_d->resetLocked();
+        return;
+    }
+
+    if (m_d->belowLeaves.contains(changedLeaf.data())) {
+        m_d->validRegion -= rect;
+    }
+}
+
+void KisBelowLayersCache::clear()
+{
+    QMutexLocker l(&m_d->lock);
+    m_d->resetLocked();
+}
+
+bool KisBelowLayersCache::isEmpty() const
+{
+    return !m_d->hasData.loadAcquire();
+}
+
+QRegion KisBelowLayersCache::validRegion() const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->validRegion;
+}
@@ -0,0 +1,81 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBELOWLAYERSCACHE_H
+#define KISBELOWLAYERSCACHE_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+#include <QScopedPointer>
+
+class QRect;
+class QRegion;
+
+/**
+ * The cache of the partial composition of a group layer: all the
+ * children of the group lying below some "split" child are merged
+ * together and stored in a separate paint device.
+ *
+ * When the user paints on a layer inside a deep stack, every update
+ * walker recomposes all the siblings lying below the layer. With the
+ * cache KisAsyncMerger just copies the stored composition into the
+ * group original and continues with the layer itself.
+ *
+ * The cache is valid only for one split child at a time. Its content
+ * is invalidated by the merger when it recalculates any leaf lying
+ * below the split child (see invalidate()) and dropped completely
+ * when the graph of the image changes or the projection of any of
+ * these leaves is changed without an update of the group.
+ *
+ * The cache keeps an extra device per group, so it is disabled by
+ * default (see KisImageConfig::cacheBelowLayersComposition()).
+ *
+ * Please note that only the layers lying *below* the split child are
+ * cached. The layers lying above it are blended on top of the changed
+ * result, and most of the blending modes are not associative, so their
+ * composition cannot be precalculated.
+ */
+class KRITAIMAGE_EXPORT KisBelowLayersCache
+{
+public:
+    KisBelowLayersCache();
+    ~KisBelowLayersCache();
+
+    static void setEnabled(bool value);
+    static bool isEnabled();
+
+    /**
+     * Copies the composition of all the leaves lying below \p splitLeaf
+     * in \p rect into \p dst. Returns false if the cache has no valid
+     * data for the whole rect.
+     */
+    bool read(KisProjectionLeafSP splitLeaf, const QRect &rect, KisPaintDeviceSP dst);
+
+    /**
+     * Stores the composition of all the leaves lying below \p splitLeaf,
+     * which is currently present in \p src, into the cache. If the cache
+     * holds the data for another split leaf, the old data is dropped.
+     */
+    void write(KisProjectionLeafSP splitLeaf, const QRect &rect, KisPaintDeviceSP src);
+
+    /**
+     * Notifies the cache that the projection of \p changedLeaf (one of
+     * the children of the group) has changed in \p rect
+     */
+    void invalidate(KisProjectionLeafSP changedLeaf, const QRect &rect);
+
+    void clear();
+
+    bool isEmpty() const;
+    QRegion validRegion() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISBELOWLAYERSCACHE_H
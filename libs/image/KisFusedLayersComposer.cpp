@@ -0,0 +1,215 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFusedLayersComposer.h"
+
+#include <QBitArray>
+#include <QRect>
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoCompositeOp.h>
+#include <KoCompositeOpRegistry.h>
+
+#include "kis_assert.h"
+#include "kis_layer_projection_plane.h"
+#include "kis_paint_device.h"
+#include "kis_paint_layer.h"
+#include "kis_projection_leaf.h"
+#include "kis_random_accessor_ng.h"
+
+
+namespace {
+struct Source {
+    KisPaintDeviceSP device;
+    const KoCompositeOp *op = nullptr;
+    QBitArray channelFlags;
+    float opacity = 1.0f;
+    QRect rect;
+    KisRandomConstAccessorSP it;
+};
+}
+
+struct KisFusedLayersComposer::Private
+{
+    QVector<KisProjectionLeafSP> leaves;
+
+    void compositeSource(Source &source, const QRect &rc,
+                         quint8 *dstChunk, const QPoint &dstChunkOrigin,
+                         qint32 dstRowStride, qint32 pixelSize);
+};
+
+KisFusedLayersComposer::KisFusedLayersComposer()
+    : m_d(new Private)
+{
+}
+
+KisFusedLayersComposer::~KisFusedLayersComposer()
+{
+}
+
+bool KisFusedLayersComposer::canBeFused(KisProjectionLeafSP leaf, const KoColorSpace *dstColorSpace)
+{
+    // the invisible leaves are just skipped
+    if (!leaf->visible()) return true;
+
+    KisPaintLayer *layer = qobject_cast<KisPaintLayer*>(leaf->node().data());
+    if (!layer || layer->hasEffectMasks()) return false;
+
+    /**
+     * The layer style replaces the projection plane of the layer,
+     * we can fuse only the plain bit-blitting one
+     */
+    if (layer->projectionPlane().data() != layer->internalProjectionPlane().data()) return false;
+
+    KisPaintDeviceSP device = leaf->projection();
+    if (!device || !(*device->colorSpace() == *dstColorSpace)) return false;
+
+    /**
+     * These ops change the destination outside the extent of
+     * the source device, see KisLayerProjectionPlane::applyImpl()
+     */
+    const QString compositeOpId = layer->compositeOpId();
+    return compositeOpId != COMPOSITE_COPY &&
+        compositeOpId != COMPOSITE_DESTINATION_IN &&
+        compositeOpId != COMPOSITE_DESTINATION_ATOP;
+}
+
+void KisFusedLayersComposer::addLeaf(KisProjectionLeafSP leaf)
+{
+    m_d->leaves.append(leaf);
+}
+
+int KisFusedLayersComposer::numLeaves() const
+{
+    return m_d->leaves.size();
+}
+
+void KisFusedLayersComposer::composite(KisPaintDeviceSP dst, const QRect &rect)
+{
+    const KoColorSpace *dstColorSpace = dst->colorSpace();
+    const qint32 pixelSize = dstColorSpace->pixelSize();
+
+    QVector<Source> sources;
+    QRect processRect;
+
+    Q_FOREACH (KisProjectionLeafSP leaf, m_d->leaves) {
+        if (!leaf->visible()) continue;
+
+        Source source;
+        source.device = leaf->projection();
+        source.rect = rect & source.device->extent();
+
+        if (source.rect.isEmpty()) continue;
+
+        KisLayer *layer = qobject_cast<KisLayer*>(leaf->node().data());
+        KIS_SAFE_ASSERT_RECOVER(layer) { continue; }
+
+        // the same parameters as KisLayerProjectionPlane and KisPainter use
+        source.op = dstColorSpace->compositeOp(layer->compositeOpId(), source.device->colorSpace());
+        source.opacity = float(leaf->opacity()) / 255.0f;
+        source.channelFlags = leaf->channelFlags();
+
+        if (!source.channelFlags.isEmpty() &&
+            source.channelFlags == QBitArray(source.channelFlags.size(), true)) {
+
+            source.channelFlags = QBitArray();
+        }
+
+        source.it = source.device->createRandomConstAccessorNG();
+
+        processRect |= source.rect;
+        sources.append(source);
+    }
+
+    if (sources.isEmpty()) return;
+
+    KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
+
+    qint32 y = processRect.y();
+    qint32 rowsRemaining = processRect.height();
+
+    while (rowsRemaining > 0) {
+        const qint32 rows = qMin(dstIt->numContiguousRows(y), rowsRemaining);
+
+        qint32 x = processRect.x();
+        qint32 columnsRemaining = processRect.width();
+
+        while (columnsRemaining > 0) {
+            const qint32 columns = qMin(dstIt->numContiguousColumns(x), columnsRemaining);
+            const QRect chunkRect(x, y, columns, rows);
+
+            dstIt->moveTo(x, y);
+            quint8 *dstChunk = dstIt->rawData();
+            const qint32 dstRowStride = dstIt->rowStride(x, y);
+
+            /**
+             * The chunk belongs to a single tile of the destination,
+             * so it stays in the cache while all the layers are
+             * blended into it
+             */
+            for (auto it = sources.begin(); it != sources.end(); ++it) {
+                const QRect rc = chunkRect & it->rect;
+                if (rc.isEmpty()) continue;
+
+                m_d->compositeSource(*it, rc, dstChunk, chunkRect.topLeft(), dstRowStride, pixelSize);
+            }
+
+            x += columns;
+            columnsRemaining -= columns;
+        }
+
+        y += rows;
+        rowsRemaining -= rows;
+    }
+}
+
+void KisFusedLayersComposer::Private::compositeSource(Source &source, const QRect &rc,
+                                                      quint8 *dstChunk, const QPoint &dstChunkOrigin,
+                                                      qint32 dstRowStride, qint32 pixelSize)
+{
+    KoCompositeOp::ParameterInfo params;
+    params.opacity = source.opacity;
+    params.channelFlags = source.channelFlags;
+    params.dstRowStride = dstRowStride;
+
+    /**
+     * The tiles of the source device are not necessarily aligned
+     * with the tiles of the destination, so the chunk may be split
+     * into several parts
+     */
+    qint32 y = rc.y();
+    qint32 rowsRemaining = rc.height();
+
+    while (rowsRemaining > 0) {
+        const qint32 rows = qMin(source.it->numContiguousRows(y), rowsRemaining);
+
+        qint32 x = rc.x();
+        qint32 columnsRemaining = rc.width();
+
+        while (columnsRemaining > 0) {
+            const qint32 columns = qMin(source.it->numContiguousColumns(x), columnsRemaining);
+
+            source.it->moveTo(x, y);
+
+            params.srcRowStart = source.it->rawDataConst();
+            params.srcRowStride = source.it->rowStride(x, y);
+            params.dstRowStart = dstChunk +
+                (y - dstChunkOrigin.y()) * dstRowStride +
+                (x - dstChunkOrigin.x()) * pixelSize;
+            params.rows = rows;
+            params.cols = columns;
+
+            source.op->composite(params);
+
+            x += columns;
+            columnsRemaining -= columns;
+        }
+
+        y += rows;
+        rowsRemaining -= rows;
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFUSEDLAYERSCOMPOSER_H
+#define KISFUSEDLAYERSCOMPOSER_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+#include <QScopedPointer>
+
+class QRect;
+class KoColorSpace;
+
+/**
+ * Composes a run of sibling layers into the projection of their
+ * parent in a single pass over the destination device.
+ *
+ * KisAsyncMerger usually composes the layers one by one: every layer
+ * is bit-blitted over the whole update rect, so the destination is
+ * read and written once per layer. With a run of N layers the composer
+ * walks over the tiles of the destination instead, and every tile is
+ * blended with all N layers while it is still in the CPU cache.
+ *
+ * Only "simple" layers can be fused (see canBeFused()): plain paint
+ * layers without masks and layer styles, whose projection plane just
+ * bit-blits the projection with the layer's composite op, opacity and
+ * channel flags. The result is exactly the same as the one of the
+ * sequential composition, since every pixel is still blended with
+ * the layers in the same bottom-to-top order.
+ */
+class KRITAIMAGE_EXPORT KisFusedLayersComposer
+{
+public:
+    KisFusedLayersComposer();
+    ~KisFusedLayersComposer();
+
+    /**
+     * Returns true if \p leaf can be composed into \p dstColorSpace
+     * by the composer
+     */
+    static bool canBeFused(KisProjectionLeafSP leaf, const KoColorSpace *dstColorSpace);
+
+    /**
+     * Adds \p leaf on top of the run. The leaf must pass canBeFused().
+     */
+    void addLeaf(KisProjectionLeafSP leaf);
+
+    int numLeaves() const;
+
+    /**
+     * Composes all the leaves of the run into \p dst in \p rect
+     */
+    void composite(KisPaintDeviceSP dst, const QRect &rect);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISFUSEDLAYERSCOMPOSER_H
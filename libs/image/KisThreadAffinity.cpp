@@ -0,0 +1,320 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisThreadAffinity.h"
+
+#include <QFile>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+
+#include <algorithm>
+#include <iterator>
+
+#include "kis_debug.h"
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+/**
+ * Protects parseCpuList() from malformed ranges like "0-2000000000"
+ */
+const int MAX_CORE_INDEX = 65535;
+
+#ifdef Q_OS_LINUX
+
+QString readSysFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+
+    return QString::fromLatin1(file.readAll()).trimmed();
+}
+
+QVector<int> availableCoresLinux()
+{
+    QVector<int> cores;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, &set)) {
+                cores.append(i);
+            }
+        }
+    }
+
+    return cores;
+}
+
+/**
+ * Returns the cores with the maximum value of the per-cpu sysfs
+ * property \p property, or an empty list if all the cores have
+ * the same value (or the property is not present)
+ */
+QVector<int> fastestCoresByProperty(const QVector<int> &cores, const QString &property)
+{
+    QVector<qint64> values;
+
+    Q_FOREACH (int core, cores) {
+        bool ok = false;
+        const qint64 value =
+            readSysFile(QString("/sys/devices/system/cpu/cpu%1/%2").arg(core).arg(property)).toLongLong(&ok);
+
+        if (!ok) return QVector<int>();
+
+        values.append(value);
+    }
+
+    if (values.isEmpty()) return QVector<int>();
+
+    const qint64 maxValue = *std::max_element(values.begin(), values.end());
+
+    QVector<int> result;
+    for (int i = 0; i < cores.size(); i++) {
+        if (values[i] == maxValue) {
+            result.append(cores[i]);
+        }
+    }
+
+    return result.size() < cores.size() ? result : QVector<int>();
+}
+
+QVector<int> performanceCoresLinux(const QVector<int> &availableCores)
+{
+    QVector<int> result;
+
+    /**
+     * Intel hybrid CPUs register a separate PMU for every type of
+     * the cores, "cpu_core" lists the performance ones
+     */
+    const QString hybridCores = readSysFile("/sys/devices/cpu_core/cpus");
+    if (!hybridCores.isEmpty()) {
+        result = KisThreadAffinity::parseCpuList(hybridCores);
+    }
+
+    /**
+     * ARM kernels report the relative performance of the cores
+     * in cpu_capacity, the other CPUs may at least differ in the
+     * maximum frequency
+     */
+    if (result.isEmpty()) {
+        result = fastestCoresByProperty(availableCores, "cpu_capacity");
+    }
+
+    if (result.isEmpty()) {
+        result = fastestCoresByProperty(availableCores, "cpufreq/cpuinfo_max_freq");
+    }
+
+    result.erase(std::remove_if(result.begin(), result.end(),
+                                [&availableCores] (int core) { return !availableCores.contains(core); }),
+                 result.end());
+
+    return result.size() < availableCores.size() ? result : QVector<int>();
+}
+
+#endif /* Q_OS_LINUX */
+
+KisThreadAffinity::CpuTopology detectTopology()
+{
+    KisThreadAffinity::CpuTopology topology;
+
+#ifdef Q_OS_LINUX
+    topology.availableCores = availableCoresLinux();
+    topology.performanceCores = performanceCoresLinux(topology.availableCores);
+#endif
+
+    if (topology.availableCores.isEmpty()) {
+        const int numCores = qMax(1, QThread::idealThreadCount());
+        for (int i = 0; i < numCores; i++) {
+            topology.availableCores.append(i);
+        }
+    }
+
+    return topology;
+}
+
+}
+
+bool KisThreadAffinity::Options::operator==(const Options &rhs) const
+{
+    return pinThreads == rhs.pinThreads &&
+        keepGuiCoreFree == rhs.keepGuiCoreFree &&
+        preferPerformanceCores == rhs.preferPerformanceCores &&
+        allowedCores == rhs.allowedCores;
+}
+
+bool KisThreadAffinity::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+KisThreadAffinity::CpuTopology KisThreadAffinity::cpuTopology()
+{
+    static const CpuTopology topology = detectTopology();
+    return topology;
+}
+
+QVector<KisThreadAffinity::WorkerPlacement>
+KisThreadAffinity::placeWorkers(int numWorkers, const Options &options, const CpuTopology &topology)
+{
+    QVector<WorkerPlacement> result(qMax(0, numWorkers));
+
+    if (!options.pinThreads || result.isEmpty()) return result;
+
+    QVector<int> cores = topology.availableCores;
+
+    if (!options.allowedCores.isEmpty()) {
+        QVector<int> allowedCores;
+        std::copy_if(cores.begin(), cores.end(), std::back_inserter(allowedCores),
+                     [&options] (int core) { return options.allowedCores.contains(core); });
+
+        if (!allowedCores.isEmpty()) {
+            cores = allowedCores;
+        } else {
+            warnKrita << "KisThreadAffinity: none of the allowed cores is available, ignoring the list:"
+                      << formatCpuList(options.allowedCores);
+        }
+    }
+
+    if (cores.isEmpty()) return result;
+
+    std::sort(cores.begin(), cores.end());
+
+    const QVector<int> &performanceCores = topology.performanceCores;
+
+    if (options.preferPerformanceCores && !performanceCores.isEmpty()) {
+        std::stable_partition(cores.begin(), cores.end(),
+                              [&performanceCores] (int core) { return performanceCores.contains(core); });
+    }
+
+    /**
+     * The first core is left for the GUI thread. On a hybrid CPU it
+     * is a performance core, which is exactly what the GUI needs.
+     */
+    if (options.keepGuiCoreFree && cores.size() > 1) {
+        cores.removeFirst();
+    }
+
+    /**
+     * Two workers pinned to the same core would just fight for it,
+     * while the OS could have moved one of them to an idle core. So
+     * the workers that don't get a core of their own are not pinned,
+     * but are still restricted to the workers' cores, otherwise they
+     * would take the core reserved for the GUI thread.
+     */
+    const int numPinnedWorkers = qMin(result.size(), cores.size());
+
+    for (int i = 0; i < numPinnedWorkers; i++) {
+        WorkerPlacement &placement = result[i];
+        placement.core = cores[i];
+        placement.isPerformanceCore =
+            options.preferPerformanceCores && performanceCores.contains(placement.core);
+    }
+
+    if (cores.size() < topology.availableCores.size()) {
+        QVector<int> sortedCores = cores;
+        std::sort(sortedCores.begin(), sortedCores.end());
+
+        for (int i = numPinnedWorkers; i < result.size(); i++) {
+            result[i].allowedCores = sortedCores;
+        }
+    }
+
+    return result;
+}
+
+bool KisThreadAffinity::pinCurrentThread(int core)
+{
+    return setCurrentThreadAffinity({core});
+}
+
+bool KisThreadAffinity::setCurrentThreadAffinity(const QVector<int> &cores)
+{
+#ifdef Q_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    bool hasCores = false;
+
+    Q_FOREACH (int core, cores) {
+        if (core < 0 || core >= CPU_SETSIZE) continue;
+
+        CPU_SET(core, &set);
+        hasCores = true;
+    }
+
+    return hasCores && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    Q_UNUSED(cores);
+    return false;
+#endif
+}
+
+QVector<int> KisThreadAffinity::parseCpuList(const QString &list)
+{
+    QSet<int> cores;
+
+    Q_FOREACH (const QString &entry, list.split(',')) {
+        if (entry.trimmed().isEmpty()) continue;
+
+        const QStringList range = entry.trimmed().split('-');
+
+        bool firstOk = false;
+        bool lastOk = false;
+
+        const int first = range.first().trimmed().toInt(&firstOk);
+        const int last = range.size() == 2 ? range.last().trimmed().toInt(&lastOk) : first;
+
+        if (!firstOk || (range.size() == 2 && !lastOk) || range.size() > 2 ||
+            first < 0 || last < first || last > MAX_CORE_INDEX) {
+
+            continue;
+        }
+
+        for (int core = first; core <= last; core++) {
+            cores.insert(core);
+        }
+    }
+
+    QVector<int> result = cores.values().toVector();
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+QString KisThreadAffinity::formatCpuList(const QVector<int> &cores)
+{
+    QVector<int> sortedCores = cores;
+    std::sort(sortedCores.begin(), sortedCores.end());
+    sortedCores.erase(std::unique(sortedCores.begin(), sortedCores.end()), sortedCores.end());
+
+    QStringList entries;
+
+    for (int i = 0; i < sortedCores.size();) {
+        int j = i;
+        while (j + 1 < sortedCores.size() && sortedCores[j + 1] == sortedCores[j] + 1) {
+            j++;
+        }
+
+        entries << (i == j ?
+                    QString::number(sortedCores[i]) :
+                    QString("%1-%2").arg(sortedCores[i]).arg(sortedCores[j]));
+        i = j + 1;
+    }
+
+    return entries.join(',');
+}
@@ -0,0 +1,123 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTHREADAFFINITY_H
+#define KISTHREADAFFINITY_H
+
+#include "kritaimage_export.h"
+
+#include <QString>
+#include <QVector>
+
+/**
+ * Decides on which CPU cores the worker threads of the updater
+ * context should run.
+ *
+ * By default the workers are not pinned and the OS is free to move
+ * them between the cores. When pinning is enabled (see
+ * KisImageConfig::pinUpdateThreads()), every worker is bound to a
+ * core of its own, which keeps the tiles in the caches of that core.
+ * If there are more workers than cores, the extra workers are not
+ * pinned.
+ *
+ * The GUI thread itself is never pinned, otherwise all the threads
+ * it creates would inherit its affinity. Instead, one core is
+ * reserved for it: no worker is pinned to that core and the workers
+ * that don't get a core of their own may run on any of the other
+ * worker cores only. So the OS always has an idle core to run the
+ * GUI thread on.
+ *
+ * On hybrid CPUs (e.g. Intel Alder Lake or ARM big.LITTLE) the
+ * workers bound to the performance cores are marked as such, and
+ * KisUpdaterContext sends the stroke jobs to them (the merge jobs
+ * can still be executed by any worker).
+ *
+ * The pinning is implemented on Linux only, on the other platforms
+ * the placement is computed, but not applied.
+ */
+class KRITAIMAGE_EXPORT KisThreadAffinity
+{
+public:
+    struct CpuTopology {
+        /// the cores the process is allowed to run on
+        QVector<int> availableCores;
+
+        /// the performance cores of a hybrid CPU, empty if the CPU is not hybrid
+        QVector<int> performanceCores;
+    };
+
+    struct Options {
+        bool pinThreads = false;
+        bool keepGuiCoreFree = true;
+        bool preferPerformanceCores = true;
+
+        /// the cores the user allowed for the workers, empty means all
+        QVector<int> allowedCores;
+
+        bool operator==(const Options &rhs) const;
+    };
+
+    struct WorkerPlacement {
+        /// the core the worker is pinned to, -1 if not pinned
+        int core = -1;
+        bool isPerformanceCore = false;
+
+        /// the cores an unpinned worker may run on, empty means any core
+        QVector<int> allowedCores;
+
+        bool operator==(const WorkerPlacement &rhs) const {
+            return core == rhs.core &&
+                isPerformanceCore == rhs.isPerformanceCore &&
+                allowedCores == rhs.allowedCores;
+        }
+    };
+
+public:
+    /**
+     * Returns true if the threads can be pinned on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * Returns the cores available to the process. The topology
+     * is detected only once and then cached.
+     */
+    static CpuTopology cpuTopology();
+
+    /**
+     * Distributes \p numWorkers workers over the cores of \p topology.
+     * Returns a placement for every worker, the workers bound to the
+     * performance cores go first. Every core gets at most one worker,
+     * the workers left without a core are not pinned, but are still
+     * kept off the core reserved for the GUI thread and off the cores
+     * the user didn't allow.
+     */
+    static QVector<WorkerPlacement> placeWorkers(int numWorkers,
+                                                 const Options &options,
+                                                 const CpuTopology &topology);
+
+    /**
+     * Pins the calling thread to \p core. Returns false if the platform
+     * doesn't support pinning or the core is not available.
+     */
+    static bool pinCurrentThread(int core);
+
+    /**
+     * Restricts the calling thread to the set of \p cores. Returns
+     * false if the platform doesn't support affinity or none of the
+     * cores is available.
+     */
+    static bool setCurrentThreadAffinity(const QVector<int> &cores);
+
+    /**
+     * Parses the list of cores in Linux's "cpulist" format,
+     * e.g. "0-3,8,10-11". Invalid entries are skipped.
+     */
+    static QVector<int> parseCpuList(const QString &list);
+    static QString formatCpuList(const QVector<int> &cores);
+};
+
+#endif // KISTHREADAFFINITY_H
@@ -0,0 +1,402 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateTracer.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "kis_assert.h"
+#include "kis_debug.h"
+#include "kis_image_config.h"
+
+Q_GLOBAL_STATIC(KisUpdateTracer, s_instance)
+
+namespace {
+QAtomicInt s_tracingEnabled(false);
+QAtomicInt s_nextTracerId(0);
+QAtomicInt s_nextThreadId(0);
+
+/**
+ * The id of the thread is assigned on the first trace event and
+ * is never reused, unlike the native thread ids, which the OS may
+ * hand out again after the thread has finished.
+ */
+int currentThreadId()
+{
+    static thread_local const int s_threadId = s_nextThreadId.fetchAndAddOrdered(1);
+    return s_threadId;
+}
+
+struct ThreadBuffer
+{
+    /**
+     * The lock is taken only by the owning thread and the readers
+     * of the tracer, so the writers never wait for each other
+     */
+    QMutex lock;
+
+    QVector<KisUpdateTracer::Event> events;
+    int nextEvent = 0;
+    int capacity = 1;
+
+    int threadIndex = -1;
+    QString threadName;
+};
+
+/**
+ * The buffer the current thread has used last time, it lets the
+ * writer skip the lookup in the tracer in the common case
+ */
+struct CachedThreadBuffer
+{
+    int tracerId = -1;
+    ThreadBuffer *buffer = nullptr;
+};
+
+thread_local CachedThreadBuffer s_cachedThreadBuffer;
+}
+
+struct KisUpdateTracer::Private
+{
+    const int id = s_nextTracerId.fetchAndAddOrdered(1);
+
+    /**
+     * Guards the list of the thread buffers and the capacity,
+     * it is taken by the writer only on the first event of
+     * the thread
+     */
+    mutable QMutex lock;
+
+    QElapsedTimer timer;
+
+    int capacity = 1;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+    QHash<int, int> threadIndexes;
+
+    ThreadBuffer* currentThreadBuffer() {
+        CachedThreadBuffer &cache = s_cachedThreadBuffer;
+        if (cache.tracerId == id) return cache.buffer;
+
+        const int threadId = currentThreadId();
+
+        QMutexLocker l(&lock);
+
+        auto it = threadIndexes.constFind(threadId);
+        if (it == threadIndexes.constEnd()) {
+            std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer);
+            buffer->capacity = capacity;
+            buffer->threadIndex = int(threadBuffers.size());
+            buffer->threadName = currentThreadName(buffer->threadIndex);
+
+            it = threadIndexes.insert(threadId, int(threadBuffers.size()));
+            threadBuffers.push_back(std::move(buffer));
+        }
+
+        cache.tracerId = id;
+        cache.buffer = threadBuffers[*it].get();
+
+        return cache.buffer;
+    }
+
+    static QString currentThreadName(int threadIndex) {
+        QString name = QThread::currentThread()->objectName();
+        if (name.isEmpty()) {
+            name = QCoreApplication::instance() &&
+                QThread::currentThread() == QCoreApplication::instance()->thread() ?
+                    QString("GUI Thread") :
+                    QString("Thread %1").arg(threadIndex);
+        }
+        return name;
+    }
+};
+
+KisUpdateTracer::KisUpdateTracer()
+    : m_d(new Private)
+{
+    m_d->timer.start();
+
+    KisImageConfig config(true);
+    setCapacity(config.updateTracingBufferSize());
+    setEnabled(config.enableUpdateTracing());
+}
+
+KisUpdateTracer::~KisUpdateTracer()
+{
+}
+
+KisUpdateTracer* KisUpdateTracer::instance()
+{
+    return s_instance;
+}
+
+bool KisUpdateTracer::isEnabled()
+{
+    return s_tracingEnabled.loadAcquire();
+}
+
+void KisUpdateTracer::setEnabled(bool value)
+{
+    s_tracingEnabled.storeRelease(value);
+}
+
+void KisUpdateTracer::setCapacity(int numEvents)
+{
+    KIS_SAFE_ASSERT_RECOVER(numEvents > 0) {
+        numEvents = 1;
+    }
+
+    QMutexLocker l(&m_d->lock);
+
+    if (numEvents == m_d->capacity) return;
+    m_d->capacity = numEvents;
+
+    for (auto it = m_d->threadBuffers.begin(); it != m_d->threadBuffers.end(); ++it) {
+        ThreadBuffer *buffer = it->get();
+
+        QMutexLocker bufferLocker(&buffer->lock);
+        buffer->events.clear();
+        buffer->nextEvent = 0;
+        buffer->capacity = numEvents;
+    }
+}
+
+int KisUpdateTracer::capacity() const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->capacity;
+}
+
+void KisUpdateTracer::clear()
+{
+    QMutexLocker l(&m_d->lock);
+
+    for (auto it = m_d->threadBuffers.begin(); it != m_d->threadBuffers.end(); ++it) {
+        ThreadBuffer *buffer = it->get();
+
+        QMutexLocker bufferLocker(&buffer->lock);
+        buffer->events.clear();
+        buffer->nextEvent = 0;
+    }
+}
+
+qint64 KisUpdateTracer::currentTime() const
+{
+    return m_d->timer.nsecsElapsed();
+}
+
+void KisUpdateTracer::addEvent(Category category, const QString &name,
+                               qint64 startTime, qint64 endTime,
+                               const QRect &rect)
+{
+    ThreadBuffer *buffer = m_d->currentThreadBuffer();
+
+    Event newEvent;
+    newEvent.category = category;
+    newEvent.name = name;
+    newEvent.rect = rect;
+    newEvent.startTime = startTime;
+    newEvent.endTime = endTime;
+    newEvent.threadIndex = buffer->threadIndex;
+
+    QMutexLocker l(&buffer->lock);
+
+    /**
+     * The ring is grown lazily, so the threads that record only
+     * a few events don't allocate the full capacity
+     */
+    if (buffer->events.size() < buffer->capacity) {
+        buffer->events.append(newEvent);
+    } else {
+        buffer->events[buffer->nextEvent] = newEvent;
+    }
+
+    buffer->nextEvent = (buffer->nextEvent + 1) % buffer->capacity;
+}
+
+QVector<KisUpdateTracer::Event> KisUpdateTracer::events() const
+{
+    QVector<Event> result;
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        for (auto it = m_d->threadBuffers.begin(); it != m_d->threadBuffers.end(); ++it) {
+            ThreadBuffer *buffer = it->get();
+
+            QMutexLocker bufferLocker(&buffer->lock);
+
+            const int numEvents = buffer->events.size();
+            const int firstEvent = numEvents < buffer->capacity ? 0 : buffer->nextEvent;
+
+            for (int i = 0; i < numEvents; i++) {
+                result.append(buffer->events[(firstEvent + i) % numEvents]);
+            }
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+                     [] (const Event &lhs, const Event &rhs) {
+                         return lhs.endTime < rhs.endTime;
+                     });
+
+    return result;
+}
+
+QString KisUpdateTracer::threadName(int threadIndex) const
+{
+    QMutexLocker l(&m_d->lock);
+
+    return threadIndex >= 0 && threadIndex < int(m_d->threadBuffers.size()) ?
+        m_d->threadBuffers[threadIndex]->threadName : QString();
+}
+
+QString KisUpdateTracer::categoryName(Category category)
+{
+    switch (category) {
+    case StrokeJob:
+        return "stroke";
+    case MergeJob:
+        return "merge";
+    case SpontaneousJob:
+        return "spontaneous";
+    case LodSync:
+        return "lod-sync";
+    case TileSwapIn:
+        return "swap-in";
+    case TextureUpload:
+        return "texture-upload";
+    }
+
+    return "unknown";
+}
+
+QByteArray KisUpdateTracer::toChromeTraceJson() const
+{
+    const QVector<Event> events = this->events();
+
+    QVector<QString> threadNames;
+    {
+        QMutexLocker l(&m_d->lock);
+        for (auto it = m_d->threadBuffers.begin(); it != m_d->threadBuffers.end(); ++it) {
+            threadNames.append((*it)->threadName);
+        }
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+
+    /**
+     * The metadata events assign the human-readable
+     * names to the thread tracks of the viewer
+     */
+    for (int i = 0; i < threadNames.size(); i++) {
+        QJsonObject nameEvent;
+        nameEvent["name"] = "thread_name";
+        nameEvent["ph"] = "M";
+        nameEvent["pid"] = pid;
+        nameEvent["tid"] = i;
+        nameEvent["args"] = QJsonObject({{"name", threadNames[i]}});
+        traceEvents.append(nameEvent);
+    }
+
+    Q_FOREACH (const Event &event, events) {
+        const QString category = categoryName(event.category);
+
+        QJsonObject object;
+        object["name"] = !event.name.isEmpty() ? event.name : category;
+        object["cat"] = category;
+        object["ph"] = "X";
+        object["pid"] = pid;
+        object["tid"] = event.threadIndex;
+
+        // Chrome expects the time in microseconds
+        object["ts"] = double(event.startTime) / 1000.0;
+        object["dur"] = double(event.endTime - event.startTime) / 1000.0;
+
+        if (!event.rect.isEmpty()) {
+            object["args"] =
+                QJsonObject({{"x", event.rect.x()},
+                             {"y", event.rect.y()},
+                             {"width", event.rect.width()},
+                             {"height", event.rect.height()}});
+        }
+
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool KisUpdateTracer::saveChromeTrace(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisUpdateTracer: failed to open file for writing:" << fileName;
+        return false;
+    }
+
+    const QByteArray data = toChromeTraceJson();
+    return file.write(data) == data.size();
+}
+
+
+KisUpdateTraceScope::KisUpdateTraceScope(KisUpdateTracer::Category category, const QRect &rect)
+    : m_category(category),
+      m_rect(rect)
+{
+    if (KisUpdateTracer::isEnabled()) {
+        KisUpdateTracer *tracer = KisUpdateTracer::instance();
+        if (tracer) {
+            m_startTime = tracer->currentTime();
+        }
+    }
+}
+
+KisUpdateTraceScope::KisUpdateTraceScope(KisUpdateTracer::Category category, const QString &name, const QRect &rect)
+    : KisUpdateTraceScope(category, rect)
+{
+    m_name = name;
+}
+
+KisUpdateTraceScope::~KisUpdateTraceScope()
+{
+    if (!isActive()) return;
+
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+    if (!tracer) return;
+
+    tracer->addEvent(m_category, m_name, m_startTime, tracer->currentTime(), m_rect);
+}
+
+void KisUpdateTraceScope::setName(const QString &name)
+{
+    m_name = name;
+}
+
+void KisUpdateTraceScope::setRect(const QRect &rect)
+{
+    m_rect = rect;
+}
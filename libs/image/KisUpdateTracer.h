@@ -0,0 +1,143 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATETRACER_H
+#define KISUPDATETRACER_H
+
+#include "kritaimage_export.h"
+
+#include <QScopedPointer>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+class QByteArray;
+
+/**
+ * Records the timings of the jobs of the update pipeline: stroke,
+ * merge and spontaneous jobs, LoD synchronization, swapping in the
+ * tiles and uploading the textures to the canvas. Unlike
+ * KisUpdateTimeMonitor, which prints only the aggregated numbers,
+ * the tracer keeps every separate event with the thread it was
+ * executed on, so the stutters can be analyzed afterwards.
+ *
+ * Every thread records its events into its own ring buffer of a
+ * fixed size (see KisImageConfig::updateTracingBufferSize()), so
+ * the trace points of different threads never wait for each other
+ * and the tracer can be left enabled for a long time. The content of the buffer can be
+ * saved in Chrome Trace Event format, which can be opened with
+ * chrome://tracing or ui.perfetto.dev.
+ *
+ * The tracer is disabled by default and the cost of a disabled
+ * trace point is a single atomic read.
+ */
+class KRITAIMAGE_EXPORT KisUpdateTracer
+{
+public:
+    enum Category {
+        StrokeJob = 0,
+        MergeJob,
+        SpontaneousJob,
+        LodSync,
+        TileSwapIn,
+        TextureUpload
+    };
+
+    struct Event {
+        Category category = StrokeJob;
+        QString name;
+        QRect rect;
+        qint64 startTime = 0; // nsec
+        qint64 endTime = 0; // nsec
+        int threadIndex = -1; // see threadName(), never reused by another thread
+    };
+
+public:
+    KisUpdateTracer();
+    ~KisUpdateTracer();
+
+    static KisUpdateTracer* instance();
+
+    /**
+     * A fast check, whether the trace points should record anything
+     */
+    static bool isEnabled();
+
+    void setEnabled(bool value);
+
+    /**
+     * Sets the number of events kept for every thread
+     */
+    void setCapacity(int numEvents);
+    int capacity() const;
+
+    void clear();
+
+    /**
+     * The current time of the tracer's clock in nanoseconds
+     */
+    qint64 currentTime() const;
+
+    void addEvent(Category category, const QString &name,
+                  qint64 startTime, qint64 endTime,
+                  const QRect &rect = QRect());
+
+    /**
+     * The events stored in the ring buffers of all the threads,
+     * ordered by the time of their completion
+     */
+    QVector<Event> events() const;
+
+    QString threadName(int threadIndex) const;
+
+    QByteArray toChromeTraceJson() const;
+    bool saveChromeTrace(const QString &fileName) const;
+
+    static QString categoryName(Category category);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+/**
+ * Records a single event of the tracer, which lasts from the
+ * construction till the destruction of the scope object.
+ *
+ * The name of the event may be expensive to generate, so it
+ * should be set only when the scope is active:
+ *
+ * \code{.cpp}
+ * KisUpdateTraceScope scope(KisUpdateTracer::StrokeJob);
+ * if (scope.isActive()) {
+ *     scope.setName(job->debugName());
+ * }
+ * \endcode
+ */
+class KRITAIMAGE_EXPORT KisUpdateTraceScope
+{
+public:
+    KisUpdateTraceScope(KisUpdateTracer::Category category, const QRect &rect = QRect());
+    KisUpdateTraceScope(KisUpdateTracer::Category category, const QString &name, const QRect &rect = QRect());
+    ~KisUpdateTraceScope();
+
+    inline bool isActive() const {
+        return m_startTime >= 0;
+    }
+
+    void setName(const QString &name);
+    void setRect(const QRect &rect);
+
+private:
+    Q_DISABLE_COPY(KisUpdateTraceScope)
+
+    KisUpdateTracer::Category m_category;
+    QString m_name;
+    QRect m_rect;
+    qint64 m_startTime = -1;
+};
+
+#endif // KISUPDATETRACER_H
@@ -0,0 +1,285 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateWalkersIndex.h"
+
+#include <QHash>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+#include "kis_assert.h"
+#include "kis_node.h"
+
+
+namespace {
+
+struct CellKey {
+    const KisNode *node = 0;
+    int levelOfDetail = 0;
+    qint32 col = 0;
+    qint32 row = 0;
+
+    bool operator==(const CellKey &rhs) const {
+        return node == rhs.node &&
+            levelOfDetail == rhs.levelOfDetail &&
+            col == rhs.col &&
+            row == rhs.row;
+    }
+};
+
+inline uint qHash(const CellKey &key, uint seed = 0)
+{
+    return ::qHash(key.node, seed) ^
+        ::qHash(key.levelOfDetail, seed) ^
+        ::qHash((qint64(key.col) << 32) | quint32(key.row), seed);
+}
+
+struct CellItem {
+    KisBaseRectsWalkerSP walker;
+    quint64 sequenceNumber = 0;
+};
+
+struct WalkerLocation {
+    CellKey key;
+    quint64 sequenceNumber = 0;
+};
+
+inline bool itemIsOlder(const CellItem &item, quint64 sequenceNumber)
+{
+    return item.sequenceNumber < sequenceNumber;
+}
+
+inline qint32 floorDiv(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+}
+
+struct KisUpdateWalkersIndex::Private
+{
+    QSize cellSize = QSize(512, 512);
+
+    QHash<CellKey, QVector<CellItem>> cells;
+    QHash<const KisBaseRectsWalker*, WalkerLocation> walkerCells;
+
+    quint64 nextSequenceNumber = 0;
+
+    CellKey cellForWalker(KisBaseRectsWalkerSP walker) const {
+        const QRect rc = walker->requestedRect();
+
+        CellKey key;
+        key.node = walker->startNode().data();
+        key.levelOfDetail = walker->levelOfDetail();
+        key.col = floorDiv(rc.left(), cellSize.width());
+        key.row = floorDiv(rc.top(), cellSize.height());
+        return key;
+    }
+
+    void insertItem(const CellKey &key, const CellItem &item) {
+        QVector<CellItem> &cell = cells[key];
+
+        /**
+         * The walkers usually come in order, so the search
+         * almost always finishes at the first iteration
+         */
+        auto it = std::upper_bound(cell.begin(), cell.end(), item.sequenceNumber,
+                                   [] (quint64 sequenceNumber, const CellItem &item) {
+                                       return sequenceNumber < item.sequenceNumber;
+                                   });
+        cell.insert(it, item);
+
+        WalkerLocation location;
+        location.key = key;
+        location.sequenceNumber = item.sequenceNumber;
+        walkerCells.insert(item.walker.data(), location);
+    }
+
+    CellItem takeItem(const KisBaseRectsWalker *walker) {
+        CellItem result;
+
+        auto keyIt = walkerCells.find(walker);
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(keyIt != walkerCells.end(), result);
+
+        auto cellIt = cells.find(keyIt->key);
+        KIS_SAFE_ASSERT_RECOVER(cellIt != cells.end()) {
+            walkerCells.erase(keyIt);
+            return result;
+        }
+
+        /**
+         * The cell is sorted by the sequence number, so even dense
+         * cells are searched in logarithmic time
+         */
+        QVector<CellItem> &cell = *cellIt;
+        auto it = std::lower_bound(cell.begin(), cell.end(),
+                                   keyIt->sequenceNumber, itemIsOlder);
+
+        KIS_SAFE_ASSERT_RECOVER_NOOP(it != cell.end() && it->walker.data() == walker);
+
+        if (it != cell.end() && it->walker.data() == walker) {
+            result = *it;
+            cell.erase(it);
+        }
+
+        if (cell.isEmpty()) {
+            cells.erase(cellIt);
+        }
+
+        walkerCells.erase(keyIt);
+
+        return result;
+    }
+};
+
+KisUpdateWalkersIndex::KisUpdateWalkersIndex()
+    : m_d(new Private)
+{
+}
+
+KisUpdateWalkersIndex::~KisUpdateWalkersIndex()
+{
+}
+
+void KisUpdateWalkersIndex::setCellSize(const QSize &size)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!size.isEmpty());
+
+    if (size == m_d->cellSize) return;
+
+    QVector<CellItem> items;
+    for (auto it = m_d->cells.begin(); it != m_d->cells.end(); ++it) {
+        items += *it;
+    }
+
+    m_d->cells.clear();
+    m_d->walkerCells.clear();
+    m_d->cellSize = size;
+
+    Q_FOREACH (const CellItem &item, items) {
+        m_d->insertItem(m_d->cellForWalker(item.walker), item);
+    }
+}
+
+QSize KisUpdateWalkersIndex::cellSize() const
+{
+    return m_d->cellSize;
+}
+
+void KisUpdateWalkersIndex::addWalker(KisBaseRectsWalkerSP walker)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->walkerCells.contains(walker.data()));
+
+    CellItem item;
+    item.walker = walker;
+    item.sequenceNumber = m_d->nextSequenceNumber++;
+
+    m_d->insertItem(m_d->cellForWalker(walker), item);
+}
+
+void KisUpdateWalkersIndex::removeWalker(KisBaseRectsWalkerSP walker)
+{
+    m_d->takeItem(walker.data());
+}
+
+void KisUpdateWalkersIndex::updateWalker(KisBaseRectsWalkerSP walker)
+{
+    const CellKey newKey = m_d->cellForWalker(walker);
+
+    auto keyIt = m_d->walkerCells.constFind(walker.data());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(keyIt != m_d->walkerCells.constEnd());
+
+    if (keyIt->key == newKey) return;
+
+    const CellItem item = m_d->takeItem(walker.data());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(item.walker);
+
+    m_d->insertItem(newKey, item);
+}
+
+QVector<KisBaseRectsWalkerSP> KisUpdateWalkersIndex::mergeCandidates(KisNodeSP node, int levelOfDetail, const QRect &rc) const
+{
+    QVector<KisBaseRectsWalkerSP> result;
+
+    const int cellWidth = m_d->cellSize.width();
+    const int cellHeight = m_d->cellSize.height();
+
+    if (rc.isEmpty() || rc.width() > cellWidth || rc.height() > cellHeight) {
+        return result;
+    }
+
+    /**
+     * The top-left corner of a walker that can be united with \p rc
+     * lies in this area, otherwise the united rect would be too big
+     */
+    const qint32 firstCol = floorDiv(rc.right() - cellWidth + 1, cellWidth);
+    const qint32 lastCol = floorDiv(rc.left() + cellWidth - 1, cellWidth);
+    const qint32 firstRow = floorDiv(rc.bottom() - cellHeight + 1, cellHeight);
+    const qint32 lastRow = floorDiv(rc.top() + cellHeight - 1, cellHeight);
+
+    struct CellCursor {
+        QVector<CellItem>::const_iterator it;
+        QVector<CellItem>::const_iterator end;
+    };
+
+    QVarLengthArray<CellCursor, 9> cursors;
+
+    CellKey key;
+    key.node = node.data();
+    key.levelOfDetail = levelOfDetail;
+
+    for (key.row = firstRow; key.row <= lastRow; key.row++) {
+        for (key.col = firstCol; key.col <= lastCol; key.col++) {
+            auto it = m_d->cells.constFind(key);
+            if (it != m_d->cells.constEnd()) {
+                cursors.append({it->constBegin(), it->constEnd()});
+            }
+        }
+    }
+
+    /**
+     * Every cell is already sorted by the sequence number, so just
+     * merge them. The walkers whose union with \p rc is too big are
+     * skipped right away, so the caller doesn't have to check the
+     * rest of a dense cell.
+     */
+    while (true) {
+        CellCursor *oldest = 0;
+
+        for (CellCursor &cursor : cursors) {
+            if (cursor.it == cursor.end) continue;
+
+            if (!oldest || cursor.it->sequenceNumber < oldest->it->sequenceNumber) {
+                oldest = &cursor;
+            }
+        }
+
+        if (!oldest) break;
+
+        const KisBaseRectsWalkerSP &walker = oldest->it->walker;
+        const QRect unitedRect = rc | walker->requestedRect();
+
+        if (unitedRect.width() <= cellWidth && unitedRect.height() <= cellHeight) {
+            result.append(walker);
+        }
+
+        ++oldest->it;
+    }
+
+    return result;
+}
+
+int KisUpdateWalkersIndex::size() const
+{
+    return m_d->walkerCells.size();
+}
+
+void KisUpdateWalkersIndex::clear()
+{
+    m_d->cells.clear();
+    m_d->walkerCells.clear();
+}
@@ -0,0 +1,73 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATEWALKERSINDEX_H
+#define KISUPDATEWALKERSINDEX_H
+
+#include "kritaimage_export.h"
+
+#include <QScopedPointer>
+#include <QSize>
+#include <QVector>
+
+#include "kis_types.h"
+#include "kis_base_rects_walker.h"
+
+/**
+ * A spatial index of the walkers waiting in KisSimpleUpdateQueue.
+ *
+ * KisSimpleUpdateQueue never merges two walkers if the united rect
+ * becomes bigger than the update patch. Therefore, if the cells of
+ * the index have the size of the patch and every walker is stored in
+ * the cell of the top-left corner of its requested rect, all the
+ * merge candidates for a rect lie in a 3x3 block of cells around it.
+ * The cells are separate for every start node and level of detail,
+ * so the lookup doesn't depend on the total number of the pending
+ * walkers.
+ *
+ * The index doesn't own the walkers, the queue should add and remove
+ * them in sync with its list of updates. If the requested rect of a
+ * walker is changed, updateWalker() should be called.
+ */
+class KRITAIMAGE_EXPORT KisUpdateWalkersIndex
+{
+public:
+    KisUpdateWalkersIndex();
+    ~KisUpdateWalkersIndex();
+
+    /**
+     * Sets the size of the cell, it should be equal to the size of
+     * the update patch. The walkers already present are redistributed.
+     */
+    void setCellSize(const QSize &size);
+    QSize cellSize() const;
+
+    void addWalker(KisBaseRectsWalkerSP walker);
+    void removeWalker(KisBaseRectsWalkerSP walker);
+
+    /**
+     * Moves the walker to the cell corresponding to its current
+     * requested rect
+     */
+    void updateWalker(KisBaseRectsWalkerSP walker);
+
+    /**
+     * Returns the walkers started from \p node on \p levelOfDetail,
+     * which may be united with \p rc without exceeding the cell size.
+     * The walkers are ordered by the time of their addition, the
+     * oldest first.
+     */
+    QVector<KisBaseRectsWalkerSP> mergeCandidates(KisNodeSP node, int levelOfDetail, const QRect &rc) const;
+
+    int size() const;
+    void clear();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISUPDATEWALKERSINDEX_H
@@ -0,0 +1,260 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisWorkStealingExecutor.h"
+
+#include <QRunnable>
+#include <QThread>
+
+#include "kis_assert.h"
+#include "kis_debug.h"
+
+
+struct KisWorkStealingExecutor::Worker
+{
+    QMutex lock;
+    std::deque<QRunnable*> tasks;
+    QThread *thread = nullptr;
+    KisThreadAffinity::WorkerPlacement placement;
+};
+
+namespace {
+struct CurrentWorker {
+    const KisWorkStealingExecutor *executor = nullptr;
+    int index = -1;
+};
+
+thread_local CurrentWorker s_currentWorker;
+}
+
+
+KisWorkStealingExecutor::KisWorkStealingExecutor(int threadCount)
+{
+    startWorkers(threadCount, QVector<KisThreadAffinity::WorkerPlacement>());
+}
+
+KisWorkStealingExecutor::~KisWorkStealingExecutor()
+{
+    waitForDone();
+    stopWorkers();
+}
+
+void KisWorkStealingExecutor::start(QRunnable *runnable, bool preferPerformanceWorker)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_workers.isEmpty());
+
+    m_numUnfinishedTasks.fetch_add(1);
+
+    int queueIndex = currentWorkerIndex();
+
+    if (preferPerformanceWorker && !m_performanceWorkers.isEmpty() &&
+        (queueIndex < 0 || !m_workers[queueIndex]->placement.isPerformanceCore)) {
+
+        queueIndex = m_performanceWorkers[m_nextPerformanceQueue.fetch_add(1) %
+                                          unsigned(m_performanceWorkers.size())];
+    }
+
+    if (queueIndex < 0) {
+        queueIndex = m_nextQueue.fetch_add(1) % unsigned(m_workers.size());
+    }
+
+    /**
+     * The counter is incremented before the task becomes visible,
+     * so it never goes negative. The worst thing that can happen
+     * is that some worker will make an extra pass over the queues.
+     */
+    m_numQueuedTasks.fetch_add(1);
+
+    Worker *worker = m_workers[queueIndex];
+    {
+        QMutexLocker l(&worker->lock);
+        worker->tasks.push_back(runnable);
+    }
+
+    if (m_numSleepingWorkers.load() > 0) {
+        QMutexLocker l(&m_sleepMutex);
+        m_sleepCondition.wakeOne();
+    }
+}
+
+void KisWorkStealingExecutor::waitForDone()
+{
+    QMutexLocker l(&m_doneMutex);
+
+    while (m_numUnfinishedTasks.load() > 0) {
+        m_doneCondition.wait(&m_doneMutex);
+    }
+}
+
+void KisWorkStealingExecutor::setThreadCount(int value, const QVector<KisThreadAffinity::WorkerPlacement> &placement)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!m_numUnfinishedTasks.load());
+
+    QVector<KisThreadAffinity::WorkerPlacement> newPlacement = placement;
+    newPlacement.resize(value);
+
+    if (value == m_workers.size() && newPlacement == workerPlacement()) return;
+
+    stopWorkers();
+    startWorkers(value, newPlacement);
+}
+
+int KisWorkStealingExecutor::threadCount() const
+{
+    return m_workers.size();
+}
+
+QVector<KisThreadAffinity::WorkerPlacement> KisWorkStealingExecutor::workerPlacement() const
+{
+    QVector<KisThreadAffinity::WorkerPlacement> result;
+    result.reserve(m_workers.size());
+
+    Q_FOREACH (Worker *worker, m_workers) {
+        result.append(worker->placement);
+    }
+
+    return result;
+}
+
+int KisWorkStealingExecutor::currentWorkerIndex() const
+{
+    return s_currentWorker.executor == this ? s_currentWorker.index : -1;
+}
+
+void KisWorkStealingExecutor::startWorkers(int threadCount, const QVector<KisThreadAffinity::WorkerPlacement> &placement)
+{
+    m_quit = false;
+
+    m_workers.resize(threadCount);
+    m_performanceWorkers.clear();
+
+    for (int i = 0; i < m_workers.size(); i++) {
+        m_workers[i] = new Worker();
+        m_workers[i]->placement = placement.value(i);
+
+        if (m_workers[i]->placement.isPerformanceCore) {
+            m_performanceWorkers.append(i);
+        }
+    }
+
+    for (int i = 0; i < m_workers.size(); i++) {
+        m_workers[i]->thread = QThread::create([this, i] () { workerLoop(i); });
+        m_workers[i]->thread->setObjectName(QString("KisUpdaterWorker%1").arg(i));
+        m_workers[i]->thread->start();
+    }
+}
+
+void KisWorkStealingExecutor::stopWorkers()
+{
+    {
+        QMutexLocker l(&m_sleepMutex);
+        m_quit = true;
+        m_sleepCondition.wakeAll();
+    }
+
+    Q_FOREACH (Worker *worker, m_workers) {
+        worker->thread->wait();
+        delete worker->thread;
+
+        KIS_SAFE_ASSERT_RECOVER_NOOP(worker->tasks.empty());
+        delete worker;
+    }
+
+    m_workers.clear();
+    m_performanceWorkers.clear();
+}
+
+QRunnable* KisWorkStealingExecutor::takeTask(int workerIndex)
+{
+    QRunnable *task = nullptr;
+
+    {
+        Worker *worker = m_workers[workerIndex];
+        QMutexLocker l(&worker->lock);
+
+        if (!worker->tasks.empty()) {
+            task = worker->tasks.back();
+            worker->tasks.pop_back();
+        }
+    }
+
+    for (int i = 1; !task && i < m_workers.size(); i++) {
+        Worker *victim = m_workers[(workerIndex + i) % m_workers.size()];
+        QMutexLocker l(&victim->lock);
+
+        if (!victim->tasks.empty()) {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+        }
+    }
+
+    if (task) {
+        m_numQueuedTasks.fetch_sub(1);
+    }
+
+    return task;
+}
+
+void KisWorkStealingExecutor::taskFinished()
+{
+    if (m_numUnfinishedTasks.fetch_sub(1) == 1) {
+        QMutexLocker l(&m_doneMutex);
+        m_doneCondition.wakeAll();
+    }
+}
+
+void KisWorkStealingExecutor::workerLoop(int workerIndex)
+{
+    s_currentWorker.executor = this;
+    s_currentWorker.index = workerIndex;
+
+    const KisThreadAffinity::WorkerPlacement &placement = m_workers[workerIndex]->placement;
+
+    if (placement.core >= 0) {
+        if (!KisThreadAffinity::pinCurrentThread(placement.core)) {
+            warnKrita << "KisWorkStealingExecutor: failed to pin worker" << workerIndex << "to core" << placement.core;
+        }
+    } else if (!placement.allowedCores.isEmpty()) {
+        if (!KisThreadAffinity::setCurrentThreadAffinity(placement.allowedCores)) {
+            warnKrita << "KisWorkStealingExecutor: failed to restrict worker" << workerIndex << "to cores"
+                      << KisThreadAffinity::formatCpuList(placement.allowedCores);
+        }
+    }
+
+    while (1) {
+        QRunnable *task = takeTask(workerIndex);
+
+        if (task) {
+            const bool autoDelete = task->autoDelete();
+            task->run();
+            if (autoDelete) {
+                delete task;
+            }
+
+            taskFinished();
+            continue;
+        }
+
+        QMutexLocker l(&m_sleepMutex);
+
+        /**
+         * The sleeping counter must be incremented before checking
+         * the queued tasks counter, start() checks them in reverse
+         * order, so the wakeup will never be missed
+         */
+        m_numSleepingWorkers.fetch_add(1);
+
+        while (!m_numQueuedTasks.load() && !m_quit) {
+            m_sleepCondition.wait(&m_sleepMutex);
+        }
+
+        m_numSleepingWorkers.fetch_sub(1);
+
+        if (m_quit && !m_numQueuedTasks.load()) break;
+    }
+
+    s_currentWorker = CurrentWorker();
+}
@@ -0,0 +1,112 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISWORKSTEALINGEXECUTOR_H
+#define KISWORKSTEALINGEXECUTOR_H
+
+#include "kritaimage_export.h"
+#include "KisThreadAffinity.h"
+
+#include <atomic>
+#include <deque>
+
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+class QRunnable;
+
+/**
+ * A thread pool with a separate queue of tasks for every worker
+ * thread. It is used by KisUpdaterContext instead of QThreadPool.
+ *
+ * A task started from inside a worker thread is pushed into the
+ * queue of this very worker, so it doesn't contend with the tasks
+ * started by the other workers. The worker takes its own tasks in
+ * LIFO order (the data is most probably still in its caches) and,
+ * when its queue is empty, steals the oldest tasks from the queues
+ * of the other workers. The tasks started from the outside (e.g.
+ * from the GUI thread) are distributed over the queues in a
+ * round-robin manner.
+ *
+ * The executor knows nothing about the kinds of the tasks, all the
+ * ordering properties of the merge, stroke and spontaneous jobs are
+ * checked by the queues before the task is started.
+ *
+ * The workers can be pinned to the CPU cores (see KisThreadAffinity).
+ * The tasks started with preferPerformanceWorker flag are pushed into
+ * the queues of the workers running on the performance cores, the
+ * other workers can still steal them when idle.
+ */
+class KRITAIMAGE_EXPORT KisWorkStealingExecutor
+{
+public:
+    KisWorkStealingExecutor(int threadCount = 0);
+    ~KisWorkStealingExecutor();
+
+    /**
+     * Starts \p runnable on one of the worker threads. If
+     * runnable->autoDelete() is true, the runnable is deleted
+     * after completion.
+     *
+     * If \p preferPerformanceWorker is true, the task is queued to
+     * a worker running on a performance core (if there is any).
+     */
+    void start(QRunnable *runnable, bool preferPerformanceWorker = false);
+
+    /**
+     * Blocks the caller until all the started tasks are completed
+     */
+    void waitForDone();
+
+    /**
+     * Restarts the workers with a new number of threads. \p placement
+     * defines the cores the workers are pinned to, the workers without
+     * a placement are not pinned.
+     * WARNING: the executor must be idle!
+     */
+    void setThreadCount(int value,
+                        const QVector<KisThreadAffinity::WorkerPlacement> &placement =
+                            QVector<KisThreadAffinity::WorkerPlacement>());
+    int threadCount() const;
+
+    QVector<KisThreadAffinity::WorkerPlacement> workerPlacement() const;
+
+    /**
+     * Returns the index of the worker if called from a worker
+     * thread of this executor, otherwise returns -1
+     */
+    int currentWorkerIndex() const;
+
+private:
+    struct Worker;
+
+    void startWorkers(int threadCount, const QVector<KisThreadAffinity::WorkerPlacement> &placement);
+    void stopWorkers();
+
+    QRunnable* takeTask(int workerIndex);
+    void taskFinished();
+    void workerLoop(int workerIndex);
+
+private:
+    QVector<Worker*> m_workers;
+    QVector<int> m_performanceWorkers;
+
+    std::atomic<int> m_numQueuedTasks {0};
+    std::atomic<int> m_numSleepingWorkers {0};
+    std::atomic<unsigned int> m_nextQueue {0};
+    std::atomic<unsigned int> m_nextPerformanceQueue {0};
+    std::atomic<bool> m_quit {false};
+
+    QMutex m_sleepMutex;
+    QWaitCondition m_sleepCondition;
+
+    QMutex m_doneMutex;
+    QWaitCondition m_doneCondition;
+    std::atomic<int> m_numUnfinishedTasks {0};
+};
+
+#endif // KISWORKSTEALINGEXECUTOR_H
@@ -33,6 +33,8 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisBelowLayersCache.h"
+#include "KisFusedLayersComposer.h"
 
 
 //#define DEBUG_MERGER
@@ -44,6 +46,27 @@
 #define DEBUG_NODE_ACTION(message, type, leaf, rect)
 #endif
 
+namespace {
+
+/**
+ * Copying the cached composition is not free, so it is not used
+ * when there is only one layer below the updated one
+ */
+const int MIN_CACHED_BELOW_LEAVES = 2;
+
+/**
+ * A single layer is composed by KisPainter as usual
+ */
+const int MIN_FUSED_LEAVES = 2;
+
+KisBelowLayersCache* belowLayersCacheForLeaf(KisProjectionLeafSP leaf)
+{
+    KisGroupLayer *group = qobject_cast<KisGroupLayer*>(leaf->node().data());
+    return group ? group->belowLayersCache() : nullptr;
+}
+
+}
+
 
 class KisUpdateOriginalVisitor : public KisNodeVisitor
 {
@@ -203,10 +226,16 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
+void KisAsyncMerger::setFusionEnabled(bool value)
+{
+    m_fusionEnabled = value;
+}
+
 void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
     const bool useTempProjections = walker.needRectVaries();
+    const QRect invalidationRect = walker.accessRect() | walker.changeRect();
 
     while(!leafStack.isEmpty()) {
         KisMergeWalker::JobItem item = leafStack.pop();
@@ -230,6 +259,10 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
             continue;
         }
 
+        if (!(item.m_position & KisMergeWalker::N_BELOW_FILTHY)) {
+            invalidateBelowLayersCache(currentLeaf, invalidationRect);
+        }
+
         if(item.m_position & KisMergeWalker::N_EXTRA) {
             // The type of layers that will not go to projection.
 
@@ -246,6 +279,13 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         if (!m_currentProjection) {
             setupProjection(currentLeaf, applyRect, useTempProjections);
+
+            if (m_currentProjection && !useTempProjections &&
+                tryUseBelowLayersCache(walker, currentLeaf, item.m_position, applyRect)) {
+
+                DEBUG_NODE_ACTION("Reading below layers cache", "", currentLeaf->parent(), applyRect);
+                continue;
+            }
         }
 
         KisUpdateOriginalVisitor originalVisitor(applyRect,
@@ -279,9 +319,31 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
             /* nothing to do */
         }
 
-        compositeWithProjection(currentLeaf, applyRect);
+        /**
+         * The layers lying above the current one may be composed
+         * together with it, then currentLeaf and position are moved
+         * to the topmost of them
+         */
+        qint32 position = item.m_position;
+        int numComposedLeaves =
+            compositeFusedRun(walker, &currentLeaf, &position, applyRect, invalidationRect);
+
+        if (!numComposedLeaves) {
+            compositeWithProjection(currentLeaf, applyRect);
+            numComposedLeaves = 1;
+        }
+
+        if (m_numBelowLeavesLeft > 0) {
+            m_numBelowLeavesLeft -= numComposedLeaves;
+
+            if (!m_numBelowLeavesLeft) {
+                m_belowLayersCache->write(m_belowLayersCacheSplitLeaf, applyRect, m_currentProjection);
+                m_belowLayersCache = nullptr;
+                m_belowLayersCacheSplitLeaf.clear();
+            }
+        }
 
-        if(item.m_position & KisMergeWalker::N_TOPMOST) {
+        if(position & KisMergeWalker::N_TOPMOST) {
             writeProjection(currentLeaf, useTempProjections, applyRect);
             resetProjection();
         }
@@ -308,6 +370,155 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
+
+    m_belowLayersCache = nullptr;
+    m_belowLayersCacheSplitLeaf.clear();
+    m_numBelowLeavesLeft = 0;
+}
+
+bool KisAsyncMerger::tryUseBelowLayersCache(KisBaseRectsWalker &walker,
+                                            KisProjectionLeafSP currentLeaf,
+                                            qint32 position, const QRect &rect)
+{
+    if (!KisBelowLayersCache::isEnabled() ||
+        walker.levelOfDetail() > 0 ||
+        !(position & KisMergeWalker::N_BELOW_FILTHY)) {
+
+        return false;
+    }
+
+    /**
+     * All the children of the group lie in the stack sequentially,
+     * from the bottom to the top. Find the first child that is not
+     * "below filthy", it is the split point of the cache.
+     */
+    KisMergeWalker::LeafStack &leafStack = walker.leafStack();
+    KisProjectionLeafSP parentLeaf = currentLeaf->parent();
+
+    int numBelowLeaves = 1;
+    int i = leafStack.size() - 1;
+
+    for (; i >= 0; i--) {
+        const KisMergeWalker::JobItem &nextItem = leafStack[i];
+
+        if (!(nextItem.m_position & KisMergeWalker::N_BELOW_FILTHY)) break;
+        if (nextItem.m_leaf->parent() != parentLeaf) return false;
+        if (nextItem.m_applyRect != rect) return false;
+
+        numBelowLeaves++;
+    }
+
+    if (i < 0 || numBelowLeaves < MIN_CACHED_BELOW_LEAVES) return false;
+
+    KisProjectionLeafSP splitLeaf = leafStack[i].m_leaf;
+    if (splitLeaf->parent() != parentLeaf) return false;
+
+    KisBelowLayersCache *cache = belowLayersCacheForLeaf(parentLeaf);
+    if (!cache) return false;
+
+    if (cache->read(splitLeaf, rect, m_currentProjection)) {
+        // the current leaf is skipped by the caller
+        for (int j = 1; j < numBelowLeaves; j++) {
+            leafStack.pop();
+        }
+        return true;
+    }
+
+    m_belowLayersCache = cache;
+    m_belowLayersCacheSplitLeaf = splitLeaf;
+    m_numBelowLeavesLeft = numBelowLeaves;
+
+    return false;
+}
+
+void KisAsyncMerger::invalidateBelowLayersCache(KisProjectionLeafSP currentLeaf, const QRect &rect)
+{
+    /**
+     * The content of all the leaves, except the ones lying below the
+     * filthy node, may change during the merge, so the caches of the
+     * parent groups should forget about them
+     */
+    KisProjectionLeafSP parentLeaf = currentLeaf->parent();
+    if (!parentLeaf) return;
+
+    KisBelowLayersCache *cache = belowLayersCacheForLeaf(parentLeaf);
+    if (cache && !cache->isEmpty()) {
+        cache->invalidate(currentLeaf, rect);
+    }
+}
+
+int KisAsyncMerger::compositeFusedRun(KisBaseRectsWalker &walker,
+                                      KisProjectionLeafSP *leaf, qint32 *position,
+                                      const QRect &rect, const QRect &invalidationRect)
+{
+    if (!m_currentProjection ||
+        !m_fusionEnabled ||
+        (*position & KisMergeWalker::N_TOPMOST)) {
+
+        return 0;
+    }
+
+    const KoColorSpace *dstColorSpace = m_currentProjection->colorSpace();
+    if (!KisFusedLayersComposer::canBeFused(*leaf, dstColorSpace)) return 0;
+
+    /**
+     * The current leaf has already been updated by the caller, the
+     * following siblings can join the run only if they need no update,
+     * that is, their projections are composed as they are.
+     *
+     * The run must not cross the split point of the below layers cache,
+     * since the cache is written right after the last below leaf.
+     */
+    KisMergeWalker::LeafStack &leafStack = walker.leafStack();
+    KisProjectionLeafSP parentLeaf = (*leaf)->parent();
+
+    const int maxRunSize = m_numBelowLeavesLeft > 0 ? m_numBelowLeavesLeft : leafStack.size() + 1;
+
+    int runSize = 1;
+
+    for (int i = leafStack.size() - 1; i >= 0 && runSize < maxRunSize; i--) {
+        const KisMergeWalker::JobItem &nextItem = leafStack[i];
+        const qint32 nextPosition = nextItem.m_position;
+
+        if (nextPosition & (KisMergeWalker::N_EXTRA |
+                            KisMergeWalker::N_FILTHY |
+                            KisMergeWalker::N_FILTHY_PROJECTION)) break;
+
+        if ((nextPosition & KisMergeWalker::N_ABOVE_FILTHY) &&
+            nextItem.m_leaf->dependsOnLowerNodes()) break;
+
+        if (!nextItem.m_leaf->isLayer() ||
+            nextItem.m_leaf->parent() != parentLeaf ||
+            nextItem.m_applyRect != rect ||
+            !KisFusedLayersComposer::canBeFused(nextItem.m_leaf, dstColorSpace)) break;
+
+        runSize++;
+
+        if (nextPosition & KisMergeWalker::N_TOPMOST) break;
+    }
+
+    if (runSize < MIN_FUSED_LEAVES) return 0;
+
+    KisFusedLayersComposer composer;
+    composer.addLeaf(*leaf);
+
+    for (int i = 1; i < runSize; i++) {
+        KisMergeWalker::JobItem item = leafStack.pop();
+
+        if (!(item.m_position & KisMergeWalker::N_BELOW_FILTHY)) {
+            invalidateBelowLayersCache(item.m_leaf, invalidationRect);
+        }
+
+        composer.addLeaf(item.m_leaf);
+
+        *leaf = item.m_leaf;
+        *position = item.m_position;
+    }
+
+    composer.composite(m_currentProjection, rect);
+
+    DEBUG_NODE_ACTION("Compositing fused projection", composer.numLeaves(), *leaf, rect);
+    return runSize;
 }
 
 void KisAsyncMerger::setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection) {
@@ -11,12 +11,20 @@
 
 class QRect;
 class KisBaseRectsWalker;
+class KisBelowLayersCache;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
 public:
     void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
 
+    /**
+     * Compose the runs of simple layers in a single pass (see
+     * KisFusedLayersComposer). Enabled by default, the tests
+     * disable it to get the reference result.
+     */
+    void setFusionEnabled(bool value);
+
 private:
     inline void resetProjection();
     inline void setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection);
@@ -24,6 +32,14 @@ private:
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
 
+    bool tryUseBelowLayersCache(KisBaseRectsWalker &walker, KisProjectionLeafSP currentLeaf,
+                                qint32 position, const QRect &rect);
+    inline void invalidateBelowLayersCache(KisProjectionLeafSP currentLeaf, const QRect &rect);
+
+    int compositeFusedRun(KisBaseRectsWalker &walker,
+                          KisProjectionLeafSP *leaf, qint32 *position,
+                          const QRect &rect, const QRect &invalidationRect);
+
 private:
     /**
      * The place where intermediate results of layer's merge
@@ -49,6 +65,17 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    /**
+     * When the below layers of the current group are not cached yet,
+     * the merger composes them as usual and saves the result into
+     * the group's cache right after the last of them
+     */
+    KisBelowLayersCache *m_belowLayersCache = nullptr;
+    KisProjectionLeafSP m_belowLayersCacheSplitLeaf;
+    int m_numBelowLeavesLeft = 0;
+
+    bool m_fusionEnabled = true;
 };
 
 
@@ -7,6 +7,7 @@
 #ifndef __KIS_BASE_RECTS_WALKER_H
 #define __KIS_BASE_RECTS_WALKER_H
 
+#include <QElapsedTimer>
 #include <QStack>
 
 #include "kis_layer.h"
@@ -105,6 +106,7 @@ public:
     KisBaseRectsWalker()
         : m_levelOfDetail(0)
     {
+        m_creationTimer.start();
     }
 
     virtual ~KisBaseRectsWalker() {
@@ -211,6 +213,14 @@ public:
         return m_levelOfDetail;
     }
 
+    /**
+     * The time passed since the walker has been created, that
+     * is, since the update has been requested (in msec)
+     */
+    inline qint64 elapsedTime() const {
+        return m_creationTimer.elapsed();
+    }
+
     virtual UpdateType type() const = 0;
 
 protected:
@@ -500,6 +510,8 @@ private:
     QRect m_lastNeedRect;
 
     int m_levelOfDetail {0};
+
+    QElapsedTimer m_creationTimer;
 };
 
 #endif /* __KIS_BASE_RECTS_WALKER_H */
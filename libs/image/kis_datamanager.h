@@ -155,6 +155,10 @@ public:
         return ACTUAL_DATAMGR::region();
     }
 
+    KisRegion takeChangedRegion() {
+        return ACTUAL_DATAMGR::takeChangedRegion();
+    }
+
 public:
 
     /**
@@ -25,6 +25,7 @@
 #include "kis_selection_mask.h"
 #include "kis_psd_layer_style.h"
 #include "kis_layer_properties_icons.h"
+#include "KisBelowLayersCache.h"
 
 
 struct Q_DECL_HIDDEN KisGroupLayer::Private
@@ -42,6 +43,7 @@ public:
     qint32 x;
     qint32 y;
     bool passThroughMode;
+    KisBelowLayersCache belowLayersCache;
 
     std::tuple<KisPaintDeviceSP, bool> originalImpl() const;
 };
@@ -190,6 +192,8 @@ void KisGroupLayer::resetCache(const KoColorSpace *colorSpace)
 
     Q_ASSERT(colorSpace);
 
+    m_d->belowLayersCache.clear();
+
     if (!m_d->paintDevice) {
 
         KisPaintDeviceSP dev = new KisPaintDevice(this, colorSpace, new KisDefaultBounds(image()));
@@ -280,6 +284,11 @@ KisPaintDeviceSP KisGroupLayer::original() const
     return std::get<0>(originalImpl());
 }
 
+KisBelowLayersCache* KisGroupLayer::belowLayersCache() const
+{
+    return &m_d->belowLayersCache;
+}
+
 KisPaintDeviceSP KisGroupLayer::lazyDestinationForSubtreeComposition() const
 {
     KisPaintDeviceSP originalDev;
@@ -328,6 +337,17 @@ void KisGroupLayer::setPassThroughMode(bool value)
     if (m_d->passThroughMode) {
         resetCache(colorSpace());
     }
+
+    /**
+     * The children of a pass-through group are composed right into
+     * the parent group, so the order of the leaves changes there
+     */
+    for (KisNodeSP node = parent(); node; node = node->parent()) {
+        KisGroupLayer *group = qobject_cast<KisGroupLayer*>(node.data());
+        if (group) {
+            group->belowLayersCache()->clear();
+        }
+    }
     baseNodeChangedCallback();
     baseNodeInvalidateAllFramesCallback();
     notifyChildMaskChanged();
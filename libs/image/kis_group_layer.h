@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KoColorSpace;
+class KisBelowLayersCache;
 
 /**
  * A KisLayer that bundles child layers into a single layer.
@@ -66,6 +67,12 @@ public:
      */
     KisPaintDeviceSP lazyDestinationForSubtreeComposition() const;
 
+    /**
+     * The cached composition of the children lying below the child
+     * that is being updated now. Used by KisAsyncMerger only.
+     */
+    KisBelowLayersCache* belowLayersCache() const;
+
     qint32 x() const override;
     qint32 y() const override;
     void setX(qint32 x) override;
@@ -198,6 +198,7 @@ public:
         }
 
         connect(q, SIGNAL(sigImageModified()), KisMemoryStatisticsServer::instance(), SLOT(notifyImageChanged()));
+        connect(&scheduler, SIGNAL(sigAdaptiveLevelOfDetailChanged()), q, SIGNAL(sigAdaptiveLevelOfDetailChanged()));
         connect(undoStore.data(), SIGNAL(historyStateChanged()), &signalRouter, SLOT(emitImageModifiedNotification()));
     }
 
@@ -2539,6 +2540,21 @@ KisLodPreferences KisImage::lodPreferences() const
     return m_d->scheduler.lodPreferences();
 }
 
+void KisImage::setViewportRect(const void *view, const QRect &rect)
+{
+    m_d->scheduler.setViewportRect(view, rect);
+}
+
+void KisImage::removeViewportRect(const void *view)
+{
+    m_d->scheduler.removeViewportRect(view);
+}
+
+int KisImage::adaptiveLevelOfDetailOffset() const
+{
+    return m_d->scheduler.adaptiveLevelOfDetailOffset();
+}
+
 void KisImage::nodeCollapsedChanged(KisNode * node)
 {
     Q_UNUSED(node);
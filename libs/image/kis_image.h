@@ -772,6 +772,31 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the area of the image currently visible on the canvas
+     * \p view (in image pixels). The updates of the visible areas of
+     * all the canvases are processed before the updates lying
+     * off-screen. Pass an empty rect if nothing is visible on this
+     * canvas and the bounds of the image if the whole image may be
+     * visible on it.
+     */
+    void setViewportRect(const void *view, const QRect &rect);
+
+    /**
+     * Forgets the visible area of \p view, should be called
+     * before the canvas is destroyed
+     */
+    void removeViewportRect(const void *view);
+
+    /**
+     * The number of levels that should be added to the level of detail
+     * chosen by the canvas to keep the updates latency within the budget.
+     * Always zero if adaptive level of detail is disabled.
+     *
+     * \see sigAdaptiveLevelOfDetailChanged()
+     */
+    int adaptiveLevelOfDetailOffset() const;
+
     KisImageAnimationInterface *animationInterface() const;
 
     /**
@@ -955,6 +980,12 @@ Q_SIGNALS:
      */
     void sigProofingConfigChanged();
 
+    /**
+     * Emitted when adaptiveLevelOfDetailOffset() changes. The receiver
+     * is expected to update the level of detail preferences of the image.
+     */
+    void sigAdaptiveLevelOfDetailChanged();
+
     /**
      * Internal signal for asynchronously requesting isolated mode to stop. Don't use it
      * outside KisImage, use sigIsolatedModeChanged() instead.
@@ -80,6 +80,28 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+bool KisImageConfig::enableUpdateTracing(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("enableUpdateTracing", false) : false;
+}
+
+void KisImageConfig::setEnableUpdateTracing(bool value)
+{
+    m_config.writeEntry("enableUpdateTracing", value);
+}
+
+int KisImageConfig::updateTracingBufferSize(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("updateTracingBufferSize", 65536) : 65536;
+}
+
+void KisImageConfig::setUpdateTracingBufferSize(int value)
+{
+    m_config.writeEntry("updateTracingBufferSize", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
@@ -137,6 +159,94 @@ void KisImageConfig::setSchedulerBalancingRatio(qreal value)
     m_config.writeEntry("schedulerBalancingRatio", value);
 }
 
+bool KisImageConfig::cacheBelowLayersComposition(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("cacheBelowLayersComposition", false) : false;
+}
+
+void KisImageConfig::setCacheBelowLayersComposition(bool value)
+{
+    m_config.writeEntry("cacheBelowLayersComposition", value);
+}
+
+bool KisImageConfig::adaptiveLevelOfDetail(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLevelOfDetail", false) : false;
+}
+
+void KisImageConfig::setAdaptiveLevelOfDetail(bool value)
+{
+    m_config.writeEntry("adaptiveLevelOfDetail", value);
+}
+
+int KisImageConfig::adaptiveLevelOfDetailLatency(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLevelOfDetailLatency", 40) : 40; // in msec
+}
+
+void KisImageConfig::setAdaptiveLevelOfDetailLatency(int value)
+{
+    m_config.writeEntry("adaptiveLevelOfDetailLatency", value);
+}
+
+int KisImageConfig::adaptiveLevelOfDetailMaxOffset(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLevelOfDetailMaxOffset", 2) : 2;
+}
+
+void KisImageConfig::setAdaptiveLevelOfDetailMaxOffset(int value)
+{
+    m_config.writeEntry("adaptiveLevelOfDetailMaxOffset", value);
+}
+
+bool KisImageConfig::pinUpdateThreads(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("pinUpdateThreads", false) : false;
+}
+
+void KisImageConfig::setPinUpdateThreads(bool value)
+{
+    m_config.writeEntry("pinUpdateThreads", value);
+}
+
+bool KisImageConfig::keepGuiCoreFree(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("keepGuiCoreFree", true) : true;
+}
+
+void KisImageConfig::setKeepGuiCoreFree(bool value)
+{
+    m_config.writeEntry("keepGuiCoreFree", value);
+}
+
+bool KisImageConfig::preferPerformanceCores(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("preferPerformanceCores", true) : true;
+}
+
+void KisImageConfig::setPreferPerformanceCores(bool value)
+{
+    m_config.writeEntry("preferPerformanceCores", value);
+}
+
+QString KisImageConfig::updateThreadsCores(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("updateThreadsCores", QString()) : QString();
+}
+
+void KisImageConfig::setUpdateThreadsCores(const QString &value)
+{
+    m_config.writeEntry("updateThreadsCores", value);
+}
+
 int KisImageConfig::maxSwapSize(bool requestDefault) const
 {
     return !requestDefault ?
@@ -168,6 +278,116 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompressionCodec(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionCodec", "LZ4") : "LZ4";
+}
+
+void KisImageConfig::setSwapCompressionCodec(const QString &value)
+{
+    m_config.writeEntry("swapCompressionCodec", value);
+}
+
+QString KisImageConfig::inMemoryCompressionCodec(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("inMemoryCompressionCodec", "LZ4") : "LZ4";
+}
+
+void KisImageConfig::setInMemoryCompressionCodec(const QString &value)
+{
+    m_config.writeEntry("inMemoryCompressionCodec", value);
+}
+
+bool KisImageConfig::tilesPrefetching(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tilesPrefetching", true) : true;
+}
+
+void KisImageConfig::setTilesPrefetching(bool value)
+{
+    m_config.writeEntry("tilesPrefetching", value);
+}
+
+bool KisImageConfig::tilesHugePages(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tilesHugePages", false) : false;
+}
+
+void KisImageConfig::setTilesHugePages(bool value)
+{
+    m_config.writeEntry("tilesHugePages", value);
+}
+
+bool KisImageConfig::tilesShareUniformData(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tilesShareUniformData", false) : false;
+}
+
+void KisImageConfig::setTilesShareUniformData(bool value)
+{
+    m_config.writeEntry("tilesShareUniformData", value);
+}
+
+bool KisImageConfig::undoDeltaMementos(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoDeltaMementos", false) : false;
+}
+
+void KisImageConfig::setUndoDeltaMementos(bool value)
+{
+    m_config.writeEntry("undoDeltaMementos", value);
+}
+
+bool KisImageConfig::undoSwapEnabled(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoSwapEnabled", false) : false;
+}
+
+void KisImageConfig::setUndoSwapEnabled(bool value)
+{
+    m_config.writeEntry("undoSwapEnabled", value);
+}
+
+int KisImageConfig::undoMemoryLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoMemoryLimit", 512) : 512;
+}
+
+void KisImageConfig::setUndoMemoryLimit(int value)
+{
+    m_config.writeEntry("undoMemoryLimit", value);
+}
+
+int KisImageConfig::undoInMemorySteps(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoInMemorySteps", 10) : 10;
+}
+
+void KisImageConfig::setUndoInMemorySteps(int value)
+{
+    m_config.writeEntry("undoInMemorySteps", value);
+}
+
+int KisImageConfig::maxUndoSwapSize(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("maxUndoSwapSize", 1024) : 1024; // in MiB
+}
+
+void KisImageConfig::setMaxUndoSwapSize(int value)
+{
+    m_config.writeEntry("maxUndoSwapSize", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -191,6 +411,13 @@ int KisImageConfig::poolLimit() const
     return totalRAM() * hp * pp;
 }
 
+int KisImageConfig::tilesCompressionLimit() const
+{
+    qreal cp = qreal(memoryCompressionLimitPercent()) / 100.0;
+
+    return totalRAM() * cp;
+}
+
 qreal KisImageConfig::memoryHardLimitPercent(bool requestDefault) const
 {
     return !requestDefault ?
@@ -224,6 +451,17 @@ void KisImageConfig::setMemoryPoolLimitPercent(qreal value)
     m_config.writeEntry("memoryPoolLimitPercent", value);
 }
 
+qreal KisImageConfig::memoryCompressionLimitPercent(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("memoryCompressionLimitPercent", 10.) : 10.;
+}
+
+void KisImageConfig::setMemoryCompressionLimitPercent(qreal value)
+{
+    m_config.writeEntry("memoryCompressionLimitPercent", value);
+}
+
 QString KisImageConfig::safelyGetWritableTempLocation(const QString &suffix, const QString &configKey, bool requestDefault) const
 {
 #ifdef Q_OS_MACOS
@@ -24,6 +24,16 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    bool enableUpdateTracing(bool requestDefault = false) const;
+    void setEnableUpdateTracing(bool value);
+
+    /**
+     * The number of events kept by KisUpdateTracer for every
+     * thread, the older events are overwritten by the newer ones
+     */
+    int updateTracingBufferSize(bool requestDefault = false) const;
+    void setUpdateTracingBufferSize(int value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
@@ -37,6 +47,57 @@ public:
     qreal schedulerBalancingRatio() const;
     void setSchedulerBalancingRatio(qreal value);
 
+    /**
+     * Cache the composition of the layers lying below the painted one
+     * in every group (see KisBelowLayersCache). Costs one extra device
+     * per group, so it is disabled by default.
+     */
+    bool cacheBelowLayersComposition(bool requestDefault = false) const;
+    void setCacheBelowLayersComposition(bool value);
+
+    /**
+     * When enabled, the level of detail of the strokes is increased
+     * automatically if the latency of the canvas updates exceeds
+     * adaptiveLevelOfDetailLatency() msec (see KisAdaptiveLodController)
+     */
+    bool adaptiveLevelOfDetail(bool requestDefault = false) const;
+    void setAdaptiveLevelOfDetail(bool value);
+
+    int adaptiveLevelOfDetailLatency(bool requestDefault = false) const;
+    void setAdaptiveLevelOfDetailLatency(int value);
+
+    int adaptiveLevelOfDetailMaxOffset(bool requestDefault = false) const;
+    void setAdaptiveLevelOfDetailMaxOffset(int value);
+
+    /**
+     * When enabled, every update thread is bound to a single CPU
+     * core (see KisThreadAffinity). The other affinity options have
+     * effect only when the threads are pinned.
+     */
+    bool pinUpdateThreads(bool requestDefault = false) const;
+    void setPinUpdateThreads(bool value);
+
+    /**
+     * Reserve one core for the GUI thread: no update thread is pinned
+     * to it and the unpinned update threads are not allowed to run on it
+     */
+    bool keepGuiCoreFree(bool requestDefault = false) const;
+    void setKeepGuiCoreFree(bool value);
+
+    /**
+     * On hybrid CPUs, bind the update threads to the performance
+     * cores first and send the stroke jobs to them
+     */
+    bool preferPerformanceCores(bool requestDefault = false) const;
+    void setPreferPerformanceCores(bool value);
+
+    /**
+     * The cores the update threads may be pinned to, in Linux's
+     * "cpulist" format, e.g. "2-7,10". Empty means all the cores.
+     */
+    QString updateThreadsCores(bool requestDefault = false) const;
+    void setUpdateThreadsCores(const QString &value);
+
     int maxSwapSize(bool requestDefault = false) const;
     void setMaxSwapSize(int value);
 
@@ -46,16 +107,85 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * Names of the codecs used for tiles compression,
+     * see KisCompressionRegistry for the list of codecs
+     */
+    QString swapCompressionCodec(bool requestDefault = false) const;
+    void setSwapCompressionCodec(const QString &value);
+
+    QString inMemoryCompressionCodec(bool requestDefault = false) const;
+    void setInMemoryCompressionCodec(const QString &value);
+
+    /**
+     * Load swapped tiles in background before the iterators reach them
+     */
+    bool tilesPrefetching(bool requestDefault = false) const;
+    void setTilesPrefetching(bool value);
+
+    /**
+     * Back the memory of the tiles with transparent huge pages
+     * (Linux only). Takes effect after restart.
+     */
+    bool tilesHugePages(bool requestDefault = false) const;
+    void setTilesHugePages(bool value);
+
+    /**
+     * Share a single tile data between all the tiles that became
+     * filled with the same color after a stroke. The check compares
+     * every tile changed by the transaction on commit, so it is
+     * disabled by default. The tiles filled with clear() share their
+     * data regardless of this option.
+     */
+    bool tilesShareUniformData(bool requestDefault = false) const;
+    void setTilesShareUniformData(bool value);
+
+    /**
+     * Store the undo history of the tiles as compressed deltas
+     * against the newer revisions instead of the whole tiles
+     */
+    bool undoDeltaMementos(bool requestDefault = false) const;
+    void setUndoDeltaMementos(bool value);
+
+    /**
+     * Move the undo history of the tiles that is older than
+     * undoInMemorySteps() revisions into a dedicated undo file
+     * when the history takes more than undoMemoryLimit() of RAM
+     */
+    bool undoSwapEnabled(bool requestDefault = false) const;
+    void setUndoSwapEnabled(bool value);
+
+    /**
+     * Zero limit means that only undoInMemorySteps() revisions
+     * are kept in memory
+     */
+    int undoMemoryLimit(bool requestDefault = false) const; // MiB
+    void setUndoMemoryLimit(int value);
+
+    int undoInMemorySteps(bool requestDefault = false) const;
+    void setUndoInMemorySteps(int value);
+
+    /**
+     * The size limit of the undo file. It is accounted separately
+     * from maxSwapSize(), so the total disk usage of Krita may reach
+     * the sum of the two values.
+     */
+    int maxUndoSwapSize(bool requestDefault = false) const; // MiB
+    void setMaxUndoSwapSize(int value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
+    int tilesCompressionLimit() const; // MiB
 
     qreal memoryHardLimitPercent(bool requestDefault = false) const; // % of total RAM
     qreal memorySoftLimitPercent(bool requestDefault = false) const; // % of memoryHardLimitPercent() * (1 - 0.01 * memoryPoolLimitPercent())
     qreal memoryPoolLimitPercent(bool requestDefault = false) const; // % of memoryHardLimitPercent()
+    qreal memoryCompressionLimitPercent(bool requestDefault = false) const; // % of total RAM, 0 disables in-memory compression
     void setMemoryHardLimitPercent(qreal value);
     void setMemorySoftLimitPercent(qreal value);
     void setMemoryPoolLimitPercent(qreal value);
+    void setMemoryCompressionLimitPercent(qreal value);
 
     static int totalRAM(); // MiB
 
@@ -141,9 +141,13 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.totalMemorySize = tileStats.totalMemorySize;
     stats.realMemorySize = tileStats.realMemorySize;
     stats.historicalMemorySize = tileStats.historicalMemorySize;
+    stats.historicalDeltaSize = tileStats.historicalDeltaSize;
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.compressedSize = tileStats.compressedSize;
+    stats.swapReclaimedSize = tileStats.swapReclaimedSize;
+    stats.historicalSwapSize = tileStats.historicalSwapSize;
 
     KisImageConfig cfg(true);
 
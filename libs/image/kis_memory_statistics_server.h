@@ -30,9 +30,13 @@ public:
               totalMemorySize(0),
               realMemorySize(0),
               historicalMemorySize(0),
+              historicalDeltaSize(0),
               poolSize(0),
 
               swapSize(0),
+              compressedSize(0),
+              swapReclaimedSize(0),
+              historicalSwapSize(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -49,9 +53,13 @@ public:
         qint64 totalMemorySize;
         qint64 realMemorySize;
         qint64 historicalMemorySize;
+        qint64 historicalDeltaSize;
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 compressedSize;
+        qint64 swapReclaimedSize;
+        qint64 historicalSwapSize;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
@@ -159,6 +159,7 @@ public:
     {
 
         m_lodData.reset();
+        m_lodSyncState = LodSyncState();
         m_externalFrameData.reset();
 
         if (!m_frames.isEmpty()) {
@@ -424,6 +425,8 @@ public:
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
     KisRegion regionForLodSyncing() const;
+    KisRegion regionForLodSyncing(LodDataStruct *dst) const;
+    bool canSyncLodIncrementally(Data *srcData, int lod) const;
 
     void updateLodDataManager(KisDataManager *srcDataManager,
                               KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
@@ -599,6 +602,18 @@ private:
     DataSP m_data;
     mutable QScopedPointer<Data> m_lodData;
     mutable QScopedPointer<Data> m_externalFrameData;
+
+    /**
+     * The state of the source data at the moment of the last
+     * upload of the LoD plane. Together with the changed flags of
+     * the tiles it tells which part of the plane is outdated.
+     */
+    struct LodSyncState {
+        Data *sourceData = 0;
+        QPoint sourceOffset;
+        KisRegion sourceRegion;
+    };
+    LodSyncState m_lodSyncState;
     mutable QMutex m_dataSwitchLock;
 
     FramesHash m_frames;
@@ -681,6 +696,9 @@ struct KisPaintDevice::Private::StrategyPolicy {
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
     LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
     QScopedPointer<Data> lodData;
+
+    KisRegion syncRegion;
+    LodSyncState sourceState;
 };
 
 KisRegion KisPaintDevice::Private::regionForLodSyncing() const
@@ -689,14 +707,83 @@ KisRegion KisPaintDevice::Private::regionForLodSyncing() const
     return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
 }
 
+KisRegion KisPaintDevice::Private::regionForLodSyncing(LodDataStruct *_dst) const
+{
+    LodDataStructImpl *dst = dynamic_cast<LodDataStructImpl*>(_dst);
+    KIS_SAFE_ASSERT_RECOVER(dst) {
+        return regionForLodSyncing();
+    }
+
+    return dst->syncRegion;
+}
+
+bool KisPaintDevice::Private::canSyncLodIncrementally(Data *srcData, int lod) const
+{
+    if (!m_lodData || m_lodSyncState.sourceData != srcData) return false;
+
+    const QPoint srcOffset(srcData->x(), srcData->y());
+
+    /**
+     * We compare color spaces as pure pointers, because they must be
+     * exactly the same, since they come from the common source.
+     */
+    return m_lodSyncState.sourceOffset == srcOffset &&
+        m_lodData->levelOfDetail() == lod &&
+        m_lodData->colorSpace() == srcData->colorSpace() &&
+        m_lodData->x() == KisLodTransform::coordToLodCoord(srcOffset.x(), lod) &&
+        m_lodData->y() == KisLodTransform::coordToLodCoord(srcOffset.y(), lod) &&
+        m_lodData->dataManager()->pixelSize() == srcData->dataManager()->pixelSize() &&
+        !memcmp(m_lodData->dataManager()->defaultPixel(),
+                srcData->dataManager()->defaultPixel(),
+                srcData->dataManager()->pixelSize());
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(newLod > 0);
 
     Data *srcData = currentNonLodData();
 
-    Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
+    const QPoint srcOffset(srcData->x(), srcData->y());
+    const KisRegion srcRegion = regionForLodSyncing();
+    const KisRegion changedRegion =
+        srcData->dataManager()->takeChangedRegion().translated(srcOffset.x(), srcOffset.y());
+
+    const bool syncIncrementally = canSyncLodIncrementally(srcData, newLod);
+
+    /**
+     * If the struct is never uploaded (e.g. the sync stroke is
+     * cancelled), the changes we have just taken from the tiles
+     * are lost, so the next sync should regenerate everything
+     */
+    const KisRegion lastSyncedRegion = m_lodSyncState.sourceRegion;
+    m_lodSyncState = LodSyncState();
+
+    /**
+     * In incremental mode we start from the current LoD plane
+     * (its tiles are shared with copy-on-write) and update only
+     * the tiles changed since the last sync plus the area of the
+     * tiles removed in the meantime.
+     */
+    Data *lodData = syncIncrementally ?
+        new Data(q, m_lodData.data(), true) :
+        new Data(q, srcData, false);
+
+    LodDataStructImpl *lodStruct = new LodDataStructImpl(lodData);
+
+    lodStruct->sourceState.sourceData = srcData;
+    lodStruct->sourceState.sourceOffset = srcOffset;
+    lodStruct->sourceState.sourceRegion = srcRegion;
+
+    if (syncIncrementally) {
+        const QRegion removedRegion = lastSyncedRegion.toQRegion() - srcRegion.toQRegion();
+
+        QVector<QRect> rects = changedRegion.rects();
+        rects += KisRegion::fromQRegion(removedRegion).rects();
+        lodStruct->syncRegion = KisRegion(std::move(rects));
+    } else {
+        lodStruct->syncRegion = srcRegion;
+    }
 
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
     int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
@@ -848,6 +935,8 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
 
     m_lodData->prepareClone(dst->lodData.data());
     m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+
+    m_lodSyncState = dst->sourceState;
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -2154,6 +2243,11 @@ KisRegion KisPaintDevice::regionForLodSyncing() const
     return m_d->regionForLodSyncing();
 }
 
+KisRegion KisPaintDevice::regionForLodSyncing(LodDataStruct *dst) const
+{
+    return m_d->regionForLodSyncing(dst);
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::createLodDataStruct(int lod)
 {
     return m_d->createLodDataStruct(lod);
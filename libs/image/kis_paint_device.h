@@ -918,6 +918,15 @@ public:
     };
 
     KisRegion regionForLodSyncing() const;
+
+    /**
+     * The region that should be passed to updateLodDataStruct() to
+     * bring \p dst into sync with the device. When the LoD plane of
+     * the device has already been synced on the same level of detail,
+     * it contains only the tiles changed since that sync.
+     */
+    KisRegion regionForLodSyncing(LodDataStruct *dst) const;
+
     LodDataStruct* createLodDataStruct(int lod);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
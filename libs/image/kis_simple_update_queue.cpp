@@ -7,11 +7,18 @@
 #include "kis_simple_update_queue.h"
 
 #include <QMutexLocker>
+#include <QSet>
 #include <QVector>
 
+#include <algorithm>
+#include <limits>
+
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_lod_transform.h"
+
+#include "config-tile-size.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -41,6 +48,25 @@
 #endif /* ENABLE_ACCUMULATOR */
 
 
+namespace {
+
+/**
+ * The patches should consist of whole tiles, otherwise two
+ * merge jobs running in parallel will fight for the same tiles
+ * of the projection
+ */
+inline qint32 alignToTileSize(qint32 value)
+{
+    return qMax(1, (value + KRITA_TILE_SIZE / 2) / KRITA_TILE_SIZE) * KRITA_TILE_SIZE;
+}
+
+inline qint32 floorDiv(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+}
+
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
     : m_overrideLevelOfDetail(-1)
 {
@@ -62,8 +88,9 @@ void KisSimpleUpdateQueue::updateSettings()
 
     KisImageConfig config(true);
 
-    m_patchWidth = config.updatePatchWidth();
-    m_patchHeight = config.updatePatchHeight();
+    m_patchWidth = alignToTileSize(config.updatePatchWidth());
+    m_patchHeight = alignToTileSize(config.updatePatchHeight());
+    m_walkersIndex.setCellSize(QSize(m_patchWidth, m_patchHeight));
 
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
@@ -75,6 +102,31 @@ int KisSimpleUpdateQueue::overrideLevelOfDetail() const
     return m_overrideLevelOfDetail;
 }
 
+void KisSimpleUpdateQueue::setPriorityRect(const QRect &rc)
+{
+    QMutexLocker locker(&m_lock);
+    m_priorityRect = rc;
+}
+
+QRect KisSimpleUpdateQueue::priorityRect() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_priorityRect;
+}
+
+bool KisSimpleUpdateQueue::isPriorityWalker(KisBaseRectsWalkerSP walker) const
+{
+    if (m_priorityRect.isEmpty()) return true;
+
+    const int lod = walker->levelOfDetail();
+
+    const QRect priorityRect = lod > 0 ?
+        KisLodTransformBase::scaledRect(KisLodTransformBase::alignedRect(m_priorityRect, lod), lod) :
+        m_priorityRect;
+
+    return walker->changeRect().intersects(priorityRect);
+}
+
 void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
 {
     updaterContext.lock();
@@ -95,8 +147,18 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 
     int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
 
+    /**
+     * The walkers lying outside the visible area are postponed
+     * until there is no visible walker that can be started, that
+     * is, they are started only on the threads that would idle
+     * otherwise.
+     */
+    int postponedItemIndex = -1;
+    int itemIndex = -1;
+
     while(iter.hasNext()) {
         item = iter.next();
+        itemIndex++;
 
         if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
             !item->checksumValid()) {
@@ -109,13 +171,28 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
         if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
             updaterContext.isJobAllowed(item)) {
 
+            if (!isPriorityWalker(item)) {
+                if (postponedItemIndex < 0) {
+                    postponedItemIndex = itemIndex;
+                }
+                continue;
+            }
+
             updaterContext.addMergeJob(item);
+            m_walkersIndex.removeWalker(item);
             iter.remove();
             jobAdded = true;
             break;
         }
     }
 
+    if (!jobAdded && postponedItemIndex >= 0) {
+        item = m_updatesList.takeAt(postponedItemIndex);
+        m_walkersIndex.removeWalker(item);
+        updaterContext.addMergeJob(item);
+        jobAdded = true;
+    }
+
     if (jobAdded) return true;
 
     if (!m_spontaneousJobsList.isEmpty()) {
@@ -217,6 +294,9 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
     if (!walkers.isEmpty()) {
         m_lock.lock();
         m_updatesList.append(walkers);
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkers) {
+            m_walkersIndex.addWalker(walker);
+        }
         m_lock.unlock();
     }
 }
@@ -254,34 +334,49 @@ qint32 KisSimpleUpdateQueue::sizeMetric() const
     return m_updatesList.size() + m_spontaneousJobsList.size();
 }
 
-bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
-                                       const QRect& cropRect,
-                                       int levelOfDetail,
-                                       KisBaseRectsWalker::UpdateType type)
+QVector<QRect> KisSimpleUpdateQueue::splitIntoPatches(const QRect &rc) const
 {
-    if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
-        return false;
+    qint32 patchWidth;
+    qint32 patchHeight;
 
-    // a bit of recursive splitting...
+    {
+        QMutexLocker locker(&m_lock);
+        patchWidth = m_patchWidth;
+        patchHeight = m_patchHeight;
+    }
+
+    if (rc.width() <= patchWidth && rc.height() <= patchHeight) {
+        return {rc};
+    }
 
-    qint32 firstCol = rc.x() / m_patchWidth;
-    qint32 firstRow = rc.y() / m_patchHeight;
+    const qint32 firstCol = floorDiv(rc.left(), patchWidth);
+    const qint32 firstRow = floorDiv(rc.top(), patchHeight);
 
-    qint32 lastCol = (rc.x() + rc.width()) / m_patchWidth;
-    qint32 lastRow = (rc.y() + rc.height()) / m_patchHeight;
+    const qint32 lastCol = floorDiv(rc.right(), patchWidth);
+    const qint32 lastRow = floorDiv(rc.bottom(), patchHeight);
 
     QVector<QRect> splitRects;
+    splitRects.reserve((lastRow - firstRow + 1) * (lastCol - firstCol + 1));
 
     for(qint32 i = firstRow; i <= lastRow; i++) {
         for(qint32 j = firstCol; j <= lastCol; j++) {
-            QRect maxPatchRect(j * m_patchWidth, i * m_patchHeight,
-                               m_patchWidth, m_patchHeight);
-            QRect patchRect = rc & maxPatchRect;
-            splitRects.append(patchRect);
+            QRect maxPatchRect(j * patchWidth, i * patchHeight,
+                               patchWidth, patchHeight);
+            splitRects.append(rc & maxPatchRect);
         }
     }
 
-    KIS_SAFE_ASSERT_RECOVER_NOOP(!splitRects.isEmpty());
+    return splitRects;
+}
+
+bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
+                                       const QRect& cropRect,
+                                       int levelOfDetail,
+                                       KisBaseRectsWalker::UpdateType type)
+{
+    const QVector<QRect> splitRects = splitIntoPatches(rc);
+    if (splitRects.size() <= 1) return false;
+
     addJob(node, splitRects, cropRect, levelOfDetail, type);
 
     return true;
@@ -294,37 +389,38 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
 {
     QMutexLocker locker(&m_lock);
 
-    QRect baseRect = rc;
-
     KisBaseRectsWalkerSP goodCandidate;
-    KisBaseRectsWalkerSP item;
-    KisWalkersListIterator iter(m_updatesList);
+    qreal bestAlpha = m_maxMergeAlpha;
+
+    const QVector<KisBaseRectsWalkerSP> candidates =
+        m_walkersIndex.mergeCandidates(node, levelOfDetail, rc);
 
     /**
-     * We add new jobs to the tail of the list,
-     * so it's more probable to find a good candidate here.
+     * We choose the candidate that gives the least amount of extra
+     * work. The newer walkers are checked first, so in case of equal
+     * coverage the most recent candidate wins.
      */
+    for (auto it = candidates.crbegin(); it != candidates.crend(); ++it) {
+        const KisBaseRectsWalkerSP &item = *it;
 
-    iter.toBack();
-
-    while(iter.hasPrevious()) {
-        item = iter.previous();
-
-        if(item->startNode() != node) continue;
         if(item->type() != type) continue;
         if(item->cropRect() != cropRect) continue;
-        if(item->levelOfDetail() != levelOfDetail) continue;
 
-        if(joinRects(baseRect, item->requestedRect(), m_maxMergeAlpha)) {
+        const qreal alpha = joinAlpha(rc, item->requestedRect());
+        if (alpha < bestAlpha) {
+            bestAlpha = alpha;
             goodCandidate = item;
-            break;
         }
     }
 
-    if(goodCandidate)
-        collectJobs(goodCandidate, baseRect, m_maxMergeCollectAlpha);
+    if (!goodCandidate) return false;
 
-    return (bool)goodCandidate;
+    QRect baseRect = rc;
+    joinRects(baseRect, goodCandidate->requestedRect(), m_maxMergeAlpha);
+
+    collectJobs(goodCandidate, baseRect, m_maxMergeCollectAlpha);
+
+    return true;
 }
 
 void KisSimpleUpdateQueue::optimize()
@@ -343,48 +439,80 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
                                        QRect baseRect,
                                        const qreal maxAlpha)
 {
-    KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
-
-    while(iter.hasNext()) {
-        item = iter.next();
-
-        if(item == baseWalker) continue;
-        if(item->type() != baseWalker->type()) continue;
-        if(item->startNode() != baseWalker->startNode()) continue;
-        if(item->cropRect() != baseWalker->cropRect()) continue;
-        if(item->levelOfDetail() != baseWalker->levelOfDetail()) continue;
+    QSet<KisBaseRectsWalker*> collectedWalkers;
 
-        if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
-            iter.remove();
+    /**
+     * Every join grows the base rect, so some more walkers
+     * may become joinable. Repeat until nothing changes.
+     */
+    bool baseRectChanged = true;
+
+    while (baseRectChanged) {
+        baseRectChanged = false;
+
+        const QVector<KisBaseRectsWalkerSP> candidates =
+            m_walkersIndex.mergeCandidates(baseWalker->startNode(),
+                                           baseWalker->levelOfDetail(),
+                                           baseRect);
+
+        Q_FOREACH (KisBaseRectsWalkerSP item, candidates) {
+            if(item == baseWalker) continue;
+            if(item->type() != baseWalker->type()) continue;
+            if(item->cropRect() != baseWalker->cropRect()) continue;
+
+            if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
+                m_walkersIndex.removeWalker(item);
+                collectedWalkers.insert(item.data());
+                baseRectChanged = true;
+            }
         }
     }
 
+    if (!collectedWalkers.isEmpty()) {
+        m_updatesList.erase(
+            std::remove_if(m_updatesList.begin(), m_updatesList.end(),
+                           [&collectedWalkers] (KisBaseRectsWalkerSP walker) {
+                               return collectedWalkers.contains(walker.data());
+                           }),
+            m_updatesList.end());
+    }
+
     if(baseWalker->requestedRect() != baseRect) {
         baseWalker->collectRects(baseWalker->startNode(), baseRect);
+        m_walkersIndex.updateWalker(baseWalker);
     }
 }
 
-bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
-                                     const QRect& newRect, qreal maxAlpha)
+qreal KisSimpleUpdateQueue::joinAlpha(const QRect& baseRect,
+                                      const QRect& newRect) const
 {
     QRect unitedRect = baseRect | newRect;
     if(unitedRect.width() > m_patchWidth || unitedRect.height() > m_patchHeight)
-        return false;
+        return std::numeric_limits<qreal>::max();
 
-    bool result = false;
     qint64 baseWork = qint64(baseRect.width()) * baseRect.height() +
         qint64(newRect.width()) * newRect.height();
 
     qint64 newWork = qint64(unitedRect.width()) * unitedRect.height();
 
-    qreal alpha = qreal(newWork) / baseWork;
+    return qreal(newWork) / baseWork;
+}
+
+bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
+                                     const QRect& newRect, qreal maxAlpha)
+{
+    bool result = false;
+
+    const QRect unitedRect = baseRect | newRect;
+    const qreal alpha = joinAlpha(baseRect, newRect);
 
     if(alpha < maxAlpha) {
         DEBUG_JOIN(baseRect, newRect, alpha);
 
         DECLARE_ACCUMULATOR();
-        ACCUMULATOR_ADD(baseWork, newWork);
+        ACCUMULATOR_ADD(qint64(baseRect.width()) * baseRect.height() +
+                        qint64(newRect.width()) * newRect.height(),
+                        qint64(unitedRect.width()) * unitedRect.height());
         ACCUMULATOR_DEBUG();
 
         baseRect = unitedRect;
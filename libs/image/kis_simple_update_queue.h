@@ -9,6 +9,7 @@
 
 #include <QMutex>
 #include "kis_updater_context.h"
+#include "KisUpdateWalkersIndex.h"
 
 typedef QList<KisBaseRectsWalkerSP> KisWalkersList;
 typedef QListIterator<KisBaseRectsWalkerSP> KisWalkersListIterator;
@@ -46,10 +47,29 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * Sets the area of the image (in LoD0 coordinates) that is
+     * currently visible to the user. The walkers intersecting this
+     * area are started first, the rest of the walkers are started
+     * only when no visible walker can be started. An empty rect
+     * means that all the walkers are processed in FIFO order.
+     */
+    void setPriorityRect(const QRect &rc);
+    QRect priorityRect() const;
+
+    /**
+     * Splits \p rc into the patches of the update patch size. The
+     * grid of the patches is aligned to the tiles, so the patches can
+     * be merged in parallel without sharing any tile of the projection.
+     * Returns {rc} if the rect is small enough.
+     */
+    QVector<QRect> splitIntoPatches(const QRect &rc) const;
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
+    bool isPriorityWalker(KisBaseRectsWalkerSP walker) const;
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
@@ -57,6 +77,7 @@ protected:
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
     bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
+    qreal joinAlpha(const QRect& baseRect, const QRect& newRect) const;
 
 protected:
 
@@ -64,6 +85,12 @@ protected:
     KisWalkersList m_updatesList;
     KisSpontaneousJobsList m_spontaneousJobsList;
 
+    /**
+     * Spatial index of the walkers in m_updatesList, used for
+     * searching the merge candidates
+     */
+    KisUpdateWalkersIndex m_walkersIndex;
+
     /**
      * Parameters of optimization
      * (loaded from a configuration file)
@@ -72,7 +99,7 @@ protected:
     /**
      * Big update areas are split into a set of smaller
      * ones, m_patchWidth and m_patchHeight represent the
-     * size of these areas.
+     * size of these areas. The size is rounded to whole tiles.
      */
     qint32 m_patchWidth;
     qint32 m_patchHeight;
@@ -94,6 +121,8 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    QRect m_priorityRect;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
@@ -16,6 +16,7 @@
 #include "kis_undo_stores.h"
 #include "kis_post_execution_undo_adapter.h"
 #include "KisCppQuirks.h"
+#include "KisLocklessBatchQueue.h"
 
 typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
@@ -59,6 +60,15 @@ private:
 };
 
 
+/**
+ * A job added by the GUI thread, but not yet put into its stroke
+ */
+struct PendingStrokeJob {
+    KisStrokeSP stroke;
+    KisStrokeJobData *data = 0;
+    KisStrokeJobData *lodBuddyData = 0;
+};
+
 struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     Private(KisStrokesQueue *_q)
         : q(_q),
@@ -94,6 +104,16 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     KisPostExecutionUndoAdapter lodNPostExecutionUndoAdapter;
     KisLodPreferences lodPreferences;
 
+    /**
+     * addJob() doesn't take the mutex, because processQueue() holds it
+     * for the whole scanning pass and the GUI thread would be blocked
+     * on every tablet event. The jobs are put into their strokes in
+     * batches by drainPendingJobs(), which is called under the mutex by
+     * every method that needs the actual state of the strokes.
+     */
+    KisLocklessBatchQueue<PendingStrokeJob> pendingJobs;
+
+    void drainPendingJobs();
     void cancelForgettableStrokes();
     void startLod0ToNStroke(int levelOfDetail, bool forgettable);
 
@@ -118,6 +138,8 @@ KisStrokesQueue::KisStrokesQueue()
 
 KisStrokesQueue::~KisStrokesQueue()
 {
+    m_d->drainPendingJobs();
+
     Q_FOREACH (KisStrokeSP stroke, m_d->strokesQueue) {
         stroke->cancelStroke();
     }
@@ -142,6 +164,19 @@ executeStrokePair(const StrokePair &pair, StrokesQueue &queue, typename StrokesQ
     return it;
 }
 
+void KisStrokesQueue::Private::drainPendingJobs()
+{
+    pendingJobs.takeAll(
+        [] (const PendingStrokeJob &job) {
+            KisStrokeSP buddy = job.stroke->lodBuddy();
+            if (buddy) {
+                buddy->addJob(job.lodBuddyData);
+            }
+
+            job.stroke->addJob(job.data);
+        });
+}
+
 void KisStrokesQueue::Private::startLod0ToNStroke(int levelOfDetail, bool forgettable)
 {
     // precondition: lock held!
@@ -281,6 +316,7 @@ KisStrokeId KisStrokesQueue::startLodNUndoStroke(KisStrokeStrategy *strokeStrate
 KisStrokeId KisStrokesQueue::startStroke(KisStrokeStrategy *strokeStrategy)
 {
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     KisStrokeSP stroke;
     KisStrokeStrategy* lodBuddyStrategy;
@@ -341,26 +377,36 @@ KisStrokeId KisStrokesQueue::startStroke(KisStrokeStrategy *strokeStrategy)
 
 void KisStrokesQueue::addJob(KisStrokeId id, KisStrokeJobData *data)
 {
-    QMutexLocker locker(&m_d->mutex);
+    PendingStrokeJob job;
 
-    KisStrokeSP stroke = id.toStrongRef();
-    KIS_SAFE_ASSERT_RECOVER_RETURN(stroke);
+    job.stroke = id.toStrongRef();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(job.stroke);
 
-    KisStrokeSP buddy = stroke->lodBuddy();
-    if (buddy) {
-        KisStrokeJobData *clonedData =
-            data->createLodClone(buddy->worksOnLevelOfDetail());
-        KIS_ASSERT_RECOVER_RETURN(clonedData);
+    job.data = data;
 
-        buddy->addJob(clonedData);
+    /**
+     * The buddy is assigned in startStroke() before the id is returned
+     * to the caller and is never changed, so it is safe to read it
+     * without the lock
+     */
+    KisStrokeSP buddy = job.stroke->lodBuddy();
+    if (buddy) {
+        job.lodBuddyData = data->createLodClone(buddy->worksOnLevelOfDetail());
+        KIS_ASSERT_RECOVER_RETURN(job.lodBuddyData);
     }
 
-    stroke->addJob(data);
+    m_d->pendingJobs.push(job);
+}
+
+bool KisStrokesQueue::hasPendingJobs() const
+{
+    return !m_d->pendingJobs.isEmpty();
 }
 
 void KisStrokesQueue::addMutatedJobs(KisStrokeId id, const QVector<KisStrokeJobData *> list)
 {
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     KisStrokeSP stroke = id.toStrongRef();
     KIS_SAFE_ASSERT_RECOVER_RETURN(stroke);
@@ -371,6 +417,7 @@ void KisStrokesQueue::addMutatedJobs(KisStrokeId id, const QVector<KisStrokeJobD
 void KisStrokesQueue::endStroke(KisStrokeId id)
 {
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     KisStrokeSP stroke = id.toStrongRef();
     KIS_SAFE_ASSERT_RECOVER_RETURN(stroke);
@@ -386,6 +433,7 @@ void KisStrokesQueue::endStroke(KisStrokeId id)
 bool KisStrokesQueue::cancelStroke(KisStrokeId id)
 {
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     KisStrokeSP stroke = id.toStrongRef();
     if(stroke) {
@@ -416,6 +464,7 @@ bool KisStrokesQueue::tryCancelCurrentStrokeAsync()
     bool anythingCanceled = false;
 
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     /**
      * We cancel only ended strokes. This is done to avoid
@@ -478,6 +527,7 @@ UndoResult KisStrokesQueue::tryUndoLastStrokeAsync()
     UndoResult result = UNDO_FAIL;
 
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     KisStrokeSP lastStroke;
     KisStrokeSP lastBuddy;
@@ -592,6 +642,8 @@ void KisStrokesQueue::processQueue(KisUpdaterContext &updaterContext,
     updaterContext.lock();
     m_d->mutex.lock();
 
+    m_d->drainPendingJobs();
+
     while(updaterContext.hasSpareThread() &&
           processOneJob(updaterContext,
                         externalJobsPending));
@@ -649,6 +701,7 @@ bool KisStrokesQueue::isEmpty() const
 qint32 KisStrokesQueue::sizeMetric() const
 {
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
     if(m_d->strokesQueue.isEmpty()) return 0;
 
     // just a rough approximation
@@ -692,6 +745,7 @@ void KisStrokesQueue::notifyUFOChangedImage()
 void KisStrokesQueue::debugDumpAllStrokes()
 {
     QMutexLocker locker(&m_d->mutex);
+    m_d->drainPendingJobs();
 
     qDebug() <<"===";
     Q_FOREACH (KisStrokeSP stroke, m_d->strokesQueue) {
@@ -32,8 +32,22 @@ public:
     ~KisStrokesQueue();
 
     KisStrokeId startStroke(KisStrokeStrategy *strokeStrategy);
+
+    /**
+     * Adds a job to the stroke without taking the lock of the queue.
+     * The job is put into the stroke on the next processQueue() call
+     * (or any other call that needs the actual state of the strokes),
+     * so the order of the jobs, endStroke() and cancelStroke() calls
+     * of the same thread is preserved.
+     */
     void addJob(KisStrokeId id, KisStrokeJobData *data);
 
+    /**
+     * Returns true if there are jobs added with addJob() that
+     * haven't been put into their strokes yet
+     */
+    bool hasPendingJobs() const;
+
     void endStroke(KisStrokeId id);
     bool cancelStroke(KisStrokeId id);
 
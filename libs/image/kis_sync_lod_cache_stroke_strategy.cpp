@@ -12,6 +12,7 @@
 #include "kis_layer_utils.h"
 #include "kis_pointer_utils.h"
 #include "KisRunnableStrokeJobUtils.h"
+#include "KisUpdateTracer.h"
 
 struct KisSyncLodCacheStrokeStrategy::Private
 {
@@ -59,10 +60,7 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
     using KritaUtils::splitRegionIntoPatches;
     using KritaUtils::optimalPatchSize;
 
-    using SharedData = QHash<KisPaintDeviceSP, QSharedPointer<KisPaintDevice::LodDataStruct>>;
-    using SharedDataSP = QSharedPointer<SharedData>;
-
-    SharedDataSP sharedData(new SharedData());
+    using LodDataStructSP = QSharedPointer<KisPaintDevice::LodDataStruct>;
 
     KisPaintDeviceList deviceList = extraDevices;
 
@@ -77,24 +75,26 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
         updatesFacade->blockUpdates();
     });
 
-    KritaUtils::addJobBarrier(jobs, [sharedData, deviceList, levelOfDetail] () mutable {
-        Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-            sharedData->insert(device, toQShared(device->createLodDataStruct(levelOfDetail)));
-        }
-    });
-
-    KritaUtils::addJobSequential(jobs, [](){});
+    /**
+     * The jobs are created inside a barrier job, so the devices
+     * cannot change until the sync is complete. The structs are
+     * created right here, because only they know which part of
+     * the LoD plane is outdated: after the first sync only the
+     * tiles changed since the previous one are regenerated.
+     */
+    QVector<QPair<KisPaintDeviceSP, LodDataStructSP>> lodData;
 
     Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-        KisRegion region = device->regionForLodSyncing();
+        LodDataStructSP data = toQShared(device->createLodDataStruct(levelOfDetail));
+        lodData << qMakePair(device, data);
+
+        KisRegion region = device->regionForLodSyncing(data.data());
         QVector<QRect> rects = splitRegionIntoPatches(region, optimalPatchSize());
 
         Q_FOREACH (const QRect &rc, rects) {
-            KritaUtils::addJobConcurrent(jobs, [sharedData, device, rc] () mutable {
-                KIS_ASSERT(sharedData->contains(device));
-
-                KisPaintDevice::LodDataStruct *data = sharedData->value(device).data();
-                device->updateLodDataStruct(data, rc);
+            KritaUtils::addJobConcurrent(jobs, [device, data, rc] () mutable {
+                KisUpdateTraceScope traceScope(KisUpdateTracer::LodSync, rc);
+                device->updateLodDataStruct(data.data(), rc);
             });
         }
     }
@@ -108,15 +108,19 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
              });
         });
 
-    KritaUtils::addJobSequential(jobs, [sharedData] () mutable {
-        auto it = sharedData->begin();
-        auto end = sharedData->end();
+    KritaUtils::addJobSequential(jobs, [](){});
 
-        for (; it != end; ++it) {
-            KisPaintDeviceSP dev = it.key();
-            dev->uploadLodDataStruct(it.value().data());
-        }
-    });
+    /**
+     * Every device owns its LoD plane, so they can be uploaded in parallel
+     */
+    for (auto it = lodData.begin(); it != lodData.end(); ++it) {
+        KisPaintDeviceSP device = it->first;
+        LodDataStructSP data = it->second;
+
+        KritaUtils::addJobConcurrent(jobs, [device, data] () mutable {
+            device->uploadLodDataStruct(data.data());
+        });
+    }
 
     KritaUtils::addJobSequentialNoCancel(jobs, [updatesFacade] () {
         updatesFacade->unblockUpdates();
@@ -14,11 +14,17 @@
 #include "kis_updater_context.h"
 #include "kis_simple_update_queue.h"
 #include "kis_strokes_queue.h"
+#include "KisBelowLayersCache.h"
+#include "KisUpdateTracer.h"
+#include "KisAdaptiveLodController.h"
+#include "KisThreadAffinity.h"
 
 #include "kis_queues_progress_updater.h"
 #include "KisImageConfigNotifier.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
 #include "kis_lazy_wait_condition.h"
 #include <mutex>
 
@@ -53,13 +59,34 @@ struct Q_DECL_HIDDEN KisUpdateScheduler::Private {
     KisQueuesProgressUpdater *progressUpdater = 0;
 
     QAtomicInt updatesLockCounter;
+    QAtomicInt processQueuesRequests;
+    KisAdaptiveLodController adaptiveLodController;
     QReadWriteLock updatesStartLock;
     KisLazyWaitCondition updatesFinishedCondition;
 
+    QMutex viewportRectsLock;
+    QHash<const void*, QRect> viewportRects;
+
     qreal balancingRatio() const {
         const qreal strokeRatioOverride = strokesQueue.balancingRatioOverride();
         return strokeRatioOverride > 0 ? strokeRatioOverride : defaultBalancingRatio;
     }
+
+    void updatePriorityRectLocked() {
+        QRect priorityRect;
+
+        /**
+         * A canvas scrolled away from the image shows nothing, so it
+         * doesn't add anything to the priority area. If none of the
+         * canvases shows anything, the rect stays empty and all the
+         * updates are processed in FIFO order.
+         */
+        for (auto it = viewportRects.constBegin(); it != viewportRects.constEnd(); ++it) {
+            priorityRect |= it.value();
+        }
+
+        updatesQueue.setPriorityRect(priorityRect);
+    }
 };
 
 KisUpdateScheduler::KisUpdateScheduler(KisProjectionUpdateListener *projectionUpdateListener, QObject *parent)
@@ -176,8 +203,21 @@ void KisUpdateScheduler::fullRefreshAsyncNoFilthy(KisNodeSP root, const QVector<
 
 void KisUpdateScheduler::fullRefresh(KisNodeSP root, const QRect& rc, const QRect &cropRect)
 {
-    KisBaseRectsWalkerSP walker = new KisFullRefreshWalker(cropRect);
-    walker->collectRects(root, rc);
+    /**
+     * A refresh of a huge image is split into tile-aligned patches that
+     * are merged by all the threads of the context. The walkers whose
+     * need rects overlap the ones of the running walkers are postponed
+     * by isJobAllowed() until the next round.
+     */
+    QList<KisBaseRectsWalkerSP> walkers;
+
+    Q_FOREACH (const QRect &patchRect, m_d->updatesQueue.splitIntoPatches(rc)) {
+        if (patchRect.isEmpty()) continue;
+
+        KisBaseRectsWalkerSP walker = new KisFullRefreshWalker(cropRect);
+        walker->collectRects(root, patchRect);
+        walkers.append(walker);
+    }
 
     bool needLock = true;
 
@@ -189,11 +229,33 @@ void KisUpdateScheduler::fullRefresh(KisNodeSP root, const QRect& rc, const QRec
     }
 
     if(needLock) immediateLockForReadOnly();
-    m_d->updaterContext.lock();
 
-    Q_ASSERT(m_d->updaterContext.isJobAllowed(walker));
-    m_d->updaterContext.addMergeJob(walker);
-    m_d->updaterContext.unlock();
+    while (!walkers.isEmpty()) {
+        bool jobAdded = false;
+        const int numFinishedJobs = m_d->updaterContext.numFinishedJobs();
+
+        m_d->updaterContext.lock();
+
+        KisMutableWalkersListIterator iter(walkers);
+        while (iter.hasNext() && m_d->updaterContext.hasSpareThread()) {
+            KisBaseRectsWalkerSP walker = iter.next();
+
+            if (m_d->updaterContext.isJobAllowed(walker)) {
+                m_d->updaterContext.addMergeJob(walker);
+                iter.remove();
+                jobAdded = true;
+            }
+        }
+
+        m_d->updaterContext.unlock();
+
+        if (walkers.isEmpty()) break;
+
+        const bool jobFinished = m_d->updaterContext.waitForJobFinished(numFinishedJobs);
+
+        // an idle context always accepts at least one walker
+        KIS_SAFE_ASSERT_RECOVER_BREAK(jobAdded || jobFinished);
+    }
 
     m_d->updaterContext.waitForDone();
 
@@ -220,8 +282,18 @@ KisStrokeId KisUpdateScheduler::startStroke(KisStrokeStrategy *strokeStrategy)
 
 void KisUpdateScheduler::addJob(KisStrokeId id, KisStrokeJobData *data)
 {
+    /**
+     * With a high-rate tablet the jobs are added about a thousand times
+     * per second. The strokes queue accepts them without locking, and
+     * if some worker is processing the queues right now, we just ask it
+     * to make one more pass. Otherwise the pass is handed over to a
+     * worker thread, so the GUI thread never waits for the context lock
+     * and never gets stuck in the processing loop.
+     */
     m_d->strokesQueue.addJob(id, data);
-    processQueues();
+
+    if (m_d->processQueuesRequests.fetchAndAddOrdered(1) > 0) return;
+    m_d->updaterContext.startProcessQueuesPass();
 }
 
 void KisUpdateScheduler::endStroke(KisStrokeId id)
@@ -269,6 +341,25 @@ KisLodPreferences KisUpdateScheduler::lodPreferences() const
     return m_d->strokesQueue.lodPreferences();
 }
 
+void KisUpdateScheduler::setViewportRect(const void *view, const QRect &rect)
+{
+    QMutexLocker l(&m_d->viewportRectsLock);
+    m_d->viewportRects.insert(view, rect);
+    m_d->updatePriorityRectLocked();
+}
+
+void KisUpdateScheduler::removeViewportRect(const void *view)
+{
+    QMutexLocker l(&m_d->viewportRectsLock);
+    m_d->viewportRects.remove(view);
+    m_d->updatePriorityRectLocked();
+}
+
+int KisUpdateScheduler::adaptiveLevelOfDetailOffset() const
+{
+    return m_d->adaptiveLodController.lodOffset();
+}
+
 void KisUpdateScheduler::explicitRegenerateLevelOfDetail()
 {
     m_d->strokesQueue.explicitRegenerateLevelOfDetail();
@@ -323,6 +414,30 @@ void KisUpdateScheduler::updateSettings()
     m_d->updatesQueue.updateSettings();
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
+    KisBelowLayersCache::setEnabled(config.cacheBelowLayersComposition());
+    KisUpdateTracer::instance()->setCapacity(config.updateTracingBufferSize());
+
+    m_d->adaptiveLodController.setLatencyBudget(config.adaptiveLevelOfDetailLatency());
+    m_d->adaptiveLodController.setMaxLodOffset(config.adaptiveLevelOfDetailMaxOffset());
+
+    const bool adaptiveLodWasEnabled = m_d->adaptiveLodController.isEnabled();
+    m_d->adaptiveLodController.setEnabled(config.adaptiveLevelOfDetail());
+
+    if (adaptiveLodWasEnabled != m_d->adaptiveLodController.isEnabled()) {
+        emit sigAdaptiveLevelOfDetailChanged();
+    }
+
+    KisThreadAffinity::Options affinityOptions;
+    affinityOptions.pinThreads = config.pinUpdateThreads();
+    affinityOptions.keepGuiCoreFree = config.keepGuiCoreFree();
+    affinityOptions.preferPerformanceCores = config.preferPerformanceCores();
+    affinityOptions.allowedCores = KisThreadAffinity::parseCpuList(config.updateThreadsCores());
+
+    // the options are applied by setThreadsLimit() below
+    m_d->updaterContext.lock();
+    m_d->updaterContext.setThreadAffinityOptions(affinityOptions);
+    m_d->updaterContext.unlock();
+
     setThreadsLimit(config.maxNumberOfThreads());
 }
 
@@ -474,6 +589,13 @@ void KisUpdateScheduler::continueUpdate(const QRect &rect)
     m_d->projectionUpdateListener->notifyProjectionUpdated(rect);
 }
 
+void KisUpdateScheduler::reportUpdateLatency(qint64 msec)
+{
+    if (m_d->adaptiveLodController.reportLatency(msec)) {
+        emit sigAdaptiveLevelOfDetailChanged();
+    }
+}
+
 void KisUpdateScheduler::doSomeUsefulWork()
 {
     m_d->updatesQueue.optimize();
@@ -481,7 +603,29 @@ void KisUpdateScheduler::doSomeUsefulWork()
 
 void KisUpdateScheduler::spareThreadAppeared()
 {
-    processQueues();
+    processQueuesOrRequestAnotherPass();
+}
+
+void KisUpdateScheduler::processQueuesOrRequestAnotherPass()
+{
+    /**
+     * Every finished job used to process the queues by itself, so with
+     * a high number of threads all of them were just waiting for the
+     * context lock. Now only one thread processes the queues, the others
+     * only notify it that it should make one more pass.
+     */
+    if (m_d->processQueuesRequests.fetchAndAddOrdered(1) > 0) return;
+    processQueuesPass();
+}
+
+void KisUpdateScheduler::processQueuesPass()
+{
+    int numRequests = 0;
+
+    do {
+        numRequests = m_d->processQueuesRequests.loadAcquire();
+        processQueues();
+    } while (!m_d->processQueuesRequests.testAndSetOrdered(numRequests, 0));
 }
 
 KisTestableUpdateScheduler::KisTestableUpdateScheduler(KisProjectionUpdateListener *projectionUpdateListener,
@@ -153,6 +153,32 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the area of the image currently visible on the canvas
+     * \p view. The updates intersecting the visible areas of all the
+     * canvases are processed first. An empty rect means that nothing
+     * is visible on this canvas, pass the bounds of the image if the
+     * whole image may be visible.
+     *
+     * \see KisSimpleUpdateQueue::setPriorityRect()
+     */
+    void setViewportRect(const void *view, const QRect &rect);
+
+    /**
+     * Forgets the visible area of \p view. Should be called when
+     * the canvas is going to be destroyed.
+     */
+    void removeViewportRect(const void *view);
+
+    /**
+     * The number of levels of detail that should be added to the level
+     * chosen by the zoom to keep the latency of the updates within the
+     * budget. Always zero if the adaptive level of detail is disabled.
+     *
+     * \see KisAdaptiveLodController
+     */
+    int adaptiveLevelOfDetailOffset() const;
+
     /**
      * Explicitly start regeneration of LoD planes of all the devices
      * in the image. This call should be performed when the user is idle,
@@ -214,9 +240,24 @@ public:
     int currentLevelOfDetail() const;
 
     void continueUpdate(const QRect &rect);
+    void reportUpdateLatency(qint64 msec);
     void doSomeUsefulWork();
     void spareThreadAppeared();
 
+    /**
+     * Processes the queues until no more passes are requested. The
+     * caller must be the one that has incremented the requests counter
+     * from zero. Called by the updater context on a worker thread.
+     */
+    void processQueuesPass();
+
+Q_SIGNALS:
+    /**
+     * Emitted (from a worker thread) when the adaptive level of
+     * detail offset changes
+     */
+    void sigAdaptiveLevelOfDetailChanged();
+
 protected:
     // Trivial constructor for testing support
     KisUpdateScheduler();
@@ -233,6 +274,7 @@ private:
     friend class UpdatesBlockTester;
     bool haveUpdatesRunning();
     void tryProcessUpdatesQueue();
+    void processQueuesOrRequestAnotherPass();
     void wakeUpWaitingThreads();
 
     void progressUpdate();
@@ -7,7 +7,7 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
+#include <QRunnable>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
@@ -27,7 +27,7 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *par
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 
     if (m_testingMode) {
         clear();
@@ -149,7 +149,12 @@ void KisUpdaterContext::startThread(int index)
         m_numRunningThreads++;
     }
 
-    m_threadPool.start(m_jobs[index]);
+    /**
+     * The stroke jobs define the latency of the brush, so they
+     * are sent to the performance cores of a hybrid CPU
+     */
+    m_executor.start(m_jobs[index],
+                     m_jobs[index]->type() == KisUpdateJobItem::Type::STROKE);
 }
 
 /**
@@ -214,6 +219,33 @@ void KisUpdaterContext::waitForDone()
     }
 }
 
+int KisUpdaterContext::numFinishedJobs() const
+{
+    return m_numFinishedJobs.load();
+}
+
+bool KisUpdaterContext::waitForJobFinished(int numFinishedJobs)
+{
+    QMutexLocker l(&m_runningThreadsMutex);
+
+    /**
+     * The waiters counter is incremented before reading the number
+     * of finished jobs, jobFinished() does it in reverse order, so
+     * the wakeup will not be missed
+     */
+    m_numJobFinishedWaiters++;
+
+    while (m_numFinishedJobs.load() == numFinishedJobs &&
+           m_numRunningThreads > 0) {
+
+        m_waitForDoneCondition.wait(l.mutex());
+    }
+
+    m_numJobFinishedWaiters--;
+
+    return m_numFinishedJobs.load() != numFinishedJobs;
+}
+
 bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                             const KisUpdateJobItem* job)
 {
@@ -247,13 +279,16 @@ void KisUpdaterContext::unlock()
 
 void KisUpdaterContext::setThreadsLimit(int value)
 {
-    m_threadPool.setMaxThreadCount(value);
-
     for (int i = 0; i < m_jobs.size(); i++) {
         KIS_SAFE_ASSERT_RECOVER_RETURN(!m_jobs[i]->isRunning());
         // don't delete the jobs until all of them are checked!
     }
 
+    m_executor.setThreadCount(value,
+                              KisThreadAffinity::placeWorkers(value,
+                                                              m_threadAffinityOptions,
+                                                              KisThreadAffinity::cpuTopology()));
+
     for (int i = 0; i < m_jobs.size(); i++) {
         delete m_jobs[i];
     }
@@ -267,15 +302,30 @@ void KisUpdaterContext::setThreadsLimit(int value)
 
 int KisUpdaterContext::threadsLimit() const
 {
-    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_threadPool.maxThreadCount());
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_executor.threadCount());
     return m_jobs.size();
 }
 
+void KisUpdaterContext::setThreadAffinityOptions(const KisThreadAffinity::Options &options)
+{
+    m_threadAffinityOptions = options;
+}
+
+KisThreadAffinity::Options KisUpdaterContext::threadAffinityOptions() const
+{
+    return m_threadAffinityOptions;
+}
+
 void KisUpdaterContext::continueUpdate(const QRect& rc)
 {
     if (m_scheduler) m_scheduler->continueUpdate(rc);
 }
 
+void KisUpdaterContext::reportUpdateLatency(qint64 msec)
+{
+    if (m_scheduler) m_scheduler->reportUpdateLatency(msec);
+}
+
 void KisUpdaterContext::doSomeUsefulWork()
 {
     if (m_scheduler) m_scheduler->doSomeUsefulWork();
@@ -285,6 +335,13 @@ void KisUpdaterContext::jobFinished()
 {
     m_lodCounter.removeLod();
     if (m_scheduler) m_scheduler->spareThreadAppeared();
+
+    m_numFinishedJobs++;
+
+    if (m_numJobFinishedWaiters.load() > 0) {
+        QMutexLocker l(&m_runningThreadsMutex);
+        m_waitForDoneCondition.wakeAll();
+    }
 }
 
 void KisUpdaterContext::jobThreadExited()
@@ -298,6 +355,42 @@ void KisUpdaterContext::jobThreadExited()
     }
 }
 
+namespace {
+struct ProcessQueuesPassRunnable : public QRunnable
+{
+    ProcessQueuesPassRunnable(KisUpdaterContext *context, KisUpdateScheduler *scheduler)
+        : m_context(context),
+          m_scheduler(scheduler)
+    {
+    }
+
+    void run() override {
+        m_scheduler->processQueuesPass();
+        m_context->jobThreadExited();
+    }
+
+    KisUpdaterContext *m_context;
+    KisUpdateScheduler *m_scheduler;
+};
+}
+
+void KisUpdaterContext::startProcessQueuesPass()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_scheduler);
+
+    if (m_testingMode) {
+        m_scheduler->processQueuesPass();
+        return;
+    }
+
+    {
+        QMutexLocker l(&m_runningThreadsMutex);
+        m_numRunningThreads++;
+    }
+
+    m_executor.start(new ProcessQueuesPassRunnable(this, m_scheduler));
+}
+
 void KisUpdaterContext::setTestingMode(bool value)
 {
     m_testingMode = value;
@@ -7,14 +7,16 @@
 #ifndef __KIS_UPDATER_CONTEXT_H
 #define __KIS_UPDATER_CONTEXT_H
 
+#include <atomic>
+
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 #include <QWaitCondition>
 
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_lock_free_lod_counter.h"
+#include "KisWorkStealingExecutor.h"
 
 #include "KisUpdaterContextSnapshotEx.h"
 #include "kis_update_scheduler.h"
@@ -98,6 +100,20 @@ public:
      */
     void waitForDone();
 
+    /**
+     * Returns the number of jobs finished since the creation of
+     * the context (wraps around on overflow)
+     */
+    int numFinishedJobs() const;
+
+    /**
+     * Block execution of the caller until at least one more job is
+     * finished after numFinishedJobs() returned \p numFinishedJobs.
+     * Returns false if the context became idle without finishing
+     * any new jobs.
+     */
+    bool waitForJobFinished(int numFinishedJobs);
+
     /**
      * Locks the context to guarantee an exclusive access
      * to the context
@@ -127,11 +143,28 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Sets the way the threads of the context are pinned to the CPU cores.
+     * The options are applied on the next call to setThreadsLimit(), so
+     * the same locking requirements apply.
+     */
+    void setThreadAffinityOptions(const KisThreadAffinity::Options &options);
+    KisThreadAffinity::Options threadAffinityOptions() const;
+
     void continueUpdate(const QRect& rc);
+    void reportUpdateLatency(qint64 msec);
     void doSomeUsefulWork();
     void jobFinished();
     void jobThreadExited();
 
+    /**
+     * Runs KisUpdateScheduler::processQueuesPass() on one of the
+     * worker threads. The pass is accounted as a running thread, so
+     * waitForDone() waits for it as well. In testing mode the pass
+     * is executed synchronously.
+     */
+    void startProcessQueuesPass();
+
     void setTestingMode(bool value);
 
 protected:
@@ -151,11 +184,14 @@ protected:
     QMutex m_lock;
     QMutex m_runningThreadsMutex;
     int m_numRunningThreads = 0;
+    std::atomic<int> m_numFinishedJobs {0};
+    std::atomic<int> m_numJobFinishedWaiters {0};
     QWaitCondition m_waitForDoneCondition;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    KisWorkStealingExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
     KisUpdateScheduler *m_scheduler;
+    KisThreadAffinity::Options m_threadAffinityOptions;
     bool m_testingMode = false;
 
 private:
@@ -0,0 +1,117 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAdaptiveLodControllerTest.h"
+
+#include <simpletest.h>
+
+#include "KisAdaptiveLodController.h"
+
+
+namespace {
+
+/**
+ * Reports \p numSamples equal latencies and returns the number
+ * of times the controller changed its suggestion
+ */
+int reportSamples(KisAdaptiveLodController &controller, qint64 latency, int numSamples)
+{
+    int numChanges = 0;
+
+    for (int i = 0; i < numSamples; i++) {
+        if (controller.reportLatency(latency)) {
+            numChanges++;
+        }
+    }
+
+    return numChanges;
+}
+
+}
+
+void KisAdaptiveLodControllerTest::testDisabled()
+{
+    KisAdaptiveLodController controller;
+    controller.setLatencyBudget(40);
+
+    QCOMPARE(reportSamples(controller, 1000, 10 * KisAdaptiveLodController::minSamples), 0);
+    QCOMPARE(controller.lodOffset(), 0);
+}
+
+void KisAdaptiveLodControllerTest::testIncreaseOffset()
+{
+    KisAdaptiveLodController controller;
+    controller.setLatencyBudget(40);
+    controller.setMaxLodOffset(2);
+    controller.setEnabled(true);
+
+    // not enough samples to make a decision
+    QCOMPARE(reportSamples(controller, 100, KisAdaptiveLodController::minSamples - 1), 0);
+    QCOMPARE(controller.lodOffset(), 0);
+
+    QCOMPARE(reportSamples(controller, 100, 1), 1);
+    QCOMPARE(controller.lodOffset(), 1);
+
+    // the old samples are dropped after every change
+    QCOMPARE(reportSamples(controller, 100, KisAdaptiveLodController::minSamples - 1), 0);
+    QCOMPARE(controller.lodOffset(), 1);
+
+    QCOMPARE(reportSamples(controller, 100, 1), 1);
+    QCOMPARE(controller.lodOffset(), 2);
+
+    // disabling resets the suggestion
+    controller.setEnabled(false);
+    QCOMPARE(controller.lodOffset(), 0);
+}
+
+void KisAdaptiveLodControllerTest::testMaxOffset()
+{
+    KisAdaptiveLodController controller;
+    controller.setLatencyBudget(40);
+    controller.setMaxLodOffset(1);
+    controller.setEnabled(true);
+
+    QCOMPARE(reportSamples(controller, 100, 10 * KisAdaptiveLodController::minSamples), 1);
+    QCOMPARE(controller.lodOffset(), 1);
+
+    controller.setMaxLodOffset(0);
+    QCOMPARE(controller.lodOffset(), 0);
+}
+
+void KisAdaptiveLodControllerTest::testDecreaseOffset()
+{
+    KisAdaptiveLodController controller;
+    controller.setLatencyBudget(40);
+    controller.setMaxLodOffset(2);
+    controller.setEnabled(true);
+
+    QCOMPARE(reportSamples(controller, 100, 2 * KisAdaptiveLodController::minSamples), 2);
+    QCOMPARE(controller.lodOffset(), 2);
+
+    QCOMPARE(reportSamples(controller, 5, 2 * KisAdaptiveLodController::minSamples), 2);
+    QCOMPARE(controller.lodOffset(), 0);
+}
+
+void KisAdaptiveLodControllerTest::testNoOscillation()
+{
+    KisAdaptiveLodController controller;
+    controller.setLatencyBudget(40);
+    controller.setMaxLodOffset(2);
+    controller.setEnabled(true);
+
+    QCOMPARE(reportSamples(controller, 100, KisAdaptiveLodController::minSamples), 1);
+    QCOMPARE(controller.lodOffset(), 1);
+
+    /**
+     * The latency fits the budget now, but it would not fit
+     * it on the lower level of detail, so the controller
+     * should stay on the current level
+     */
+    QCOMPARE(reportSamples(controller, 25, 10 * KisAdaptiveLodController::minSamples), 0);
+    QCOMPARE(controller.lodOffset(), 1);
+}
+
+SIMPLE_TEST_MAIN(KisAdaptiveLodControllerTest)
@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISADAPTIVELODCONTROLLERTEST_H
+#define KISADAPTIVELODCONTROLLERTEST_H
+
+#include <QtTest>
+#include <QObject>
+
+class KisAdaptiveLodControllerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testDisabled();
+    void testIncreaseOffset();
+    void testMaxOffset();
+    void testDecreaseOffset();
+    void testNoOscillation();
+};
+
+#endif // KISADAPTIVELODCONTROLLERTEST_H
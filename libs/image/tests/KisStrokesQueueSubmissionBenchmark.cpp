@@ -0,0 +1,123 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokesQueueSubmissionBenchmark.h"
+
+#include <simpletest.h>
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <numeric>
+
+#include "kis_image.h"
+#include "kis_simple_stroke_strategy.h"
+#include "kis_debug.h"
+
+namespace {
+
+const int NUM_EVENTS = 3000;
+
+class SpinningStrokeStrategy : public KisSimpleStrokeStrategy
+{
+public:
+    SpinningStrokeStrategy(int jobDurationUs)
+        : KisSimpleStrokeStrategy(QLatin1String("SpinningStrokeStrategy")),
+          m_jobDurationNs(qint64(jobDurationUs) * 1000)
+    {
+        enableJob(KisSimpleStrokeStrategy::JOB_DOSTROKE, true, KisStrokeJobData::CONCURRENT);
+    }
+
+    void doStrokeCallback(KisStrokeJobData *data) override {
+        Q_UNUSED(data);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while (timer.nsecsElapsed() < m_jobDurationNs);
+    }
+
+private:
+    qint64 m_jobDurationNs;
+};
+
+void spinFor(qint64 nsec)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.nsecsElapsed() < nsec);
+}
+
+}
+
+void KisStrokesQueueSubmissionBenchmark::runBenchmark(int eventRate, int jobDurationUs)
+{
+    KisImageSP image = new KisImage(0, 1000, 1000, 0, "submission benchmark image");
+
+    /**
+     * Wait until the image has completed all its initial updates
+     */
+    image->waitForDone();
+
+    QVector<qint64> blockingTimes;
+    blockingTimes.reserve(NUM_EVENTS);
+
+    const qint64 eventInterval = eventRate > 0 ? 1000000000 / eventRate : 0;
+
+    KisStrokeId id = image->startStroke(new SpinningStrokeStrategy(jobDurationUs));
+
+    QElapsedTimer eventTimer;
+    eventTimer.start();
+
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        QElapsedTimer timer;
+        timer.start();
+
+        image->addJob(id, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+        blockingTimes.append(timer.nsecsElapsed());
+
+        // emulate the rate of the tablet events
+        spinFor(qint64(i + 1) * eventInterval - eventTimer.nsecsElapsed());
+    }
+
+    const qint64 submissionTime = eventTimer.elapsed();
+
+    image->endStroke(id);
+    image->waitForDone();
+
+    std::sort(blockingTimes.begin(), blockingTimes.end());
+
+    const qint64 totalTime = std::accumulate(blockingTimes.begin(), blockingTimes.end(), qint64(0));
+
+    qDebug() << "Rate:" << (eventRate > 0 ? QString("%1 Hz").arg(eventRate) : QString("burst"))
+             << "job:" << jobDurationUs << "us"
+             << "threads:" << image->workingThreadsLimit();
+    qDebug() << "    blocking time per event (us):"
+             << "mean" << qreal(totalTime) / blockingTimes.size() / 1000.0
+             << "median" << blockingTimes[blockingTimes.size() / 2] / 1000.0
+             << "p99" << blockingTimes[blockingTimes.size() * 99 / 100] / 1000.0
+             << "max" << blockingTimes.last() / 1000.0;
+    qDebug() << "    submission took" << submissionTime << "ms";
+}
+
+void KisStrokesQueueSubmissionBenchmark::benchmarkTablet1000Hz()
+{
+    runBenchmark(1000, 500);
+}
+
+void KisStrokesQueueSubmissionBenchmark::benchmarkTablet1000HzShortJobs()
+{
+    runBenchmark(1000, 20);
+}
+
+void KisStrokesQueueSubmissionBenchmark::benchmarkBurst()
+{
+    runBenchmark(0, 20);
+}
+
+SIMPLE_TEST_MAIN(KisStrokesQueueSubmissionBenchmark)
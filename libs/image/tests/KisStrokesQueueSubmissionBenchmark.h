@@ -0,0 +1,31 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKESQUEUESUBMISSIONBENCHMARK_H
+#define KISSTROKESQUEUESUBMISSIONBENCHMARK_H
+
+#include <QtTest>
+#include <QObject>
+
+/**
+ * Measures how long the GUI thread is blocked in KisImage::addJob()
+ * while the worker threads are busy with a stroke, that is, the
+ * latency a tablet event handler sees on every event.
+ */
+class KisStrokesQueueSubmissionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    void runBenchmark(int eventRate, int jobDurationUs);
+
+private Q_SLOTS:
+    void benchmarkTablet1000Hz();
+    void benchmarkTablet1000HzShortJobs();
+    void benchmarkBurst();
+};
+
+#endif // KISSTROKESQUEUESUBMISSIONBENCHMARK_H
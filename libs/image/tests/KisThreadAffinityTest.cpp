@@ -0,0 +1,237 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisThreadAffinityTest.h"
+
+#include <simpletest.h>
+
+#include <QRunnable>
+
+#include "KisThreadAffinity.h"
+#include "KisWorkStealingExecutor.h"
+
+
+namespace {
+
+KisThreadAffinity::CpuTopology hybridTopology()
+{
+    // 4 performance cores and 4 efficient ones
+    KisThreadAffinity::CpuTopology topology;
+    topology.availableCores = {0, 1, 2, 3, 4, 5, 6, 7};
+    topology.performanceCores = {0, 1, 2, 3};
+    return topology;
+}
+
+QVector<int> placedCores(const QVector<KisThreadAffinity::WorkerPlacement> &placement)
+{
+    QVector<int> result;
+    Q_FOREACH (const KisThreadAffinity::WorkerPlacement &worker, placement) {
+        result.append(worker.core);
+    }
+    return result;
+}
+
+}
+
+void KisThreadAffinityTest::testParseCpuList()
+{
+    QCOMPARE(KisThreadAffinity::parseCpuList(""), QVector<int>());
+    QCOMPARE(KisThreadAffinity::parseCpuList("3"), QVector<int>({3}));
+    QCOMPARE(KisThreadAffinity::parseCpuList("0-3"), QVector<int>({0, 1, 2, 3}));
+    QCOMPARE(KisThreadAffinity::parseCpuList("8, 0-2,10-11\n"), QVector<int>({0, 1, 2, 8, 10, 11}));
+    QCOMPARE(KisThreadAffinity::parseCpuList("1-2,2-3"), QVector<int>({1, 2, 3}));
+
+    // invalid entries are skipped
+    QCOMPARE(KisThreadAffinity::parseCpuList("a,3-1,4-x,1-2-3,5"), QVector<int>({5}));
+    QCOMPARE(KisThreadAffinity::parseCpuList("0-2000000000"), QVector<int>());
+}
+
+void KisThreadAffinityTest::testFormatCpuList()
+{
+    QCOMPARE(KisThreadAffinity::formatCpuList({}), QString());
+    QCOMPARE(KisThreadAffinity::formatCpuList({0, 1, 2, 3}), QString("0-3"));
+    QCOMPARE(KisThreadAffinity::formatCpuList({10, 8, 0, 1, 11, 1}), QString("0-1,8,10-11"));
+
+    const QString list("0-2,5,7-9");
+    QCOMPARE(KisThreadAffinity::formatCpuList(KisThreadAffinity::parseCpuList(list)), list);
+}
+
+void KisThreadAffinityTest::testNotPinned()
+{
+    KisThreadAffinity::Options options;
+    options.pinThreads = false;
+
+    const QVector<KisThreadAffinity::WorkerPlacement> placement =
+        KisThreadAffinity::placeWorkers(4, options, hybridTopology());
+
+    QCOMPARE(placement.size(), 4);
+    QCOMPARE(placedCores(placement), QVector<int>({-1, -1, -1, -1}));
+}
+
+void KisThreadAffinityTest::testKeepGuiCoreFree()
+{
+    KisThreadAffinity::CpuTopology topology;
+    topology.availableCores = {0, 1, 2, 3};
+
+    KisThreadAffinity::Options options;
+    options.pinThreads = true;
+
+    options.keepGuiCoreFree = true;
+    QCOMPARE(placedCores(KisThreadAffinity::placeWorkers(3, options, topology)),
+             QVector<int>({1, 2, 3}));
+
+    options.keepGuiCoreFree = false;
+    QCOMPARE(placedCores(KisThreadAffinity::placeWorkers(3, options, topology)),
+             QVector<int>({0, 1, 2}));
+
+    // a single core cannot be left free
+    topology.availableCores = {5};
+    options.keepGuiCoreFree = true;
+    QCOMPARE(placedCores(KisThreadAffinity::placeWorkers(2, options, topology)),
+             QVector<int>({5, -1}));
+}
+
+void KisThreadAffinityTest::testAllowedCores()
+{
+    KisThreadAffinity::CpuTopology topology;
+    topology.availableCores = {0, 1, 2, 3, 4, 5, 6, 7};
+
+    KisThreadAffinity::Options options;
+    options.pinThreads = true;
+    options.keepGuiCoreFree = false;
+    options.allowedCores = {6, 4, 12};
+
+    QCOMPARE(placedCores(KisThreadAffinity::placeWorkers(2, options, topology)),
+             QVector<int>({4, 6}));
+
+    // none of the allowed cores is available, the list is ignored
+    options.allowedCores = {12, 13};
+    QCOMPARE(placedCores(KisThreadAffinity::placeWorkers(2, options, topology)),
+             QVector<int>({0, 1}));
+}
+
+void KisThreadAffinityTest::testPerformanceCores()
+{
+    KisThreadAffinity::CpuTopology topology = hybridTopology();
+
+    // the efficient cores are listed first in the system
+    topology.performanceCores = {4, 5, 6, 7};
+
+    KisThreadAffinity::Options options;
+    options.pinThreads = true;
+    options.keepGuiCoreFree = true;
+    options.preferPerformanceCores = true;
+
+    QVector<KisThreadAffinity::WorkerPlacement> placement =
+        KisThreadAffinity::placeWorkers(5, options, topology);
+
+    // the first performance core is left for the GUI
+    QCOMPARE(placedCores(placement), QVector<int>({5, 6, 7, 0, 1}));
+
+    QVector<bool> isPerformanceCore;
+    Q_FOREACH (const KisThreadAffinity::WorkerPlacement &worker, placement) {
+        isPerformanceCore.append(worker.isPerformanceCore);
+    }
+    QCOMPARE(isPerformanceCore, QVector<bool>({true, true, true, false, false}));
+
+    options.preferPerformanceCores = false;
+    placement = KisThreadAffinity::placeWorkers(5, options, topology);
+
+    QCOMPARE(placedCores(placement), QVector<int>({1, 2, 3, 4, 5}));
+    Q_FOREACH (const KisThreadAffinity::WorkerPlacement &worker, placement) {
+        QVERIFY(!worker.isPerformanceCore);
+    }
+}
+
+void KisThreadAffinityTest::testMoreWorkersThanCores()
+{
+    KisThreadAffinity::CpuTopology topology;
+    topology.availableCores = {0, 1, 2};
+
+    KisThreadAffinity::Options options;
+    options.pinThreads = true;
+    options.keepGuiCoreFree = true;
+
+    QVector<KisThreadAffinity::WorkerPlacement> placement =
+        KisThreadAffinity::placeWorkers(5, options, topology);
+
+    QCOMPARE(placedCores(placement), QVector<int>({1, 2, -1, -1, -1}));
+
+    // the unpinned workers still keep off the GUI core
+    QCOMPARE(placement[0].allowedCores, QVector<int>());
+    QCOMPARE(placement[1].allowedCores, QVector<int>());
+    for (int i = 2; i < placement.size(); i++) {
+        QCOMPARE(placement[i].allowedCores, QVector<int>({1, 2}));
+    }
+
+    options.keepGuiCoreFree = false;
+    placement = KisThreadAffinity::placeWorkers(5, options, topology);
+
+    QCOMPARE(placedCores(placement), QVector<int>({0, 1, 2, -1, -1}));
+
+    // all the cores are allowed, no need to restrict anything
+    Q_FOREACH (const KisThreadAffinity::WorkerPlacement &worker, placement) {
+        QCOMPARE(worker.allowedCores, QVector<int>());
+    }
+
+    // the workers may not escape the cores allowed by the user
+    options.allowedCores = {1, 2};
+    placement = KisThreadAffinity::placeWorkers(3, options, topology);
+
+    QCOMPARE(placedCores(placement), QVector<int>({1, 2, -1}));
+    QCOMPARE(placement[2].allowedCores, QVector<int>({1, 2}));
+}
+
+namespace {
+struct CountingRunnable : public QRunnable
+{
+    CountingRunnable(QAtomicInt &counter) : m_counter(counter) {}
+
+    void run() override {
+        m_counter.ref();
+    }
+
+    QAtomicInt &m_counter;
+};
+}
+
+void KisThreadAffinityTest::testExecutorPlacement()
+{
+    const KisThreadAffinity::CpuTopology topology = KisThreadAffinity::cpuTopology();
+    QVERIFY(!topology.availableCores.isEmpty());
+
+    KisThreadAffinity::Options options;
+    options.pinThreads = true;
+    options.keepGuiCoreFree = false;
+
+    QVector<KisThreadAffinity::WorkerPlacement> placement =
+        KisThreadAffinity::placeWorkers(2, options, topology);
+
+    // pretend the first worker runs on a performance core
+    placement[0].isPerformanceCore = true;
+
+    KisWorkStealingExecutor executor(2);
+    executor.setThreadCount(2, placement);
+    QCOMPARE(executor.workerPlacement(), placement);
+
+    QAtomicInt counter;
+
+    for (int i = 0; i < 100; i++) {
+        CountingRunnable *runnable = new CountingRunnable(counter);
+        runnable->setAutoDelete(true);
+        executor.start(runnable, i % 2);
+    }
+
+    executor.waitForDone();
+    QCOMPARE(counter.loadAcquire(), 100);
+
+    // resetting the placement restarts the workers unpinned
+    executor.setThreadCount(2);
+    QCOMPARE(executor.workerPlacement(),
+             QVector<KisThreadAffinity::WorkerPlacement>(2));
+}
+
+SIMPLE_TEST_MAIN(KisThreadAffinityTest)
@@ -0,0 +1,28 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTHREADAFFINITYTEST_H
+#define KISTHREADAFFINITYTEST_H
+
+#include <QtTest>
+#include <QObject>
+
+class KisThreadAffinityTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testParseCpuList();
+    void testFormatCpuList();
+    void testNotPinned();
+    void testKeepGuiCoreFree();
+    void testAllowedCores();
+    void testPerformanceCores();
+    void testMoreWorkersThanCores();
+    void testExecutorPlacement();
+};
+
+#endif // KISTHREADAFFINITYTEST_H
@@ -0,0 +1,179 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateTracerTest.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QThread>
+
+#include <simpletest.h>
+
+#include "KisUpdateTracer.h"
+
+
+void KisUpdateTracerTest::init()
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+    tracer->setCapacity(1024);
+    tracer->clear();
+    tracer->setEnabled(true);
+}
+
+void KisUpdateTracerTest::cleanup()
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+    tracer->setEnabled(false);
+    tracer->clear();
+}
+
+void KisUpdateTracerTest::testRingBuffer()
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+    tracer->setCapacity(4);
+
+    for (int i = 0; i < 6; i++) {
+        tracer->addEvent(KisUpdateTracer::MergeJob, QString::number(i), 10 * i, 10 * i + 5);
+    }
+
+    QVector<KisUpdateTracer::Event> events = tracer->events();
+    QCOMPARE(events.size(), 4);
+
+    for (int i = 0; i < events.size(); i++) {
+        QCOMPARE(events[i].name, QString::number(i + 2));
+        QCOMPARE(events[i].startTime, qint64(10 * (i + 2)));
+        QCOMPARE(events[i].category, KisUpdateTracer::MergeJob);
+        QCOMPARE(tracer->threadName(events[i].threadIndex), QString("GUI Thread"));
+    }
+
+    tracer->clear();
+    QVERIFY(tracer->events().isEmpty());
+}
+
+void KisUpdateTracerTest::testScope()
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+
+    tracer->setEnabled(false);
+
+    {
+        KisUpdateTraceScope scope(KisUpdateTracer::StrokeJob, "disabled");
+        QVERIFY(!scope.isActive());
+    }
+
+    QVERIFY(tracer->events().isEmpty());
+
+    tracer->setEnabled(true);
+
+    {
+        KisUpdateTraceScope scope(KisUpdateTracer::TileSwapIn, QRect(0, 0, 64, 64));
+        QVERIFY(scope.isActive());
+        scope.setName("swap");
+        QTest::qSleep(1);
+    }
+
+    QVector<KisUpdateTracer::Event> events = tracer->events();
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].category, KisUpdateTracer::TileSwapIn);
+    QCOMPARE(events[0].name, QString("swap"));
+    QCOMPARE(events[0].rect, QRect(0, 0, 64, 64));
+    QVERIFY(events[0].endTime > events[0].startTime);
+}
+
+void KisUpdateTracerTest::testChromeTraceJson()
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+
+    tracer->addEvent(KisUpdateTracer::StrokeJob, "dab", 1000, 3500, QRect(10, 20, 30, 40));
+    tracer->addEvent(KisUpdateTracer::TextureUpload, QString(), 4000, 5000);
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(tracer->toChromeTraceJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QJsonArray traceEvents = doc.object()["traceEvents"].toArray();
+
+    QVector<QJsonObject> metadataEvents;
+    QVector<QJsonObject> completeEvents;
+
+    Q_FOREACH (const QJsonValue &value, traceEvents) {
+        const QJsonObject object = value.toObject();
+        if (object["ph"].toString() == "M") {
+            metadataEvents << object;
+        } else if (object["ph"].toString() == "X") {
+            completeEvents << object;
+        }
+    }
+
+    QCOMPARE(metadataEvents.size(), 1);
+    QCOMPARE(metadataEvents[0]["name"].toString(), QString("thread_name"));
+    QCOMPARE(metadataEvents[0]["args"].toObject()["name"].toString(), QString("GUI Thread"));
+
+    QCOMPARE(completeEvents.size(), 2);
+
+    QCOMPARE(completeEvents[0]["name"].toString(), QString("dab"));
+    QCOMPARE(completeEvents[0]["cat"].toString(), QString("stroke"));
+    QCOMPARE(completeEvents[0]["ts"].toDouble(), 1.0);
+    QCOMPARE(completeEvents[0]["dur"].toDouble(), 2.5);
+    QCOMPARE(completeEvents[0]["tid"].toInt(), metadataEvents[0]["tid"].toInt());
+    QCOMPARE(completeEvents[0]["args"].toObject()["width"].toInt(), 30);
+
+    // the unnamed events are named after their category
+    QCOMPARE(completeEvents[1]["name"].toString(), QString("texture-upload"));
+    QVERIFY(!completeEvents[1].contains("args"));
+}
+
+void KisUpdateTracerTest::testThreads()
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+    tracer->setCapacity(8);
+
+    const int numThreads = 4;
+    const int numEvents = 12;
+
+    /**
+     * The threads are run one after another, so the OS is free
+     * to reuse the native id of a finished thread for the next
+     * one, but the tracer should still tell them apart
+     */
+    for (int i = 0; i < numThreads; i++) {
+        QScopedPointer<QThread> thread(
+            QThread::create([tracer, i] () {
+                for (int j = 0; j < numEvents; j++) {
+                    const qint64 time = tracer->currentTime();
+                    tracer->addEvent(KisUpdateTracer::MergeJob, QString::number(i), time, time);
+                }
+            }));
+
+        thread->setObjectName(QString("Worker %1").arg(i));
+        thread->start();
+        QVERIFY(thread->wait(10000));
+    }
+
+    const QVector<KisUpdateTracer::Event> events = tracer->events();
+
+    // every thread keeps only the last 8 events
+    QCOMPARE(events.size(), numThreads * 8);
+
+    QSet<int> threadIndexes;
+
+    for (int i = 0; i < events.size(); i++) {
+        if (i > 0) {
+            QVERIFY(events[i].endTime >= events[i - 1].endTime);
+        }
+
+        QCOMPARE(tracer->threadName(events[i].threadIndex),
+                 QString("Worker %1").arg(events[i].name));
+
+        threadIndexes.insert(events[i].threadIndex);
+    }
+
+    QCOMPARE(threadIndexes.size(), numThreads);
+}
+
+SIMPLE_TEST_MAIN(KisUpdateTracerTest)
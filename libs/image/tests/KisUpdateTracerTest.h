@@ -0,0 +1,27 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATETRACERTEST_H
+#define KISUPDATETRACERTEST_H
+
+#include <QtTest>
+#include <QObject>
+
+class KisUpdateTracerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testRingBuffer();
+    void testScope();
+    void testChromeTraceJson();
+    void testThreads();
+};
+
+#endif // KISUPDATETRACERTEST_H
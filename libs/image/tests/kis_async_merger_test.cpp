@@ -21,6 +21,8 @@
 #include "kis_filter_mask.h"
 #include "kis_selection.h"
 #include "kis_paint_device_debug_utils.h"
+#include "KisBelowLayersCache.h"
+#include <KoCompositeOpRegistry.h>
 #include <KisGlobalResourcesInterface.h>
 
 #include "filter/kis_filter.h"
@@ -496,6 +498,186 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
                                   "async_merger_test", "mask_on_adj", "initial", 3));
 }
 
+    /*
+      +-----------+
+      |root       |
+      | paint 5   |
+      | paint 4   | <-- updated layer
+      | paint 3   |
+      | paint 2   |
+      | paint 1   |
+      +-----------+
+     */
 
-SIMPLE_TEST_MAIN(KisAsyncMergerTest)
+void KisAsyncMergerTest::testBelowLayersCache()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 256, 256, cs, "below layers cache test");
+
+    const QRect fillRect(20, 20, 200, 200);
+    const QRect updateRect(0, 0, 128, 256);
+
+    QVector<KisPaintLayerSP> layers;
+    const QVector<QColor> colors({Qt::red, Qt::green, Qt::blue, Qt::yellow, Qt::magenta});
+
+    for (int i = 0; i < colors.size(); i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i + 1), 150);
+        layer->paintDevice()->fill(fillRect.translated(i * 7, i * 5), KoColor(colors[i], cs));
+        image->addNode(layer, image->rootLayer());
+        layers << layer;
+    }
+
+    layers[1]->setCompositeOpId(COMPOSITE_MULT);
+    image->waitForDone();
+
+    KisGroupLayer *root = image->rootLayer().data();
+    KisBelowLayersCache *cache = root->belowLayersCache();
+
+    auto referenceProjection = [&] () -> KisPaintDeviceSP {
+        KisBelowLayersCache::setEnabled(false);
+
+        KisFullRefreshWalker walker(image->bounds());
+        KisAsyncMerger merger;
+        walker.collectRects(root, image->bounds());
+        merger.startMerge(walker);
+
+        KisBelowLayersCache::setEnabled(true);
+
+        return new KisPaintDevice(*root->projection());
+    };
+
+    auto mergeLayer = [&] (KisLayerSP layer, const QRect &rc) {
+        KisMergeWalker walker(image->bounds());
+        KisAsyncMerger merger;
+        walker.collectRects(layer, rc);
+        merger.startMerge(walker);
+    };
+
+    KisBelowLayersCache::setEnabled(true);
+    referenceProjection();
+    cache->clear();
+
+    // the first update fills the cache
+    mergeLayer(layers[3], updateRect);
+    QCOMPARE(cache->validRegion(), QRegion(updateRect));
+
+    // the second update reads from the cache
+    layers[3]->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::cyan, cs));
+    mergeLayer(layers[3], updateRect);
+    QCOMPARE(cache->validRegion(), QRegion(updateRect));
+
+    QPoint pt;
+    KisPaintDeviceSP result = new KisPaintDevice(*root->projection());
+    QVERIFY(TestUtil::comparePaintDevices(pt, result, referenceProjection()));
+
+    // the changes of the layers below the split layer invalidate the cache
+    layers[1]->paintDevice()->fill(QRect(30, 30, 50, 50), KoColor(Qt::white, cs));
+    mergeLayer(layers[1], QRect(30, 30, 50, 50));
+    QVERIFY(!cache->validRegion().intersects(QRect(30, 30, 50, 50)));
+
+    layers[3]->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::black, cs));
+    mergeLayer(layers[3], updateRect);
+    QCOMPARE(cache->validRegion(), QRegion(updateRect));
+
+    result = new KisPaintDevice(*root->projection());
+    QVERIFY(TestUtil::comparePaintDevices(pt, result, referenceProjection()));
+
+    // a layer below the split layer changes without updating the group
+    layers[0]->paintDevice()->fill(QRect(40, 40, 60, 60), KoColor(Qt::white, cs));
+
+    layers[3]->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::cyan, cs));
+    mergeLayer(layers[3], updateRect);
+    QCOMPARE(cache->validRegion(), QRegion(updateRect));
 
+    result = new KisPaintDevice(*root->projection());
+    QVERIFY(TestUtil::comparePaintDevices(pt, result, referenceProjection()));
+
+    // any change of the graph drops the cache
+    image->addNode(new KisPaintLayer(image, "paint6", OPACITY_OPAQUE_U8), image->rootLayer());
+    image->waitForDone();
+    mergeLayer(layers[0], updateRect);
+    QVERIFY(cache->isEmpty());
+
+    KisBelowLayersCache::setEnabled(false);
+}
+
+    /*
+      +-----------+
+      |root       |
+      | paint 8   |
+      | paint 7   |
+      | paint 6   | <-- has a filter mask
+      | paint 5   |
+      | paint 4   | <-- hidden
+      | paint 3   | <-- inherits alpha
+      | paint 2   | <-- offset by (13, 7)
+      | paint 1   | <-- updated layer
+      +-----------+
+     */
+
+void KisAsyncMergerTest::testFusedComposition()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 256, 256, cs, "fused composition test");
+
+    const QRect fillRect(20, 20, 200, 200);
+
+    QVector<KisPaintLayerSP> layers;
+    const QVector<QColor> colors({Qt::red, Qt::green, Qt::blue, Qt::yellow,
+                                  Qt::magenta, Qt::cyan, Qt::gray, Qt::darkRed});
+    const QStringList compositeOps({COMPOSITE_OVER, COMPOSITE_MULT, COMPOSITE_OVER, COMPOSITE_SCREEN,
+                                    COMPOSITE_OVERLAY, COMPOSITE_OVER, COMPOSITE_HUE, COMPOSITE_DIFF});
+
+    for (int i = 0; i < colors.size(); i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i + 1), 100 + 20 * i);
+        layer->paintDevice()->fill(fillRect.translated(i * 7, i * 5), KoColor(colors[i], cs));
+        layer->setCompositeOpId(compositeOps[i]);
+        image->addNode(layer, image->rootLayer());
+        layers << layer;
+    }
+
+    layers[1]->paintDevice()->moveTo(13, 7);
+    layers[2]->disableAlphaChannel(true);
+    layers[3]->setVisible(false);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+    KIS_ASSERT(filter);
+    KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    mask->initSelection(layers[5]);
+    mask->setFilter(configuration->cloneWithResourcesSnapshot());
+    image->addNode(mask, layers[5]);
+
+    image->initialRefreshGraph();
+
+    KisGroupLayer *root = image->rootLayer().data();
+
+    auto mergeLayer = [&] (KisLayerSP layer, const QRect &rc, bool useFusion) -> KisPaintDeviceSP {
+        KisMergeWalker walker(image->bounds());
+        KisAsyncMerger merger;
+        merger.setFusionEnabled(useFusion);
+        walker.collectRects(layer, rc);
+        merger.startMerge(walker);
+
+        return new KisPaintDevice(*root->projection());
+    };
+
+    QPoint pt;
+
+    layers[0]->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::white, cs));
+
+    KisPaintDeviceSP reference = mergeLayer(layers[0], image->bounds(), false);
+    KisPaintDeviceSP result = mergeLayer(layers[0], image->bounds(), true);
+    QVERIFY(TestUtil::comparePaintDevices(pt, result, reference));
+
+    // the update rect is not aligned to the tiles
+    const QRect updateRect(30, 17, 150, 101);
+
+    layers[4]->paintDevice()->fill(QRect(40, 40, 100, 50), KoColor(Qt::black, cs));
+
+    reference = mergeLayer(layers[4], updateRect, false);
+    result = mergeLayer(layers[4], updateRect, true);
+    QVERIFY(TestUtil::comparePaintDevices(pt, result, reference));
+}
+
+SIMPLE_TEST_MAIN(KisAsyncMergerTest)
@@ -1537,6 +1537,87 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+void syncLodCacheIncrementally(KisPaintDeviceSP dev, int levelOfDetail, KisRegion *syncedRegion = 0)
+{
+    QScopedPointer<KisPaintDevice::LodDataStruct> s(dev->createLodDataStruct(levelOfDetail));
+
+    KisRegion region = dev->regionForLodSyncing(s.data());
+    Q_FOREACH(QRect rect2, KritaUtils::splitRegionIntoPatches(region, KritaUtils::optimalPatchSize())) {
+        dev->updateLodDataStruct(s.data(), rect2);
+    }
+
+    dev->uploadLodDataStruct(s.data());
+
+    if (syncedRegion) {
+        *syncedRegion = region;
+    }
+}
+
+void KisPaintDeviceTest::testIncrementalLodSync()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(QRect(0,0,256,256));
+    dev->setDefaultBounds(bounds);
+
+    fillGradientDevice(dev, QRect(0,0,256,256));
+
+    KisRegion syncedRegion;
+
+    // the first sync regenerates the whole plane
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCacheIncrementally(dev, 1, &syncedRegion);
+    QCOMPARE(syncedRegion.boundingRect(), QRect(0,0,256,256));
+
+    // nothing has changed since the last sync
+    syncLodCacheIncrementally(dev, 1, &syncedRegion);
+    QVERIFY(syncedRegion.isEmpty());
+
+    // only the changed tile is regenerated
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(70,10,20,20), KoColor(Qt::blue, cs));
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCacheIncrementally(dev, 1, &syncedRegion);
+    QCOMPARE(syncedRegion.boundingRect(), QRect(64,0,64,64));
+
+    // the area of the removed tiles is regenerated as well
+    bounds->testingSetLevelOfDetail(0);
+    dev->clear(QRect(128,128,128,128));
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCacheIncrementally(dev, 1, &syncedRegion);
+    QCOMPARE(syncedRegion.boundingRect(), QRect(128,128,128,128));
+
+    // a struct that has never been uploaded invalidates the plane
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(10,10,20,20), KoColor(Qt::green, cs));
+
+    bounds->testingSetLevelOfDetail(1);
+    delete dev->createLodDataStruct(1);
+
+    syncLodCacheIncrementally(dev, 1, &syncedRegion);
+    QCOMPARE(syncedRegion.boundingRect(), QRect(0,0,256,256));
+
+    // and the result is the same as the full regeneration gives
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(200,30,20,20), KoColor(Qt::yellow, cs));
+
+    // the clone shares the default bounds with the source device
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    refDev->makeCloneFromRough(dev, dev->extent());
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCacheIncrementally(dev, 1, &syncedRegion);
+    QCOMPARE(syncedRegion.boundingRect(), QRect(192,0,64,64));
+
+    syncLodCache(refDev, 1);
+
+    QCOMPARE(dev->convertToQImage(0, 0, 0, 128, 128),
+             refDev->convertToQImage(0, 0, 0, 128, 128));
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
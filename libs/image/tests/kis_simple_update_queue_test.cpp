@@ -26,6 +26,9 @@
 #include <KisGlobalResourcesInterface.h>
 
 #include "lod_override.h"
+#include "config-tile-size.h"
+
+#include <random>
 
 
 
@@ -140,6 +143,46 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testSplitIntoPatches()
+{
+    KisTestableSimpleUpdateQueue queue;
+
+    // small rects are never split
+    QCOMPARE(queue.splitIntoPatches(QRect(10,10,100,100)),
+             QVector<QRect>({QRect(10,10,100,100)}));
+
+    QVector<QRect> rects;
+    rects << QRect(-100,-100,1300,700)
+          << QRect(0,0,4000,20)
+          << QRect(3,5,1530,1021);
+
+    Q_FOREACH (const QRect &rc, rects) {
+        const QVector<QRect> patches = queue.splitIntoPatches(rc);
+        QVERIFY(patches.size() > 1);
+
+        QRegion region;
+        qint64 totalArea = 0;
+
+        Q_FOREACH (const QRect &patch, patches) {
+            QVERIFY(rc.contains(patch));
+
+            // every internal border of the patches lies on the tiles grid
+            if (patch.left() != rc.left()) {
+                QCOMPARE(patch.left() % KRITA_TILE_SIZE, 0);
+            }
+            if (patch.top() != rc.top()) {
+                QCOMPARE(patch.top() % KRITA_TILE_SIZE, 0);
+            }
+
+            region += patch;
+            totalArea += qint64(patch.width()) * patch.height();
+        }
+
+        QCOMPARE(region, QRegion(rc));
+        QCOMPARE(totalArea, qint64(rc.width()) * rc.height());
+    }
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
@@ -270,5 +313,145 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testPriorityRect()
+{
+    QRect imageRect(0,0,512,512);
+
+    QRect offscreenRect(400,400,50,50);
+    QRect visibleRect(0,0,50,50);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "priority test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    {
+        // no viewport, FIFO order
+        KisTestableUpdaterContext context(1);
+        KisTestableSimpleUpdateQueue queue;
+
+        queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+        queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+        queue.processQueue(context);
+
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), offscreenRect));
+
+        QCOMPARE(queue.getWalkersList().size(), 1);
+        QVERIFY(checkWalker(queue.getWalkersList()[0], visibleRect));
+    }
+
+    {
+        // the visible update overtakes the off-screen one
+        KisTestableUpdaterContext context(1);
+        KisTestableSimpleUpdateQueue queue;
+        queue.setPriorityRect(QRect(0,0,100,100));
+
+        queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+        queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+        queue.processQueue(context);
+
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), visibleRect));
+
+        QCOMPARE(queue.getWalkersList().size(), 1);
+        QVERIFY(checkWalker(queue.getWalkersList()[0], offscreenRect));
+    }
+
+    {
+        // the off-screen updates are still started on the idle threads
+        KisTestableUpdaterContext context(2);
+        KisTestableSimpleUpdateQueue queue;
+        queue.setPriorityRect(QRect(0,0,100,100));
+
+        queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+        queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+        queue.processQueue(context);
+
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), visibleRect));
+        QVERIFY(checkWalker(jobs[1]->walker(), offscreenRect));
+
+        QVERIFY(queue.getWalkersList().isEmpty());
+    }
+
+    {
+        // LoD walkers are compared against the scaled viewport
+        KisTestableUpdaterContext context(1);
+        KisTestableSimpleUpdateQueue queue;
+        queue.setPriorityRect(QRect(400,400,100,100));
+
+        TestUtil::LodOverride l(1, image);
+
+        const QRect lodOffscreenRect(0,0,50,50);
+        const QRect lodVisibleRect(200,200,50,50);
+
+        queue.addUpdateJob(paintLayer, lodOffscreenRect, imageRect, 1);
+        queue.addUpdateJob(paintLayer, lodVisibleRect, imageRect, 1);
+        queue.processQueue(context);
+
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), lodVisibleRect, 1));
+    }
+}
+
+void KisSimpleUpdateQueueTest::testManyRandomUpdates()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+
+    const int numUpdates = 2000;
+    QRegion requestedRegion;
+
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<int> position(-32, 1000);
+    std::uniform_int_distribution<int> size(1, 40);
+
+    for (int i = 0; i < numUpdates; i++) {
+        const QRect rc(position(generator), position(generator),
+                       size(generator), size(generator));
+
+        queue.addUpdateJob(paintLayer, rc, imageRect, 0);
+        requestedRegion += rc;
+    }
+
+    queue.optimize();
+
+    // the small updates are coalesced
+    QVERIFY(queue.getWalkersList().size() < numUpdates / 2);
+
+    // ...and none of them is lost
+    KisTestableUpdaterContext context(4);
+    QRegion processedRegion;
+
+    while (!queue.isEmpty()) {
+        queue.processQueue(context);
+
+        Q_FOREACH (KisUpdateJobItem *job, context.getJobs()) {
+            if (job->type() == KisUpdateJobItem::Type::MERGE) {
+                processedRegion += job->walker()->requestedRect();
+            }
+        }
+
+        context.clear();
+    }
+
+    QVERIFY((requestedRegion - processedRegion).isEmpty());
+}
+
 KISTEST_MAIN(KisSimpleUpdateQueueTest)
 
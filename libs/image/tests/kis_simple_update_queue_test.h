@@ -21,9 +21,12 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testSplitIntoPatches();
     void testChecksum();
     void testMixingTypes();
     void testSpontaneousJobsCompression();
+    void testPriorityRect();
+    void testManyRandomUpdates();
 };
 
 #endif /* KIS_SIMPLE_UPDATE_QUEUE_TEST_H */
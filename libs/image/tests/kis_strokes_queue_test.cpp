@@ -1127,4 +1127,50 @@ void KisStrokesQueueTest::testUniquelyConcurrentJobs()
 }
 
 
+void KisStrokesQueueTest::testPendingJobs()
+{
+    KisStrokesQueue queue;
+    KisStrokeId id = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("pnd_"), false));
+
+    QVERIFY(!queue.hasPendingJobs());
+
+    queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::SEQUENTIAL));
+    queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::SEQUENTIAL));
+
+    // the jobs are not put into the stroke until the queue is processed
+    QVERIFY(queue.hasPendingJobs());
+
+    KisTestableUpdaterContext context(2);
+    QVector<KisUpdateJobItem*> jobs;
+
+    queue.processQueue(context, false);
+    QVERIFY(!queue.hasPendingJobs());
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "pnd_init");
+    VERIFY_EMPTY(jobs[1]);
+
+    queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::SEQUENTIAL));
+
+    // ending the stroke puts the pending jobs before the finishing job
+    queue.endStroke(id);
+    QVERIFY(!queue.hasPendingJobs());
+
+    for (int i = 0; i < 3; i++) {
+        context.clear();
+        queue.processQueue(context, false);
+
+        jobs = context.getJobs();
+        COMPARE_NAME(jobs[0], "pnd_dab");
+        VERIFY_EMPTY(jobs[1]);
+    }
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "pnd_finish");
+    VERIFY_EMPTY(jobs[1]);
+}
+
 KISTEST_MAIN(KisStrokesQueueTest)
@@ -17,6 +17,7 @@
 
 #include "kis_merge_walker.h"
 #include "kis_updater_context.h"
+#include "KisWorkStealingExecutor.h"
 #include "kis_image.h"
 
 #include "scheduler_utils.h"
@@ -235,5 +236,70 @@ void KisUpdaterContextTest::stressTestExclusiveJobs()
              << "/" << NUM_CHECKS * NUM_JOBS;
 }
 
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(KisWorkStealingExecutor &executor, QAtomicInt &counter,
+                     QAtomicInt &outsideWorkers, int depth)
+        : m_executor(executor),
+          m_counter(counter),
+          m_outsideWorkers(outsideWorkers),
+          m_depth(depth)
+    {
+    }
+
+    void run() override {
+        if (m_executor.currentWorkerIndex() < 0) {
+            m_outsideWorkers.ref();
+        }
+
+        m_counter.ref();
+
+        if (m_depth > 0) {
+            for (int i = 0; i < 2; i++) {
+                m_executor.start(new SpawningRunnable(m_executor, m_counter,
+                                                      m_outsideWorkers, m_depth - 1));
+            }
+        }
+    }
+
+private:
+    KisWorkStealingExecutor &m_executor;
+    QAtomicInt &m_counter;
+    QAtomicInt &m_outsideWorkers;
+    int m_depth;
+};
+
+void KisUpdaterContextTest::testWorkStealingExecutor()
+{
+    const int depth = 10;
+    const int numTasksPerRoot = (1 << (depth + 1)) - 1;
+
+    KisWorkStealingExecutor executor(NUM_THREADS);
+    QCOMPARE(executor.threadCount(), NUM_THREADS);
+    QCOMPARE(executor.currentWorkerIndex(), -1);
+
+    QAtomicInt counter;
+    QAtomicInt outsideWorkers;
+
+    for (int i = 0; i < 4; i++) {
+        executor.start(new SpawningRunnable(executor, counter, outsideWorkers, depth));
+    }
+
+    executor.waitForDone();
+
+    QCOMPARE(int(counter), 4 * numTasksPerRoot);
+    QCOMPARE(int(outsideWorkers), 0);
+
+    executor.setThreadCount(2);
+    QCOMPARE(executor.threadCount(), 2);
+
+    counter = 0;
+    executor.start(new SpawningRunnable(executor, counter, outsideWorkers, depth));
+    executor.waitForDone();
+
+    QCOMPARE(int(counter), numTasksPerRoot);
+}
+
 KISTEST_MAIN(KisUpdaterContextTest)
 
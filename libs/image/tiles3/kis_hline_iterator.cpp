@@ -43,7 +43,10 @@ KisHLineIterator2::KisHLineIterator2(KisDataManager *dataManager, qint32 x, qint
     m_tilesCacheSize = m_rightCol - m_leftCol + 1;
     m_tilesCache.resize(m_tilesCacheSize);
 
-    m_tileWidth = m_pixelSize * KisTileData::HEIGHT;
+    m_tileWidth = m_pixelSize * KisTileData::WIDTH;
+
+    // let the prefetcher load the tiles while we are fetching the first row
+    prefetchTiles(m_row, 2);
 
     // let's preallocate first row
     for (quint32 i = 0; i < m_tilesCacheSize; i++){
@@ -201,6 +204,8 @@ void KisHLineIterator2::fetchTileDataForCache(KisTileInfo& kti, qint32 col, qint
 
 void KisHLineIterator2::preallocateTiles()
 {
+    prefetchTiles(m_row + 1, 1);
+
     for (quint32 i = 0; i < m_tilesCacheSize; ++i){
         unlockTile(m_tilesCache[i].tile);
         unlockOldTile(m_tilesCache[i].oldtile);
@@ -208,6 +213,16 @@ void KisHLineIterator2::preallocateTiles()
     }
 }
 
+void KisHLineIterator2::prefetchTiles(qint32 row, qint32 numRows)
+{
+    /**
+     * We don't know how many rows the user is going to walk
+     * through, so we just announce a few rows ahead of the cursor
+     */
+    m_dataManager->prefetchRect(QRect(m_left, row * KisTileData::HEIGHT,
+                                      m_right - m_left + 1, numRows * KisTileData::HEIGHT));
+}
+
 qint32 KisHLineIterator2::x() const
 {
     return m_x + m_offsetX;
@@ -73,5 +73,6 @@ private:
     void switchToTile(qint32 xInTile);
     void fetchTileDataForCache(KisTileInfo& kti, qint32 col, qint32 row);
     void preallocateTiles();
+    void prefetchTiles(qint32 row, qint32 numRows);
 };
 #endif
@@ -0,0 +1,268 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_memento_item.h"
+
+#include <QScopedPointer>
+
+#include "kis_assert.h"
+#include "kis_tile_data_store.h"
+#include "swap/kis_abstract_compression.h"
+#include "swap/kis_compression_registry.h"
+#include "swap/kis_undo_swap_store.h"
+
+
+namespace {
+QAtomicInt s_deltaEncodingEnabled(false);
+QAtomicInt s_deltaEncodingCodec(KisCompressionRegistry::LZ4);
+QAtomicInteger<qint64> s_totalDeltaMemory(0);
+
+/**
+ * We don't want to spend the memory on the deltas that
+ * are only slightly smaller than the tile itself
+ */
+const qint32 MAX_DELTA_RATIO = 2;
+
+void xorBuffers(quint8 *dst, const quint8 *src, qint32 size)
+{
+    for (qint32 i = 0; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+}
+
+
+void KisMementoItem::setDeltaEncodingEnabled(bool value)
+{
+    s_deltaEncodingEnabled.storeRelease(value);
+}
+
+bool KisMementoItem::deltaEncodingEnabled()
+{
+    return s_deltaEncodingEnabled.loadAcquire();
+}
+
+void KisMementoItem::setDeltaEncodingCodec(int codec)
+{
+    s_deltaEncodingCodec.storeRelease(codec);
+}
+
+int KisMementoItem::deltaEncodingCodec()
+{
+    return s_deltaEncodingCodec.loadAcquire();
+}
+
+qint64 KisMementoItem::totalDeltaMemory()
+{
+    return s_totalDeltaMemory.loadAcquire();
+}
+
+void KisMementoItem::registerDeltaMemory(qint64 size)
+{
+    if (size) {
+        s_totalDeltaMemory.fetchAndAddOrdered(size);
+    }
+}
+
+bool KisMementoItem::tryEncodeDelta(KisMementoItemSP base, KisAbstractCompression *compression, int codec)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(compression, false);
+
+    if (isSwappedOut() || base->isSwappedOut() ||
+        !m_committedFlag || !base->m_committedFlag ||
+        m_type != CHANGED || base->m_type != CHANGED ||
+        isDeltaEncoded() || base->isDeltaEncoded() ||
+        !m_tileData || !base->m_tileData ||
+        m_tileData == base->m_tileData ||
+        m_tileData->pixelSize() != base->m_tileData->pixelSize()) {
+
+        return false;
+    }
+
+    /**
+     * The tile data is still shared with some other tile (e.g. in
+     * a copy of the device), so dropping it will not free any memory
+     */
+    if (m_tileData->numUsers() > 1) return false;
+
+    const qint32 pixelSize = m_tileData->pixelSize();
+    const qint32 tileDataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+    QByteArray xorBuffer(tileDataSize, Qt::Uninitialized);
+    QByteArray linearBuffer(tileDataSize, Qt::Uninitialized);
+
+    m_tileData->blockSwapping();
+    base->m_tileData->blockSwapping();
+
+    memcpy(xorBuffer.data(), m_tileData->data(), tileDataSize);
+    xorBuffers((quint8*)xorBuffer.data(), base->m_tileData->data(), tileDataSize);
+
+    base->m_tileData->unblockSwapping();
+    m_tileData->unblockSwapping();
+
+    KisAbstractCompression::linearizeColors((quint8*)xorBuffer.data(),
+                                            (quint8*)linearBuffer.data(),
+                                            tileDataSize, pixelSize);
+
+    const qint32 maxDeltaSize = tileDataSize / MAX_DELTA_RATIO;
+
+    QByteArray delta(1 + compression->outputBufferSize(tileDataSize), Qt::Uninitialized);
+    delta[0] = char(codec);
+
+    const qint32 compressedSize =
+        compression->compress((quint8*)linearBuffer.data(), tileDataSize,
+                              (quint8*)delta.data() + 1, delta.size() - 1);
+
+    if (!compressedSize || compressedSize >= maxDeltaSize) return false;
+
+    delta.resize(1 + compressedSize);
+    delta.squeeze();
+
+    releaseTileData();
+    m_tileData = 0;
+
+    m_delta = delta;
+    m_deltaBase = base;
+    registerDeltaMemory(m_delta.size());
+
+    return true;
+}
+
+void KisMementoItem::decodeDelta()
+{
+    if (!isDeltaEncoded()) return;
+
+    KisMementoItemSP base = m_deltaBase.toStrongRef();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(base);
+
+    base->restoreData();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(base->m_tileData);
+
+    const qint32 pixelSize = base->m_tileData->pixelSize();
+    const qint32 tileDataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionRegistry::create(quint8(m_delta[0])));
+    KIS_SAFE_ASSERT_RECOVER_RETURN(compression);
+
+    QByteArray linearBuffer(tileDataSize, Qt::Uninitialized);
+    QByteArray xorBuffer(tileDataSize, Qt::Uninitialized);
+
+    const qint32 bytesWritten =
+        compression->decompress((const quint8*)m_delta.constData() + 1, m_delta.size() - 1,
+                                (quint8*)linearBuffer.data(), tileDataSize);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(bytesWritten == tileDataSize);
+
+    KisAbstractCompression::delinearizeColors((quint8*)linearBuffer.data(),
+                                              (quint8*)xorBuffer.data(),
+                                              tileDataSize, pixelSize);
+
+    KisTileData *td = base->m_tileData->clone();
+
+    /**
+     * The item is committed, so we should own the tile data
+     * the same way commit() does it
+     */
+    td->acquire();
+    td->setMementoed(true);
+
+    td->blockSwapping();
+    xorBuffers(td->data(), (const quint8*)xorBuffer.constData(), tileDataSize);
+    td->unblockSwapping();
+
+    m_tileData = td;
+
+    registerDeltaMemory(-m_delta.size());
+    m_delta.clear();
+    m_deltaBase = KisMementoItemWSP();
+}
+
+bool KisMementoItem::trySwapOut(KisUndoSwapStore *store, qint64 *freedMemory)
+{
+    if (isSwappedOut() || !m_committedFlag) return false;
+
+    if (isDeltaEncoded()) {
+        if (!store->storeData(m_delta, &m_swapChunk)) return false;
+
+        *freedMemory = m_delta.size();
+        m_swappedOutPixelSize = 0;
+
+        registerDeltaMemory(-m_delta.size());
+        m_delta.clear();
+
+    } else {
+        /**
+         * The data that is still used by the other tiles is not
+         * actually a part of the history. And there is no use in
+         * reading back the data that has already been swapped out
+         * by the swapper. Peeking at data() without the lock is
+         * safe here, the worst we can get is a missed chance.
+         */
+        if (m_type != CHANGED || !m_tileData ||
+            !m_tileData->historical() || !m_tileData->data()) {
+
+            return false;
+        }
+
+        m_tileData->blockSwapping();
+        const bool result = store->storeTileData(m_tileData, &m_swapChunk);
+        m_tileData->unblockSwapping();
+
+        if (!result) return false;
+
+        m_swappedOutPixelSize = m_tileData->pixelSize();
+        *freedMemory = m_swappedOutPixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+        releaseTileData();
+        m_tileData = 0;
+    }
+
+    m_swapStore = store;
+
+    return true;
+}
+
+void KisMementoItem::restoreData()
+{
+    loadSwappedOutData();
+    decodeDelta();
+}
+
+void KisMementoItem::loadSwappedOutData()
+{
+    if (!isSwappedOut()) return;
+
+    if (!m_swappedOutPixelSize) {
+        m_delta = m_swapStore->loadData(m_swapChunk);
+        registerDeltaMemory(m_delta.size());
+    } else {
+        const QByteArray defaultPixel(m_swappedOutPixelSize, 0);
+
+        KisTileData *td =
+            KisTileDataStore::instance()->createDefaultTileData(m_swappedOutPixelSize,
+                                                                (const quint8*)defaultPixel.constData());
+        td->acquire();
+        td->setMementoed(true);
+
+        td->blockSwapping();
+        m_swapStore->loadTileData(m_swapChunk, td);
+        td->unblockSwapping();
+
+        m_tileData = td;
+    }
+
+    m_swapStore = 0;
+    m_swapChunk = KisChunk();
+    m_swappedOutPixelSize = 0;
+}
+
+void KisMementoItem::forgetSwappedOutData()
+{
+    m_swapStore->forgetChunk(m_swapChunk);
+
+    m_swapStore = 0;
+    m_swapChunk = KisChunk();
+}
@@ -7,15 +7,21 @@
 #ifndef KIS_MEMENTO_ITEM_H_
 #define KIS_MEMENTO_ITEM_H_
 
+#include <QByteArray>
+
+#include "kis_assert.h"
 #include <kis_shared.h>
 #include <kis_shared_ptr.h>
 #include "kis_tile.h"
 
 
 class KisMementoItem;
+class KisUndoSwapStore;
+class KisAbstractCompression;
 typedef KisSharedPtr<KisMementoItem> KisMementoItemSP;
+typedef KisWeakSharedPtr<KisMementoItem> KisMementoItemWSP;
 
-class KisMementoItem : public KisShared
+class KRITAIMAGE_EXPORT KisMementoItem : public KisShared
 {
 public:
     enum enumType {
@@ -36,13 +42,21 @@ public:
             m_col(rhs.m_col),
             m_row(rhs.m_row),
             m_next(0),
-            m_parent(0) {
+            m_parent(0),
+            m_delta(rhs.m_delta),
+            m_deltaBase(rhs.m_deltaBase) {
+        /**
+         * The swapped out data belongs to a single item only
+         */
+        KIS_ASSERT_RECOVER_NOOP(!rhs.isSwappedOut());
+
         if (m_tileData) {
             if (m_committedFlag)
                 m_tileData->acquire();
             else
                 m_tileData->ref();
         }
+        registerDeltaMemory(m_delta.size());
     }
 
     /**
@@ -84,6 +98,11 @@ public:
 
     ~KisMementoItem() {
         releaseTileData();
+        registerDeltaMemory(-m_delta.size());
+
+        if (isSwappedOut()) {
+            forgetSwappedOutData();
+        }
     }
 
     void notifyDetachedFromDataManager() {
@@ -142,10 +161,68 @@ public:
     }
 
     inline KisTileSP tile(KisMementoManager *mm) {
+        restoreData();
         Q_ASSERT(m_tileData);
         return KisTileSP(new KisTile(m_col, m_row, m_tileData, mm));
     }
 
+    /**
+     * Replaces the tile data of a committed item with a compressed
+     * XOR-delta against the data of a newer item \p base. Usually only
+     * a small part of a tile is changed by a stroke, so the delta is
+     * much smaller than the tile itself. The data is reconstructed by
+     * decodeDelta() when the item is needed for undo again.
+     *
+     * The delta is compressed with \p compression, which should be
+     * created for \p codec. The caller owns it, so the compression
+     * object (and its buffers) can be reused for all the items of
+     * the commit.
+     *
+     * Returns false if the item cannot be encoded (e.g. its tile data
+     * is shared with other tiles) or the delta is not small enough.
+     */
+    bool tryEncodeDelta(KisMementoItemSP base, KisAbstractCompression *compression, int codec);
+
+    inline bool isDeltaEncoded() const {
+        return !m_delta.isEmpty();
+    }
+
+    /**
+     * Moves the data of a committed item (either the tile data or
+     * the delta) into the undo file. Only the tile data that is not
+     * used by any other tile can be moved. On success \p freedMemory
+     * is set to the amount of RAM released.
+     */
+    bool trySwapOut(KisUndoSwapStore *store, qint64 *freedMemory);
+
+    inline bool isSwappedOut() const {
+        return m_swapStore;
+    }
+
+    /**
+     * Loads the swapped out data and decodes the delta, so that
+     * tileData() would return valid data again
+     */
+    void restoreData();
+
+    static void setDeltaEncodingEnabled(bool value);
+    static bool deltaEncodingEnabled();
+
+    /**
+     * The codec used for the new deltas. It is resolved from
+     * KisImageConfig by KisTileDataStore, when it (re)reads the
+     * config, so that tryEncodeDelta() wouldn't read the config
+     * on every commit.
+     */
+    static void setDeltaEncodingCodec(int codec);
+    static int deltaEncodingCodec();
+
+    /**
+     * Total size of the deltas of all the items in all
+     * the memento managers
+     */
+    static qint64 totalDeltaMemory();
+
     inline enumType type() {
         return m_type;
     }
@@ -177,7 +254,7 @@ public:
     void debugPrintInfo() {
         QString s = QString("------\n"
                    "Memento item:\t\t0x%1 (0x%2)\n"
-                   "   status:\t(%3,%4) %5%6\n"
+                   "   status:\t(%3,%4) %5%6%11\n"
                    "   parent:\t0x%7 (0x%8)\n"
                    "   next:\t0x%9 (0x%10)\n")
                 .arg((quintptr)this)
@@ -189,11 +266,19 @@ public:
                 .arg((quintptr)m_parent.data())
                 .arg(m_parent ? (quintptr)m_parent->m_tileData : 0)
                 .arg((quintptr)m_next.data())
-                .arg(m_next ? (quintptr)m_next->m_tileData : 0);
+                .arg(m_next ? (quintptr)m_next->m_tileData : 0)
+                .arg(isSwappedOut() ? QString(" swapped") :
+                     isDeltaEncoded() ? QString(" delta %1").arg(m_delta.size()) : QString());
         dbgKrita << s;
     }
 
 protected:
+    static void registerDeltaMemory(qint64 size);
+
+    void decodeDelta();
+    void loadSwappedOutData();
+    void forgetSwappedOutData();
+
     void releaseTileData() {
         if (m_tileData) {
             if (m_committedFlag) {
@@ -216,6 +301,22 @@ protected:
 
     KisMementoItemSP m_next;
     KisMementoItemSP m_parent;
+
+    /**
+     * The base item is always newer than this one, so the weak
+     * pointer avoids the cycle with its m_parent link
+     */
+    QByteArray m_delta;
+    KisMementoItemWSP m_deltaBase;
+
+    /**
+     * When the item is swapped out, either m_tileData or m_delta is
+     * stored in the undo file, depending on m_swappedOutPixelSize
+     * (zero for the delta)
+     */
+    KisUndoSwapStore *m_swapStore {0};
+    KisChunk m_swapChunk;
+    qint32 m_swappedOutPixelSize {0};
 private:
 };
 
@@ -5,12 +5,18 @@
  */
 
 #include <QtGlobal>
+#include <algorithm>
+#include <limits>
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
+#include "swap/kis_abstract_compression.h"
+#include "swap/kis_compression_registry.h"
 
 
 //#define DEBUG_MM
 
+#define MAX_ITEMS_SWAPPED_OUT_PER_COMMIT 256
+
 #ifdef DEBUG_MM
 #define DEBUG_LOG_TILE_ACTION(action, tile, col, row)                   \
     printf("### MementoManager (0x%X): %s "             \
@@ -78,7 +84,8 @@ KisMementoManager::KisMementoManager(const KisMementoManager& rhs)
         m_cancelledRevisions(rhs.m_cancelledRevisions),
         m_headsHashTable(rhs.m_headsHashTable, 0),
         m_currentMemento(rhs.m_currentMemento),
-        m_registrationBlocked(rhs.m_registrationBlocked)
+        m_registrationBlocked(rhs.m_registrationBlocked),
+        m_accessCounter(rhs.m_accessCounter)
 {
     Q_ASSERT_X(!m_registrationBlocked,
                "KisMementoManager", "(impossible happened) "
@@ -163,6 +170,20 @@ void KisMementoManager::registerTileDeleted(KisTile *tile)
     }
 }
 
+KisAbstractCompression* KisMementoManager::prepareDeltaCompression()
+{
+    if (!KisMementoItem::deltaEncodingEnabled()) return 0;
+
+    const int codec = KisMementoItem::deltaEncodingCodec();
+
+    if (!m_deltaCompression || m_deltaCodec != codec) {
+        m_deltaCompression.reset(KisCompressionRegistry::create(codec));
+        m_deltaCodec = codec;
+    }
+
+    return m_deltaCompression.data();
+}
+
 void KisMementoManager::commit()
 {
     if (m_index.isEmpty()) {
@@ -184,6 +205,8 @@ void KisMementoManager::commit()
     KisMementoItemSP parentMI;
     bool newTile;
 
+    KisAbstractCompression *deltaCompression = prepareDeltaCompression();
+
     KisMementoItemHashTableIterator iter(&m_index);
     while ((mi = iter.tile())) {
         parentMI = m_headsHashTable.getTileLazy(mi->col(), mi->row(), newTile);
@@ -192,6 +215,14 @@ void KisMementoManager::commit()
         mi->commit();
         revisionList.append(mi);
 
+        /**
+         * The previous state of the tile is needed only for undo
+         * now, so it can be stored as a delta against the new one
+         */
+        if (!newTile && deltaCompression) {
+            parentMI->tryEncodeDelta(mi, deltaCompression, m_deltaCodec);
+        }
+
         m_headsHashTable.deleteTile(mi->col(), mi->row());
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
@@ -201,17 +232,68 @@ void KisMementoManager::commit()
     KisHistoryItem hItem;
     hItem.itemList = revisionList;
     hItem.memento = m_currentMemento.data();
+    hItem.lastAccess = ++m_accessCounter;
     m_revisions.append(hItem);
 
     m_currentMemento = 0;
     KIS_ASSERT(m_index.isEmpty());
 
+    swapOutOldRevisions();
+
     DEBUG_DUMP_MESSAGE("COMMIT_DONE");
 
     // Waking up pooler to prepare copies for us
     KisTileDataStore::instance()->kickPooler();
 }
 
+void KisMementoManager::shareUniformTiles(KisTileHashTable *ht)
+{
+    KisUniformTileDataCache *cache = KisTileDataStore::instance()->uniformTileDataCache();
+
+    QByteArray pixel;
+    KisMementoItemSP mi;
+
+    blockRegistration();
+
+    KisMementoItemHashTableIterator iter(&m_index);
+    while ((mi = iter.tile())) {
+        iter.next();
+
+        if (mi->type() != KisMementoItem::CHANGED) continue;
+
+        KisTileSP tile = ht->getExistingTile(mi->col(), mi->row());
+        if (!tile || tile->tileData() != mi->tileData() ||
+            tile->tileData()->isUniform()) {
+
+            continue;
+        }
+
+        const qint32 pixelSize = tile->pixelSize();
+
+        tile->lockForRead();
+        const bool isUniform =
+            KisUniformTileDataCache::isUniformData(tile->data(), pixelSize);
+        if (isUniform) {
+            pixel = QByteArray((const char*)tile->data(), pixelSize);
+        }
+        tile->unlockForRead();
+
+        if (!isUniform) continue;
+
+        KisTileData *td = cache->acquireTileData(pixelSize, (const quint8*)pixel.constData());
+        KisTileSP uniformTile = new KisTile(mi->col(), mi->row(), td, this);
+        td->release();
+
+        ht->deleteTile(tile);
+        ht->addTile(uniformTile);
+
+        mi->reset();
+        mi->changeTile(uniformTile.data());
+    }
+
+    unblockRegistration();
+}
+
 KisTileSP KisMementoManager::getCommittedTile(qint32 col, qint32 row, bool &existingTile)
 {
     /**
@@ -312,6 +394,14 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
     m_currentMemento = 0;
     KIS_ASSERT(!namedTransactionInProgress());
 
+    /**
+     * The items of the previous revision are loaded back into
+     * memory now, so the revision has just been used
+     */
+    if (!m_revisions.isEmpty()) {
+        m_revisions.last().lastAccess = ++m_accessCounter;
+    }
+
     m_cancelledRevisions.prepend(changeList);
     DEBUG_DUMP_MESSAGE("UNDONE");
 
@@ -398,6 +488,66 @@ void KisMementoManager::resetRevisionHistory(KisMementoItemList list)
     }
 }
 
+void KisMementoManager::swapOutOldRevisions()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    if (!store->undoSwapEnabled()) return;
+
+    const int numCandidates = m_revisions.size() - store->undoInMemorySteps();
+    if (numCandidates <= 0) return;
+
+    /**
+     * Zero limit means that only the last undoInMemorySteps()
+     * revisions are kept in memory
+     */
+    const qint64 memoryLimit = store->undoMemoryLimit();
+    qint64 excessMemory = memoryLimit > 0 ?
+        store->undoMemoryInRam() - memoryLimit :
+        std::numeric_limits<qint64>::max();
+
+    if (excessMemory <= 0) return;
+
+    /**
+     * Revisions are swapped out in LRU order, so the ones the user
+     * has recently undone and redone stay in memory longer
+     */
+    QVector<int> candidates;
+    candidates.reserve(numCandidates);
+    for (int i = 0; i < numCandidates; i++) {
+        candidates.append(i);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [this] (int lhs, int rhs) {
+                         return m_revisions[lhs].lastAccess < m_revisions[rhs].lastAccess;
+                     });
+
+    /**
+     * The commit happens at the end of every stroke, so we
+     * shouldn't delay it too much. The rest of the items will
+     * be swapped out during the next commits.
+     */
+    int itemsLeft = MAX_ITEMS_SWAPPED_OUT_PER_COMMIT;
+
+    Q_FOREACH (int index, candidates) {
+        Q_FOREACH (KisMementoItemSP mi, m_revisions[index].itemList) {
+            /**
+             * The heads are read by getCommittedTile() concurrently,
+             * so they must always stay in memory
+             */
+            if (m_headsHashTable.getExistingTile(mi->col(), mi->row()) == mi) continue;
+
+            qint64 freedMemory = 0;
+            if (!mi->trySwapOut(store->undoSwapStore(), &freedMemory)) continue;
+
+            excessMemory -= freedMemory;
+            itemsLeft--;
+
+            if (excessMemory <= 0 || !itemsLeft) return;
+        }
+    }
+}
+
 void KisMementoManager::setDefaultTileData(KisTileData *defaultTileData)
 {
     m_headsHashTable.setDefaultTileData(defaultTileData);
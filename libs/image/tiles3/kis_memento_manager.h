@@ -8,6 +8,7 @@
 #define KIS_MEMENTO_MANAGER_
 
 #include <QList>
+#include <QScopedPointer>
 
 #include "kis_memento_item.h"
 #include "config-hash-table-implementation.h"
@@ -16,9 +17,16 @@ typedef QList<KisMementoItemSP> KisMementoItemList;
 typedef QListIterator<KisMementoItemSP> KisMementoItemListIterator;
 
 class KisMemento;
+class KisAbstractCompression;
 struct KisHistoryItem {
     KisMemento* memento;
     KisMementoItemList itemList;
+
+    /**
+     * The value of KisMementoManager::m_accessCounter when
+     * the revision was last committed or undone to
+     */
+    quint64 lastAccess {0};
 };
 
 typedef QList<KisHistoryItem> KisHistoryList;
@@ -75,6 +83,14 @@ public:
      */
     void commit();
 
+    /**
+     * Checks the tiles changed in INDEX, and replaces the ones
+     * filled with a single color in \p ht with the tiles sharing
+     * the uniform tile data from KisUniformTileDataCache. Should
+     * be called right before commit().
+     */
+    void shareUniformTiles(KisTileHashTable *ht);
+
     /**
      * Undo and Redo stuff respectively.
      *
@@ -117,6 +133,20 @@ protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
 
+    /**
+     * Returns the compression for delta-encoding of the parent
+     * items or null if the encoding is disabled. The compression is
+     * recreated only when the codec is changed in the config.
+     */
+    KisAbstractCompression* prepareDeltaCompression();
+
+    /**
+     * Moves the items of the revisions older than
+     * KisTileDataStore::undoInMemorySteps() into the undo file
+     * until the history fits KisTileDataStore::undoMemoryLimit()
+     */
+    void swapOutOldRevisions();
+
 protected:
     /**
      * INDEX of tiles to be committed with next commit()
@@ -158,6 +188,17 @@ protected:
      * \see rollforward()
      */
     bool m_registrationBlocked;
+
+    /**
+     * A logical clock used for LRU ordering of the revisions
+     */
+    quint64 m_accessCounter {0};
+
+    /**
+     * \see prepareDeltaCompression()
+     */
+    QScopedPointer<KisAbstractCompression> m_deltaCompression;
+    int m_deltaCodec {0};
 };
 
 #endif /* KIS_MEMENTO_MANAGER_ */
@@ -118,10 +118,10 @@ KisRandomAccessor2::KisTileInfo* KisRandomAccessor2::fetchTileData(qint32 col, q
     lockOldTile(kti->oldtile);
     kti->oldData = kti->oldtile->data();
 
-    kti->area_x1 = col * KisTileData::HEIGHT;
-    kti->area_y1 = row * KisTileData::WIDTH;
-    kti->area_x2 = kti->area_x1 + KisTileData::HEIGHT - 1;
-    kti->area_y2 = kti->area_y1 + KisTileData::WIDTH - 1;
+    kti->area_x1 = col * KisTileData::WIDTH;
+    kti->area_y1 = row * KisTileData::HEIGHT;
+    kti->area_x2 = kti->area_x1 + KisTileData::WIDTH - 1;
+    kti->area_y2 = kti->area_y1 + KisTileData::HEIGHT - 1;
 
     return kti;
 }
@@ -26,6 +26,8 @@ void KisTile::init(qint32 col, qint32 row,
     m_tileData = defaultTileData;
     m_tileData->acquire();
 
+    m_changedFlag.storeRelease(1);
+
     if (mm) {
         mm->registerTileChange(this);
     }
@@ -257,6 +259,23 @@ void KisTile::lockForWrite()
 #endif
     }
 
+    /**
+     * The tile data is not shared anymore (e.g. it has been dropped
+     * by the uniform tiles cache), so it is going to be changed in
+     * place and will not be uniform after that
+     */
+    if (m_tileData->isUniform()) {
+        m_tileData->setUniform(false);
+    }
+
+    /**
+     * Avoid writing into the shared cache line when
+     * the flag is already set
+     */
+    if (!m_changedFlag.load()) {
+        m_changedFlag.storeRelease(1);
+    }
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
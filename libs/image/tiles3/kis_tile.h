@@ -119,6 +119,16 @@ public:
         return m_tileData;
     }
 
+    /**
+     * Returns true if the tile has been locked for writing (or
+     * created) since the previous call to this method and resets
+     * the flag. Used for tracking the changes of the device between
+     * the synchronizations of its LoD planes.
+     */
+    inline bool takeChangedFlag() {
+        return m_changedFlag.fetchAndStoreOrdered(0);
+    }
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
@@ -148,6 +158,11 @@ private:
 
     QAtomicPointer<KisMementoManager> m_mementoManager;
 
+    /**
+     * Set on every write access, see takeChangedFlag()
+     */
+    QAtomicInt m_changedFlag;
+
     /**
      * This is a special mutex for guarding copy-on-write
      * operations. We do not use lockless way here as it'll
@@ -11,48 +11,18 @@
 
 #include <kis_debug.h>
 
-#include <boost/pool/singleton_pool.hpp>
 #include "kis_tile_data_store_iterators.h"
 
-// BPP == bytes per pixel
-#define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-#define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
+const qint32 KisTileData::WIDTH;
+const qint32 KisTileData::HEIGHT;
 
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
-
-const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
-const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
-
-SimpleCache KisTileData::m_cache;
-
-SimpleCache::~SimpleCache()
-{
-    clear();
-}
-
-void SimpleCache::clear()
-{
-    QWriteLocker l(&m_cacheLock);
-    quint8 *ptr = 0;
-
-    while (m_4Pool.pop(ptr)) {
-        BoostPool4BPP::free(ptr);
-    }
-
-    while (m_8Pool.pop(ptr)) {
-        BoostPool8BPP::free(ptr);
-    }
-
-    while (m_16Pool.pop(ptr)) {
-        free(ptr);
-    }
-}
+KisTileDataSlabAllocator KisTileData::m_allocator(__TILE_DATA_WIDTH * __TILE_DATA_HEIGHT);
 
 
 KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
+      m_uniformFlag(0),
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
@@ -82,6 +52,7 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
 KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
+      m_uniformFlag(0),
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
@@ -134,40 +105,17 @@ void KisTileData::allocateMemory()
 
 quint8* KisTileData::allocateData(const qint32 pixelSize)
 {
-    quint8 *ptr = 0;
-
-    if (!m_cache.pop(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            ptr = (quint8*)BoostPool4BPP::malloc();
-            break;
-        case 8:
-            ptr = (quint8*)BoostPool8BPP::malloc();
-            break;
-        default:
-            ptr = (quint8*) malloc(pixelSize * WIDTH * HEIGHT);
-            break;
-        }
-    }
-
-    return ptr;
+    return m_allocator.allocate(pixelSize);
 }
 
 void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 {
-    if (!m_cache.push(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            BoostPool4BPP::free(ptr);
-            break;
-        case 8:
-            BoostPool8BPP::free(ptr);
-            break;
-        default:
-            free(ptr);
-            break;
-        }
-    }
+    m_allocator.free(ptr, pixelSize);
+}
+
+void KisTileData::setHugePagesEnabled(bool value)
+{
+    m_allocator.setHugePagesEnabled(value);
 }
 
 //#define DEBUG_POOL_RELEASE
@@ -180,6 +128,8 @@ void KisTileData::releaseInternalPools()
 {
     const int maxMigratedTiles = 100;
 
+    KisTileDataStore::instance()->uniformTileDataCache()->releaseUnusedTileData();
+
     if (KisTileDataStore::instance()->numTilesInMemory() < maxMigratedTiles) {
 
         QVector<KisTileData*> dataObjects;
@@ -197,14 +147,6 @@ void KisTileData::releaseInternalPools()
                 delete clone;
             }
 
-            // check if the tile data has actually been pooled
-            if (item->m_pixelSize != 4 &&
-                item->m_pixelSize != 8 &&
-                item->m_pixelSize != 16) {
-
-                continue;
-            }
-
             // check if the tile has been swapped out
             if (item->m_data) {
                 const bool locked = item->m_swapLock.tryLockForWrite();
@@ -221,10 +163,13 @@ void KisTileData::releaseInternalPools()
         }
 
         if (!failedToLock) {
-            // purge the pools memory
-            m_cache.clear();
-            BoostPool4BPP::purge_memory();
-            BoostPool8BPP::purge_memory();
+            // free all the tiles so that their slabs could be released
+            Q_FOREACH (KisTileData *item, dataObjects) {
+                freeData(item->m_data, item->m_pixelSize);
+                item->m_data = 0;
+            }
+
+            m_allocator.releaseFreeMemory();
 
             auto it = dataObjects.begin();
             auto chunkIt = memoryChunks.constBegin();
@@ -258,6 +203,9 @@ void KisTileData::releaseInternalPools()
 #endif /* DEBUG_POOL_RELEASE */
 
     } else {
+        // the tiles are not migrated, but the empty slabs can be released anyway
+        m_allocator.releaseFreeMemory();
+
         dbgKrita << "DEBUG: releasing of the pooled memory has been cancelled:"
                  << "there are still"
                  << KisTileDataStore::instance()->numTilesInMemory()
@@ -107,6 +107,13 @@ inline bool KisTileData::historical() const {
     return mementoed() && numUsers() <= 1;
 }
 
+inline bool KisTileData::isUniform() const {
+    return m_uniformFlag.loadAcquire();
+}
+inline void KisTileData::setUniform(bool value) {
+    m_uniformFlag.storeRelease(value);
+}
+
 inline int KisTileData::age() const {
     return m_age;
 }
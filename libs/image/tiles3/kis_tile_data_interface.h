@@ -13,6 +13,9 @@
 
 #include "kis_lockless_stack.h"
 #include "swap/kis_chunk_allocator.h"
+#include "kis_tile_data_slab_allocator.h"
+
+#include "config-tile-size.h"
 
 class KisTileData;
 class KisTileDataStore;
@@ -20,9 +23,16 @@ class KisTileDataStore;
 /**
  * WARNING: Those definitions for internal use only!
  * Please use KisTileData::WIDTH/HEIGHT instead
+ *
+ * The size of the tiles is selected at build time with
+ * KRITA_TILE_SIZE CMake option (64 by default)
  */
-#define __TILE_DATA_WIDTH 64
-#define __TILE_DATA_HEIGHT 64
+#define __TILE_DATA_WIDTH KRITA_TILE_SIZE
+#define __TILE_DATA_HEIGHT KRITA_TILE_SIZE
+
+static_assert((__TILE_DATA_WIDTH & (__TILE_DATA_WIDTH - 1)) == 0 &&
+              (__TILE_DATA_HEIGHT & (__TILE_DATA_HEIGHT - 1)) == 0,
+              "The size of the tile should be a power of two");
 
 typedef KisLocklessStack<KisTileData*> KisTileDataCache;
 
@@ -31,57 +41,6 @@ typedef KisTileDataList::iterator KisTileDataListIterator;
 typedef KisTileDataList::const_iterator KisTileDataListConstIterator;
 
 
-class SimpleCache
-{
-public:
-    SimpleCache() = default;
-    ~SimpleCache();
-
-    bool push(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            m_4Pool.push(ptr);
-            break;
-        case 8:
-            m_8Pool.push(ptr);
-            break;
-        case 16:
-            m_16Pool.push(ptr);
-            break;
-        default:
-            return false;
-        }
-
-        return true;
-    }
-
-    bool pop(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            return m_4Pool.pop(ptr);
-        case 8:
-            return m_8Pool.pop(ptr);
-        case 16:
-            return m_16Pool.pop(ptr);
-        default:
-            return false;
-        }
-    }
-
-    void clear();
-
-private:
-    QReadWriteLock m_cacheLock;
-    KisLocklessStack<quint8*> m_4Pool;
-    KisLocklessStack<quint8*> m_8Pool;
-    KisLocklessStack<quint8*> m_16Pool;
-};
-
-
 /**
  * Stores actual tile's data
  */
@@ -180,6 +139,14 @@ public:
      */
     inline bool historical() const;
 
+    /**
+     * Shows that the tile data is filled with a single color and is
+     * shared between the tiles via KisUniformTileDataCache. Such tile
+     * data is never changed in place, the tiles always COW it first.
+     */
+    inline bool isUniform() const;
+    inline void setUniform(bool value);
+
     /**
      * Used for swapping purposes only.
      * Frees the memory occupied by the tile data.
@@ -201,13 +168,19 @@ public:
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
-     * glibc directly, but use pools (implemented via boost) to
+     * glibc directly, but use slabs (see KisTileDataSlabAllocator) to
      * allocate bigger chunks. This method should be called when one
      * knows that we have just free'd quite a lot of memory and we
      * won't need it anymore. E.g. when a document has been closed.
      */
     static void releaseInternalPools();
 
+    /**
+     * Back the tile data slabs with transparent huge pages
+     * (if supported by the system)
+     */
+    static void setHugePagesEnabled(bool value);
+
 private:
     void fillWithPixel(const quint8 *defPixel);
 
@@ -226,6 +199,7 @@ private:
 private:
     friend class KisTile;
     friend class KisTileDataStore;
+    friend class KisSwappedDataStore;
 
     friend class KisTileDataStoreIterator;
     friend class KisTileDataStoreReverseIterator;
@@ -262,6 +236,14 @@ private:
      */
     qint32 m_mementoFlag;
 
+    /**
+     * \see isUniform()
+     *
+     * The flag is read by the memento managers of the other devices
+     * while the tile data is being detached, so it must be atomic
+     */
+    QAtomicInt m_uniformFlag;
+
     /**
      * Counts up time after last access to the tile data.
      * 0 - recently accessed
@@ -276,7 +258,8 @@ private:
      * lockForRead() - used by regular threads to ensure swapper
      *                 won't touch this tile data.
      * tryLockForWrite() - used by swapper to check no-one reads
-     *                     this tile data
+     *                     this tile data. The swap compaction
+     *                     uses it to relocate the swapped data.
      */
     QReadWriteLock m_swapLock;
 
@@ -305,11 +288,15 @@ private:
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
-    static SimpleCache m_cache;
+    static KisTileDataSlabAllocator m_allocator;
 
 public:
-    static const qint32 WIDTH;
-    static const qint32 HEIGHT;
+    /**
+     * The values are known at compile time, so the divisions
+     * by the size of the tile can be optimized into shifts
+     */
+    static const qint32 WIDTH = __TILE_DATA_WIDTH;
+    static const qint32 HEIGHT = __TILE_DATA_HEIGHT;
 };
 
 #endif /* KIS_TILE_DATA_INTERFACE_H_ */
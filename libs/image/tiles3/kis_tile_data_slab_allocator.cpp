@@ -0,0 +1,426 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_slab_allocator.h"
+
+#include <cstdlib>
+
+#include <QMutexLocker>
+
+#include "kis_assert.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#endif
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+
+struct KisTileDataSlabAllocator::Slab
+{
+    quint8 *base = nullptr;
+
+    /**
+     * The size of the mapping, it may be bigger than the buffers
+     * of the slab (see createSlab())
+     */
+    quint64 size = 0;
+
+    /**
+     * Free buffers are linked into a list, the pointer to the next
+     * free buffer is stored in the first bytes of the buffer itself
+     */
+    quint8 *freeList = nullptr;
+
+    /**
+     * The buffers above this index has never been touched, we don't
+     * link them into the free list to avoid committing the memory
+     * of the slab before it is actually needed
+     */
+    int numTouched = 0;
+    int numUsed = 0;
+
+    bool isPartial = false;
+};
+
+struct KisTileDataSlabAllocator::SizeClass
+{
+    qint32 bufferSize = 0;
+    int buffersPerSlab = 0;
+
+    KisLocklessStack<quint8*> cache;
+
+    QMutex lock;
+    QMap<quintptr, Slab*> slabs;
+    QVector<Slab*> partialSlabs;
+    Slab *spareSlab = nullptr;
+
+    /**
+     * The number of buffers taken from the slabs, including
+     * the ones stored in the cache
+     */
+    qint64 numAllocated = 0;
+};
+
+
+KisTileDataSlabAllocator::KisTileDataSlabAllocator(qint32 bufferPixels, quint64 slabSize)
+    : m_bufferPixels(bufferPixels),
+      m_slabSize(slabSize),
+      m_useHugePages(false),
+      m_slabsMemory(0)
+{
+}
+
+KisTileDataSlabAllocator::~KisTileDataSlabAllocator()
+{
+    releaseFreeMemory();
+
+    /**
+     * Slabs with live tiles might still be present if some tiles
+     * have leaked. We don't unmap them, because the tile data objects
+     * may still be destroyed by other static objects.
+     */
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        SizeClass *sc = m_classes[i].loadAcquire();
+        if (sc && sc->slabs.isEmpty()) {
+            delete sc;
+        }
+    }
+}
+
+quint8* KisTileDataSlabAllocator::allocate(qint32 pixelSize)
+{
+    if (pixelSize <= 0 || pixelSize > MAX_PIXEL_SIZE) {
+        return (quint8*) malloc(pixelSize * m_bufferPixels);
+    }
+
+    SizeClass *sc = sizeClass(pixelSize);
+    quint8 *ptr = nullptr;
+
+    if (!sc->cache.pop(ptr) && !refill(sc, &ptr)) {
+        // the system refused to give us a new slab, let malloc try
+        ptr = (quint8*) malloc(pixelSize * m_bufferPixels);
+    }
+
+    return ptr;
+}
+
+void KisTileDataSlabAllocator::free(quint8 *ptr, qint32 pixelSize)
+{
+    if (pixelSize <= 0 || pixelSize > MAX_PIXEL_SIZE) {
+        ::free(ptr);
+        return;
+    }
+
+    SizeClass *sc = sizeClassIfExists(pixelSize);
+    KIS_SAFE_ASSERT_RECOVER(sc) {
+        ::free(ptr);
+        return;
+    }
+
+    if (sc->cache.size() < MAX_CACHED_BUFFERS) {
+        sc->cache.push(ptr);
+        return;
+    }
+
+    quint8 *buffers[REFILL_BATCH_SIZE];
+    int numBuffers = 0;
+
+    buffers[numBuffers++] = ptr;
+    while (numBuffers < REFILL_BATCH_SIZE && sc->cache.pop(buffers[numBuffers])) {
+        numBuffers++;
+    }
+
+    releaseToSlabs(sc, buffers, numBuffers);
+}
+
+void KisTileDataSlabAllocator::releaseFreeMemory()
+{
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        SizeClass *sc = m_classes[i].loadAcquire();
+        if (!sc) continue;
+
+        QVector<quint8*> buffers;
+        quint8 *ptr = nullptr;
+        while (sc->cache.pop(ptr)) {
+            buffers.append(ptr);
+        }
+
+        releaseToSlabs(sc, buffers.data(), buffers.size());
+
+        QMutexLocker l(&sc->lock);
+        if (sc->spareSlab) {
+            destroySlab(sc, sc->spareSlab);
+            sc->spareSlab = nullptr;
+        }
+    }
+}
+
+void KisTileDataSlabAllocator::setHugePagesEnabled(bool value)
+{
+    m_useHugePages.storeRelease(value);
+}
+
+bool KisTileDataSlabAllocator::hugePagesEnabled() const
+{
+    return m_useHugePages.loadAcquire();
+}
+
+qint64 KisTileDataSlabAllocator::slabsMemory() const
+{
+    return m_slabsMemory.loadAcquire();
+}
+
+qint64 KisTileDataSlabAllocator::freeSlabsMemory() const
+{
+    qint64 usedMemory = 0;
+
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        SizeClass *sc = m_classes[i].loadAcquire();
+        if (!sc) continue;
+
+        QMutexLocker l(&sc->lock);
+        usedMemory += (sc->numAllocated - sc->cache.size()) * sc->bufferSize;
+    }
+
+    return qMax(qint64(0), slabsMemory() - usedMemory);
+}
+
+int KisTileDataSlabAllocator::numSlabs(qint32 pixelSize) const
+{
+    SizeClass *sc = sizeClassIfExists(pixelSize);
+    if (!sc) return 0;
+
+    QMutexLocker l(&sc->lock);
+    return sc->slabs.size();
+}
+
+KisTileDataSlabAllocator::SizeClass* KisTileDataSlabAllocator::sizeClass(qint32 pixelSize)
+{
+    SizeClass *sc = m_classes[pixelSize].loadAcquire();
+
+    if (Q_UNLIKELY(!sc)) {
+        QMutexLocker l(&m_classCreationLock);
+
+        sc = m_classes[pixelSize].loadAcquire();
+        if (!sc) {
+            sc = new SizeClass();
+            sc->bufferSize = pixelSize * m_bufferPixels;
+            sc->buffersPerSlab = qMax(quint64(1), m_slabSize / sc->bufferSize);
+            m_classes[pixelSize].storeRelease(sc);
+        }
+    }
+
+    return sc;
+}
+
+KisTileDataSlabAllocator::SizeClass* KisTileDataSlabAllocator::sizeClassIfExists(qint32 pixelSize) const
+{
+    if (pixelSize <= 0 || pixelSize > MAX_PIXEL_SIZE) return nullptr;
+    return m_classes[pixelSize].loadAcquire();
+}
+
+bool KisTileDataSlabAllocator::refill(SizeClass *sc, quint8 **result)
+{
+    QMutexLocker l(&sc->lock);
+
+    for (int i = 0; i < REFILL_BATCH_SIZE; i++) {
+        if (sc->partialSlabs.isEmpty()) {
+            Slab *slab = sc->spareSlab;
+            sc->spareSlab = nullptr;
+
+            if (!slab) {
+                slab = createSlab(sc);
+                if (!slab) break;
+            }
+
+            slab->isPartial = true;
+            sc->partialSlabs.append(slab);
+        }
+
+        Slab *slab = sc->partialSlabs.last();
+        quint8 *ptr = nullptr;
+
+        if (slab->freeList) {
+            ptr = slab->freeList;
+            slab->freeList = *reinterpret_cast<quint8**>(ptr);
+        } else {
+            KIS_SAFE_ASSERT_RECOVER_BREAK(slab->numTouched < sc->buffersPerSlab);
+            ptr = slab->base + qint64(slab->numTouched) * sc->bufferSize;
+            slab->numTouched++;
+        }
+
+        slab->numUsed++;
+        sc->numAllocated++;
+
+        if (slab->numUsed == sc->buffersPerSlab) {
+            slab->isPartial = false;
+            sc->partialSlabs.removeLast();
+        }
+
+        if (!i) {
+            *result = ptr;
+        } else {
+            sc->cache.push(ptr);
+        }
+    }
+
+    return *result;
+}
+
+void KisTileDataSlabAllocator::releaseToSlabs(SizeClass *sc, quint8 **buffers, int numBuffers)
+{
+    if (!numBuffers) return;
+
+    QMutexLocker l(&sc->lock);
+
+    for (int i = 0; i < numBuffers; i++) {
+        releaseToSlabsLocked(sc, buffers[i]);
+    }
+}
+
+void KisTileDataSlabAllocator::releaseToSlabsLocked(SizeClass *sc, quint8 *ptr)
+{
+    auto it = sc->slabs.upperBound(quintptr(ptr));
+
+    if (it == sc->slabs.begin() ||
+        quintptr(ptr) >= (it - 1).key() + quint64(sc->buffersPerSlab) * sc->bufferSize) {
+
+        // the buffer was allocated by the malloc() fallback
+        ::free(ptr);
+        return;
+    }
+
+    Slab *slab = (it - 1).value();
+
+    *reinterpret_cast<quint8**>(ptr) = slab->freeList;
+    slab->freeList = ptr;
+    slab->numUsed--;
+    sc->numAllocated--;
+
+    if (!slab->numUsed) {
+        if (slab->isPartial) {
+            sc->partialSlabs.removeOne(slab);
+            slab->isPartial = false;
+        }
+
+        /**
+         * Keep one empty slab per class to avoid mapping/unmapping
+         * the memory when a tile is created and destroyed repeatedly
+         */
+        if (!sc->spareSlab) {
+            sc->spareSlab = slab;
+        } else {
+            destroySlab(sc, slab);
+        }
+    } else if (!slab->isPartial) {
+        slab->isPartial = true;
+        sc->partialSlabs.append(slab);
+    }
+}
+
+KisTileDataSlabAllocator::Slab* KisTileDataSlabAllocator::createSlab(SizeClass *sc)
+{
+    quint64 size = quint64(sc->buffersPerSlab) * sc->bufferSize;
+
+    /**
+     * A huge page can back only a whole aligned region of its size.
+     * When the buffer size doesn't divide the huge page size (e.g. for
+     * 3, 5 or 6 bytes per pixel), the slab is a bit smaller than the
+     * huge page, so the mapping is rounded up. The tail is shorter
+     * than a single buffer and stays unused.
+     */
+    if (hugePagesEnabled()) {
+        size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+    void *ptr = mapMemory(size);
+    if (!ptr) return nullptr;
+
+    Slab *slab = new Slab();
+    slab->base = static_cast<quint8*>(ptr);
+    slab->size = size;
+    sc->slabs.insert(quintptr(slab->base), slab);
+
+    m_slabsMemory.fetchAndAddOrdered(size);
+
+    return slab;
+}
+
+void KisTileDataSlabAllocator::destroySlab(SizeClass *sc, Slab *slab)
+{
+    const quint64 size = slab->size;
+
+    sc->slabs.remove(quintptr(slab->base));
+    unmapMemory(slab->base, size);
+    delete slab;
+
+    m_slabsMemory.fetchAndSubOrdered(size);
+}
+
+void* KisTileDataSlabAllocator::mapMemory(quint64 size)
+{
+#if defined(Q_OS_WIN)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(Q_OS_UNIX)
+    /**
+     * Huge pages can back only the regions aligned to the huge page
+     * size, so we map a bit more memory and cut the aligned part out
+     */
+    const quint64 alignment = size >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : 0;
+
+    void *rawPtr = mmap(nullptr, size + alignment,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (rawPtr == MAP_FAILED) return nullptr;
+
+    quint8 *ptr = static_cast<quint8*>(rawPtr);
+
+    if (alignment) {
+        quint8 *alignedPtr = reinterpret_cast<quint8*>(
+            (reinterpret_cast<quintptr>(ptr) + alignment - 1) & ~quintptr(alignment - 1));
+
+        const quint64 headSize = alignedPtr - ptr;
+        const quint64 tailSize = alignment - headSize;
+
+        if (headSize) {
+            munmap(ptr, headSize);
+        }
+
+        if (tailSize) {
+            munmap(alignedPtr + size, tailSize);
+        }
+
+        ptr = alignedPtr;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (m_useHugePages.loadAcquire()) {
+        madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return ptr;
+#else
+    return ::malloc(size);
+#endif
+}
+
+void KisTileDataSlabAllocator::unmapMemory(void *ptr, quint64 size)
+{
+#if defined(Q_OS_WIN)
+    Q_UNUSED(size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#elif defined(Q_OS_UNIX)
+    munmap(ptr, size);
+#else
+    Q_UNUSED(size);
+    ::free(ptr);
+#endif
+}
@@ -0,0 +1,114 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_DATA_SLAB_ALLOCATOR_H
+#define __KIS_TILE_DATA_SLAB_ALLOCATOR_H
+
+#include "kritaimage_export.h"
+
+#include <QtGlobal>
+#include <QAtomicPointer>
+#include <QAtomicInteger>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+
+#include "kis_lockless_stack.h"
+
+/**
+ * The allocator for the pixel buffers of the tile data objects.
+ *
+ * Every pixel size gets its own size class. The buffers of a size
+ * class are cut from big slabs (2 MiB by default) requested from
+ * the system directly, so they are not mixed with the rest of the
+ * heap and can be returned to the system as soon as the slab becomes
+ * empty.
+ *
+ * The buffers freed recently are kept in a per-class lockless cache,
+ * so most of allocations and deallocations never touch the class
+ * lock. The slabs themselves are processed under the lock in batches
+ * of REFILL_BATCH_SIZE buffers.
+ *
+ * On Linux the slabs are aligned to the huge page size and can be
+ * backed by transparent huge pages, see setHugePagesEnabled().
+ */
+class KRITAIMAGE_EXPORT KisTileDataSlabAllocator
+{
+public:
+    /**
+     * Tile buffers of the pixel sizes bigger than this value are
+     * allocated with malloc() directly
+     */
+    static const int MAX_PIXEL_SIZE = 64;
+
+    static const int REFILL_BATCH_SIZE = 16;
+    static const int MAX_CACHED_BUFFERS = 256;
+
+public:
+    KisTileDataSlabAllocator(qint32 bufferPixels, quint64 slabSize = 2 * 1024 * 1024);
+    ~KisTileDataSlabAllocator();
+
+    quint8* allocate(qint32 pixelSize);
+    void free(quint8 *ptr, qint32 pixelSize);
+
+    /**
+     * Returns all the cached buffers to their slabs and gives
+     * the empty slabs back to the system. Should be called when
+     * one knows that a lot of memory has just been free'd, e.g.
+     * when a document has been closed.
+     */
+    void releaseFreeMemory();
+
+    /**
+     * Backs the slabs allocated from now on with transparent huge
+     * pages. Has no effect on systems without THP support.
+     */
+    void setHugePagesEnabled(bool value);
+    bool hugePagesEnabled() const;
+
+    /**
+     * The amount of memory currently requested from the system
+     * for the slabs of all the size classes
+     */
+    qint64 slabsMemory() const;
+
+    /**
+     * The amount of memory of the slabs that is not occupied
+     * by the tiles (free slots and cached buffers)
+     */
+    qint64 freeSlabsMemory() const;
+
+    int numSlabs(qint32 pixelSize) const;
+
+private:
+    struct Slab;
+    struct SizeClass;
+
+    SizeClass* sizeClass(qint32 pixelSize);
+    SizeClass* sizeClassIfExists(qint32 pixelSize) const;
+
+    bool refill(SizeClass *sc, quint8 **result);
+    void releaseToSlabs(SizeClass *sc, quint8 **buffers, int numBuffers);
+    void releaseToSlabsLocked(SizeClass *sc, quint8 *ptr);
+
+    Slab* createSlab(SizeClass *sc);
+    void destroySlab(SizeClass *sc, Slab *slab);
+
+    void* mapMemory(quint64 size);
+    void unmapMemory(void *ptr, quint64 size);
+
+private:
+    const qint32 m_bufferPixels;
+    const quint64 m_slabSize;
+
+    QAtomicPointer<SizeClass> m_classes[MAX_PIXEL_SIZE + 1];
+    QMutex m_classCreationLock;
+
+    QAtomicInt m_useHugePages;
+    QAtomicInteger<qint64> m_slabsMemory;
+};
+
+#endif /* __KIS_TILE_DATA_SLAB_ALLOCATOR_H */
@@ -15,6 +15,9 @@
 #include "kis_debug.h"
 
 #include "kis_tile_data_store_iterators.h"
+#include "kis_image_config.h"
+#include "kis_memento_item.h"
+#include "swap/kis_compression_registry.h"
 
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
@@ -58,20 +61,37 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
+      m_compressedStore(KisImageConfig(true).tilesCompressionLimit() * MiB),
+      m_uniformTileDataCache(this),
+      m_shareUniformTiles(false),
+      m_undoSwapEnabled(false),
+      m_undoMemoryLimit(0),
+      m_undoInMemorySteps(0),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
       m_clockIndex(1)
 {
+    KisTileData::setHugePagesEnabled(KisImageConfig(true).tilesHugePages());
+    KisMementoItem::setDeltaEncodingEnabled(KisImageConfig(true).undoDeltaMementos());
+    KisMementoItem::setDeltaEncodingCodec(KisCompressionRegistry::codecForUsage(KisCompressionRegistry::InMemoryUsage));
+    readUndoSwapConfig();
+    m_shareUniformTiles.storeRelease(KisImageConfig(true).tilesShareUniformData());
+
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start();
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
+    m_uniformTileDataCache.clear();
+
     if (numTiles() > 0) {
         errKrita << "Warning: some tiles have leaked:";
         errKrita << "\tTiles in memory:" << numTilesInMemory() << "\n"
@@ -96,13 +116,36 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.historicalMemorySize = m_pooler.lastHistoricalMemoryMetric() * metricCoeff;
     stats.poolSize = m_pooler.lastPoolMemoryMetric() * metricCoeff;
 
-    stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
+    stats.compressedSize = m_compressedStore.arenaSize();
+    stats.historicalDeltaSize = KisMementoItem::totalDeltaMemory();
+
+    stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize +
+        stats.compressedSize + stats.historicalDeltaSize;
 
     stats.swapSize = m_swappedStore.totalSwapMemoryUsed();
+    stats.swapReclaimedSize = m_swappedStore.totalReclaimedSize();
+    stats.historicalSwapSize = m_undoSwapStore.totalMemoryUsed();
 
     return stats;
 }
 
+qint64 KisTileDataStore::undoMemoryInRam() const
+{
+    const qint64 metricCoeff = qint64(KisTileData::WIDTH) * KisTileData::HEIGHT;
+
+    return m_pooler.lastHistoricalMemoryMetric() * metricCoeff +
+        KisMementoItem::totalDeltaMemory();
+}
+
+void KisTileDataStore::readUndoSwapConfig()
+{
+    KisImageConfig config(true);
+
+    m_undoSwapEnabled.storeRelease(config.undoSwapEnabled());
+    m_undoMemoryLimit.storeRelease(qint64(config.undoMemoryLimit()) * MiB);
+    m_undoInMemorySteps.storeRelease(config.undoInMemorySteps());
+}
+
 void KisTileDataStore::tryForceUpdateMemoryStatisticsWhileIdle()
 {
     // in case the pooler is disabled, we should force it
@@ -196,13 +239,21 @@ void KisTileDataStore::freeTileData(KisTileData *td)
 
     DEBUG_FREE_ACTION(td);
 
+    /**
+     * This is the only place where m_iteratorLock is taken before
+     * td->m_swapLock (see ensureTileDataLoaded()). It is safe,
+     * because the tile data has no users anymore, so nobody else
+     * can be waiting for its swap lock.
+     */
     m_iteratorLock.lockForRead();
     td->m_swapLock.lockForWrite();
 
-    if (!td->data()) {
-        m_swappedStore.forgetTileData(td);
-    } else {
+    if (td->data()) {
         unregisterTileDataImp(td);
+    } else if (td->m_state == KisTileData::COMPRESSED) {
+        m_compressedStore.forgetTileData(td);
+    } else {
+        m_swappedStore.forgetTileData(td);
     }
 
     td->m_swapLock.unlock();
@@ -224,32 +275,38 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
         /**
          * The order of this heavy locking is very important.
          * Change it only in case, you really know what you are doing.
+         *
+         * The tile is loaded under its own swap lock only, so the
+         * swap-ins of different tiles run in parallel. The lock order
+         * is: td->m_swapLock first, m_iteratorLock second, the same
+         * as in duplicateTileData(), which registers the clone while
+         * the swapping of the source tile is blocked.
+         *
+         * The threads holding m_iteratorLock for write (the swapper,
+         * the pooler, compressed tiles eviction) never wait for the
+         * swap lock of an unloaded tile: they either use
+         * tryLockForWrite() or touch only the tiles registered in
+         * m_tileDataMap, and our tile is registered only after it
+         * has been loaded.
          */
-        m_iteratorLock.lockForWrite();
+        td->m_swapLock.lockForWrite();
 
         /**
-         * If someone has managed to load the td from swap, then, most
-         * probably, they have already taken the swap lock. This may
-         * lead to a deadlock, because COW mechanism breaks lock
-         * ordering rules in duplicateTileData() (it takes m_listLock
-         * while the swap lock is held). In our case it is enough just
-         * to check whether the other thread has already fetched the
-         * data. Please notice that we do not take both of the locks
-         * while checking this, because holding m_listLock is
-         * enough. Nothing can happen to the tile while we hold
-         * m_listLock.
+         * Another thread could have loaded the tile while
+         * we were waiting for the lock
          */
-
         if (!td->data()) {
-            td->m_swapLock.lockForWrite();
-
-            m_swappedStore.swapInTileData(td);
-            registerTileDataImp(td);
-
-            td->m_swapLock.unlock();
+            if (td->m_state == KisTileData::COMPRESSED) {
+                m_compressedStore.decompressTileData(td);
+            } else {
+                m_swappedStore.swapInTileData(td);
+            }
+
+            td->m_state = KisTileData::NORMAL;
+            registerTileData(td);
         }
 
-        m_iteratorLock.unlock();
+        td->m_swapLock.unlock();
 
         /**
          * <-- In theory, livelock is possible here...
@@ -269,16 +326,87 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     if (!td->m_swapLock.tryLockForWrite()) return result;
 
     if (td->data()) {
-        if (m_swappedStore.trySwapOutTileData(td)) {
-            unregisterTileDataImp(td);
+        /**
+         * Try to keep the tile in RAM in compressed form first. It
+         * will be evicted to the swap file later, if the compressed
+         * store becomes full (see evictCompressedTiles()).
+         */
+        if (m_compressedStore.isEnabled() &&
+            m_compressedStore.tryCompressTileData(td)) {
+
+            td->m_state = KisTileData::COMPRESSED;
+            result = true;
+
+        } else if (m_swappedStore.trySwapOutTileData(td)) {
+            td->m_state = KisTileData::SWAPPED;
             result = true;
         }
+
+        if (result) {
+            unregisterTileDataImp(td);
+        }
     }
     td->m_swapLock.unlock();
 
     return result;
 }
 
+qint64 KisTileDataStore::evictCompressedTiles(qint64 needToFree)
+{
+    const int batchSize = 64;
+    qint64 freed = 0;
+
+    QWriteLocker locker(&m_iteratorLock);
+
+    while (freed < needToFree) {
+        QVector<KisTileData*> candidates = m_compressedStore.oldestTiles(batchSize);
+        if (candidates.isEmpty()) break;
+
+        int numEvicted = 0;
+
+        Q_FOREACH (KisTileData *td, candidates) {
+            if (freed >= needToFree) break;
+
+            /**
+             * Nobody can load the tile data while we hold
+             * m_iteratorLock, but they can still try to access it,
+             * so we cannot block here
+             */
+            if (!td->m_swapLock.tryLockForWrite()) continue;
+
+            if (td->m_state == KisTileData::COMPRESSED) {
+                const qint64 compressedBefore = m_compressedStore.compressedMemoryUsed();
+
+                if (m_compressedStore.tryEvictTileData(td, &m_swappedStore)) {
+                    td->m_state = KisTileData::SWAPPED;
+                    freed += compressedBefore - m_compressedStore.compressedMemoryUsed();
+                    numEvicted++;
+                }
+            }
+
+            td->m_swapLock.unlock();
+        }
+
+        if (!numEvicted) break;
+    }
+
+    return freed;
+}
+
+bool KisTileDataStore::swapFileNeedsCompaction()
+{
+    return m_swappedStore.needsCompaction();
+}
+
+qint64 KisTileDataStore::compactSwapFile(qint64 maxBytesToMove)
+{
+    /**
+     * The swapped store locks the swap lock of every tile it
+     * relocates, so we don't need m_iteratorLock here
+     */
+    return m_swappedStore.compact(maxBytesToMove);
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -349,6 +477,8 @@ void KisTileDataStore::debugSwapAll()
 
 void KisTileDataStore::debugClear()
 {
+    m_uniformTileDataCache.clear();
+
     QWriteLocker l(&m_iteratorLock);
     ConcurrentMap<int, KisTileData*>::Iterator iter(m_tileDataMap);
 
@@ -367,6 +497,12 @@ void KisTileDataStore::testingRereadConfig()
 {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_prefetcher.testingRereadConfig();
+    KisTileData::setHugePagesEnabled(KisImageConfig(true).tilesHugePages());
+    KisMementoItem::setDeltaEncodingEnabled(KisImageConfig(true).undoDeltaMementos());
+    KisMementoItem::setDeltaEncodingCodec(KisCompressionRegistry::codecForUsage(KisCompressionRegistry::InMemoryUsage));
+    readUndoSwapConfig();
+    m_shareUniformTiles.storeRelease(KisImageConfig(true).tilesShareUniformData());
     kickPooler();
 }
 
@@ -15,7 +15,11 @@
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
+#include "swap/kis_compressed_data_store.h"
+#include "swap/kis_undo_swap_store.h"
+#include "kis_uniform_tile_data_cache.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
 class KisTileDataStoreIterator;
@@ -39,9 +43,22 @@ public:
         qint64 realMemorySize;
         qint64 historicalMemorySize;
 
+        /**
+         * Memory occupied by the delta-encoded undo history,
+         * see KisMementoItem::tryEncodeDelta()
+         */
+        qint64 historicalDeltaSize;
+
         qint64 poolSize;
 
+        qint64 compressedSize;
         qint64 swapSize;
+        qint64 swapReclaimedSize;
+
+        /**
+         * Size of the undo history moved into the undo file
+         */
+        qint64 historicalSwapSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -49,15 +66,17 @@ public:
 
     /**
      * Returns total number of tiles present: in memory
-     * or in a swap file
+     * (compressed or not) or in a swap file
      */
     inline qint32 numTiles() const
     {
-        return m_numTiles.loadAcquire() + m_swappedStore.numTiles();
+        return m_numTiles.loadAcquire() +
+            m_compressedStore.numTiles() +
+            m_swappedStore.numTiles();
     }
 
     /**
-     * Returns the number of tiles present in memory only
+     * Returns the number of uncompressed tiles present in memory only
      */
     inline qint32 numTilesInMemory() const
     {
@@ -77,6 +96,51 @@ public:
         return m_memoryMetric.loadAcquire();
     }
 
+    inline KisUndoSwapStore* undoSwapStore()
+    {
+        return &m_undoSwapStore;
+    }
+
+    inline KisUniformTileDataCache* uniformTileDataCache()
+    {
+        return &m_uniformTileDataCache;
+    }
+
+    /**
+     * Shows if the tiles that became filled with a single color
+     * should be replaced with the shared uniform tile data on
+     * commit, see KisMementoManager::shareUniformTiles()
+     */
+    inline bool shareUniformTiles() const
+    {
+        return m_shareUniformTiles.loadAcquire();
+    }
+
+    /**
+     * The policy of moving the undo history into the undo
+     * file, see KisMementoManager::swapOutOldRevisions()
+     */
+    inline bool undoSwapEnabled() const
+    {
+        return m_undoSwapEnabled.loadAcquire();
+    }
+
+    inline qint64 undoMemoryLimit() const
+    {
+        return m_undoMemoryLimit.loadAcquire();
+    }
+
+    inline int undoInMemorySteps() const
+    {
+        return m_undoInMemorySteps.loadAcquire();
+    }
+
+    /**
+     * The amount of RAM occupied by the undo history, as it was
+     * estimated by the pooler during its last cycle
+     */
+    qint64 undoMemoryInRam() const;
+
     KisTileDataStoreIterator* beginIteration();
     void endIteration(KisTileDataStoreIterator* iterator);
 
@@ -100,6 +164,27 @@ public:
         m_swapper.kick();
     }
 
+    /**
+     * Returns true if some of the tiles are swapped out or
+     * compressed, that is, if it makes sense to prefetch them
+     */
+    inline bool hasSwappedTiles() const
+    {
+        return m_swappedStore.numTiles() || m_compressedStore.numTiles();
+    }
+
+    /**
+     * Ask the prefetcher thread to load the data of \p tile into
+     * memory in background. Please check hasSwappedTiles() before
+     * calling it to avoid useless overhead.
+     */
+    inline void prefetchTile(KisTile *tile)
+    {
+        if (m_prefetcher.isEnabled()) {
+            m_prefetcher.prefetchTile(tile);
+        }
+    }
+
     /**
      * Try swap out the tile data.
      * It may fail in case the tile is being accessed
@@ -107,6 +192,41 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Returns the number of bytes occupied by the tiles
+     * compressed in memory
+     */
+    inline qint64 compressedMemoryUsed() const
+    {
+        return m_compressedStore.compressedMemoryUsed();
+    }
+
+    /**
+     * Moves the oldest tiles from the in-memory compressed
+     * store into the swap file until at least \p needToFree
+     * bytes of the compressed store are freed.
+     *
+     * Returns the number of bytes actually freed
+     */
+    qint64 evictCompressedTiles(qint64 needToFree);
+
+    /**
+     * Returns true if the swap file has too many holes
+     * and should be compacted with compactSwapFile()
+     */
+    bool swapFileNeedsCompaction();
+
+    /**
+     * Relocates up to \p maxBytesToMove bytes of swapped data
+     * into the holes of the swap file and truncates it. The data
+     * is moved in small batches, so the swapping of the tiles is
+     * blocked only for short periods of time. It should still be
+     * called when the user is idle.
+     *
+     * Returns the number of bytes the swap file has been shrunk by
+     */
+    qint64 compactSwapFile(qint64 maxBytesToMove);
+
 
     /**
      * WARN: The following three method are only for usage
@@ -122,10 +242,10 @@ public:
      * and it's swapping is blocked by holding td->m_swapLock
      * in a read mode.
      * PRECONDITIONS: td->m_swapLock is *unlocked*
-     *                m_listRWLock is *unlocked*
+     *                m_iteratorLock is *unlocked*
      * POSTCONDITIONS: td->m_data is in memory and
      *                 td->m_swapLock is locked
-     *                 m_listRWLock is unlocked
+     *                 m_iteratorLock is unlocked
      */
     void ensureTileDataLoaded(KisTileData *td);
 
@@ -150,13 +270,25 @@ private:
 
     friend class KisLowMemoryBenchmark;
     void testingRereadConfig();
+
+    void readUndoSwapConfig();
+
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
     KisSwappedDataStore m_swappedStore;
+    KisCompressedDataStore m_compressedStore;
+    KisUndoSwapStore m_undoSwapStore;
+    KisUniformTileDataCache m_uniformTileDataCache;
+    QAtomicInt m_shareUniformTiles;
+
+    QAtomicInt m_undoSwapEnabled;
+    QAtomicInteger<qint64> m_undoMemoryLimit;
+    QAtomicInt m_undoInMemorySteps;
 
     /**
      * This metric is used for computing the volume
@@ -25,7 +25,10 @@
  * How to use:
  *   1) each hash must be unique, otherwise tiles would rewrite each-other
  *   2) 0 key is reserved, so can't be used
- *   3) col and row must be less than 0x7FFF to guarantee uniqueness of hash for each pair
+ *   3) col and row must be less than 0x7FFF to guarantee uniqueness of hash for each pair,
+ *      so the addressable area depends on the size of the tile: it is
+ *      0x7FFF * KisTileData::WIDTH pixels in each direction (about 1M
+ *      pixels for the smallest 32x32 tiles)
  */
 
 template <class T>
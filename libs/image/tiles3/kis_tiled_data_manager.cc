@@ -22,7 +22,7 @@
 #include "kis_global.h"
 
 
-/* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
+/* The data area is divided into tiles each say 64x64 pixels (KRITA_TILE_SIZE, defined at compiletime)
  * The tiles are laid out in a matrix that can have negative indexes.
  * The matrix grows automatically if needed (a call for writeacces to a tile
  * outside the current extent)
@@ -148,6 +148,8 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     quint32 numTiles;
     qint32 tilesVersion = LEGACY_VERSION;
+    qint32 tileWidth = KisTileData::WIDTH;
+    qint32 tileHeight = KisTileData::HEIGHT;
 
     if (line[0] == 'V') {
         QList<QByteArray> lineItems = line.split(' ');
@@ -157,7 +159,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
         tilesVersion = lineItems.takeFirst().toInt();
 
-        if(!processTilesHeader(stream, numTiles))
+        if(!processTilesHeader(stream, numTiles, tileWidth, tileHeight))
             return false;
     }
     else {
@@ -166,6 +168,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     KisAbstractTileCompressorSP compressor =
         KisTileCompressorFactory::create(tilesVersion);
+    compressor->setStreamTileSize(tileWidth, tileHeight);
 
     bool readSuccess = true;
     for (quint32 i = 0; i < numTiles; i++) {
@@ -206,7 +209,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
     } while(0)                                                  \
 
 
-bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles)
+bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                                             qint32 &tileWidth, qint32 &tileHeight)
 {
     /**
      * We assume that there is only one version of this header
@@ -225,13 +229,20 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
     while(!foundDataMark && stream->canReadLine()) {
         takeOneLine(stream, maxLineLength, keyword, value);
 
+        /**
+         * The tiles might have been written by a build with
+         * different KRITA_TILE_SIZE, the compressor will
+         * convert them
+         */
         if (keyword == "TILEWIDTH") {
-            if(value != KisTileData::WIDTH)
+            if(value <= 0 || value > KisAbstractTileCompressor::MAX_STREAM_TILE_SIZE)
                 goto wrongString;
+            tileWidth = value;
         }
         else if (keyword == "TILEHEIGHT") {
-            if(value != KisTileData::HEIGHT)
+            if(value <= 0 || value > KisAbstractTileCompressor::MAX_STREAM_TILE_SIZE)
                 goto wrongString;
+            tileHeight = value;
         }
         else if (keyword == "PIXELSIZE") {
             if((quint32)value != pixelSize())
@@ -251,9 +262,15 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
     if(testsPassed != totalNumTests) {
         warnTiles << "Not enough fields of tiles header present"
                   << testsPassed << "of" << totalNumTests;
+        return false;
     }
 
-    return testsPassed == totalNumTests;
+    if (!KisAbstractTileCompressor::isValidStreamTileSize(tileWidth, tileHeight, pixelSize())) {
+        warnTiles << "Wrong size of the tiles in tiles header:" << tileWidth << tileHeight << pixelSize();
+        return false;
+    }
+
+    return true;
 
 wrongString:
     warnTiles << "Wrong string in tiles header:" << keyword << value;
@@ -275,7 +292,15 @@ void KisTiledDataManager::purge(const QRect& area)
         while ((tile = iter.tile())) {
             if (tile->extent().intersects(area)) {
                 tile->lockForRead();
-                if(memcmp(defaultData, tile->data(), tileDataSize) == 0) {
+
+                /**
+                 * Uniform tiles are never changed in place, so
+                 * comparing a single pixel is enough
+                 */
+                const qint32 compareSize =
+                    tile->tileData()->isUniform() ? pixelSize() : tileDataSize;
+
+                if(memcmp(defaultData, tile->data(), compareSize) == 0) {
                     tilesToDelete.push_back(tile);
                 }
                 tile->unlockForRead();
@@ -348,8 +373,7 @@ void KisTiledDataManager::clear(QRect clearRect, const quint8 *clearPixel)
         clearRect.width() >= KisTileData::WIDTH &&
         clearRect.height() >= KisTileData::HEIGHT) {
 
-        td = KisTileDataStore::instance()->createDefaultTileData(pixelSize, clearPixel);
-        td->acquire();
+        td = KisTileDataStore::instance()->uniformTileDataCache()->acquireTileData(pixelSize, clearPixel);
     }
 
     for (qint32 row = firstRow; row <= lastRow; ++row) {
@@ -660,6 +684,31 @@ QRect KisTiledDataManager::extent() const
     return m_extentManager.extent();
 }
 
+void KisTiledDataManager::prefetchRect(const QRect &rect) const
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    /**
+     * Most of the time nothing is swapped, so avoid the
+     * overhead of walking through the hash table
+     */
+    if (rect.isEmpty() || !store->hasSwappedTiles()) return;
+
+    const qint32 firstColumn = xToCol(rect.left());
+    const qint32 lastColumn = xToCol(rect.right());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    for (qint32 row = firstRow; row <= lastRow; ++row) {
+        for (qint32 column = firstColumn; column <= lastColumn; ++column) {
+            KisTileSP tile = m_hashTable->getExistingTile(column, row);
+            if (tile) {
+                store->prefetchTile(tile.data());
+            }
+        }
+    }
+}
+
 KisRegion KisTiledDataManager::region() const
 {
     QVector<QRect> rects;
@@ -675,6 +724,23 @@ KisRegion KisTiledDataManager::region() const
     return KisRegion(std::move(rects));
 }
 
+KisRegion KisTiledDataManager::takeChangedRegion()
+{
+    QVector<QRect> rects;
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        if (tile->takeChangedFlag()) {
+            rects << tile->extent();
+        }
+        iter.next();
+    }
+
+    return KisRegion(std::move(rects));
+}
+
 void KisTiledDataManager::setPixel(qint32 x, qint32 y, const quint8 * data)
 {
     KisTileDataWrapper tw(this, x, y, KisTileDataWrapper::WRITE);
@@ -697,6 +763,7 @@ void KisTiledDataManager::readBytes(quint8 *data,
                                     qint32 dataRowStride) const
 {
     QReadLocker locker(&m_lock);
+    prefetchRect(QRect(x, y, width, height));
     // Actual bytes reading/writing is done in private header
     readBytesBody(data, x, y, width, height, dataRowStride);
 }
@@ -707,6 +774,7 @@ KisTiledDataManager::readPlanarBytes(QVector<qint32> channelSizes,
                                      qint32 width, qint32 height) const
 {
     QReadLocker locker(&m_lock);
+    prefetchRect(QRect(x, y, width, height));
     // Actual bytes reading/writing is done in private header
     return readPlanarBytesBody(channelSizes, x, y, width, height);
 }
@@ -149,6 +149,10 @@ public:
             memento->saveNewDefaultPixel(m_defaultPixel, m_pixelSize);
         }
 
+        if (KisTileDataStore::instance()->shareUniformTiles()) {
+            m_mementoManager->shareUniformTiles(m_hashTable);
+        }
+
         m_mementoManager->commit();
     }
 
@@ -209,6 +213,14 @@ protected:
 public:
 
 
+    /**
+     * Announce that the tiles covering \p rect are going to be
+     * accessed soon. If some of them are swapped out, they will be
+     * loaded in background by KisTileDataPrefetcher. Non-existing
+     * tiles are skipped.
+     */
+    void prefetchRect(const QRect &rect) const;
+
     void  extent(qint32 &x, qint32 &y, qint32 &w, qint32 &h) const;
     void  setExtent(qint32 x, qint32 y, qint32 w, qint32 h);
     QRect extent() const;
@@ -216,6 +228,14 @@ public:
 
     KisRegion region() const;
 
+    /**
+     * Returns the region of the tiles that have been changed (or
+     * created) since the previous call to this method and resets
+     * their state. The tiles removed in the meantime are not
+     * reported, the caller should compare region() to find them.
+     */
+    KisRegion takeChangedRegion();
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
@@ -358,7 +378,8 @@ private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
     bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
-    bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
+    bool processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                            qint32 &tileWidth, qint32 &tileHeight);
 
     inline qint32 divideRoundDown(qint32 x, const qint32 y) const
     {
@@ -0,0 +1,106 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_uniform_tile_data_cache.h"
+
+#include <QMutexLocker>
+
+#include "kis_tile_data.h"
+#include "kis_tile_data_store.h"
+
+
+KisUniformTileDataCache::KisUniformTileDataCache(KisTileDataStore *store)
+    : m_store(store)
+{
+}
+
+KisUniformTileDataCache::~KisUniformTileDataCache()
+{
+    clear();
+}
+
+KisTileData* KisUniformTileDataCache::acquireTileData(qint32 pixelSize, const quint8 *pixel)
+{
+    const QByteArray key((const char*)pixel, pixelSize);
+
+    QMutexLocker l(&m_lock);
+
+    KisTileData *td = m_entries.value(key, 0);
+
+    if (!td) {
+        if (m_entries.size() >= MAX_ENTRIES) {
+            releaseUnusedTileDataLocked();
+        }
+
+        td = m_store->createDefaultTileData(pixelSize, pixel);
+        td->setUniform(true);
+
+        /**
+         * If the cache is full of the colors that are still in use,
+         * the tile data is not shared, but it is still uniform until
+         * it is changed in place
+         */
+        if (m_entries.size() < MAX_ENTRIES) {
+            td->acquire();
+            m_entries.insert(key, td);
+        }
+    }
+
+    td->acquire();
+    return td;
+}
+
+void KisUniformTileDataCache::releaseUnusedTileData()
+{
+    QMutexLocker l(&m_lock);
+    releaseUnusedTileDataLocked();
+}
+
+void KisUniformTileDataCache::releaseUnusedTileDataLocked()
+{
+    auto it = m_entries.begin();
+    while (it != m_entries.end()) {
+        KisTileData *td = it.value();
+
+        /**
+         * New users can appear only via acquireTileData() or via
+         * COW-sharing from the existing users, so the check is safe
+         * while we hold the lock
+         */
+        if (td->numUsers() <= 1) {
+            td->release();
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KisUniformTileDataCache::clear()
+{
+    QMutexLocker l(&m_lock);
+
+    Q_FOREACH (KisTileData *td, m_entries) {
+        td->release();
+    }
+    m_entries.clear();
+}
+
+int KisUniformTileDataCache::numEntries() const
+{
+    QMutexLocker l(&m_lock);
+    return m_entries.size();
+}
+
+bool KisUniformTileDataCache::isUniformData(const quint8 *data, qint32 pixelSize)
+{
+    /**
+     * The data is uniform iff every byte is equal to the byte
+     * that is one pixel further, which is a single memcmp()
+     */
+    const qint32 tileDataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+    return !memcmp(data, data + pixelSize, tileDataSize - pixelSize);
+}
@@ -0,0 +1,75 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_UNIFORM_TILE_DATA_CACHE_H
+#define __KIS_UNIFORM_TILE_DATA_CACHE_H
+
+#include "kritaimage_export.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+class KisTileData;
+class KisTileDataStore;
+
+/**
+ * Keeps one shared tile data object per color for the tiles that
+ * are filled with a single color (flat fills, selections, masks).
+ * All such tiles of all the devices point to the same tile data,
+ * the same way the non-existing tiles share the default tile data
+ * of the hash table. The tile data objects are marked with
+ * KisTileData::setUniform().
+ *
+ * The cache owns a user reference to every tile data it keeps, so
+ * the tiles never change the data in place and always COW it.
+ */
+class KRITAIMAGE_EXPORT KisUniformTileDataCache
+{
+public:
+    static const int MAX_ENTRIES = 256;
+
+public:
+    KisUniformTileDataCache(KisTileDataStore *store);
+    ~KisUniformTileDataCache();
+
+    /**
+     * Returns a tile data filled with \p pixel. The tile data is
+     * acquired for the caller, so it should be released with
+     * KisTileData::release() when not needed anymore.
+     */
+    KisTileData* acquireTileData(qint32 pixelSize, const quint8 *pixel);
+
+    /**
+     * Drops the tile data objects that are not used by
+     * any tile or memento
+     */
+    void releaseUnusedTileData();
+
+    /**
+     * Drops all the tile data objects from the cache
+     */
+    void clear();
+
+    int numEntries() const;
+
+    /**
+     * Returns true if the tile \p data consists
+     * of the same pixel repeated
+     */
+    static bool isUniformData(const quint8 *data, qint32 pixelSize);
+
+private:
+    void releaseUnusedTileDataLocked();
+
+private:
+    KisTileDataStore *m_store;
+
+    mutable QMutex m_lock;
+    QHash<QByteArray, KisTileData*> m_entries;
+};
+
+#endif /* __KIS_UNIFORM_TILE_DATA_CACHE_H */
@@ -43,13 +43,16 @@ KisVLineIterator2::KisVLineIterator2(KisDataManager *dataManager, qint32 x, qint
     m_column = xToCol(m_x);
     m_xInTile = calcXInTile(m_x, m_column);
 
-    m_topInTopmostTile = m_top - m_topRow * KisTileData::WIDTH;
+    m_topInTopmostTile = m_top - m_topRow * KisTileData::HEIGHT;
 
     m_tilesCacheSize = m_bottomRow - m_topRow + 1;
     m_tilesCache.resize(m_tilesCacheSize);
 
     m_tileSize = m_lineStride * KisTileData::HEIGHT;
 
+    // let the prefetcher load the tiles while we are fetching the first column
+    prefetchTiles(m_column, 2);
+
     // let's preallocate first row
     for (int i = 0; i < m_tilesCacheSize; i++){
         fetchTileDataForCache(m_tilesCache[i], m_column, m_topRow + i);
@@ -106,7 +109,7 @@ void KisVLineIterator2::nextColumn()
     m_y = m_top;
     ++m_x;
 
-    if (++m_xInTile < KisTileData::HEIGHT) {
+    if (++m_xInTile < KisTileData::WIDTH) {
         /* do nothing, usual case */
     } else {
         ++m_column;
@@ -204,6 +207,8 @@ void KisVLineIterator2::fetchTileDataForCache(KisTileInfo& kti, qint32 col, qint
 
 void KisVLineIterator2::preallocateTiles()
 {
+    prefetchTiles(m_column + 1, 1);
+
     for (int i = 0; i < m_tilesCacheSize; ++i){
         unlockTile(m_tilesCache[i].tile);
         unlockOldTile(m_tilesCache[i].oldtile);
@@ -211,6 +216,16 @@ void KisVLineIterator2::preallocateTiles()
     }
 }
 
+void KisVLineIterator2::prefetchTiles(qint32 column, qint32 numColumns)
+{
+    /**
+     * We don't know how many columns the user is going to walk
+     * through, so we just announce a few columns ahead of the cursor
+     */
+    m_dataManager->prefetchRect(QRect(column * KisTileData::WIDTH, m_top,
+                                      numColumns * KisTileData::WIDTH, m_bottom - m_top + 1));
+}
+
 qint32 KisVLineIterator2::x() const
 {
     return m_x + m_offsetX;
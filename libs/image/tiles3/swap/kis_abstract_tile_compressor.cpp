@@ -6,10 +6,37 @@
 
 #include "kis_abstract_tile_compressor.h"
 
+#include <limits>
+
+const qint32 KisAbstractTileCompressor::MAX_STREAM_TILE_SIZE = 256;
+
 KisAbstractTileCompressor::KisAbstractTileCompressor()
+    : m_streamTileWidth(KisTileData::WIDTH),
+      m_streamTileHeight(KisTileData::HEIGHT)
 {
 }
 
 KisAbstractTileCompressor::~KisAbstractTileCompressor()
 {
 }
+
+void KisAbstractTileCompressor::setStreamTileSize(qint32 width, qint32 height)
+{
+    m_streamTileWidth = width;
+    m_streamTileHeight = height;
+}
+
+bool KisAbstractTileCompressor::isValidStreamTileSize(qint32 width, qint32 height, qint32 pixelSize)
+{
+    if (width <= 0 || width > MAX_STREAM_TILE_SIZE ||
+        height <= 0 || height > MAX_STREAM_TILE_SIZE ||
+        pixelSize <= 0) {
+
+        return false;
+    }
+
+    const qint64 tileDataSize = qint64(pixelSize) * width * height;
+
+    // one more byte is needed for the compression flag
+    return tileDataSize < std::numeric_limits<qint32>::max();
+}
@@ -78,7 +78,35 @@ public:
      */
     virtual qint32 tileDataBufferSize(KisTileData *tileData) = 0;
 
+    /**
+     * Sets the size of the tiles stored in the stream passed to
+     * readTile(). The stream might have been written by a build
+     * of Krita with different KRITA_TILE_SIZE, in such a case the
+     * pixels are copied into the data manager rect-by-rect.
+     */
+    void setStreamTileSize(qint32 width, qint32 height);
+
+    /**
+     * Checks that the tiles of \p width x \p height pixels of
+     * \p pixelSize bytes read from a stream are sane. The tile size
+     * may not exceed MAX_STREAM_TILE_SIZE (the biggest KRITA_TILE_SIZE
+     * a build can have) and the size of the tile data must fit into
+     * qint32.
+     */
+    static bool isValidStreamTileSize(qint32 width, qint32 height, qint32 pixelSize);
+
+    static const qint32 MAX_STREAM_TILE_SIZE;
+
 protected:
+    inline bool streamHasNativeTileSize() const {
+        return m_streamTileWidth == KisTileData::WIDTH &&
+            m_streamTileHeight == KisTileData::HEIGHT;
+    }
+
+    inline void writeBytes(KisTiledDataManager *dm, const quint8 *data, const QRect &rect) {
+        dm->writeBytesBody(data, rect.x(), rect.y(), rect.width(), rect.height());
+    }
+
     inline qint32 xToCol(KisTiledDataManager *dm, qint32 x) {
         return dm->xToCol(x);
     }
@@ -90,6 +118,10 @@ protected:
     inline qint32 pixelSize(KisTiledDataManager *dm) {
         return dm->pixelSize();
     }
+
+protected:
+    qint32 m_streamTileWidth;
+    qint32 m_streamTileHeight;
 };
 
 #endif /* __KIS_ABSTRACT_TILE_COMPRESSOR_H */
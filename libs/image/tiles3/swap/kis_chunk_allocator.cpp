@@ -33,13 +33,26 @@ KisChunkAllocator::~KisChunkAllocator()
 }
 
 KisChunk KisChunkAllocator::getChunk(quint64 size)
+{
+    KisChunk chunk;
+
+    if (!tryGetChunk(size, &chunk)) {
+        qFatal("KisChunkAllocator: out of swap space");
+    }
+
+    return chunk;
+}
+
+bool KisChunkAllocator::tryGetChunk(quint64 size, KisChunk *chunk)
 {
     KisChunkDataListIterator startPosition = m_iterator;
     START_COUNTING();
 
     forever {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+        if(tryInsertChunk(m_list, m_iterator, size)) {
+            *chunk = WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+            return true;
+        }
 
         if(m_iterator == m_list.end())
             break;
@@ -52,8 +65,10 @@ KisChunk KisChunkAllocator::getChunk(quint64 size)
     m_iterator = m_list.begin();
 
     forever {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+        if(tryInsertChunk(m_list, m_iterator, size)) {
+            *chunk = WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+            return true;
+        }
 
         if(m_iterator == m_list.end() || m_iterator == startPosition)
             break;
@@ -65,15 +80,16 @@ KisChunk KisChunkAllocator::getChunk(quint64 size)
     REGISTER_FAIL();
     m_iterator = m_list.end();
 
-    while ((m_storeSize += m_storeSlabSize) <= m_storeMaxSize) {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
-    }
+    while (m_storeSize + m_storeSlabSize <= m_storeMaxSize) {
+        m_storeSize += m_storeSlabSize;
 
-    qFatal("KisChunkAllocator: out of swap space");
+        if(tryInsertChunk(m_list, m_iterator, size)) {
+            *chunk = WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+            return true;
+        }
+    }
 
-    // just let gcc be happy! :)
-    return KisChunk(m_list.end());
+    return false;
 }
 
 bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
@@ -113,6 +129,74 @@ void KisChunkAllocator::freeChunk(KisChunk chunk)
 }
 
 
+bool KisChunkAllocator::tryInsertChunkBefore(quint64 size, quint64 limit,
+                                             KisChunkDataListIterator &iterator,
+                                             KisChunk *chunk)
+{
+    forever {
+        const quint64 lowBound =
+            HAS_PREVIOUS(m_list, iterator) ? PEEK_PREVIOUS(iterator).m_end + 1 : 0;
+
+        if (lowBound + size > limit) break;
+
+        if (tryInsertChunk(m_list, iterator, size)) {
+            *chunk = WRAP_PREVIOUS_CHUNK_DATA(iterator);
+            return true;
+        }
+
+        if (iterator == m_list.end()) break;
+
+        iterator++;
+    }
+
+    return false;
+}
+
+quint64 KisChunkAllocator::compact(quint64 maxBytesToMove,
+                                   std::function<bool(KisChunk, KisChunk)> moveChunk)
+{
+    quint64 bytesMoved = 0;
+
+    /**
+     * The holes are filled in the order of addresses, so we
+     * never need to look behind the last found hole
+     */
+    KisChunkDataListIterator hole = m_list.begin();
+
+    while (bytesMoved < maxBytesToMove && !m_list.isEmpty()) {
+        KisChunk lastChunk(m_list.end() - 1);
+        KisChunk newChunk;
+
+        if (!tryInsertChunkBefore(lastChunk.size(), lastChunk.begin(), hole, &newChunk)) {
+            break;
+        }
+
+        if (!moveChunk(lastChunk, newChunk)) {
+            freeChunk(newChunk);
+            break;
+        }
+
+        if (hole == lastChunk.position()) {
+            hole = m_list.end();
+        }
+
+        freeChunk(lastChunk);
+        bytesMoved += lastChunk.size();
+    }
+
+    return bytesMoved;
+}
+
+quint64 KisChunkAllocator::shrinkStore()
+{
+    const quint64 usedSize = !m_list.isEmpty() ? m_list.last().m_end + 1 : 0;
+    const quint64 numSlabs = qMax(1ULL, (usedSize + m_storeSlabSize - 1) / m_storeSlabSize);
+
+    m_storeSize = qMin(m_storeSize, numSlabs * m_storeSlabSize);
+
+    return m_storeSize;
+}
+
 
 /**************************************************************/
 /*******             Debugging features                ********/
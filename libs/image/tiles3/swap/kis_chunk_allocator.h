@@ -8,6 +8,7 @@
 #define __KIS_CHUNK_LIST_H
 
 #include <QLinkedList>
+#include <functional>
 #include "kritaimage_export.h"
 
 #define MiB (1ULL << 20)
@@ -78,38 +79,51 @@ public:
     quint64 m_end;
 };
 
+/**
+ * A handle of a chunk allocated by KisChunkAllocator.
+ *
+ * The handle keeps a copy of the chunk boundaries, so they can be
+ * read without accessing the allocator's list, that is, without
+ * taking the lock that guards the allocator. The boundaries of
+ * the chunk never change while it is allocated.
+ */
 class KRITAIMAGE_EXPORT KisChunk
 {
 public:
-    KisChunk() {}
+    KisChunk()
+        : m_data(0, 0)
+    {
+    }
 
     KisChunk(KisChunkDataListIterator iterator)
-        : m_iterator(iterator)
+        : m_iterator(iterator),
+          m_data(*iterator)
     {
     }
 
     inline quint64 begin() const {
-        return m_iterator->m_begin;
+        return m_data.m_begin;
     }
 
     inline quint64 end() const {
-        return m_iterator->m_end;
+        return m_data.m_end;
     }
 
     inline quint64 size() const {
-        return m_iterator->size();
+        return m_data.size();
     }
 
     inline KisChunkDataListIterator position() {
         return m_iterator;
     }
 
-    inline const KisChunkData& data() {
-        return *m_iterator;
+    inline const KisChunkData& data() const {
+        return m_data;
     }
 
 private:
     KisChunkDataListIterator m_iterator;
+    KisChunkData m_data;
 };
 
 
@@ -125,8 +139,48 @@ public:
     }
 
     KisChunk getChunk(quint64 size);
+
+    /**
+     * Same as getChunk(), but returns false instead of
+     * crashing when the store is out of space
+     */
+    bool tryGetChunk(quint64 size, KisChunk *chunk);
+
     void freeChunk(KisChunk chunk);
 
+    /**
+     * The size of the address space currently used by the
+     * allocator, it grows by slabs when needed
+     */
+    inline quint64 storeSize() const {
+        return m_storeSize;
+    }
+
+    inline quint64 slabSize() const {
+        return m_storeSlabSize;
+    }
+
+    /**
+     * Moves the chunks from the end of the store into the holes
+     * at its beginning, until \p maxBytesToMove bytes are moved or
+     * no more chunks can be moved. For every chunk \p moveChunk is
+     * called with the old and the new position of the chunk, it
+     * should copy the data and return true on success. The old
+     * chunk is freed afterwards.
+     *
+     * Returns the number of bytes moved.
+     *
+     * \see shrinkStore()
+     */
+    quint64 compact(quint64 maxBytesToMove,
+                    std::function<bool(KisChunk, KisChunk)> moveChunk);
+
+    /**
+     * Drops the unused slabs at the end of the store. Returns
+     * the new size of the store.
+     */
+    quint64 shrinkStore();
+
     void debugChunks();
     bool sanityCheck(bool pleaseCrash = true);
     qreal debugFragmentation(bool toStderr = true);
@@ -136,6 +190,10 @@ private:
                         KisChunkDataListIterator &iterator,
                         quint64 size);
 
+    bool tryInsertChunkBefore(quint64 size, quint64 limit,
+                              KisChunkDataListIterator &iterator,
+                              KisChunk *chunk);
+
 private:
     quint64 m_storeMaxSize;
     quint64 m_storeSlabSize;
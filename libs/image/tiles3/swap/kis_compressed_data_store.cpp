@@ -0,0 +1,272 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_compressed_data_store.h"
+
+#include "kis_debug.h"
+#include "kis_tile_compressor_2.h"
+#include "kis_swapped_data_store.h"
+#include "tiles3/kis_tile_data.h"
+
+#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
+
+
+struct KisCompressedDataStore::Slab
+{
+    Slab(quint64 size)
+        : allocator(size, size),
+          data(static_cast<quint8*>(malloc(size)))
+    {
+    }
+
+    ~Slab() {
+        free(data);
+    }
+
+    KisChunkAllocator allocator;
+    quint8 *data;
+};
+
+
+KisCompressedDataStore::KisCompressedDataStore(quint64 maxArenaSize, quint64 slabSize)
+    : m_maxArenaSize(maxArenaSize),
+      m_slabSize(slabSize),
+      m_arenaSize(0),
+      m_compressedMemoryUsed(0),
+      m_totalUncompressedMemoryUsed(0)
+{
+    m_compressor = new KisTileCompressor2(
+        KisCompressionRegistry::codecForUsage(KisCompressionRegistry::InMemoryUsage));
+}
+
+KisCompressedDataStore::~KisCompressedDataStore()
+{
+    qDeleteAll(m_slabs);
+    delete m_compressor;
+}
+
+bool KisCompressedDataStore::isEnabled() const
+{
+    return m_maxArenaSize >= m_slabSize;
+}
+
+quint64 KisCompressedDataStore::numTiles() const
+{
+    // see a comment in KisSwappedDataStore::numTiles()
+    return m_entries.size();
+}
+
+bool KisCompressedDataStore::tryAllocate(qint32 size, int *slabIndex, KisChunk *chunk)
+{
+    /**
+     * Try the most recently created slabs first, the older ones
+     * will probably be emptied by eviction soon
+     */
+    for (int i = m_slabs.size() - 1; i >= 0; i--) {
+        Slab *slab = m_slabs[i];
+        if (slab && slab->allocator.tryGetChunk(size, chunk)) {
+            *slabIndex = i;
+            return true;
+        }
+    }
+
+    if (m_arenaSize + m_slabSize > m_maxArenaSize) {
+        return false;
+    }
+
+    Slab *newSlab = new Slab(m_slabSize);
+    if (!newSlab->data) {
+        delete newSlab;
+        return false;
+    }
+
+    int index = m_slabs.indexOf(0);
+    if (index < 0) {
+        index = m_slabs.size();
+        m_slabs.append(newSlab);
+    } else {
+        m_slabs[index] = newSlab;
+    }
+
+    m_arenaSize += m_slabSize;
+
+    if (!newSlab->allocator.tryGetChunk(size, chunk)) {
+        delete newSlab;
+        m_slabs[index] = 0;
+        m_arenaSize -= m_slabSize;
+        return false;
+    }
+
+    *slabIndex = index;
+    return true;
+}
+
+void KisCompressedDataStore::freeEntry(const Entry &entry)
+{
+    Slab *slab = m_slabs[entry.slab];
+    KIS_SAFE_ASSERT_RECOVER_RETURN(slab);
+
+    m_compressedMemoryUsed -= entry.chunk.size();
+    slab->allocator.freeChunk(entry.chunk);
+
+    // return the empty slab to the system
+    if (!slab->allocator.numChunks()) {
+        delete slab;
+        m_slabs[entry.slab] = 0;
+        m_arenaSize -= m_slabSize;
+    }
+}
+
+bool KisCompressedDataStore::tryCompressTileData(KisTileData *td)
+{
+    Q_ASSERT(td->data());
+    QMutexLocker locker(&m_lock);
+
+    /**
+     * We are expecting that the lock of KisTileData
+     * has already been taken by the caller for us.
+     * So we can modify the tile data freely.
+     */
+
+    const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
+    if(m_buffer.size() < expectedBufferSize)
+        m_buffer.resize(expectedBufferSize);
+
+    qint32 bytesWritten;
+    m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
+
+    Entry entry;
+    if (!tryAllocate(bytesWritten, &entry.slab, &entry.chunk)) {
+        return false;
+    }
+
+    memcpy(m_slabs[entry.slab]->data + entry.chunk.begin(), m_buffer.data(), bytesWritten);
+
+    entry.queuePosition = m_queue.insert(m_queue.end(), td);
+    m_entries.insert(td, entry);
+
+    m_compressedMemoryUsed += bytesWritten;
+    m_totalUncompressedMemoryUsed += TILE_DATA_SIZE(td->pixelSize());
+
+    td->releaseMemory();
+
+    return true;
+}
+
+void KisCompressedDataStore::decompressTileData(KisTileData *td)
+{
+    Q_ASSERT(!td->data());
+    QMutexLocker locker(&m_lock);
+
+    // see comment in tryCompressTileData()
+
+    auto it = m_entries.find(td);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(it != m_entries.end());
+
+    const Entry entry = *it;
+    m_entries.erase(it);
+    m_queue.erase(entry.queuePosition);
+
+    td->allocateMemory();
+
+    quint8 *ptr = m_slabs[entry.slab]->data + entry.chunk.begin();
+    m_compressor->decompressTileData(ptr, entry.chunk.size(), td);
+
+    m_totalUncompressedMemoryUsed -= TILE_DATA_SIZE(td->pixelSize());
+    freeEntry(entry);
+}
+
+bool KisCompressedDataStore::tryEvictTileData(KisTileData *td, KisSwappedDataStore *swappedStore)
+{
+    Q_ASSERT(!td->data());
+    QMutexLocker locker(&m_lock);
+
+    auto it = m_entries.find(td);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(it != m_entries.end(), false);
+
+    const Entry entry = *it;
+    const quint8 *ptr = m_slabs[entry.slab]->data + entry.chunk.begin();
+
+    if (!swappedStore->trySwapOutCompressedData(td, ptr, entry.chunk.size())) {
+        return false;
+    }
+
+    m_entries.erase(it);
+    m_queue.erase(entry.queuePosition);
+
+    m_totalUncompressedMemoryUsed -= TILE_DATA_SIZE(td->pixelSize());
+    freeEntry(entry);
+
+    return true;
+}
+
+void KisCompressedDataStore::forgetTileData(KisTileData *td)
+{
+    QMutexLocker locker(&m_lock);
+
+    auto it = m_entries.find(td);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(it != m_entries.end());
+
+    const Entry entry = *it;
+    m_entries.erase(it);
+    m_queue.erase(entry.queuePosition);
+
+    m_totalUncompressedMemoryUsed -= TILE_DATA_SIZE(td->pixelSize());
+    freeEntry(entry);
+}
+
+QVector<KisTileData*> KisCompressedDataStore::oldestTiles(int maxTiles) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QVector<KisTileData*> result;
+    result.reserve(qMin(maxTiles, m_queue.size()));
+
+    for (auto it = m_queue.constBegin();
+         it != m_queue.constEnd() && result.size() < maxTiles;
+         ++it) {
+
+        result.append(*it);
+    }
+
+    return result;
+}
+
+qint64 KisCompressedDataStore::compressedMemoryUsed() const
+{
+    return m_compressedMemoryUsed;
+}
+
+qint64 KisCompressedDataStore::arenaSize() const
+{
+    return m_arenaSize;
+}
+
+qint64 KisCompressedDataStore::totalUncompressedMemoryUsed() const
+{
+    return m_totalUncompressedMemoryUsed;
+}
+
+qint64 KisCompressedDataStore::maxArenaSize() const
+{
+    return m_maxArenaSize;
+}
+
+void KisCompressedDataStore::debugStatistics()
+{
+    QMutexLocker locker(&m_lock);
+
+    qInfo() << "Compressed tiles:\t" << m_entries.size();
+    qInfo() << "Arena size:\t\t" << arenaSize();
+    qInfo() << "Compressed data:\t" << m_compressedMemoryUsed;
+    qInfo() << "Uncompressed data:\t" << m_totalUncompressedMemoryUsed;
+
+    Q_FOREACH (Slab *slab, m_slabs) {
+        if (slab) {
+            slab->allocator.sanityCheck();
+        }
+    }
+}
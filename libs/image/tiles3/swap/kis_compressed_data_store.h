@@ -0,0 +1,147 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_COMPRESSED_DATA_STORE_H
+#define __KIS_COMPRESSED_DATA_STORE_H
+
+#include "kritaimage_export.h"
+
+#include <QMutex>
+#include <QByteArray>
+#include <QHash>
+#include <QLinkedList>
+#include <QVector>
+
+#include "kis_chunk_allocator.h"
+
+#define DEFAULT_COMPRESSED_SLAB_SIZE (16*MiB)
+
+class KisTileData;
+class KisAbstractTileCompressor;
+class KisSwappedDataStore;
+
+/**
+ * The in-memory tier of the swapping subsystem. Cold tiles are first
+ * compressed into an arena in RAM and only when the arena gets full,
+ * they are evicted into the swap file (see KisSwappedDataStore). For
+ * typical documents the compression ratio is 3-5x, so most of the
+ * swap-file round trips can be avoided.
+ *
+ * The arena consists of slabs of a fixed size, every slab has its
+ * own KisChunkAllocator. Slabs that become empty are returned to the
+ * system.
+ *
+ * The tiles are evicted into the swap file in FIFO order, the
+ * compressed data is copied there as it is, without recompression.
+ */
+class KRITAIMAGE_EXPORT KisCompressedDataStore
+{
+public:
+    KisCompressedDataStore(quint64 maxArenaSize, quint64 slabSize = DEFAULT_COMPRESSED_SLAB_SIZE);
+    ~KisCompressedDataStore();
+
+    /**
+     * Returns true if the tier has non-zero size limit and is
+     * actually used by KisTileDataStore
+     */
+    bool isEnabled() const;
+
+    /**
+     * Returns number of compressed tile data objects
+     */
+    quint64 numTiles() const;
+
+    /**
+     * Compress the data stored in the \a td into the arena and
+     * free memory occupied by td->data(). Returns false if there
+     * is no space left in the arena.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool tryCompressTileData(KisTileData *td);
+
+    /**
+     * Restore the data of a \a td from the arena
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    void decompressTileData(KisTileData *td);
+
+    /**
+     * Move the compressed data of \a td into the swap file without
+     * decompressing it
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool tryEvictTileData(KisTileData *td, KisSwappedDataStore *swappedStore);
+
+    /**
+     * Forget all the information linked with the tile data.
+     * This should be done before deleting of the tile data,
+     * whose actual data is compressed
+     */
+    void forgetTileData(KisTileData *td);
+
+    /**
+     * Returns up to \p maxTiles tiles data objects that were
+     * compressed the earliest. They are the first candidates
+     * for eviction into the swap file.
+     */
+    QVector<KisTileData*> oldestTiles(int maxTiles) const;
+
+    /**
+     * Returns the number of bytes actually occupied by
+     * the compressed data
+     */
+    qint64 compressedMemoryUsed() const;
+
+    /**
+     * Returns the amount of memory requested from the system
+     * for the arena slabs
+     */
+    qint64 arenaSize() const;
+
+    /**
+     * Returns the size in bytes of the total memory stored in the arena
+     * in *uncompressed* form!
+     */
+    qint64 totalUncompressedMemoryUsed() const;
+
+    qint64 maxArenaSize() const;
+
+    void debugStatistics();
+
+private:
+    struct Slab;
+
+    struct Entry {
+        int slab = -1;
+        KisChunk chunk;
+        QLinkedList<KisTileData*>::iterator queuePosition;
+    };
+
+    bool tryAllocate(qint32 size, int *slabIndex, KisChunk *chunk);
+    void freeEntry(const Entry &entry);
+
+private:
+    QByteArray m_buffer;
+    KisAbstractTileCompressor *m_compressor;
+
+    QVector<Slab*> m_slabs;
+    QHash<KisTileData*, Entry> m_entries;
+    QLinkedList<KisTileData*> m_queue;
+
+    const quint64 m_maxArenaSize;
+    const quint64 m_slabSize;
+
+    mutable QMutex m_lock;
+
+    qint64 m_arenaSize;
+    qint64 m_compressedMemoryUsed;
+    qint64 m_totalUncompressedMemoryUsed;
+};
+
+#endif /* __KIS_COMPRESSED_DATA_STORE_H */
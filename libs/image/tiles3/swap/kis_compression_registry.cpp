@@ -0,0 +1,97 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_compression_registry.h"
+
+#include "kis_lzf_compression.h"
+#include "kis_lz4_compression.h"
+#include "kis_zlib_compression.h"
+#include "kis_image_config.h"
+#include "kis_debug.h"
+
+
+KisAbstractCompression* KisCompressionRegistry::create(int codec)
+{
+    switch (codec) {
+    case LZF:
+        return new KisLzfCompression();
+    case LZ4:
+        return new KisLz4Compression();
+    case ZLIB:
+        return new KisZlibCompression();
+    default:
+        return 0;
+    }
+}
+
+bool KisCompressionRegistry::isKnownCodec(int codec)
+{
+    return codec == LZF || codec == LZ4 || codec == ZLIB;
+}
+
+QString KisCompressionRegistry::codecName(int codec)
+{
+    switch (codec) {
+    case LZF:
+        return "LZF";
+    case LZ4:
+        return "LZ4";
+    case ZLIB:
+        return "ZLIB";
+    default:
+        return QString();
+    }
+}
+
+int KisCompressionRegistry::codecByName(const QString &name)
+{
+    const QString normalized = name.trimmed().toUpper();
+
+    if (normalized == "LZF") {
+        return LZF;
+    } else if (normalized == "LZ4") {
+        return LZ4;
+    } else if (normalized == "ZLIB") {
+        return ZLIB;
+    }
+
+    return 0;
+}
+
+QStringList KisCompressionRegistry::codecNames()
+{
+    return QStringList() << codecName(LZF) << codecName(LZ4) << codecName(ZLIB);
+}
+
+KisCompressionRegistry::Codec KisCompressionRegistry::codecForUsage(Usage usage)
+{
+    KisImageConfig config(true);
+
+    QString name;
+    QString defaultName;
+
+    switch (usage) {
+    case SwapUsage:
+        name = config.swapCompressionCodec();
+        defaultName = config.swapCompressionCodec(true);
+        break;
+    case InMemoryUsage:
+        name = config.inMemoryCompressionCodec();
+        defaultName = config.inMemoryCompressionCodec(true);
+        break;
+    case StorageUsage:
+        return LZF;
+    }
+
+    int codec = codecByName(name);
+
+    if (!codec) {
+        warnKrita << "Unknown tile compression codec" << name << "falling back to" << defaultName;
+        codec = codecByName(defaultName);
+    }
+
+    return Codec(codec);
+}
@@ -0,0 +1,79 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_COMPRESSION_REGISTRY_H
+#define __KIS_COMPRESSION_REGISTRY_H
+
+#include "kritaimage_export.h"
+#include <QString>
+#include <QStringList>
+
+class KisAbstractCompression;
+
+/**
+ * The list of compression algorithms that can be used for
+ * storing tiles.
+ *
+ * Every codec has a numeric id, which is written into the first byte
+ * of every compressed tile, and a name, which is written into the
+ * tile header of .kra files. Both of them are part of the file format,
+ * so the existing values must never be changed! LZF has id 1 to keep
+ * compatibility with the COMPRESSED_DATA_FLAG of the older versions of
+ * KisTileCompressor2.
+ */
+class KRITAIMAGE_EXPORT KisCompressionRegistry
+{
+public:
+    enum Codec {
+        LZF = 1,
+        LZ4 = 2,
+        ZLIB = 3
+    };
+
+    /**
+     * Different uses of the compression have different trade-offs,
+     * so the codec is chosen separately for every use
+     */
+    enum Usage {
+        SwapUsage,     ///< tiles swapped out into the swap file
+        InMemoryUsage, ///< tiles compressed in RAM
+        StorageUsage   ///< "layers" payload of .kra files, always LZF
+    };
+
+    /**
+     * Creates a new compression object for \p codec. The caller owns
+     * the result. Returns null for unknown codecs.
+     */
+    static KisAbstractCompression* create(int codec);
+
+    static bool isKnownCodec(int codec);
+
+    static QString codecName(int codec);
+
+    /**
+     * Returns the id of the codec with \p name or 0 if there
+     * is no such a codec
+     */
+    static int codecByName(const QString &name);
+
+    static QStringList codecNames();
+
+    /**
+     * Returns the codec selected by the user for the \p usage
+     * in KisImageConfig.
+     *
+     * The tiles of .kra files are always compressed with LZF. The
+     * older versions of Krita check only for the LZF flag and read
+     * any other codec as raw data, and the version of the tiles
+     * cannot be bumped either, because they abort on unknown versions.
+     */
+    static Codec codecForUsage(Usage usage);
+
+private:
+    KisCompressionRegistry();
+};
+
+#endif /* __KIS_COMPRESSION_REGISTRY_H */
@@ -52,6 +52,20 @@ bool KisLegacyTileCompressor::readTile(QIODevice *stream, KisTiledDataManager *d
 
     stream->readLine((char *)headerBuffer, bufferSize);
     sscanf((char *) headerBuffer, "%d,%d,%d,%d", &x, &y, &width, &height);
+    delete[] headerBuffer;
+
+    /**
+     * Legacy files always store 64x64 tiles, which may differ
+     * from the tiles of the current build
+     */
+    if (width != KisTileData::WIDTH || height != KisTileData::HEIGHT) {
+        if (!isValidStreamTileSize(width, height, pixelSize(dm))) return false;
+
+        QByteArray buffer(pixelSize(dm) * width * height, 0);
+        stream->read(buffer.data(), buffer.size());
+        writeBytes(dm, (const quint8*)buffer.constData(), QRect(x, y, width, height));
+        return true;
+    }
 
     qint32 row = yToRow(dm, y);
     qint32 col = xToCol(dm, x);
@@ -0,0 +1,297 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_lz4_compression.h"
+
+#include <cstring>
+
+#define LZ4_MIN_MATCH      4
+#define LZ4_LAST_LITERALS  5   /* the last 5 bytes are always literals */
+#define LZ4_MF_LIMIT      12   /* the last match must start 12 bytes before the end */
+#define LZ4_MAX_DISTANCE  65535
+
+#define LZ4_HASH_LOG  12
+#define LZ4_HASH_SIZE (1 << LZ4_HASH_LOG)
+
+#define LZ4_RUN_MASK  15
+#define LZ4_ML_MASK   15
+
+namespace {
+
+inline quint32 readU32(const quint8 *p)
+{
+    quint32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline quint64 readU64(const quint8 *p)
+{
+    quint64 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline quint32 hashU32(quint32 sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+/**
+ * Counts the number of equal bytes in \p ip and \p ref, comparing
+ * 8 bytes at a time
+ */
+inline const quint8* matchEnd(const quint8 *ip, const quint8 *ref, const quint8 *limit)
+{
+    while (ip + 8 <= limit) {
+        const quint64 diff = readU64(ip) ^ readU64(ref);
+        if (diff) {
+#if defined(__GNUC__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            return ip + (__builtin_ctzll(diff) >> 3);
+#else
+            break;
+#endif
+        }
+        ip += 8;
+        ref += 8;
+    }
+
+    while (ip < limit && *ip == *ref) {
+        ip++;
+        ref++;
+    }
+
+    return ip;
+}
+
+/**
+ * Copies data in 8-byte chunks, may overrun \p dst by up to 7 bytes
+ */
+inline void wildCopy(quint8 *dst, const quint8 *src, quint8 *dstEnd)
+{
+    do {
+        memcpy(dst, src, 8);
+        dst += 8;
+        src += 8;
+    } while (dst < dstEnd);
+}
+
+inline quint8* writeLength(quint8 *op, qint32 length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = length;
+    return op;
+}
+
+inline quint8* writeLiterals(quint8 *op, const quint8 *anchor, qint32 literalLength, quint8 matchNibble)
+{
+    quint8 *token = op++;
+
+    if (literalLength >= LZ4_RUN_MASK) {
+        *token = (LZ4_RUN_MASK << 4) | matchNibble;
+        op = writeLength(op, literalLength - LZ4_RUN_MASK);
+    } else {
+        *token = (literalLength << 4) | matchNibble;
+    }
+
+    memcpy(op, anchor, literalLength);
+    return op + literalLength;
+}
+
+}
+
+int lz4_compress(const quint8 *input, int length, quint8 *output)
+{
+    const quint8 *ip = input;
+    const quint8 *anchor = input;
+    const quint8 *const iend = input + length;
+    const quint8 *const mflimit = iend - LZ4_MF_LIMIT;
+    const quint8 *const matchlimit = iend - LZ4_LAST_LITERALS;
+
+    quint8 *op = output;
+
+    if (length > LZ4_MF_LIMIT) {
+        qint32 htab[LZ4_HASH_SIZE];
+        memset(htab, 0, sizeof(htab));
+
+        while (ip < mflimit) {
+            const quint32 sequence = readU32(ip);
+            const quint32 hash = hashU32(sequence);
+            const quint8 *ref = input + htab[hash];
+            htab[hash] = ip - input;
+
+            if (ref >= ip ||
+                ip - ref > LZ4_MAX_DISTANCE ||
+                readU32(ref) != sequence) {
+
+                /**
+                 * Skip faster through the incompressible areas, the
+                 * same way the reference implementation does
+                 */
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            /* extend the match backwards, over the pending literals */
+            while (ip > anchor && ref > input && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            const quint8 *end = matchEnd(ip + LZ4_MIN_MATCH, ref + LZ4_MIN_MATCH, matchlimit);
+
+            const qint32 literalLength = ip - anchor;
+            const qint32 matchLength = end - ip - LZ4_MIN_MATCH;
+            const quint16 offset = ip - ref;
+
+            op = writeLiterals(op, anchor, literalLength,
+                               matchLength >= LZ4_ML_MASK ? LZ4_ML_MASK : matchLength);
+
+            *op++ = offset & 0xff;
+            *op++ = offset >> 8;
+
+            if (matchLength >= LZ4_ML_MASK) {
+                op = writeLength(op, matchLength - LZ4_ML_MASK);
+            }
+
+            ip = end;
+            anchor = ip;
+
+            /* feed the hash table with the tail of the match */
+            if (ip < mflimit) {
+                htab[hashU32(readU32(ip - 2))] = ip - 2 - input;
+            }
+        }
+    }
+
+    /* left-over as literal copy */
+    op = writeLiterals(op, anchor, iend - anchor, 0);
+
+    return op - output;
+}
+
+int lz4_decompress(const quint8 *input, int length, quint8 *output, int maxout)
+{
+    const quint8 *ip = input;
+    const quint8 *const iend = input + length;
+    quint8 *op = output;
+    quint8 *const oend = output + maxout;
+
+    while (ip < iend) {
+        const quint8 token = *ip++;
+
+        qint32 literalLength = token >> 4;
+        if (literalLength == LZ4_RUN_MASK) {
+            quint8 s;
+            do {
+                if (ip >= iend) return 0;
+                s = *ip++;
+                literalLength += s;
+            } while (s == 255);
+        }
+
+        if (literalLength > iend - ip || literalLength > oend - op)
+            return 0;
+
+        if (literalLength <= iend - ip - 8 && literalLength <= oend - op - 8) {
+            wildCopy(op, ip, op + literalLength);
+        } else {
+            memcpy(op, ip, literalLength);
+        }
+        ip += literalLength;
+        op += literalLength;
+
+        /* the last sequence has no match part */
+        if (ip >= iend)
+            break;
+
+        if (iend - ip < 2)
+            return 0;
+
+        const qint32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (!offset || offset > op - output)
+            return 0;
+
+        qint32 matchLength = token & LZ4_ML_MASK;
+        if (matchLength == LZ4_ML_MASK) {
+            quint8 s;
+            do {
+                if (ip >= iend) return 0;
+                s = *ip++;
+                matchLength += s;
+            } while (s == 255);
+        }
+        matchLength += LZ4_MIN_MATCH;
+
+        if (matchLength > oend - op)
+            return 0;
+
+        const quint8 *ref = op - offset;
+
+        if (offset >= 8 && matchLength <= oend - op - 8) {
+            wildCopy(op, ref, op + matchLength);
+            op += matchLength;
+        } else if (offset >= matchLength) {
+            memcpy(op, ref, matchLength);
+            op += matchLength;
+        } else {
+            /**
+             * Overlapping copy, e.g. a run of repeated pixels. The
+             * pattern repeats every \p offset bytes, so after writing
+             * the first period byte-by-byte we can switch to 8-byte
+             * chunks, using a multiple of the offset as a distance.
+             */
+            const qint32 period = offset * ((8 + offset - 1) / offset);
+            quint8 *const matchEndPtr = op + matchLength;
+
+            for (qint32 i = 0; i < period && op < matchEndPtr; i++)
+                *op++ = *ref++;
+
+            if (op < matchEndPtr) {
+                if (matchEndPtr <= oend - 8) {
+                    wildCopy(op, op - period, matchEndPtr);
+                    op = matchEndPtr;
+                } else {
+                    for (; op < matchEndPtr; ++op)
+                        *op = *(op - period);
+                }
+            }
+        }
+    }
+
+    return op - output;
+}
+
+
+KisLz4Compression::KisLz4Compression()
+{
+}
+
+KisLz4Compression::~KisLz4Compression()
+{
+}
+
+qint32 KisLz4Compression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    Q_UNUSED(outputLength);
+    return lz4_compress(input, inputLength, output);
+}
+
+qint32 KisLz4Compression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    return lz4_decompress(input, inputLength, output, outputLength);
+}
+
+qint32 KisLz4Compression::outputBufferSize(qint32 dataSize)
+{
+    // the same bound as LZ4_COMPRESSBOUND() in liblz4
+    return dataSize + dataSize / 255 + 16;
+}
@@ -11,9 +11,12 @@
 
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
-KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
+KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize, quint64 maxFileSize)
     : m_readWindowEx(writeWindowSize / 4),
-      m_writeWindowEx(writeWindowSize)
+      m_writeWindowEx(writeWindowSize),
+      m_rangeSize(writeWindowSize),
+      m_numRanges(maxFileSize / writeWindowSize + 1),
+      m_ranges(new QAtomicPointer<quint8>[m_numRanges])
 {
     m_valid = true;
 
@@ -47,6 +50,106 @@ KisMemoryWindow::~KisMemoryWindow()
 {
 }
 
+const quint8* KisMemoryWindow::getConcurrentReadChunkPtr(const KisChunkData &readChunk)
+{
+#ifdef Q_OS_WIN32
+    /**
+     * On Windows the file cannot be resized while it has any
+     * mappings (see a comment in adjustWindow()), so we cannot
+     * keep the range mappings alive
+     */
+    Q_UNUSED(readChunk);
+    return nullptr;
+#else
+    const quint64 rangeIndex = readChunk.m_begin / m_rangeSize;
+
+    if (!m_valid ||
+        rangeIndex >= quint64(m_numRanges) ||
+        readChunk.size() > RANGE_MAPPING_OVERLAP) {
+
+        return nullptr;
+    }
+
+    quint8 *window = m_ranges[rangeIndex].loadAcquire();
+
+    if (!window) {
+        window = mapRange(rangeIndex);
+        if (!window) return nullptr;
+    }
+
+    return window + readChunk.m_begin - rangeIndex * m_rangeSize;
+#endif
+}
+
+quint8* KisMemoryWindow::mapRange(int rangeIndex)
+{
+    QMutexLocker l(&m_mappingLock);
+
+    quint8 *window = m_ranges[rangeIndex].loadAcquire();
+    if (window) return window;
+
+    const quint64 rangeBegin = rangeIndex * m_rangeSize;
+    const quint64 rangeMappingSize = m_rangeSize + RANGE_MAPPING_OVERLAP;
+
+    /**
+     * The chunks being read have already been written, so
+     * adjustWindow() has already grown the file enough
+     */
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(rangeBegin + rangeMappingSize <= quint64(m_file.size()), nullptr);
+
+    window = m_file.map(rangeBegin, rangeMappingSize);
+
+    if (window) {
+        m_ranges[rangeIndex].storeRelease(window);
+    }
+
+    return window;
+}
+
+quint64 KisMemoryWindow::fileSize()
+{
+    QMutexLocker l(&m_mappingLock);
+    return m_valid ? m_file.size() : 0;
+}
+
+void KisMemoryWindow::truncate(quint64 usedSize)
+{
+    QMutexLocker l(&m_mappingLock);
+
+    if (!m_valid) return;
+
+    quint64 newSize = (usedSize + 32) & (~31ULL);
+
+#ifndef Q_OS_WIN32
+    // keep the file big enough for the range mappings
+    if (usedSize) {
+        newSize = ((usedSize - 1) / m_rangeSize + 1) * m_rangeSize + RANGE_MAPPING_OVERLAP;
+    }
+#endif
+
+    if (newSize >= quint64(m_file.size())) return;
+
+    for (int i = 0; i < m_numRanges; i++) {
+        quint8 *window = m_ranges[i].fetchAndStoreOrdered(nullptr);
+        if (window) {
+            m_file.unmap(window);
+        }
+    }
+
+    MappingWindow *windows[] = {&m_readWindowEx, &m_writeWindowEx};
+    for (MappingWindow *window : windows) {
+        if (window->window) {
+            m_file.unmap(window->window);
+            window->window = 0;
+            window->chunk.setChunk(0, 0);
+        }
+    }
+
+    if (!m_file.resize(newSize)) {
+        warnKrita << "KisMemoryWindow: failed to truncate the swap file to" << newSize;
+    }
+}
+
 quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 {
     if (!adjustWindow(readChunk, &m_readWindowEx, &m_writeWindowEx)) {
@@ -73,6 +176,8 @@ bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
        !(requestedChunk.m_begin >= adjustingWindow->chunk.m_begin &&
          requestedChunk.m_end <= adjustingWindow->chunk.m_end))
     {
+        QMutexLocker l(&m_mappingLock);
+
         m_file.unmap(adjustingWindow->window);
 
         quint64 windowSize = adjustingWindow->defaultSize;
@@ -91,6 +196,17 @@ bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
             // Align by 32 bytes
             quint64 newSize = (adjustingWindow->chunk.m_end + 1 + 32) & (~31ULL);
 
+#ifndef Q_OS_WIN32
+            /**
+             * Make sure the range mappings used by
+             * getConcurrentReadChunkPtr() would fit into the file
+             */
+            const quint64 rangeEnd =
+                (adjustingWindow->chunk.m_end / m_rangeSize + 1) * m_rangeSize +
+                RANGE_MAPPING_OVERLAP;
+            newSize = qMax(newSize, rangeEnd);
+#endif
+
 #ifdef Q_OS_WIN32
             /**
              * Workaround for Qt's "feature"
@@ -8,12 +8,23 @@
 #define __KIS_MEMORY_WINDOW_H
 
 #include <QTemporaryFile>
+#include <QMutex>
+#include <QAtomicPointer>
+#include <QScopedArrayPointer>
 
 #include "kis_chunk_allocator.h"
 
 
 #define DEFAULT_WINDOW_SIZE (16*MiB)
 
+/**
+ * Every range mapping is bigger than the range itself by this
+ * value, so that a chunk starting in a range would always fit
+ * into its mapping. The chunks of the swapped tiles are much
+ * smaller than that.
+ */
+#define RANGE_MAPPING_OVERLAP (1*MiB)
+
 class KRITAIMAGE_EXPORT KisMemoryWindow
 {
 public:
@@ -21,9 +32,44 @@ public:
      * @param swapDir If the dir doesn't exist, it'll be created, if it's empty QDir::tempPath will be used.
      * @param writeWindowSize write window size.
      */
-    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE);
+    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE, quint64 maxFileSize = DEFAULT_STORE_SIZE);
     ~KisMemoryWindow();
 
+    /**
+     * A thread-safe alternative to getReadChunkPtr().
+     *
+     * The file is split into ranges of writeWindowSize bytes, and each
+     * range gets its own read-only mapping, which is created on the
+     * first access and stays alive until the window is destroyed.
+     * Looking up an existing mapping doesn't take any locks, so
+     * several threads can read (and decompress) their chunks in
+     * parallel. The returned pointer is valid until the chunk is
+     * overwritten.
+     *
+     * Returns null if the chunk cannot be read this way (e.g. it is
+     * too big or the platform doesn't support it). In such a case
+     * the caller should use getReadChunkPtr() with its own locking.
+     */
+    const quint8* getConcurrentReadChunkPtr(const KisChunkData &readChunk);
+
+    inline const quint8* getConcurrentReadChunkPtr(const KisChunk &readChunk) {
+        return getConcurrentReadChunkPtr(readChunk.data());
+    }
+
+    /**
+     * The current size of the swap file on disk
+     */
+    quint64 fileSize();
+
+    /**
+     * Shrinks the swap file so that it would still contain
+     * the first \p usedSize bytes. All the mappings are released.
+     *
+     * LOCKING: the caller must guarantee that nobody reads the
+     *          file concurrently, including getConcurrentReadChunkPtr()
+     */
+    void truncate(quint64 usedSize);
+
     inline quint8* getReadChunkPtr(KisChunk readChunk) {
         return getReadChunkPtr(readChunk.data());
     }
@@ -59,12 +105,25 @@ private:
                       MappingWindow *adjustingWindow,
                       MappingWindow *otherWindow);
 
+    quint8* mapRange(int rangeIndex);
+
 private:
     QTemporaryFile m_file;
 
     bool m_valid;
     MappingWindow m_readWindowEx;
     MappingWindow m_writeWindowEx;
+
+    /**
+     * Guards all the operations that change the mappings or
+     * the size of the file. QFile doesn't allow them to be run
+     * concurrently.
+     */
+    QMutex m_mappingLock;
+
+    const quint64 m_rangeSize;
+    const int m_numRanges;
+    QScopedArrayPointer<QAtomicPointer<quint8>> m_ranges;
 };
 
 #endif /* __KIS_MEMORY_WINDOW_H */
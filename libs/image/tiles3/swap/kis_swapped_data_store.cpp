@@ -4,17 +4,19 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-//#include "kis_debug.h"
+#include "kis_debug.h"
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
+#include "KisUpdateTracer.h"
 
 #include "kis_tile_compressor_2.h"
 
 //#define COMPRESSOR_VERSION 2
 
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_totalSwapMemoryUsed(0)
+    : m_totalSwapMemoryUsed(0),
+      m_totalReclaimedSize(0)
 {
     KisImageConfig config(true);
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
@@ -22,14 +24,19 @@ KisSwappedDataStore::KisSwappedDataStore()
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize, maxSwapSize);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    m_compressor = new KisTileCompressor2(
+        KisCompressionRegistry::codecForUsage(KisCompressionRegistry::SwapUsage));
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
+    KisAbstractTileCompressor *decompressor = 0;
+    while (m_decompressorsPool.pop(decompressor)) {
+        delete decompressor;
+    }
+
     delete m_compressor;
     delete m_swapSpace;
     delete m_allocator;
@@ -61,16 +68,34 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     qint32 bytesWritten;
     m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
 
-    KisChunk chunk = m_allocator->getChunk(bytesWritten);
+    if (!storeCompressedData(td, (quint8*) m_buffer.data(), bytesWritten)) {
+        return false;
+    }
+
+    td->releaseMemory();
+
+    return true;
+}
+
+bool KisSwappedDataStore::trySwapOutCompressedData(KisTileData *td, const quint8 *data, qint32 size)
+{
+    QMutexLocker locker(&m_lock);
+    return storeCompressedData(td, data, size);
+}
+
+bool KisSwappedDataStore::storeCompressedData(KisTileData *td, const quint8 *data, qint32 size)
+{
+    KisChunk chunk = m_allocator->getChunk(size);
     quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
     if (!ptr) {
         qWarning() << "swap out of tile failed";
+        m_allocator->freeChunk(chunk);
         return false;
     }
-    memcpy(ptr, m_buffer.data(), bytesWritten);
+    memcpy(ptr, data, size);
 
-    td->releaseMemory();
     td->setSwapChunk(chunk);
+    m_chunkOwners.insert(chunk.begin(), td);
 
     m_totalSwapMemoryUsed += chunk.size();
 
@@ -80,27 +105,72 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
-    QMutexLocker locker(&m_lock);
+
+    KisUpdateTraceScope traceScope(KisUpdateTracer::TileSwapIn);
 
     // see comment in swapOutTileData()
 
-    KisChunk chunk = td->swapChunk();
-    m_totalSwapMemoryUsed -= chunk.size();
+    /**
+     * Nobody can reuse the chunk before we free it, so we
+     * can read it without holding the lock. KisChunk keeps
+     * a copy of the chunk boundaries, so we don't need to
+     * access the allocator either.
+     */
+    const KisChunk chunk = td->swapChunk();
 
     td->allocateMemory();
-    td->setSwapChunk(KisChunk());
 
-    quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
-    Q_ASSERT(ptr);
-    m_compressor->decompressTileData(ptr, chunk.size(), td);
+    const quint8 *ptr = 0;
+
+    {
+        QReadLocker swapSpaceLocker(&m_swapSpaceLock);
+
+        ptr = m_swapSpace->getConcurrentReadChunkPtr(chunk);
+
+        if (ptr) {
+            KisAbstractTileCompressor *decompressor = acquireDecompressor();
+            decompressor->decompressTileData(ptr, chunk.size(), td);
+            releaseDecompressor(decompressor);
+        }
+    }
+
+    QMutexLocker locker(&m_lock);
+
+    if (!ptr) {
+        ptr = m_swapSpace->getReadChunkPtr(chunk);
+        Q_ASSERT(ptr);
+        m_compressor->decompressTileData(ptr, chunk.size(), td);
+    }
+
+    m_totalSwapMemoryUsed -= chunk.size();
+    m_chunkOwners.remove(chunk.begin());
+    td->setSwapChunk(KisChunk());
     m_allocator->freeChunk(chunk);
 }
 
+KisAbstractTileCompressor* KisSwappedDataStore::acquireDecompressor()
+{
+    KisAbstractTileCompressor *decompressor = 0;
+
+    if (!m_decompressorsPool.pop(decompressor)) {
+        decompressor = new KisTileCompressor2(
+            KisCompressionRegistry::codecForUsage(KisCompressionRegistry::SwapUsage));
+    }
+
+    return decompressor;
+}
+
+void KisSwappedDataStore::releaseDecompressor(KisAbstractTileCompressor *decompressor)
+{
+    m_decompressorsPool.push(decompressor);
+}
+
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
     m_totalSwapMemoryUsed -= td->swapChunk().size();
+    m_chunkOwners.remove(td->swapChunk().begin());
 
     m_allocator->freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
@@ -111,6 +181,104 @@ qint64 KisSwappedDataStore::totalSwapMemoryUsed() const
     return m_totalSwapMemoryUsed;
 }
 
+bool KisSwappedDataStore::needsCompaction()
+{
+    QMutexLocker locker(&m_lock);
+
+    /**
+     * Compact only when at least a quarter of the file
+     * and at least one slab is wasted in holes
+     */
+    const qint64 fileSize = m_swapSpace->fileSize();
+    const qint64 wastedSize = fileSize - m_totalSwapMemoryUsed;
+
+    return wastedSize > fileSize / 4 &&
+        wastedSize > qint64(m_allocator->slabSize());
+}
+
+qint64 KisSwappedDataStore::compact(qint64 maxBytesToMove)
+{
+    /**
+     * The amount of data moved while holding the store's lock,
+     * the swap-outs and the swap-ins wait for us only that long
+     */
+    const quint64 bytesPerBatch = 256 * 1024;
+
+    auto moveChunk =
+        [this] (KisChunk oldChunk, KisChunk newChunk) {
+            KisTileData *td = m_chunkOwners.value(oldChunk.begin());
+            KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(td, false);
+
+            /**
+             * The tile is being swapped in or freed right now. Its
+             * chunk is read without holding m_lock, so we cannot
+             * move it. Just stop here, the compaction will continue
+             * in the next idle cycle.
+             *
+             * NOTE: the tile data cannot be deleted while we hold
+             *       m_lock, because it is still registered in
+             *       m_chunkOwners (see forgetTileData())
+             */
+            if (!td->m_swapLock.tryLockForWrite()) return false;
+
+            bool result = false;
+
+            const quint8 *src = m_swapSpace->getReadChunkPtr(oldChunk);
+            if (src) {
+                /**
+                 * The read and the write windows may be remapped
+                 * independently, so copy the data via the buffer
+                 */
+                if (m_buffer.size() < qint32(oldChunk.size())) {
+                    m_buffer.resize(oldChunk.size());
+                }
+                memcpy(m_buffer.data(), src, oldChunk.size());
+
+                quint8 *dst = m_swapSpace->getWriteChunkPtr(newChunk);
+                if (dst) {
+                    memcpy(dst, m_buffer.data(), newChunk.size());
+
+                    m_chunkOwners.remove(oldChunk.begin());
+                    m_chunkOwners.insert(newChunk.begin(), td);
+                    td->setSwapChunk(newChunk);
+
+                    result = true;
+                }
+            }
+
+            td->m_swapLock.unlock();
+            return result;
+        };
+
+    quint64 bytesMoved = 0;
+
+    while (bytesMoved < quint64(maxBytesToMove)) {
+        QMutexLocker locker(&m_lock);
+
+        const quint64 batchSize = qMin(bytesPerBatch, quint64(maxBytesToMove) - bytesMoved);
+        const quint64 batchMoved = m_allocator->compact(batchSize, moveChunk);
+        if (!batchMoved) break;
+
+        bytesMoved += batchMoved;
+    }
+
+    QMutexLocker locker(&m_lock);
+    QWriteLocker swapSpaceLocker(&m_swapSpaceLock);
+
+    const qint64 oldFileSize = m_swapSpace->fileSize();
+    m_swapSpace->truncate(m_allocator->shrinkStore());
+    const qint64 reclaimedSize = qMax(0LL, oldFileSize - qint64(m_swapSpace->fileSize()));
+
+    m_totalReclaimedSize += reclaimedSize;
+
+    return reclaimedSize;
+}
+
+qint64 KisSwappedDataStore::totalReclaimedSize() const
+{
+    return m_totalReclaimedSize;
+}
+
 void KisSwappedDataStore::debugStatistics()
 {
     m_allocator->sanityCheck();
@@ -10,7 +10,11 @@
 #include "kritaimage_export.h"
 
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QByteArray>
+#include <QHash>
+
+#include "kis_lockless_stack.h"
 
 
 class QMutex;
@@ -38,9 +42,23 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Write already compressed data of \a td into the swap file.
+     * The \p data should be produced by KisTileCompressor2 (with
+     * any codec). Used for moving tiles from KisCompressedDataStore
+     * into the swap file without recompressing them.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool trySwapOutCompressedData(KisTileData *td, const quint8 *data, qint32 size);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
+     *
+     * The data is decompressed without holding the store's lock,
+     * so several threads can swap in their tiles in parallel.
+     *
      * LOCKING: the lock on the tile data should be taken
      *          by the caller before making a call.
      */
@@ -59,21 +77,74 @@ public:
      */
     qint64 totalSwapMemoryUsed() const;
 
+    /**
+     * Returns true if the swap file has enough free space
+     * in the holes between the chunks to be worth compacting
+     */
+    bool needsCompaction();
+
+    /**
+     * Moves up to \p maxBytesToMove bytes of the swapped data from
+     * the end of the swap file into the holes at its beginning and
+     * truncates the file. Returns the number of bytes the file
+     * has been shrunk by.
+     *
+     * The chunks are moved in small batches, the store's lock is
+     * released between them. A chunk is moved only if the swap lock
+     * of its tile data can be taken without waiting, so the tiles
+     * being swapped in are just skipped.
+     *
+     * LOCKING: no locks should be held by the caller
+     */
+    qint64 compact(qint64 maxBytesToMove);
+
+    /**
+     * The total number of bytes reclaimed by compact()
+     */
+    qint64 totalReclaimedSize() const;
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
+private:
+    bool storeCompressedData(KisTileData *td, const quint8 *data, qint32 size);
+
+    KisAbstractTileCompressor* acquireDecompressor();
+    void releaseDecompressor(KisAbstractTileCompressor *decompressor);
+
 private:
     QByteArray m_buffer;
     KisAbstractTileCompressor *m_compressor;
 
+    /**
+     * The compressors keep internal buffers, so every thread
+     * swapping in a tile needs its own instance
+     */
+    KisLocklessStack<KisAbstractTileCompressor*> m_decompressorsPool;
+
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
+    /**
+     * Tile data objects owning the chunks, indexed by the
+     * beginning of the chunk. Used for relocation of the chunks
+     * during compaction.
+     */
+    QHash<quint64, KisTileData*> m_chunkOwners;
+
     QMutex m_lock;
 
+    /**
+     * Guards the range mappings of m_swapSpace. swapInTileData()
+     * reads them without holding m_lock, so compact() takes this
+     * lock for write to truncate the file.
+     */
+    QReadWriteLock m_swapSpaceLock;
+
     qint64 m_totalSwapMemoryUsed;
+    qint64 m_totalReclaimedSize;
 };
 
 #endif /* __KIS_SWAPPED_DATA_STORE_H */
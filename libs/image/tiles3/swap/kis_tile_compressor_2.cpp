@@ -5,22 +5,40 @@
  */
 
 #include "kis_tile_compressor_2.h"
-#include "kis_lzf_compression.h"
+#include "kis_abstract_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
+#include "kis_debug.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(KisCompressionRegistry::Codec codec)
+    : m_codec(codec),
+      m_compressionName(KisCompressionRegistry::codecName(codec))
 {
-    m_compression = new KisLzfCompression();
+    m_compression = compressionForCodec(m_codec);
+    KIS_ASSERT(m_compression);
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
-    delete m_compression;
+    qDeleteAll(m_decompressors);
+}
+
+KisAbstractCompression* KisTileCompressor2::compressionForCodec(int codec)
+{
+    if (!KisCompressionRegistry::isKnownCodec(codec)) return 0;
+
+    if (m_decompressors.size() <= codec) {
+        m_decompressors.resize(codec + 1);
+    }
+
+    KisAbstractCompression *&compression = m_decompressors[codec];
+    if (!compression) {
+        compression = KisCompressionRegistry::create(codec);
+    }
+
+    return compression;
 }
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
@@ -50,7 +68,14 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+    const qint32 pixelSize = this->pixelSize(dm);
+
+    if (!isValidStreamTileSize(m_streamTileWidth, m_streamTileHeight, pixelSize)) {
+        warnFile << "Invalid size of the tiles:" << m_streamTileWidth << m_streamTileHeight << pixelSize;
+        return false;
+    }
+
+    const qint32 tileDataSize = pixelSize * m_streamTileWidth * m_streamTileHeight;
     prepareStreamingBuffer(tileDataSize);
 
     QByteArray header = stream->readLine(maxHeaderLength());
@@ -63,7 +88,41 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        /**
+         * The codec is also stored in the first byte of the tile
+         * data, so the name is used for sanity check only
+         */
+        if (!KisCompressionRegistry::codecByName(compressionName)) {
+            warnFile << "Unknown tile compression:" << compressionName;
+            return false;
+        }
+
+        /**
+         * The compressed data is never bigger than the raw
+         * data plus the compression flag
+         */
+        if (dataSize <= 0 || dataSize > m_streamingBuffer.size()) {
+            warnFile << "Wrong size of the tile data:" << dataSize;
+            return false;
+        }
+
+        if (!streamHasNativeTileSize()) {
+            stream->read(m_streamingBuffer.data(), dataSize);
+
+            if (m_retilingBuffer.size() < tileDataSize) {
+                m_retilingBuffer.resize(tileDataSize);
+            }
+
+            bool res = decompressBuffer((quint8*)m_streamingBuffer.data(), dataSize,
+                                        (quint8*)m_retilingBuffer.data(), tileDataSize,
+                                        pixelSize);
+            if (res) {
+                writeBytes(dm, (quint8*)m_retilingBuffer.data(),
+                           QRect(x, y, m_streamTileWidth, m_streamTileHeight));
+            }
+            return res;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -122,8 +181,8 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
-        buffer[0] = COMPRESSED_DATA_FLAG;
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
+        buffer[0] = m_codec;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
@@ -139,24 +198,38 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
                                             KisTileData *tileData)
 {
     const qint32 pixelSize = tileData->pixelSize();
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
-    if(buffer[0] == COMPRESSED_DATA_FLAG) {
+    return decompressBuffer(buffer, bufferSize,
+                            tileData->data(), TILE_DATA_SIZE(pixelSize),
+                            pixelSize);
+}
+
+bool KisTileCompressor2::decompressBuffer(quint8 *buffer, qint32 bufferSize,
+                                          quint8 *data, qint32 tileDataSize,
+                                          qint32 pixelSize)
+{
+    if(buffer[0] != RAW_DATA_FLAG) {
+        KisAbstractCompression *compression = compressionForCodec(buffer[0]);
+        if (!compression) {
+            warnKrita << "Unknown tile compression codec:" << buffer[0];
+            return false;
+        }
+
         prepareWorkBuffers(tileDataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
-                                                      tileData->data(),
+                                                      data,
                                                       tileDataSize, pixelSize);
             return true;
         }
         return false;
     }
     else {
-        memcpy(tileData->data(), buffer + 1, tileDataSize);
+        memcpy(data, buffer + 1, tileDataSize);
         return true;
     }
     return false;
@@ -8,13 +8,23 @@
 #define __KIS_TILE_COMPRESSOR_2_H
 
 #include "kis_abstract_tile_compressor.h"
+#include "kis_compression_registry.h"
+
+#include <QVector>
 
 class KisAbstractCompression;
 
+/**
+ * Compresses tiles with one of the codecs of KisCompressionRegistry.
+ *
+ * The first byte of every compressed tile stores the id of the codec
+ * used (or RAW_DATA_FLAG), so the compressor can decompress data
+ * written with any known codec, not only with the one it writes.
+ */
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    KisTileCompressor2(KisCompressionRegistry::Codec codec = KisCompressionRegistry::LZF);
     ~KisTileCompressor2() override;
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
@@ -37,16 +47,29 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    bool decompressBuffer(quint8 *buffer, qint32 bufferSize,
+                          quint8 *data, qint32 tileDataSize,
+                          qint32 pixelSize);
+
+    /**
+     * Returns a (lazily created) compression object for the
+     * \p codec or null if the codec is unknown
+     */
+    KisAbstractCompression* compressionForCodec(int codec);
+
 private:
     static const qint8 RAW_DATA_FLAG = 0;
-    static const qint8 COMPRESSED_DATA_FLAG = 1;
 
 private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+    QByteArray m_retilingBuffer;
+
+    KisCompressionRegistry::Codec m_codec;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    QVector<KisAbstractCompression*> m_decompressors;
+    QString m_compressionName;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
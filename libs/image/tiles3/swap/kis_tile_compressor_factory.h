@@ -13,13 +13,20 @@
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
-    static KisAbstractTileCompressorSP create(qint32 version) {
+    /**
+     * Creates a compressor for tiles of \p version. The \p usage
+     * defines which codec the compressor will use for writing the
+     * data, reading is possible with any codec.
+     */
+    static KisAbstractTileCompressorSP create(qint32 version,
+                                              KisCompressionRegistry::Usage usage = KisCompressionRegistry::StorageUsage) {
         switch(version) {
         case 1:
             return KisAbstractTileCompressorSP(new KisLegacyTileCompressor());
             break;
         case 2:
-            return KisAbstractTileCompressorSP(new KisTileCompressor2());
+            return KisAbstractTileCompressorSP(
+                new KisTileCompressor2(KisCompressionRegistry::codecForUsage(usage)));
             break;
         default:
             qFatal("Unknown version of the tiles");
@@ -0,0 +1,114 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_prefetcher.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+
+#include "kis_image_config.h"
+#include "tiles3/kis_tile.h"
+#include "tiles3/kis_tile_data_store.h"
+
+
+const int KisTileDataPrefetcher::MAX_QUEUE_SIZE = 1024;
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+    KisTileDataStore *store = 0;
+
+    QMutex lock;
+    QWaitCondition workAvailable;
+    QQueue<KisTileSP> queue;
+
+    bool shouldExit = false;
+    QAtomicInt isEnabled;
+    QAtomicInt numPrefetchedTiles;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->store = store;
+    testingRereadConfig();
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::prefetchTile(KisTile *tile)
+{
+    QMutexLocker l(&m_d->lock);
+
+    if (m_d->shouldExit || m_d->queue.size() >= MAX_QUEUE_SIZE) return;
+
+    m_d->queue.enqueue(KisTileSP(tile));
+    m_d->workAvailable.wakeOne();
+}
+
+bool KisTileDataPrefetcher::isEnabled() const
+{
+    return m_d->isEnabled;
+}
+
+qint64 KisTileDataPrefetcher::numPrefetchedTiles() const
+{
+    return m_d->numPrefetchedTiles;
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    {
+        QMutexLocker l(&m_d->lock);
+        m_d->shouldExit = true;
+        m_d->queue.clear();
+        m_d->workAvailable.wakeAll();
+    }
+
+    wait();
+}
+
+void KisTileDataPrefetcher::testingRereadConfig()
+{
+    KisImageConfig config(true);
+    m_d->isEnabled = config.tilesPrefetching();
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        KisTileSP tile;
+
+        {
+            QMutexLocker l(&m_d->lock);
+
+            while (!m_d->shouldExit && m_d->queue.isEmpty()) {
+                m_d->workAvailable.wait(&m_d->lock);
+            }
+
+            if (m_d->shouldExit) return;
+
+            tile = m_d->queue.dequeue();
+        }
+
+        /**
+         * Locking the tile for read is enough to bring its data
+         * back into memory. We use the usual locking path, so all
+         * the swapping rules of KisTileDataStore are respected.
+         *
+         * NOTE: we cannot check tile->tileData()->data() before
+         *       locking, because the tile data may be replaced
+         *       by COW concurrently
+         */
+        tile->lockForRead();
+        tile->unlockForRead();
+        m_d->numPrefetchedTiles.ref();
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_DATA_PREFETCHER_H
+#define __KIS_TILE_DATA_PREFETCHER_H
+
+#include <QThread>
+
+#include "kritaimage_export.h"
+
+class KisTileDataStore;
+class KisTile;
+
+/**
+ * A thread that loads swapped out (or compressed) tiles back into
+ * memory before somebody actually needs them. The iterators and
+ * KisTiledDataManager::readBytes() announce the tiles they are going
+ * to visit, so by the time the cursor reaches a tile, it has usually
+ * already been swapped in and the caller does not need to stall.
+ *
+ * Prefetching is only a hint: when the queue is full, the requests
+ * are just dropped.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    ~KisTileDataPrefetcher() override;
+
+    /**
+     * Schedule \p tile to be loaded into memory. The prefetcher
+     * keeps a reference to the tile until it is processed.
+     */
+    void prefetchTile(KisTile *tile);
+
+    /**
+     * Returns true if prefetching is enabled in the config
+     */
+    bool isEnabled() const;
+
+    /**
+     * The number of tiles that have been processed by the
+     * prefetcher since its creation
+     */
+    qint64 numPrefetchedTiles() const;
+
+    void terminatePrefetcher();
+
+    void testingRereadConfig();
+
+private:
+    void run() override;
+
+private:
+    static const int MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* __KIS_TILE_DATA_PREFETCHER_H */
@@ -113,6 +113,20 @@ void KisTileDataSwapper::doJob()
     DEBUG_VALUE(m_d->limits.softLimitThreshold());
     DEBUG_VALUE(m_d->limits.hardLimitThreshold());
 
+    /**
+     * Make some space in the compressed store first, so that
+     * the passes below could put the tiles there
+     */
+    qint64 compressedMemory = m_d->store->compressedMemoryUsed();
+    DEBUG_VALUE(compressedMemory);
+
+    if (compressedMemory > m_d->limits.compressedThreshold()) {
+        qint64 compressedFree = compressedMemory - m_d->limits.compressedLimit();
+        DEBUG_VALUE(compressedFree);
+        DEBUG_ACTION("\t evict compressed");
+        compressedMemory -= m_d->store->evictCompressedTiles(compressedFree);
+        DEBUG_VALUE(compressedMemory);
+    }
 
     if(memoryMetric > m_d->limits.softLimitThreshold()) {
         qint32 softFree =  memoryMetric - m_d->limits.softLimit();
@@ -41,6 +41,16 @@
   |                        |
   +------------------------+  <-- 0 MiB
 
+
+   The tiles swapped out by the swapper are first compressed into
+   an in-memory arena (KisCompressedDataStore), which has its own
+   limit, independent from the limits above:
+
+  |== compressedThreshold ==|  <-- the swapper starts evicting the
+  |.........................|      oldest compressed tiles into the
+  |.........................|      swap file
+  |=== compressedLimit =====|  <-- the swapper stops evicting
+
  */
 
 
@@ -57,6 +67,10 @@ public:
 
         m_softLimitThreshold = qBound(0, MiB_TO_METRIC(config.tilesSoftLimit()), m_hardLimitThreshold);
         m_softLimit = m_softLimitThreshold - m_softLimitThreshold / 8;
+
+        const qint64 compressedSize = qint64(config.tilesCompressionLimit()) * MiB;
+        m_compressedThreshold = compressedSize - compressedSize / 8;
+        m_compressedLimit = m_compressedThreshold - m_compressedThreshold / 8;
     }
 
     /**
@@ -83,12 +97,27 @@ public:
         return m_softLimit;
     }
 
+    /**
+     * These methods return the size of the compressed
+     * data in bytes
+     */
+
+    inline qint64 compressedThreshold() {
+        return m_compressedThreshold;
+    }
+
+    inline qint64 compressedLimit() {
+        return m_compressedLimit;
+    }
+
 private:
     qint32 m_emergencyThreshold;
     qint32 m_hardLimitThreshold;
     qint32 m_hardLimit;
     qint32 m_softLimitThreshold;
     qint32 m_softLimit;
+    qint64 m_compressedThreshold;
+    qint64 m_compressedLimit;
 };
 
 
@@ -0,0 +1,142 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_undo_swap_store.h"
+
+#include <QMutexLocker>
+
+#include "kis_debug.h"
+#include "kis_memory_window.h"
+#include "kis_image_config.h"
+#include "kis_tile_compressor_2.h"
+
+
+KisUndoSwapStore::KisUndoSwapStore()
+    : m_swapSpace(0),
+      m_swapDir(KisImageConfig(true).swapDir()),
+      m_maxSwapSize(KisImageConfig(true).maxUndoSwapSize() * MiB),
+      m_swapWindowSize(KisImageConfig(true).swapWindowSize() * MiB),
+      m_totalMemoryUsed(0)
+{
+    KisImageConfig config(true);
+
+    m_allocator = new KisChunkAllocator(config.swapSlabSize() * MiB, m_maxSwapSize);
+    m_compressor = new KisTileCompressor2(
+        KisCompressionRegistry::codecForUsage(KisCompressionRegistry::SwapUsage));
+}
+
+KisUndoSwapStore::~KisUndoSwapStore()
+{
+    delete m_compressor;
+    delete m_swapSpace;
+    delete m_allocator;
+}
+
+bool KisUndoSwapStore::storeTileData(KisTileData *td, KisChunk *chunk)
+{
+    QMutexLocker locker(&m_lock);
+
+    const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
+    if (m_buffer.size() < expectedBufferSize) {
+        m_buffer.resize(expectedBufferSize);
+    }
+
+    qint32 bytesWritten;
+    m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
+
+    return tryStoreLocked((quint8*) m_buffer.data(), bytesWritten, chunk);
+}
+
+void KisUndoSwapStore::loadTileData(const KisChunk &chunk, KisTileData *td)
+{
+    QMutexLocker locker(&m_lock);
+
+    quint8 *ptr = readChunkLocked(chunk);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(ptr);
+
+    if (ptr) {
+        m_compressor->decompressTileData(ptr, chunk.size(), td);
+    }
+
+    freeChunkLocked(chunk);
+}
+
+bool KisUndoSwapStore::storeData(const QByteArray &data, KisChunk *chunk)
+{
+    QMutexLocker locker(&m_lock);
+    return tryStoreLocked((const quint8*) data.constData(), data.size(), chunk);
+}
+
+QByteArray KisUndoSwapStore::loadData(const KisChunk &chunk)
+{
+    QMutexLocker locker(&m_lock);
+
+    QByteArray result;
+
+    const quint8 *ptr = readChunkLocked(chunk);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(ptr);
+
+    if (ptr) {
+        result = QByteArray((const char*) ptr, chunk.size());
+    }
+
+    freeChunkLocked(chunk);
+
+    return result;
+}
+
+void KisUndoSwapStore::forgetChunk(const KisChunk &chunk)
+{
+    QMutexLocker locker(&m_lock);
+    freeChunkLocked(chunk);
+}
+
+quint64 KisUndoSwapStore::numChunks() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_allocator->numChunks();
+}
+
+qint64 KisUndoSwapStore::totalMemoryUsed() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_totalMemoryUsed;
+}
+
+bool KisUndoSwapStore::tryStoreLocked(const quint8 *data, qint32 size, KisChunk *chunk)
+{
+    if (!m_swapSpace) {
+        m_swapSpace = new KisMemoryWindow(m_swapDir, m_swapWindowSize, m_maxSwapSize);
+    }
+
+    if (!m_allocator->tryGetChunk(size, chunk)) {
+        return false;
+    }
+
+    quint8 *ptr = m_swapSpace->getWriteChunkPtr(*chunk);
+    if (!ptr) {
+        qWarning() << "writing of the undo data failed";
+        m_allocator->freeChunk(*chunk);
+        return false;
+    }
+    memcpy(ptr, data, size);
+
+    m_totalMemoryUsed += chunk->size();
+
+    return true;
+}
+
+quint8* KisUndoSwapStore::readChunkLocked(const KisChunk &chunk)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_swapSpace, 0);
+    return m_swapSpace->getReadChunkPtr(chunk);
+}
+
+void KisUndoSwapStore::freeChunkLocked(const KisChunk &chunk)
+{
+    m_totalMemoryUsed -= chunk.size();
+    m_allocator->freeChunk(chunk);
+}
@@ -0,0 +1,93 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_UNDO_SWAP_STORE_H
+#define __KIS_UNDO_SWAP_STORE_H
+
+#include "kritaimage_export.h"
+
+#include <QMutex>
+#include <QByteArray>
+
+#include "kis_chunk_allocator.h"
+
+class KisTileData;
+class KisAbstractTileCompressor;
+class KisMemoryWindow;
+
+/**
+ * A dedicated file for the undo history of the tiles.
+ *
+ * The memento managers move the data of the revisions that are older
+ * than a few undo steps into this file (see KisMementoManager) and
+ * read it back lazily when the user actually undoes that far. Unlike
+ * KisSwappedDataStore, the data is owned by the memento items, not by
+ * the tile data objects, so the swapper and the pooler never see it.
+ *
+ * The file is created on the first write. Its size is limited by
+ * KisImageConfig::maxUndoSwapSize(), which is independent from the
+ * limit of the main swap file.
+ */
+class KRITAIMAGE_EXPORT KisUndoSwapStore
+{
+public:
+    KisUndoSwapStore();
+    ~KisUndoSwapStore();
+
+    /**
+     * Compresses the data of \p td into the file. The tile data
+     * itself is not changed.
+     * LOCKING: the swapping of the tile data should be blocked
+     *          by the caller
+     */
+    bool storeTileData(KisTileData *td, KisChunk *chunk);
+
+    /**
+     * Reads the data stored by storeTileData() into \p td and
+     * frees the \p chunk
+     */
+    void loadTileData(const KisChunk &chunk, KisTileData *td);
+
+    /**
+     * Stores an opaque (already compressed) blob of data
+     */
+    bool storeData(const QByteArray &data, KisChunk *chunk);
+
+    /**
+     * Reads the data stored by storeData() and frees the \p chunk
+     */
+    QByteArray loadData(const KisChunk &chunk);
+
+    void forgetChunk(const KisChunk &chunk);
+
+    quint64 numChunks() const;
+
+    /**
+     * The number of bytes occupied by the data in the file
+     */
+    qint64 totalMemoryUsed() const;
+
+private:
+    bool tryStoreLocked(const quint8 *data, qint32 size, KisChunk *chunk);
+    quint8* readChunkLocked(const KisChunk &chunk);
+    void freeChunkLocked(const KisChunk &chunk);
+
+private:
+    QByteArray m_buffer;
+    KisAbstractTileCompressor *m_compressor;
+
+    KisChunkAllocator *m_allocator;
+    KisMemoryWindow *m_swapSpace;
+
+    const QString m_swapDir;
+    const quint64 m_maxSwapSize;
+    const quint64 m_swapWindowSize;
+
+    mutable QMutex m_lock;
+    qint64 m_totalMemoryUsed;
+};
+
+#endif /* __KIS_UNDO_SWAP_STORE_H */
@@ -0,0 +1,101 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_zlib_compression.h"
+
+#include <zlib.h>
+#include <cstring>
+
+#include "kis_debug.h"
+
+/**
+ * Negative window bits means "raw deflate", without zlib header
+ * and adler32 checksum. The size of the tile is known anyway.
+ */
+#define ZLIB_RAW_WINDOW_BITS -15
+#define ZLIB_MEM_LEVEL 8
+
+
+struct KisZlibCompression::Private
+{
+    z_stream deflateStream;
+    z_stream inflateStream;
+
+    bool deflateInitialized = false;
+    bool inflateInitialized = false;
+
+    int level = 6;
+};
+
+KisZlibCompression::KisZlibCompression(int level)
+    : m_d(new Private)
+{
+    m_d->level = qBound(1, level, 9);
+
+    memset(&m_d->deflateStream, 0, sizeof(z_stream));
+    memset(&m_d->inflateStream, 0, sizeof(z_stream));
+
+    m_d->deflateInitialized =
+        deflateInit2(&m_d->deflateStream, m_d->level, Z_DEFLATED,
+                     ZLIB_RAW_WINDOW_BITS, ZLIB_MEM_LEVEL, Z_DEFAULT_STRATEGY) == Z_OK;
+
+    m_d->inflateInitialized =
+        inflateInit2(&m_d->inflateStream, ZLIB_RAW_WINDOW_BITS) == Z_OK;
+
+    if (!m_d->deflateInitialized || !m_d->inflateInitialized) {
+        warnKrita << "KisZlibCompression: failed to initialize zlib streams";
+    }
+}
+
+KisZlibCompression::~KisZlibCompression()
+{
+    if (m_d->deflateInitialized) {
+        deflateEnd(&m_d->deflateStream);
+    }
+
+    if (m_d->inflateInitialized) {
+        inflateEnd(&m_d->inflateStream);
+    }
+}
+
+qint32 KisZlibCompression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    if (!m_d->deflateInitialized) return 0;
+
+    z_stream &stream = m_d->deflateStream;
+    deflateReset(&stream);
+
+    stream.next_in = const_cast<Bytef*>(input);
+    stream.avail_in = inputLength;
+    stream.next_out = output;
+    stream.avail_out = outputLength;
+
+    const int result = deflate(&stream, Z_FINISH);
+
+    return result == Z_STREAM_END ? qint32(stream.total_out) : 0;
+}
+
+qint32 KisZlibCompression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    if (!m_d->inflateInitialized) return 0;
+
+    z_stream &stream = m_d->inflateStream;
+    inflateReset(&stream);
+
+    stream.next_in = const_cast<Bytef*>(input);
+    stream.avail_in = inputLength;
+    stream.next_out = output;
+    stream.avail_out = outputLength;
+
+    const int result = inflate(&stream, Z_FINISH);
+
+    return result == Z_STREAM_END ? qint32(stream.total_out) : 0;
+}
+
+qint32 KisZlibCompression::outputBufferSize(qint32 dataSize)
+{
+    return deflateBound(&m_d->deflateStream, dataSize);
+}
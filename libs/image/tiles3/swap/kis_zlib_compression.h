@@ -0,0 +1,42 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZLIB_COMPRESSION_H
+#define __KIS_ZLIB_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+#include <QScopedPointer>
+
+/**
+ * Raw deflate compression. Much slower than LZF/LZ4, but gives
+ * considerably better ratio, so it is useful where the data is
+ * written once and kept for a long time.
+ *
+ * The zlib streams are allocated once and reused for every call,
+ * so the object is not thread-safe, just like the other
+ * compression classes.
+ */
+class KRITAIMAGE_EXPORT KisZlibCompression : public KisAbstractCompression
+{
+public:
+    /**
+     * \p level is the usual zlib compression level in range [1, 9]
+     */
+    KisZlibCompression(int level = 6);
+    ~KisZlibCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_ZLIB_COMPRESSION_H */
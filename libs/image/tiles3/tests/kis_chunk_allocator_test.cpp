@@ -30,6 +30,44 @@ void KisChunkAllocatorTest::testOperations()
     QVERIFY(qFuzzyCompare(allocator.debugFragmentation(), 1./6));
 }
 
+void KisChunkAllocatorTest::testCompaction()
+{
+    const quint64 slabSize = 1024;
+    KisChunkAllocator allocator(slabSize, 16 * slabSize);
+
+    QList<KisChunk> chunks;
+    for (int i = 0; i < 100; i++) {
+        chunks << allocator.getChunk(100);
+    }
+
+    QCOMPARE(allocator.storeSize(), 10 * slabSize);
+
+    // free every other chunk
+    for (int i = 0; i < 50; i++) {
+        allocator.freeChunk(chunks.takeAt(i));
+    }
+
+    QVERIFY(allocator.debugFragmentation() > 0.4);
+
+    int numMoved = 0;
+    quint64 bytesMoved = allocator.compact(1000000,
+        [&numMoved] (KisChunk oldChunk, KisChunk newChunk) {
+            // chunks are always moved down
+            if (newChunk.begin() >= oldChunk.begin()) return false;
+            if (newChunk.size() != oldChunk.size()) return false;
+            numMoved++;
+            return true;
+        });
+
+    QCOMPARE(bytesMoved, quint64(numMoved * 100));
+    QCOMPARE(allocator.numChunks(), quint64(50));
+
+    allocator.sanityCheck();
+    QVERIFY(allocator.debugFragmentation() < 0.05);
+
+    QCOMPARE(allocator.shrinkStore(), 5 * slabSize);
+}
+
 
 #define NUM_TRANSACTIONS 30
 #define NUM_CHUNKS_ALLOC 15000
@@ -20,6 +20,7 @@ qreal measureFragmentation(qint32 transactions, qint32 chunksAlloc,
 private Q_SLOTS:
     void testOperations();
     void testFragmentation();
+    void testCompaction();
 };
 
 #endif /* KIS_CHUNK_ALLOCATOR_TEST_H */
@@ -0,0 +1,157 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_compressed_data_store_test.h"
+#include <simpletest.h>
+
+#include "kis_debug.h"
+
+#include "kis_image_config.h"
+
+#include "tiles3/kis_tile_data.h"
+#include "tiles_test_utils.h"
+
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_compressed_data_store.h"
+#include "tiles3/swap/kis_swapped_data_store.h"
+
+
+#define COLUMN2COLOR(col) (col%255)
+
+void KisCompressedDataStoreTest::testRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 10000;
+
+    KisCompressedDataStore store(4 * MiB, 1 * MiB);
+    QVERIFY(store.isEnabled());
+
+    QList<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+
+        QVERIFY(store.tryCompressTileData(td));
+        QVERIFY(!td->data());
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+    QCOMPARE(store.totalUncompressedMemoryUsed(), qint64(NUM_TILES) * TILESIZE);
+    QVERIFY(store.compressedMemoryUsed() < qint64(NUM_TILES) * TILESIZE / 16);
+    store.debugStatistics();
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+
+        store.decompressTileData(td);
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.compressedMemoryUsed(), qint64(0));
+    QCOMPARE(store.arenaSize(), qint64(0));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
+void KisCompressedDataStoreTest::testArenaOverflow()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+
+    KisCompressedDataStore store(1 * MiB, 1 * MiB);
+
+    QList<KisTileData*> tileDataList;
+
+    /**
+     * Noise doesn't compress, so the arena should
+     * get full after 1 MiB / 4 KiB tiles
+     */
+    qsrand(10);
+    bool overflowed = false;
+
+    for(qint32 i = 0; i < 1024 && !overflowed; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+        for (qint32 j = 0; j < TILESIZE; j++) {
+            td->data()[j] = qrand() % 256;
+        }
+        tileDataList.append(td);
+
+        overflowed = !store.tryCompressTileData(td);
+        QCOMPARE(bool(td->data()), overflowed);
+    }
+
+    QVERIFY(overflowed);
+    QVERIFY(store.arenaSize() <= store.maxArenaSize());
+
+    Q_FOREACH (KisTileData *td, tileDataList) {
+        if (!td->data()) {
+            store.forgetTileData(td);
+        }
+        delete td;
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.arenaSize(), qint64(0));
+}
+
+void KisCompressedDataStoreTest::testEviction()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 1000;
+    const qint32 NUM_EVICTED = 300;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+
+    KisSwappedDataStore swappedStore;
+    KisCompressedDataStore store(4 * MiB, 1 * MiB);
+
+    QList<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+        QVERIFY(store.tryCompressTileData(td));
+        tileDataList.append(td);
+    }
+
+    QVector<KisTileData*> oldest = store.oldestTiles(NUM_EVICTED);
+    QCOMPARE(oldest.size(), NUM_EVICTED);
+
+    for(qint32 i = 0; i < NUM_EVICTED; i++) {
+        // the oldest tiles should go first
+        QCOMPARE(oldest[i], tileDataList[i]);
+        QVERIFY(store.tryEvictTileData(oldest[i], &swappedStore));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES - NUM_EVICTED));
+    QCOMPARE(swappedStore.numTiles(), quint64(NUM_EVICTED));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+
+        if (i < NUM_EVICTED) {
+            swappedStore.swapInTileData(td);
+        } else {
+            store.decompressTileData(td);
+        }
+
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
+SIMPLE_TEST_MAIN(KisCompressedDataStoreTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_COMPRESSED_DATA_STORE_TEST_H
+#define KIS_COMPRESSED_DATA_STORE_TEST_H
+
+#include <simpletest.h>
+
+class KisCompressedDataStoreTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRoundTrip();
+    void testArenaOverflow();
+    void testEviction();
+};
+
+#endif /* KIS_COMPRESSED_DATA_STORE_TEST_H */
@@ -9,6 +9,7 @@
 
 #include "kis_debug.h"
 #include <QTemporaryDir>
+#include <QtConcurrent>
 
 #include "../swap/kis_memory_window.h"
 
@@ -42,6 +43,61 @@ void KisMemoryWindowTest::testWindow()
     QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
 }
 
+void KisMemoryWindowTest::testConcurrentRead()
+{
+    QTemporaryDir swapDir;
+
+    const quint64 windowSize = 1024;
+    KisMemoryWindow memory(swapDir.path(), windowSize, 64 * windowSize);
+
+    const int numChunks = 128;
+    const quint8 chunkLength = 100;
+
+    /**
+     * Some of the chunks cross the borders of the ranges
+     */
+    QVector<KisChunkData> chunks;
+    for (int i = 0; i < numChunks; i++) {
+        chunks << KisChunkData(i * 3 * windowSize / 7, chunkLength);
+    }
+
+    for (int i = 0; i < numChunks; i++) {
+        quint8 *ptr = memory.getWriteChunkPtr(chunks[i]);
+        QVERIFY(ptr);
+        memset(ptr, i, chunkLength);
+    }
+
+    QVector<int> indexes;
+    for (int i = 0; i < 16 * numChunks; i++) {
+        indexes << i % numChunks;
+    }
+
+    QAtomicInt numFailures;
+
+    QtConcurrent::blockingMap(indexes, [&] (int index) {
+        const quint8 *ptr = memory.getConcurrentReadChunkPtr(chunks[index]);
+
+#ifdef Q_OS_WIN32
+        // not supported on Windows
+        if (ptr) numFailures.ref();
+#else
+        if (!ptr) {
+            numFailures.ref();
+            return;
+        }
+
+        for (int j = 0; j < chunkLength; j++) {
+            if (ptr[j] != index) {
+                numFailures.ref();
+                break;
+            }
+        }
+#endif
+    });
+
+    QCOMPARE(int(numFailures), 0);
+}
+
 void KisMemoryWindowTest::testTopReports()
 {
 
@@ -119,5 +119,100 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+namespace {
+
+/**
+ * Noisy data that cannot be compressed well, so that
+ * the tiles occupy a few slabs of the swap file
+ */
+void fillWithNoise(quint8 *data, qint32 size, quint32 seed)
+{
+    quint32 value = seed;
+    for (qint32 i = 0; i < size; i++) {
+        value = value * 1103515245 + 12345;
+        data[i] = quint8(value >> 16);
+    }
+}
+
+bool memoryIsFilledWithNoise(const quint8 *data, qint32 size, quint32 seed)
+{
+    QByteArray expected(size, 0);
+    fillWithNoise(reinterpret_cast<quint8*>(expected.data()), size, seed);
+    return !memcmp(data, expected.constData(), size);
+}
+
+}
+
+void KisSwappedDataStoreTest::testCompactionRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 4000;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(64);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+
+    KisSwappedDataStore store;
+
+    QList<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        fillWithNoise(td->data(), TILESIZE, i);
+        QVERIFY(store.trySwapOutTileData(td));
+    }
+
+    QVERIFY(!store.needsCompaction());
+
+    /**
+     * Swap in the first half of the tiles, so that
+     * the beginning of the file becomes a hole
+     */
+    for(qint32 i = 0; i < NUM_TILES / 2; i++) {
+        KisTileData *td = tileDataList[i];
+        store.swapInTileData(td);
+        QVERIFY(memoryIsFilledWithNoise(td->data(), TILESIZE, i));
+    }
+
+    QVERIFY(store.needsCompaction());
+
+    const qint64 reclaimedSize = store.compact(NUM_TILES * TILESIZE);
+    QVERIFY(reclaimedSize > 0);
+    QCOMPARE(store.totalReclaimedSize(), reclaimedSize);
+
+    store.debugStatistics();
+
+    /**
+     * The relocated tiles should be read back exactly
+     */
+    for(qint32 i = NUM_TILES / 2; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+        store.swapInTileData(td);
+        QVERIFY(memoryIsFilledWithNoise(td->data(), TILESIZE, i));
+    }
+
+    /**
+     * And the truncated file is still usable for swapping out
+     */
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(store.trySwapOutTileData(td));
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        store.swapInTileData(td);
+        QVERIFY(memoryIsFilledWithNoise(td->data(), TILESIZE, i));
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
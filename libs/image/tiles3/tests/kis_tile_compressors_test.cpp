@@ -167,6 +167,64 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testLowLevelRoundTripCodecs_data()
+{
+    QTest::addColumn<int>("codec");
+
+    QTest::newRow("lzf") << int(KisCompressionRegistry::LZF);
+    QTest::newRow("lz4") << int(KisCompressionRegistry::LZ4);
+    QTest::newRow("zlib") << int(KisCompressionRegistry::ZLIB);
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripCodecs()
+{
+    QFETCH(int, codec);
+
+    KisAbstractTileCompressor *compressor =
+        new KisTileCompressor2(KisCompressionRegistry::Codec(codec));
+
+    doRoundTrip(compressor);
+    doLowLevelRoundTrip(compressor);
+    doLowLevelRoundTripIncompressible(compressor);
+
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testDecompressOtherCodec()
+{
+    const qint32 pixelSize = 1;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager dm(pixelSize, &oddPixel1);
+    KisTileSP tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+
+    KisTileData *td = tile->tileData();
+
+    /**
+     * Data written with one codec should be readable by a compressor
+     * that writes with any other codec, e.g. after changing the
+     * settings or when loading files from older versions of Krita
+     */
+    KisTileCompressor2 writer(KisCompressionRegistry::LZ4);
+    KisTileCompressor2 reader(KisCompressionRegistry::LZF);
+
+    qint32 bufferSize = writer.tileDataBufferSize(td);
+    quint8 *buffer = new quint8[bufferSize];
+    qint32 bytesWritten;
+    writer.compressTileData(td, buffer, bufferSize, bytesWritten);
+    QCOMPARE(int(buffer[0]), int(KisCompressionRegistry::LZ4));
+
+    memset(td->data(), oddPixel2, TILESIZE);
+
+    QVERIFY(reader.decompressTileData(buffer, bytesWritten, td));
+    QVERIFY(memoryIsFilled(oddPixel1, td->data(), TILESIZE));
+
+    delete[] buffer;
+    tile->unlock();
+}
+
 
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
@@ -0,0 +1,162 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_slab_allocator_test.h"
+#include <simpletest.h>
+
+#include <QtConcurrent>
+
+#include "kis_debug.h"
+
+#include "tiles3/kis_tile_data_slab_allocator.h"
+
+#define NUM_PIXELS 4096
+
+void KisTileDataSlabAllocatorTest::testAllPixelSizes()
+{
+    KisTileDataSlabAllocator allocator(NUM_PIXELS);
+
+    QVector<QPair<quint8*, qint32>> buffers;
+
+    /**
+     * Every pixel size in [1, 40] covers all the color spaces
+     * we have. 80 bytes is bigger than MAX_PIXEL_SIZE and should
+     * be handled by the malloc() fallback.
+     */
+    for (qint32 pixelSize = 1; pixelSize <= 40; pixelSize++) {
+        for (int i = 0; i < 50; i++) {
+            quint8 *ptr = allocator.allocate(pixelSize);
+            memset(ptr, pixelSize, pixelSize * NUM_PIXELS);
+            buffers.append(qMakePair(ptr, pixelSize));
+        }
+    }
+
+    for (int i = 0; i < 10; i++) {
+        quint8 *ptr = allocator.allocate(80);
+        memset(ptr, 80, 80 * NUM_PIXELS);
+        buffers.append(qMakePair(ptr, 80));
+    }
+
+    QCOMPARE(allocator.numSlabs(80), 0);
+
+    for (qint32 pixelSize = 1; pixelSize <= 40; pixelSize++) {
+        QVERIFY(allocator.numSlabs(pixelSize) > 0);
+    }
+
+    for (auto it = buffers.begin(); it != buffers.end(); ++it) {
+        const quint8 *ptr = it->first;
+        const qint32 size = it->second * NUM_PIXELS;
+
+        QCOMPARE(int(ptr[0]), it->second);
+        QCOMPARE(int(ptr[size - 1]), it->second);
+        QCOMPARE(quintptr(ptr) % 16, quintptr(0));
+    }
+
+    for (auto it = buffers.begin(); it != buffers.end(); ++it) {
+        allocator.free(it->first, it->second);
+    }
+
+    allocator.releaseFreeMemory();
+    QCOMPARE(allocator.slabsMemory(), qint64(0));
+}
+
+void KisTileDataSlabAllocatorTest::testReleaseEmptySlabs()
+{
+    const qint32 pixelSize = 5;
+    const int numBuffers = 1000;
+
+    KisTileDataSlabAllocator allocator(NUM_PIXELS);
+
+    QVector<quint8*> buffers;
+    for (int i = 0; i < numBuffers; i++) {
+        buffers.append(allocator.allocate(pixelSize));
+    }
+
+    const int numSlabs = allocator.numSlabs(pixelSize);
+    QVERIFY(numSlabs > 1);
+    QVERIFY(allocator.freeSlabsMemory() < allocator.slabsMemory() / numSlabs);
+
+    /**
+     * Free every second buffer: no slab should become empty,
+     * so the memory stays allocated
+     */
+    for (int i = 0; i < numBuffers; i += 2) {
+        allocator.free(buffers[i], pixelSize);
+    }
+    allocator.releaseFreeMemory();
+    QCOMPARE(allocator.numSlabs(pixelSize), numSlabs);
+
+    /**
+     * Now free the rest: the empty slabs are returned to the
+     * system, except of one spare slab, which is released
+     * by releaseFreeMemory()
+     */
+    for (int i = 1; i < numBuffers; i += 2) {
+        allocator.free(buffers[i], pixelSize);
+    }
+    QVERIFY(allocator.numSlabs(pixelSize) < numSlabs);
+
+    allocator.releaseFreeMemory();
+    QCOMPARE(allocator.numSlabs(pixelSize), 0);
+    QCOMPARE(allocator.slabsMemory(), qint64(0));
+}
+
+void KisTileDataSlabAllocatorTest::testHugePages()
+{
+    const quint64 hugePageSize = 2 * 1024 * 1024;
+
+    KisTileDataSlabAllocator allocator(NUM_PIXELS);
+    allocator.setHugePagesEnabled(true);
+    QVERIFY(allocator.hugePagesEnabled());
+
+    // the buffers of 3, 5 and 6 bytes per pixel don't fill a huge page exactly
+    for (qint32 pixelSize = 3; pixelSize <= 6; pixelSize++) {
+        quint8 *ptr = allocator.allocate(pixelSize);
+        memset(ptr, 1, pixelSize * NUM_PIXELS);
+
+#ifdef Q_OS_LINUX
+        // the first buffer of the slab is aligned to the huge page size
+        QCOMPARE(quintptr(ptr) % hugePageSize, quintptr(0));
+        QCOMPARE(quint64(allocator.slabsMemory()) % hugePageSize, quint64(0));
+#endif
+
+        allocator.free(ptr, pixelSize);
+        allocator.releaseFreeMemory();
+        QCOMPARE(allocator.slabsMemory(), qint64(0));
+    }
+}
+
+void KisTileDataSlabAllocatorTest::testConcurrentAllocation()
+{
+    KisTileDataSlabAllocator allocator(NUM_PIXELS);
+
+    QVector<qint32> pixelSizes({4, 5, 8, 10, 16, 20, 4, 8});
+
+    auto job = [&allocator] (qint32 pixelSize) {
+        QVector<quint8*> buffers;
+
+        for (int round = 0; round < 20; round++) {
+            for (int i = 0; i < 100; i++) {
+                quint8 *ptr = allocator.allocate(pixelSize);
+                memset(ptr, pixelSize, pixelSize * NUM_PIXELS);
+                buffers.append(ptr);
+            }
+
+            Q_FOREACH (quint8 *ptr, buffers) {
+                KIS_ASSERT(ptr[pixelSize * NUM_PIXELS - 1] == pixelSize);
+                allocator.free(ptr, pixelSize);
+            }
+            buffers.clear();
+        }
+    };
+
+    QtConcurrent::blockingMap(pixelSizes, job);
+
+    allocator.releaseFreeMemory();
+    QCOMPARE(allocator.slabsMemory(), qint64(0));
+}
+
+SIMPLE_TEST_MAIN(KisTileDataSlabAllocatorTest)
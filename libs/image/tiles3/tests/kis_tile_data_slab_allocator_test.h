@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_SLAB_ALLOCATOR_TEST_H
+#define KIS_TILE_DATA_SLAB_ALLOCATOR_TEST_H
+
+#include <simpletest.h>
+
+class KisTileDataSlabAllocatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAllPixelSizes();
+    void testReleaseEmptySlabs();
+    void testHugePages();
+    void testConcurrentAllocation();
+};
+
+#endif /* KIS_TILE_DATA_SLAB_ALLOCATOR_TEST_H */
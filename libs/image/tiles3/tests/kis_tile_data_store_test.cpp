@@ -7,6 +7,8 @@
 #include "kis_tile_data_store_test.h"
 #include <simpletest.h>
 
+#include <QElapsedTimer>
+
 #include "kis_debug.h"
 
 #include "kis_image_config.h"
@@ -176,5 +178,140 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+namespace {
+
+const qint32 NUM_COLUMNS = 8;
+const qint32 NUM_ROWS = 8;
+
+inline quint8 tileColor(qint32 col, qint32 row) {
+    return COLUMN2COLOR(1 + col + row * NUM_COLUMNS);
+}
+
+void fillTiles(KisTiledDataManager &dm)
+{
+    for (qint32 row = 0; row < NUM_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_COLUMNS; col++) {
+            KisTileSP tile = dm.getTile(col, row, true);
+            tile->lockForWrite();
+            memset(tile->data(), tileColor(col, row), TILESIZE);
+            tile->unlockForWrite();
+        }
+    }
+}
+
+bool tileIsResident(KisTiledDataManager &dm, qint32 col, qint32 row)
+{
+    KisTileSP tile = dm.getTile(col, row, false);
+    return tile->tileData()->data();
+}
+
+}
+
+void KisTileDataStoreTest::testPrefetching()
+{
+    KisImageConfig config(false);
+    config.setTilesPrefetching(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    fillTiles(dm);
+    store->debugSwapAll();
+
+    for (qint32 row = 0; row < NUM_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_COLUMNS; col++) {
+            QVERIFY(!tileIsResident(dm, col, row));
+        }
+    }
+
+    const QRect prefetchedTiles(2, 2, 4, 4);
+    const qint64 numPrefetchedBefore = store->m_prefetcher.numPrefetchedTiles();
+
+    dm.prefetchRect(QRect(prefetchedTiles.x() * KisTileData::WIDTH,
+                          prefetchedTiles.y() * KisTileData::HEIGHT,
+                          prefetchedTiles.width() * KisTileData::WIDTH,
+                          prefetchedTiles.height() * KisTileData::HEIGHT));
+
+    QTRY_COMPARE_WITH_TIMEOUT(store->m_prefetcher.numPrefetchedTiles() - numPrefetchedBefore,
+                              qint64(prefetchedTiles.width() * prefetchedTiles.height()), 10000);
+
+    for (qint32 row = 0; row < NUM_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_COLUMNS; col++) {
+            QCOMPARE(tileIsResident(dm, col, row), prefetchedTiles.contains(col, row));
+        }
+    }
+
+    for (qint32 row = 0; row < NUM_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_COLUMNS; col++) {
+            KisTileSP tile = dm.getTile(col, row, false);
+            tile->lockForRead();
+            QVERIFY(memoryIsFilled(tileColor(col, row), tile->data(), TILESIZE));
+            tile->unlockForRead();
+        }
+    }
+}
+
+void KisTileDataStoreTest::testPrefetchingConcurrentWrite()
+{
+    KisImageConfig config(false);
+    config.setTilesPrefetching(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    fillTiles(dm);
+    store->debugSwapAll();
+
+    const qint64 numPrefetchedBefore = store->m_prefetcher.numPrefetchedTiles();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    /**
+     * The prefetching request only puts the tiles into the queue
+     * of the prefetcher, it must not wait for them to be loaded
+     */
+    dm.prefetchRect(QRect(0, 0, NUM_COLUMNS * KisTileData::WIDTH, NUM_ROWS * KisTileData::HEIGHT));
+
+    /**
+     * The writes race with the prefetcher. Whoever loads the tile
+     * first, the written data must never be overwritten by the
+     * stale data from the swap
+     */
+    for (qint32 row = 0; row < NUM_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_COLUMNS; col++) {
+            KisTileSP tile = dm.getTile(col, row, true);
+            tile->lockForWrite();
+            QVERIFY(memoryIsFilled(tileColor(col, row), tile->data(), TILESIZE));
+            memset(tile->data(), 255 - tileColor(col, row), TILESIZE);
+            tile->unlockForWrite();
+        }
+    }
+
+    QVERIFY(timer.elapsed() < 5000);
+
+    QTRY_COMPARE_WITH_TIMEOUT(store->m_prefetcher.numPrefetchedTiles() - numPrefetchedBefore,
+                              qint64(NUM_COLUMNS * NUM_ROWS), 10000);
+
+    for (qint32 row = 0; row < NUM_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_COLUMNS; col++) {
+            KisTileSP tile = dm.getTile(col, row, false);
+            tile->lockForRead();
+            QVERIFY(memoryIsFilled(255 - tileColor(col, row), tile->data(), TILESIZE));
+            tile->unlockForRead();
+        }
+    }
+}
+
 SIMPLE_TEST_MAIN(KisTileDataStoreTest)
 
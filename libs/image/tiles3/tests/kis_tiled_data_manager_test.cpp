@@ -8,6 +8,11 @@
 #include <simpletest.h>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_memento_item.h"
+#include "tiles3/swap/kis_abstract_tile_compressor.h"
+#include "kis_image_config.h"
+
+#include <QBuffer>
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -527,6 +532,292 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
     QVERIFY(memoryIsFilled(oddPixel2, tile10->data(), TILESIZE));
 }
 
+void KisTiledDataManagerTest::testReadForeignTileSize()
+{
+    /**
+     * Emulate a file written by a build with tiles twice
+     * smaller than ours
+     */
+    const qint32 tileWidth = KisTileData::WIDTH / 2;
+    const qint32 tileHeight = KisTileData::HEIGHT / 2;
+
+    QByteArray data;
+    data.append(QString("VERSION 2\n"
+                        "TILEWIDTH %1\n"
+                        "TILEHEIGHT %2\n"
+                        "PIXELSIZE 1\n"
+                        "DATA 4\n").arg(tileWidth).arg(tileHeight).toLatin1());
+
+    for (int row = 0; row < 2; row++) {
+        for (int col = 0; col < 2; col++) {
+            data.append(QString("%1,%2,LZF,%3\n")
+                        .arg(col * tileWidth)
+                        .arg(row * tileHeight)
+                        .arg(tileWidth * tileHeight + 1).toLatin1());
+
+            // raw (uncompressed) data flag
+            data.append(char(0));
+            data.append(QByteArray(tileWidth * tileHeight, char(10 + row * 2 + col)));
+        }
+    }
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+    QVERIFY(dm.read(&buffer));
+
+    QCOMPARE(dm.extent(), QRect(0, 0, KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    QByteArray result(tileWidth * tileHeight, 0);
+
+    for (int row = 0; row < 2; row++) {
+        for (int col = 0; col < 2; col++) {
+            dm.readBytes((quint8*)result.data(),
+                         col * tileWidth, row * tileHeight,
+                         tileWidth, tileHeight);
+
+            QVERIFY(memoryIsFilled(10 + row * 2 + col, (quint8*)result.data(), result.size()));
+        }
+    }
+}
+
+void KisTiledDataManagerTest::checkUndoHistory(std::function<void()> checkHistoryStored)
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    const QRect rect(0, 0, 2 * KisTileData::WIDTH, KisTileData::HEIGHT);
+
+    /**
+     * Every stroke changes only a small part of the tiles,
+     * so that the deltas would be small enough
+     */
+    QVector<KisMementoSP> mementos;
+    QVector<QRect> strokeRects;
+
+    quint8 oddPixel = 128;
+    dm.clear(rect, &oddPixel);
+
+    for (int i = 0; i < 4; i++) {
+        const QRect strokeRect(10 + i * 20, 10 + i * 5, 30, 10);
+        quint8 strokePixel = 200 + i;
+
+        mementos << dm.getMemento();
+        dm.clear(strokeRect, &strokePixel);
+        dm.commit();
+
+        strokeRects << strokeRect;
+    }
+
+    checkHistoryStored();
+
+    QByteArray expected(rect.width() * rect.height(), char(oddPixel));
+    QVector<QByteArray> revisions;
+    revisions << expected;
+
+    for (int i = 0; i < strokeRects.size(); i++) {
+        const QRect &r = strokeRects[i];
+        for (int y = r.top(); y <= r.bottom(); y++) {
+            for (int x = r.left(); x <= r.right(); x++) {
+                expected[y * rect.width() + x] = char(200 + i);
+            }
+        }
+        revisions << expected;
+    }
+
+    QByteArray buffer(rect.width() * rect.height(), 0);
+
+    for (int i = mementos.size() - 1; i >= 0; i--) {
+        dm.rollback(mementos[i]);
+        dm.readBytes((quint8*)buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QCOMPARE(buffer, revisions[i]);
+    }
+
+    for (int i = 0; i < mementos.size(); i++) {
+        dm.rollforward(mementos[i]);
+        dm.readBytes((quint8*)buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QCOMPARE(buffer, revisions[i + 1]);
+    }
+}
+
+void KisTiledDataManagerTest::testDeltaMementos()
+{
+    KisMementoItem::setDeltaEncodingEnabled(true);
+
+    const qint64 initialDeltaMemory = KisMementoItem::totalDeltaMemory();
+
+    checkUndoHistory([initialDeltaMemory] () {
+        QVERIFY(KisMementoItem::totalDeltaMemory() > initialDeltaMemory);
+    });
+
+    KisMementoItem::setDeltaEncodingEnabled(false);
+}
+
+void KisTiledDataManagerTest::testSwapOutUndoHistory()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    {
+        KisImageConfig config(false);
+        config.setUndoSwapEnabled(true);
+        config.setUndoMemoryLimit(0);
+        config.setUndoInMemorySteps(1);
+        store->testingRereadConfig();
+    }
+
+    const qint64 initialSwapSize = store->undoSwapStore()->totalMemoryUsed();
+
+    checkUndoHistory([store, initialSwapSize] () {
+        QVERIFY(store->undoSwapStore()->totalMemoryUsed() > initialSwapSize);
+    });
+
+    QCOMPARE(store->undoSwapStore()->totalMemoryUsed(), initialSwapSize);
+
+    {
+        KisImageConfig config(false);
+        config.setUndoSwapEnabled(config.undoSwapEnabled(true));
+        config.setUndoMemoryLimit(config.undoMemoryLimit(true));
+        config.setUndoInMemorySteps(config.undoInMemorySteps(true));
+        store->testingRereadConfig();
+    }
+}
+
+void KisTiledDataManagerTest::testUniformTiles()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    {
+        KisImageConfig config(false);
+        config.setTilesShareUniformData(true);
+        store->testingRereadConfig();
+    }
+
+    const qint32 w = KisTileData::WIDTH;
+    const qint32 h = KisTileData::HEIGHT;
+
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 77;
+    quint8 oddPixel = 10;
+
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    // paint the tiles pixel by pixel, not with clear()
+    KisMementoSP memento1 = dm.getMemento();
+    QByteArray fill(w * h, char(fillPixel));
+    dm.writeBytes((quint8*)fill.data(), 0, 0, w, h);
+    dm.writeBytes((quint8*)fill.data(), w, 0, w, h);
+    dm.commit();
+
+    KisTileSP tile00 = dm.getTile(0, 0, false);
+    KisTileSP tile10 = dm.getTile(1, 0, false);
+    QVERIFY(tile00->tileData()->isUniform());
+    QCOMPARE(tile00->tileData(), tile10->tileData());
+
+    // a fill of another device shares the same data
+    KisTiledDataManager dm2(1, &defaultPixel);
+    dm2.clear(QRect(0, 0, w, h), &fillPixel);
+    QCOMPARE(dm2.getTile(0, 0, false)->tileData(), tile00->tileData());
+
+    tile00 = tile10 = 0;
+
+    // changing a single pixel should COW the shared data
+    KisMementoSP memento2 = dm.getMemento();
+    dm.writeBytes(&oddPixel, 5, 5, 1, 1);
+    dm.commit();
+
+    tile00 = dm.getTile(0, 0, false);
+    tile10 = dm.getTile(1, 0, false);
+    QVERIFY(!tile00->tileData()->isUniform());
+    QVERIFY(tile10->tileData()->isUniform());
+    tile00 = tile10 = 0;
+
+    QByteArray buffer(2 * w * h, 0);
+    dm.readBytes((quint8*)buffer.data(), 0, 0, 2 * w, h);
+    QCOMPARE(quint8(buffer[5 * 2 * w + 5]), oddPixel);
+    QCOMPARE(quint8(buffer[6 * 2 * w + 6]), fillPixel);
+
+    dm.rollback(memento2);
+    dm.readBytes((quint8*)buffer.data(), 0, 0, 2 * w, h);
+    QVERIFY(memoryIsFilled(fillPixel, (quint8*)buffer.data(), buffer.size()));
+
+    dm.rollback(memento1);
+    dm.readBytes((quint8*)buffer.data(), 0, 0, 2 * w, h);
+    QVERIFY(memoryIsFilled(defaultPixel, (quint8*)buffer.data(), buffer.size()));
+
+    {
+        KisImageConfig config(false);
+        config.setTilesShareUniformData(config.tilesShareUniformData(true));
+        store->testingRereadConfig();
+    }
+}
+
+void KisTiledDataManagerTest::testReadOversizedTileHeader()
+{
+    quint8 defaultPixel = 0;
+
+    {
+        /**
+         * The size of the tile data would overflow qint32
+         */
+        QByteArray data("VERSION 2\n"
+                        "TILEWIDTH 32767\n"
+                        "TILEHEIGHT 32767\n"
+                        "PIXELSIZE 4\n"
+                        "DATA 1\n"
+                        "0,0,LZF,5\n");
+        data.append(QByteArray(5, char(0)));
+
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        KisTiledDataManager dm(4, &defaultPixel);
+        QVERIFY(!dm.read(&buffer));
+        QVERIFY(dm.extent().isEmpty());
+    }
+
+    {
+        /**
+         * Just a bit bigger than the largest supported tile size
+         */
+        QByteArray data;
+        data.append(QString("VERSION 2\n"
+                            "TILEWIDTH %1\n"
+                            "TILEHEIGHT 64\n"
+                            "PIXELSIZE 1\n"
+                            "DATA 1\n")
+                    .arg(KisAbstractTileCompressor::MAX_STREAM_TILE_SIZE + 1).toLatin1());
+
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        KisTiledDataManager dm(1, &defaultPixel);
+        QVERIFY(!dm.read(&buffer));
+    }
+
+    {
+        /**
+         * The size of the compressed data is bigger than
+         * the tile itself
+         */
+        QByteArray data("VERSION 2\n"
+                        "TILEWIDTH 32\n"
+                        "TILEHEIGHT 32\n"
+                        "PIXELSIZE 1\n"
+                        "DATA 1\n"
+                        "0,0,LZF,100000000\n");
+        data.append(QByteArray(32 * 32 + 1, char(0)));
+
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        KisTiledDataManager dm(1, &defaultPixel);
+        QVERIFY(!dm.read(&buffer));
+        QVERIFY(dm.extent().isEmpty());
+    }
+}
+
 //#include <valgrind/callgrind.h>
 
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
@@ -7,6 +7,7 @@
 #define KIS_TILED_DATA_MANAGER_TEST_H
 
 #include <simpletest.h>
+#include <functional>
 
 class KisTiledDataManager;
 
@@ -30,6 +31,8 @@ private:
 
     void benchmarkCOWImpl();
 
+    void checkUndoHistory(std::function<void()> checkHistoryStored);
+
 private Q_SLOTS:
     void testUndoingNewTiles();
     void testPurgedAndEmptyTransactions();
@@ -40,6 +43,11 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testReadForeignTileSize();
+    void testReadOversizedTileHeader();
+    void testDeltaMementos();
+    void testSwapOutUndoHistory();
+    void testUniformTiles();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
@@ -9,7 +9,11 @@
 #include <QHash>
 #include <QList>
 #include <QMutex>
+#include <QThread>
 #include <QThreadStorage>
+#include <QVector>
+
+#include <algorithm>
 
 #include <KoColorSpace.h>
 
@@ -43,33 +47,137 @@ uint qHash(const KoColorConversionCacheKey& key)
     return qHash(key.src) + qHash(key.dst) + qHash(key.renderingIntent) + qHash(key.conversionFlags);
 }
 
+namespace {
+/**
+ * The number of the recently used transformations every thread keeps
+ * in its thread-local storage
+ */
+const int THREAD_LOCAL_CACHE_SIZE = 8;
+
+/**
+ * The number of the transformations the cache keeps. When the limit is
+ * reached, the least recently used of the idle transformations are
+ * deleted. The transformations held by the threads are never deleted,
+ * but there are at most THREAD_LOCAL_CACHE_SIZE of them per thread.
+ */
+const int MAX_CACHED_TRANSFORMATIONS = 128;
+}
+
 struct KoColorConversionCache::CachedTransformation {
 
     CachedTransformation(KoColorConversionTransformation* _transfo)
-        : transfo(_transfo), use(0)
+        : transfo(_transfo), ref(1)
     {}
 
     ~CachedTransformation() {
         delete transfo;
     }
 
+    /**
+     * The transformation is referenced by the cache itself and by
+     * every KoCachedColorConversionTransformation object, so it is
+     * free only when the cache is the only owner
+     */
     bool isNotInUse() {
-        return !use;
+        return ref.loadAcquire() == 1;
+    }
+
+    static void release(CachedTransformation *transfo) {
+        if (!transfo->ref.deref()) {
+            delete transfo;
+        }
     }
 
     KoColorConversionTransformation* transfo;
-    QAtomicInt use;
+    QAtomicInt ref;
+
+    /// the value of Private::clock when the transformation was taken from the cache
+    quint64 lastUsed = 0;
 };
 
 typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
 
+struct ThreadLocalCache {
+    int generation = 0;
+
+    /// the most recently used transformation is the first one
+    QList<FastPathCacheItem> items;
+};
+
 struct KoColorConversionCache::Private {
     QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
     QMutex cacheMutex;
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+    /**
+     * Incremented every time a color space is destroyed, so the
+     * threads could drop their stale items without dereferencing
+     * the keys
+     */
+    QAtomicInt generation;
+
+    /**
+     * When all the instances of a conversion are in use, the threads
+     * start sharing them instead of creating the new ones
+     */
+    int maxTransformationsPerKey = QThread::idealThreadCount();
+
+    /// incremented every time a transformation is taken from the cache
+    quint64 clock = 0;
+
+    QThreadStorage<ThreadLocalCache*> fastStorage;
+
+    ThreadLocalCache* threadLocalCache();
+    void evictIdleTransformationsLocked();
 };
 
+ThreadLocalCache* KoColorConversionCache::Private::threadLocalCache()
+{
+    const int currentGeneration = generation.loadAcquire();
+
+    ThreadLocalCache *localCache = fastStorage.localData();
+
+    if (!localCache) {
+        localCache = new ThreadLocalCache();
+        localCache->generation = currentGeneration;
+        fastStorage.setLocalData(localCache);
+    } else if (localCache->generation != currentGeneration) {
+        localCache->items.clear();
+        localCache->generation = currentGeneration;
+    }
+
+    return localCache;
+}
+
+void KoColorConversionCache::Private::evictIdleTransformationsLocked()
+{
+    if (cache.size() <= MAX_CACHED_TRANSFORMATIONS) return;
+
+    QVector<CachedTransformation*> idleTransfos;
+
+    Q_FOREACH (CachedTransformation *ct, cache) {
+        if (ct->isNotInUse()) {
+            idleTransfos.append(ct);
+        }
+    }
+
+    std::sort(idleTransfos.begin(), idleTransfos.end(),
+              [] (const CachedTransformation *lhs, const CachedTransformation *rhs) {
+                  return lhs->lastUsed < rhs->lastUsed;
+              });
+
+    const int numToEvict = qMin(idleTransfos.size(), cache.size() - MAX_CACHED_TRANSFORMATIONS);
+    idleTransfos.resize(numToEvict);
+
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (idleTransfos.contains(it.value())) {
+            CachedTransformation::release(it.value());
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 
 KoColorConversionCache::KoColorConversionCache() : d(new Private)
 {
@@ -77,8 +185,10 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
+    d->fastStorage.setLocalData(0);
+
     Q_FOREACH (CachedTransformation* transfo, d->cache) {
-        delete transfo;
+        CachedTransformation::release(transfo);
     }
     delete d;
 }
@@ -90,49 +200,74 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 {
     KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    ThreadLocalCache *localCache = d->threadLocalCache();
+    QList<FastPathCacheItem> &items = localCache->items;
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
+    for (int i = 0; i < items.size(); i++) {
+        if (items[i].first == key) {
+            if (i > 0) {
+                items.move(i, 0);
+            }
+            return items.first().second;
         }
     }
 
-    cacheItem = 0;
+    if (items.size() >= THREAD_LOCAL_CACHE_SIZE) {
+        items.removeLast();
+    }
+
+    {
+        QMutexLocker lock(&d->cacheMutex);
+        QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
 
-    QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
-    if (cachedTransfos.size() != 0) {
         Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            ct->transfo->setSrcColorSpace(src);
-            ct->transfo->setDstColorSpace(dst);
+            if (ct->isNotInUse()) {
+                ct->lastUsed = ++d->clock;
+                ct->transfo->setSrcColorSpace(src);
+                ct->transfo->setDstColorSpace(dst);
+
+                items.prepend(FastPathCacheItem(key, KoCachedColorConversionTransformation(ct)));
+                return items.first().second;
+            }
+        }
 
-            cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
-            break;
+        if (cachedTransfos.size() >= d->maxTransformationsPerKey) {
+            items.prepend(FastPathCacheItem(key, KoCachedColorConversionTransformation(cachedTransfos.first())));
+            return items.first().second;
         }
     }
-    if (!cacheItem) {
-        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
-        d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
-    }
 
-    d->fastStorage.setLocalData(cacheItem);
-    return cacheItem->second;
+    /**
+     * Creation of the transformation may take a lot of time,
+     * so it is done without holding the lock
+     */
+    KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
+    CachedTransformation* ct = new CachedTransformation(transfo);
+    items.prepend(FastPathCacheItem(key, KoCachedColorConversionTransformation(ct)));
+
+    QMutexLocker lock(&d->cacheMutex);
+    ct->lastUsed = ++d->clock;
+    d->cache.insert(key, ct);
+    d->evictIdleTransformationsLocked();
+
+    return items.first().second;
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
+    d->generation.ref();
     d->fastStorage.setLocalData(0);
 
     QMutexLocker lock(&d->cacheMutex);
     QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
     for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
         if (it.key().src == cs || it.key().dst == cs) {
-            Q_ASSERT(it.value()->isNotInUse()); // That's terribly evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
+            /**
+             * The transformation may still be referenced from the
+             * thread-local storage of the other threads, then it
+             * will be deleted when they drop their stale items
+             */
+            CachedTransformation::release(it.value());
             it = d->cache.erase(it);
         } else {
             ++it;
@@ -145,24 +280,32 @@ void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(KoColorConversionCache::CachedTransformation* transfo)
     : m_transfo(transfo)
 {
-    m_transfo = transfo;
-    m_transfo->use.ref();
+    m_transfo->ref.ref();
 }
 
 KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation& rhs)
     : m_transfo(rhs.m_transfo)
 {
-    m_transfo->use.ref();
+    m_transfo->ref.ref();
+}
+
+KoCachedColorConversionTransformation& KoCachedColorConversionTransformation::operator=(const KoCachedColorConversionTransformation& rhs)
+{
+    if (m_transfo != rhs.m_transfo) {
+        rhs.m_transfo->ref.ref();
+        KoColorConversionCache::CachedTransformation::release(m_transfo);
+        m_transfo = rhs.m_transfo;
+    }
+    return *this;
 }
 
 KoCachedColorConversionTransformation::~KoCachedColorConversionTransformation()
 {
-    Q_ASSERT(m_transfo->use > 0);
-    m_transfo->use.deref();
+    Q_ASSERT(m_transfo->ref > 0);
+    KoColorConversionCache::CachedTransformation::release(m_transfo);
 }
 
 const KoColorConversionTransformation* KoCachedColorConversionTransformation::transformation() const
 {
     return m_transfo->transfo;
 }
-
@@ -15,6 +15,15 @@ class KoColorSpace;
 /**
  * This class holds a cache of KoColorConversionTransformations.
  *
+ * The cache is a pool of transformations: a transformation is given
+ * to a single thread only, the other threads asking for the same
+ * conversion get their own instances (up to the number of the CPU
+ * cores). Every thread also keeps a few of the recently used
+ * transformations in its thread-local storage, so the lookup of
+ * the conversions used by the thread doesn't touch the mutex of
+ * the cache. The size of the cache is bounded, the least recently
+ * used of the idle transformations are deleted first.
+ *
  * This class is not part of public API, and can be changed without notice.
  */
 class KoColorConversionCache
@@ -64,6 +73,7 @@ private:
     KoCachedColorConversionTransformation(KoColorConversionCache::CachedTransformation* transfo);
 public:
     KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation&);
+    KoCachedColorConversionTransformation& operator=(const KoCachedColorConversionTransformation&);
     ~KoCachedColorConversionTransformation();
 public:
     const KoColorConversionTransformation* transformation() const;
@@ -0,0 +1,103 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedLut3DInterpolator_H
+#define KoOptimizedLut3DInterpolator_H
+
+#include "KoOptimizedLut3DInterpolatorBase.h"
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+template<typename _impl = xsimd::current_arch>
+class KoOptimizedLut3DInterpolator : public KoOptimizedLut3DInterpolatorBase
+{
+public:
+    void interpolate(const float *lut, int gridSize, int numChannels,
+                     const float *r, const float *g, const float *b,
+                     float *dst, int numPixels) const override
+    {
+#if XSIMD_VERSION_MAJOR < 10
+        // the vectorized version needs gather operations
+        interpolateScalar(lut, gridSize, numChannels, r, g, b, dst, numPixels, 0, numPixels);
+#else
+        using float_v = xsimd::batch<float, _impl>;
+
+        const int vectorEnd = numPixels - numPixels % float_v::size;
+
+        const float_v zero(0.0f);
+        const float_v one(1.0f);
+        const float_v scale(float(gridSize - 1));
+        const float_v maxBase(float(gridSize - 2));
+
+        /**
+         * The offsets are smaller than 2^24 for any sane size of
+         * the grid, so they are calculated in floats and converted
+         * into integers only for the gather operation
+         */
+        const float_v strideR(float(gridSize * gridSize * numChannels));
+        const float_v strideG(float(gridSize * numChannels));
+        const float_v strideB(float(numChannels));
+        const float_v strideAll = strideR + strideG + strideB;
+
+        for (int i = 0; i < vectorEnd; i += float_v::size) {
+            const float_v x = xsimd::min(xsimd::max(float_v::load_unaligned(r + i), zero), one) * scale;
+            const float_v y = xsimd::min(xsimd::max(float_v::load_unaligned(g + i), zero), one) * scale;
+            const float_v z = xsimd::min(xsimd::max(float_v::load_unaligned(b + i), zero), one) * scale;
+
+            const float_v baseX = xsimd::min(xsimd::floor(x), maxBase);
+            const float_v baseY = xsimd::min(xsimd::floor(y), maxBase);
+            const float_v baseZ = xsimd::min(xsimd::floor(z), maxBase);
+
+            const float_v fx = x - baseX;
+            const float_v fy = y - baseY;
+            const float_v fz = z - baseZ;
+
+            // see the comment in KoOptimizedLut3DInterpolatorBase::interpolateScalar()
+            const auto xMax = fx >= fy && fx >= fz;
+            const auto yMax = !xMax && fy >= fz;
+            const auto xMin = fx < fy && fx < fz;
+            const auto yMin = !xMin && fy < fz;
+
+            const float_v max = xsimd::select(xMax, fx, xsimd::select(yMax, fy, fz));
+            const float_v min = xsimd::select(xMin, fx, xsimd::select(yMin, fy, fz));
+            const float_v mid = fx + fy + fz - max - min;
+
+            const float_v offset1 = xsimd::select(xMax, strideR, xsimd::select(yMax, strideG, strideB));
+            const float_v offset2 = strideAll - xsimd::select(xMin, strideR, xsimd::select(yMin, strideG, strideB));
+
+            const float_v base = baseX * strideR + baseY * strideG + baseZ * strideB;
+
+            const auto index0 = xsimd::nearbyint_as_int(base);
+            const auto index1 = xsimd::nearbyint_as_int(base + offset1);
+            const auto index2 = xsimd::nearbyint_as_int(base + offset2);
+            const auto index3 = xsimd::nearbyint_as_int(base + strideAll);
+
+            const float_v w0 = one - max;
+            const float_v w1 = max - mid;
+            const float_v w2 = mid - min;
+            const float_v w3 = min;
+
+            for (int ch = 0; ch < numChannels; ch++) {
+                const float *channelLut = lut + ch;
+
+                const float_v result =
+                    w0 * float_v::gather(channelLut, index0) +
+                    w1 * float_v::gather(channelLut, index1) +
+                    w2 * float_v::gather(channelLut, index2) +
+                    w3 * float_v::gather(channelLut, index3);
+
+                result.store_unaligned(dst + ch * numPixels + i);
+            }
+        }
+
+        interpolateScalar(lut, gridSize, numChannels, r, g, b, dst, numPixels, vectorEnd, numPixels);
+#endif
+    }
+};
+
+#endif // KoOptimizedLut3DInterpolator_H
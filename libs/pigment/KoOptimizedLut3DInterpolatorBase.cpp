@@ -0,0 +1,87 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedLut3DInterpolatorBase.h"
+
+#include <cmath>
+
+KoOptimizedLut3DInterpolatorBase::KoOptimizedLut3DInterpolatorBase()
+{
+}
+
+KoOptimizedLut3DInterpolatorBase::~KoOptimizedLut3DInterpolatorBase()
+{
+}
+
+void KoOptimizedLut3DInterpolatorBase::interpolate(const float *lut, int gridSize, int numChannels,
+                                                   const float *r, const float *g, const float *b,
+                                                   float *dst, int numPixels) const
+{
+    interpolateScalar(lut, gridSize, numChannels, r, g, b, dst, numPixels, 0, numPixels);
+}
+
+void KoOptimizedLut3DInterpolatorBase::interpolateScalar(const float *lut, int gridSize, int numChannels,
+                                                         const float *r, const float *g, const float *b,
+                                                         float *dst, int numPixels,
+                                                         int begin, int end)
+{
+    const float scale = gridSize - 1;
+    const float maxBase = gridSize - 2;
+
+    const int strideR = gridSize * gridSize * numChannels;
+    const int strideG = gridSize * numChannels;
+    const int strideB = numChannels;
+
+    for (int i = begin; i < end; i++) {
+        const float x = qBound(0.0f, r[i], 1.0f) * scale;
+        const float y = qBound(0.0f, g[i], 1.0f) * scale;
+        const float z = qBound(0.0f, b[i], 1.0f) * scale;
+
+        // the last node of the grid belongs to the previous cell
+        const float baseX = qMin(std::floor(x), maxBase);
+        const float baseY = qMin(std::floor(y), maxBase);
+        const float baseZ = qMin(std::floor(z), maxBase);
+
+        const float fx = x - baseX;
+        const float fy = y - baseY;
+        const float fz = z - baseZ;
+
+        /**
+         * The cell is split into six tetrahedra, each of them has
+         * the nodes (0,0,0) and (1,1,1). The other two nodes are
+         * found by moving along the axis with the largest fraction
+         * first and then along the axis with the middle one.
+         */
+        const bool xMax = fx >= fy && fx >= fz;
+        const bool yMax = !xMax && fy >= fz;
+        const bool xMin = fx < fy && fx < fz;
+        const bool yMin = !xMin && fy < fz;
+
+        const float max = xMax ? fx : yMax ? fy : fz;
+        const float min = xMin ? fx : yMin ? fy : fz;
+        const float mid = fx + fy + fz - max - min;
+
+        const int offset1 = xMax ? strideR : yMax ? strideG : strideB;
+        const int offset2 = strideR + strideG + strideB - (xMin ? strideR : yMin ? strideG : strideB);
+        const int offset3 = strideR + strideG + strideB;
+
+        const float *node0 = lut +
+            int(baseX) * strideR + int(baseY) * strideG + int(baseZ) * strideB;
+        const float *node1 = node0 + offset1;
+        const float *node2 = node0 + offset2;
+        const float *node3 = node0 + offset3;
+
+        const float w0 = 1.0f - max;
+        const float w1 = max - mid;
+        const float w2 = mid - min;
+        const float w3 = min;
+
+        for (int ch = 0; ch < numChannels; ch++) {
+            dst[ch * numPixels + i] =
+                w0 * node0[ch] + w1 * node1[ch] + w2 * node2[ch] + w3 * node3[ch];
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedLut3DInterpolatorBase_H
+#define KoOptimizedLut3DInterpolatorBase_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Tetrahedral interpolation in a 3D lookup table
+ *
+ * The interpolator is used by the color conversions that replace the
+ * full color management pipeline with a precomputed 3D LUT, e.g. for
+ * RGB->RGB and RGB->CMYK conversions between two fixed profiles.
+ *
+ * The LUT is a cube of `gridSize^3` nodes, every node has
+ * `numChannels` float values. The nodes are stored in (r, g, b)
+ * order, that is, the blue coordinate changes the fastest:
+ *
+ * \code{.cpp}
+ * const float *node = lut + ((r * gridSize + g) * gridSize + b) * numChannels;
+ * \endcode
+ *
+ * The input coordinates are normalized to [0, 1] and passed as three
+ * separate planes. The result is written as `numChannels` planes of
+ * `numPixels` values each.
+ *
+ * The actual implementation is placed in class
+ * `KoOptimizedLut3DInterpolator`. To create an interpolator optimized
+ * for your CPU architecture, just call
+ * KoOptimizedLut3DInterpolatorFactory::create().
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedLut3DInterpolatorBase
+{
+public:
+    KoOptimizedLut3DInterpolatorBase();
+    virtual ~KoOptimizedLut3DInterpolatorBase();
+
+    virtual void interpolate(const float *lut, int gridSize, int numChannels,
+                             const float *r, const float *g, const float *b,
+                             float *dst, int numPixels) const;
+
+protected:
+    /**
+     * Interpolates pixels in range [begin, end) without any vectorization,
+     * it is used by the scalar version of the interpolator and for the
+     * pixels that don't fill the whole SIMD register.
+     */
+    static void interpolateScalar(const float *lut, int gridSize, int numChannels,
+                                  const float *r, const float *g, const float *b,
+                                  float *dst, int numPixels,
+                                  int begin, int end);
+};
+
+#endif // KoOptimizedLut3DInterpolatorBase_H
@@ -0,0 +1,15 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedLut3DInterpolatorFactory.h"
+
+#include "KoOptimizedLut3DInterpolatorFactoryImpl.h"
+
+
+KoOptimizedLut3DInterpolatorBase *KoOptimizedLut3DInterpolatorFactory::create()
+{
+    return createOptimizedClass<KoOptimizedLut3DInterpolatorFactoryImpl>();
+}
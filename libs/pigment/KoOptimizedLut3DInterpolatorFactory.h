@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedLut3DInterpolatorFACTORY_H
+#define KoOptimizedLut3DInterpolatorFACTORY_H
+
+#include "KoOptimizedLut3DInterpolatorBase.h"
+
+/**
+ * \see KoOptimizedLut3DInterpolatorBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedLut3DInterpolatorFactory
+{
+public:
+    static KoOptimizedLut3DInterpolatorBase* create();
+};
+
+#endif // KoOptimizedLut3DInterpolatorFACTORY_H
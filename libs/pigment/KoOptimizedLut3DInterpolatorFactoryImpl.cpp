@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedLut3DInterpolatorFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedLut3DInterpolator.h"
+
+template<>
+KoOptimizedLut3DInterpolatorBase *
+KoOptimizedLut3DInterpolatorFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KoOptimizedLut3DInterpolator<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedLut3DInterpolatorFACTORYIMPL_H
+#define KoOptimizedLut3DInterpolatorFACTORYIMPL_H
+
+#include <KoOptimizedLut3DInterpolatorBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedLut3DInterpolatorFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoOptimizedLut3DInterpolatorBase* create();
+};
+
+#endif // KoOptimizedLut3DInterpolatorFACTORYIMPL_H
@@ -0,0 +1,14 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedLut3DInterpolatorFactoryImpl.h"
+
+template<>
+KoOptimizedLut3DInterpolatorBase *
+KoOptimizedLut3DInterpolatorFactoryImpl::create<xsimd::generic>()
+{
+    return new KoOptimizedLut3DInterpolatorBase();
+}
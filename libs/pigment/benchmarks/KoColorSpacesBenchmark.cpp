@@ -6,7 +6,12 @@
 
 #include "KoColorSpacesBenchmark.h"
 
+#include <QThread>
+#include <QThreadPool>
+
 #include <simpletest.h>
+#include <color_conversion_test_util.h>
+#include <KoColorModelStandardIds.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
 
@@ -134,4 +139,70 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+namespace {
+
+/**
+ * The size of a row of a tile, the paint device converts its
+ * data in chunks of this size
+ */
+const int CONVERSION_CHUNK = 64;
+
+}
+
+void KoColorSpacesBenchmark::benchmarkConversion_data()
+{
+    QTest::addColumn<int>("numThreads");
+    QTest::addColumn<bool>("interleaved");
+
+    const int idealThreadCount = QThread::idealThreadCount();
+
+    QTest::newRow("1 thread") << 1 << false;
+    QTest::newRow("1 thread, interleaved") << 1 << true;
+    QTest::newRow("all threads") << idealThreadCount << false;
+    QTest::newRow("all threads, interleaved") << idealThreadCount << true;
+}
+
+void KoColorSpacesBenchmark::benchmarkConversion()
+{
+    QFETCH(int, numThreads);
+    QFETCH(bool, interleaved);
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *labColorSpace = KoColorSpaceRegistry::instance()->lab16();
+    const KoColorSpace *cmykColorSpace =
+        KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(), Integer8BitsColorDepthID.id(), 0);
+
+    if (!labColorSpace || !cmykColorSpace) {
+        QSKIP("LCMS color spaces are not available");
+    }
+
+    QVector<const KoColorSpace*> dstColorSpaces({labColorSpace});
+    if (interleaved) {
+        // every chunk uses a different conversion than the previous one
+        dstColorSpaces << cmykColorSpace;
+    }
+
+    const int dstPixelSize = qMax(labColorSpace->pixelSize(), cmykColorSpace->pixelSize());
+
+    QScopedArrayPointer<quint8> src(new quint8[NB_PIXELS * srcColorSpace->pixelSize()]);
+    QScopedArrayPointer<quint8> dst(new quint8[NB_PIXELS * dstPixelSize]);
+
+    for (int i = 0; i < NB_PIXELS * int(srcColorSpace->pixelSize()); i++) {
+        src[i] = quint8(i * 7 + i / 13);
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new TestUtil::ColorConversionRunnable(srcColorSpace, dstColorSpaces,
+                                                             src.data(), dst.data(), dstPixelSize,
+                                                             NB_PIXELS / CONVERSION_CHUNK, CONVERSION_CHUNK,
+                                                             i, numThreads));
+        }
+        pool.waitForDone();
+    }
+}
+
 SIMPLE_TEST_MAIN(KoColorSpacesBenchmark)
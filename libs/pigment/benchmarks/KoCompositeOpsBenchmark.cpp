@@ -8,7 +8,11 @@
 
 #include "../compositeops/KoCompositeOpAlphaDarken.h"
 #include "../compositeops/KoCompositeOpOver.h"
+#include "../compositeops/KoCompositeOpGeneric.h"
+#include "../compositeops/KoColorSpaceBlendingPolicy.h"
 #include <KoOptimizedCompositeOpFactory.h>
+#include <KoCompositeOpRegistry.h>
+#include <KisSupportedArchitectures.h>
 
 #include <KoColorSpaceTraits.h>
 #include <KoColorSpaceRegistry.h>
@@ -40,8 +44,53 @@ const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
             }                                                                                   \
         }
 
+/**
+ * The separable ops are benchmarked on a smaller image, since
+ * they are tested for 64-bit and 128-bit pixels as well
+ */
+const int SEPARABLE_IMG_WIDTH = 512;
+const int SEPARABLE_IMG_HEIGHT = 512;
+
+template<class Traits>
+KoCompositeOp* createLegacySeparableOp(const KoColorSpace *cs, const QString &id)
+{
+    using T = typename Traits::channels_type;
+    using Policy = KoAdditiveBlendingPolicy<Traits>;
+
+    if (id == COMPOSITE_MULT) return new KoCompositeOpGenericSC<Traits, &cfMultiply<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SCREEN) return new KoCompositeOpGenericSC<Traits, &cfScreen<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_OVERLAY) return new KoCompositeOpGenericSC<Traits, &cfOverlay<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_HARD_LIGHT) return new KoCompositeOpGenericSC<Traits, &cfHardLight<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) return new KoCompositeOpGenericSC<Traits, &cfSoftLight<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SOFT_LIGHT_SVG) return new KoCompositeOpGenericSC<Traits, &cfSoftLightSvg<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_DODGE) return new KoCompositeOpGenericSC<Traits, &cfColorDodge<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_BURN) return new KoCompositeOpGenericSC<Traits, &cfColorBurn<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_LINEAR_BURN) return new KoCompositeOpGenericSC<Traits, &cfLinearBurn<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_LINEAR_LIGHT) return new KoCompositeOpGenericSC<Traits, &cfLinearLight<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_ADD) return new KoCompositeOpGenericSC<Traits, &cfAddition<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_SUBTRACT) return new KoCompositeOpGenericSC<Traits, &cfSubtract<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_DARKEN) return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_LIGHTEN) return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_DIFF) return new KoCompositeOpGenericSC<Traits, &cfDifference<T>, Policy>(cs, id, QString());
+    if (id == COMPOSITE_EXCLUSION) return new KoCompositeOpGenericSC<Traits, &cfExclusion<T>, Policy>(cs, id, QString());
+
+    return nullptr;
+}
+
+template<typename channels_type>
+void fillSeparableBuffer(quint8 *buffer, int numPixels)
+{
+    channels_type *ptr = reinterpret_cast<channels_type*>(buffer);
+
+    for (int i = 0; i < numPixels * 4; i++) {
+        *ptr++ = KoColorSpaceMaths<float, channels_type>::scaleToA(float(qrand()) / RAND_MAX);
+    }
+}
+
 void KoCompositeOpsBenchmark::initTestCase()
 {
+    qDebug() << "Optimized code uses set:" << KisSupportedArchitectures::bestArchName();
+
     const int bufLen = IMG_HEIGHT * IMG_WIDTH * KoBgrU8Traits::pixelSize;
 
     m_dstBuffer = new quint8[bufLen];
@@ -97,4 +146,104 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
 }
 
 
+void KoCompositeOpsBenchmark::benchmarkCompositeSeparable_data()
+{
+    QTest::addColumn<QString>("id");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<bool>("optimized");
+
+    const QStringList ids({
+        COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_OVERLAY, COMPOSITE_HARD_LIGHT,
+        COMPOSITE_SOFT_LIGHT_PHOTOSHOP, COMPOSITE_SOFT_LIGHT_SVG, COMPOSITE_DODGE,
+        COMPOSITE_BURN, COMPOSITE_LINEAR_BURN, COMPOSITE_LINEAR_LIGHT, COMPOSITE_ADD,
+        COMPOSITE_SUBTRACT, COMPOSITE_DARKEN, COMPOSITE_LIGHTEN, COMPOSITE_DIFF,
+        COMPOSITE_EXCLUSION});
+
+    /**
+     * The optimized ops use the best instruction set available,
+     * other sets can be checked by disabling them in kritarc
+     * ("disableAVXOptimizations" and "amdDisableVectorWorkaround")
+     */
+    const QString arch = KisSupportedArchitectures::bestArchName();
+
+    Q_FOREACH (const QString &id, ids) {
+        Q_FOREACH (int depth, QVector<int>({8, 16, 32})) {
+            QTest::addRow("%s-%d-scalar", id.toLatin1().data(), depth) << id << depth << false;
+            QTest::addRow("%s-%d-%s", id.toLatin1().data(), depth, arch.toLatin1().data()) << id << depth << true;
+        }
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeSeparable()
+{
+    QFETCH(QString, id);
+    QFETCH(int, depth);
+    QFETCH(bool, optimized);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+    QScopedPointer<KoCompositeOp> compositeOp;
+
+    if (depth == 8) {
+        const KoColorSpace *cs = registry->rgb8();
+        compositeOp.reset(optimized ?
+                          KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, QString()) :
+                          createLegacySeparableOp<KoBgrU8Traits>(cs, id));
+    } else if (depth == 16) {
+        const KoColorSpace *cs = registry->rgb16();
+        compositeOp.reset(optimized ?
+                          KoOptimizedCompositeOpFactory::createGenericSCOpU64(cs, id, QString()) :
+                          createLegacySeparableOp<KoBgrU16Traits>(cs, id));
+    } else {
+        const KoColorSpace *cs = registry->colorSpace("RGBA", "F32", "");
+        compositeOp.reset(optimized ?
+                          KoOptimizedCompositeOpFactory::createGenericSCOp128(cs, id, QString()) :
+                          createLegacySeparableOp<KoRgbF32Traits>(cs, id));
+    }
+
+    if (!compositeOp) {
+        QSKIP("The op has no optimized version for this CPU");
+    }
+
+    const int pixelSize = compositeOp->colorSpace()->pixelSize();
+    const int numPixels = SEPARABLE_IMG_WIDTH * SEPARABLE_IMG_HEIGHT;
+
+    QVector<quint8> srcBuffer(numPixels * pixelSize);
+    QVector<quint8> dstBuffer(numPixels * pixelSize);
+    QVector<quint8> mskBuffer(numPixels);
+
+    qsrand(42);
+
+    if (depth == 8) {
+        fillSeparableBuffer<quint8>(srcBuffer.data(), numPixels);
+        fillSeparableBuffer<quint8>(dstBuffer.data(), numPixels);
+    } else if (depth == 16) {
+        fillSeparableBuffer<quint16>(srcBuffer.data(), numPixels);
+        fillSeparableBuffer<quint16>(dstBuffer.data(), numPixels);
+    } else {
+        fillSeparableBuffer<float>(srcBuffer.data(), numPixels);
+        fillSeparableBuffer<float>(dstBuffer.data(), numPixels);
+    }
+
+    for (int i = 0; i < numPixels; i++) {
+        mskBuffer[i] = qrand() & 0xFF;
+    }
+
+    const int rowStride = SEPARABLE_IMG_WIDTH * pixelSize;
+
+    QBENCHMARK {
+        for (int y = 0; y < SEPARABLE_IMG_HEIGHT / TILE_HEIGHT; y++) {
+            for (int x = 0; x < SEPARABLE_IMG_WIDTH / TILE_WIDTH; x++) {
+                const int bufOffset = y * TILE_HEIGHT * rowStride + x * TILE_WIDTH * pixelSize;
+                const int mskOffset = y * TILE_HEIGHT * SEPARABLE_IMG_WIDTH + x * TILE_WIDTH;
+
+                compositeOp->composite(dstBuffer.data() + bufOffset, rowStride,
+                                       srcBuffer.data() + bufOffset, rowStride,
+                                       mskBuffer.data() + mskOffset, SEPARABLE_IMG_WIDTH,
+                                       TILE_HEIGHT, TILE_WIDTH,
+                                       OPACITY_HALF);
+            }
+        }
+    }
+}
+
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
@@ -22,6 +22,9 @@ private Q_SLOTS:
     void benchmarkCompositeAlphaDarkenHard();
     void benchmarkCompositeAlphaDarkenCreamy();
 
+    void benchmarkCompositeSeparable_data();
+    void benchmarkCompositeSeparable();
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
@@ -54,6 +54,13 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return new KoCompositeOpCopy2<Traits>(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return nullptr;
+    }
 };
 
 template<>
@@ -71,6 +78,9 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, category);
+    }
 };
 
 template<>
@@ -87,6 +97,9 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, category);
+    }
 };
 
 template<>
@@ -104,6 +117,9 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp128(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp128(cs, id, category);
+    }
 };
 
 template<>
@@ -121,8 +137,56 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOpU64(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOpU64(cs, id, category);
+    }
+};
+
+
+template<class Traits>
+struct OptimizedHSLOpsSelector
+{
+    static KoCompositeOp* createGenericHSLOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return nullptr;
+    }
+};
+
+template<>
+struct OptimizedHSLOpsSelector<KoBgrU8Traits>
+{
+    static KoCompositeOp* createGenericHSLOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOp32(cs, id, category);
+    }
+};
+
+template<>
+struct OptimizedHSLOpsSelector<KoBgrU16Traits>
+{
+    static KoCompositeOp* createGenericHSLOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOpU64(cs, id, category);
+    }
+};
+
+#ifdef HAVE_OPENEXR
+template<>
+struct OptimizedHSLOpsSelector<KoRgbF16Traits>
+{
+    static KoCompositeOp* createGenericHSLOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOpF16(cs, id, category);
+    }
 };
+#endif
 
+template<>
+struct OptimizedHSLOpsSelector<KoRgbF32Traits>
+{
+    static KoCompositeOp* createGenericHSLOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOp128(cs, id, category);
+    }
+};
 
 template<class Traits>
 struct AddGeneralOps<Traits, true>
@@ -140,7 +204,8 @@ struct AddGeneralOps<Traits, true>
                 cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
             }
         } else {
-            cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+            KoCompositeOp *op = OptimizedOpsSelector<Traits>::createGenericSCOp(cs, id, category);
+            cs->addCompositeOp(op ? op : new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
         }
      }
 
@@ -283,7 +348,8 @@ struct AddRGBOps<Traits, true>
     template<void compositeFunc(Arg, Arg, Arg, Arg&, Arg&, Arg&)>
 
     static void add(KoColorSpace* cs, const QString& id, const QString& category) {
-        cs->addCompositeOp(new KoCompositeOpGenericHSL<Traits, compositeFunc>(cs, id, category));
+        KoCompositeOp *op = OptimizedHSLOpsSelector<Traits>::createGenericHSLOp(cs, id, category);
+        cs->addCompositeOp(op ? op : new KoCompositeOpGenericHSL<Traits, compositeFunc>(cs, id, category));
     }
 
     static void add(KoColorSpace* cs) {
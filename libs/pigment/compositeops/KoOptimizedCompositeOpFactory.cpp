@@ -7,6 +7,8 @@
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpFactory.h"
 
+#include "KoColorSpaceTraits.h"
+
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(const KoColorSpace *cs)
 {
     return createOptimizedClass<
@@ -78,3 +80,45 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp32(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<KoBgrU8Traits> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOpU64(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<KoBgrU16Traits> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp128(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<KoRgbF32Traits> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOp32(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoBgrU8Traits> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOpU64(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoBgrU16Traits> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOpF16(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+#ifdef HAVE_OPENEXR
+    return createOptimizedClass<KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoRgbF16Traits> >(cs, id, category);
+#else
+    Q_UNUSED(cs);
+    Q_UNUSED(id);
+    Q_UNUSED(category);
+    return nullptr;
+#endif
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOp128(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoRgbF32Traits> >(cs, id, category);
+}
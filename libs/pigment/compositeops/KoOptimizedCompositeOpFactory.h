@@ -11,6 +11,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 /**
  * The creation of the optimized composite ops is moved into a separate
@@ -39,6 +40,25 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+
+    /**
+     * Create an optimized version of the separable composite op \p id
+     * (see KoCompositeOpGenericSC). Return nullptr if there is no
+     * optimized version of the op or the CPU has no vector instructions.
+     */
+    static KoCompositeOp* createGenericSCOp32(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericSCOpU64(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericSCOp128(const KoColorSpace *cs, const QString &id, const QString &category);
+
+    /**
+     * Create an optimized version of the non-separable (HSX) composite
+     * op \p id (see KoCompositeOpGenericHSL). Return nullptr if there is
+     * no optimized version of the op or the CPU has no vector instructions.
+     */
+    static KoCompositeOp* createGenericHSLOp32(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericHSLOpU64(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericHSLOpF16(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericHSLOp128(const KoColorSpace *cs, const QString &id, const QString &category);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -13,7 +13,10 @@
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
 #include "KoOptimizedCompositeOpCopy128.h"
+#include "KoOptimizedCompositeOpGenericSC.h"
+#include "KoOptimizedCompositeOpGenericHSL.h"
 
+#include <KoColorSpaceTraits.h>
 #include <KoCompositeOpRegistry.h>
 
 template<>
@@ -124,4 +127,69 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoOptimizedCompositeOpAlphaDarkenCreamyU64<xsimd::current_arch>(param);
 }
 
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<KoBgrU8Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericSC<xsimd::current_arch, KoBgrU8Traits>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<KoBgrU16Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericSC<xsimd::current_arch, KoBgrU16Traits>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<KoRgbF32Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericSC<xsimd::current_arch, KoRgbF32Traits>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoBgrU8Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericHSL<xsimd::current_arch, KoBgrU8Traits>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoBgrU16Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericHSL<xsimd::current_arch, KoBgrU16Traits>(param, id, category);
+}
+
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoRgbF16Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericHSL<xsimd::current_arch, KoRgbF16Traits>(param, id, category);
+}
+#endif
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoRgbF32Traits>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedCompositeOpGenericHSL<xsimd::current_arch, KoRgbF32Traits>(param, id, category);
+}
+
 #endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -12,6 +12,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 template<typename _impl>
 class KoOptimizedCompositeOpAlphaDarkenCreamy32;
@@ -55,4 +56,26 @@ struct KoOptimizedCompositeOpFactoryPerArch {
     static KoCompositeOp *create(const KoColorSpace *);
 };
 
+/**
+ * Creates the optimized separable composite ops (see
+ * KoOptimizedCompositeOpGenericSC). The scalar version returns
+ * nullptr, so the caller falls back to KoCompositeOpGenericSC.
+ */
+template<class Traits>
+struct KoOptimizedCompositeOpGenericSCFactoryPerArch {
+    template<typename _impl>
+    static KoCompositeOp *create(const KoColorSpace *, const QString &id, const QString &category);
+};
+
+/**
+ * Creates the optimized non-separable composite ops (see
+ * KoOptimizedCompositeOpGenericHSL). The scalar version returns
+ * nullptr, so the caller falls back to KoCompositeOpGenericHSL.
+ */
+template<class Traits>
+struct KoOptimizedCompositeOpGenericHSLFactoryPerArch {
+    template<typename _impl>
+    static KoCompositeOp *create(const KoColorSpace *, const QString &id, const QString &category);
+};
+
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
@@ -121,3 +121,67 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<KoBgrU8Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<KoBgrU16Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<KoRgbF32Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoBgrU8Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoBgrU16Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoRgbF16Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+#endif
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericHSLFactoryPerArch<KoRgbF32Traits>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
@@ -0,0 +1,563 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICHSL_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICHSL_H
+
+#include <limits>
+
+#include "KoCompositeOpFunctions.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Vector versions of the HSX helpers from KoColorSpaceMaths.h.
+ *
+ * Every operation repeats the scalar one step by step, so the
+ * results are the same as the ones of cfXXX<HSXType, float>().
+ * The branches of the scalar code are replaced with per-lane
+ * selects, the branch that is not taken in any of the lanes
+ * is skipped.
+ */
+namespace KoStreamedHSXFunctions
+{
+
+template<class HSXType>
+struct VectorHSX;
+
+template<>
+struct VectorHSX<HSYType> {
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getLightness(const float_v &r, const float_v &g, const float_v &b) {
+        return float_v(float(0.299)) * r + float_v(float(0.587)) * g + float_v(float(0.114)) * b;
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getSaturation(const float_v &r, const float_v &g, const float_v &b) {
+        return xsimd::max(r, xsimd::max(g, b)) - xsimd::min(r, xsimd::min(g, b));
+    }
+};
+
+template<>
+struct VectorHSX<HSIType> {
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getLightness(const float_v &r, const float_v &g, const float_v &b) {
+        return (r + g + b) * float_v(float(0.33333333333333333333));
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getSaturation(const float_v &r, const float_v &g, const float_v &b) {
+        const float_v max = xsimd::max(r, xsimd::max(g, b));
+        const float_v min = xsimd::min(r, xsimd::min(g, b));
+        const float_v chroma = max - min;
+
+        return xsimd::select(chroma > float_v(std::numeric_limits<float>::epsilon()),
+                             float_v(1.0f) - min / getLightness(r, g, b),
+                             float_v(0.0f));
+    }
+};
+
+template<>
+struct VectorHSX<HSLType> {
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getLightness(const float_v &r, const float_v &g, const float_v &b) {
+        const float_v max = xsimd::max(r, xsimd::max(g, b));
+        const float_v min = xsimd::min(r, xsimd::min(g, b));
+        return (max + min) * float_v(0.5f);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getSaturation(const float_v &r, const float_v &g, const float_v &b) {
+        const float_v max = xsimd::max(r, xsimd::max(g, b));
+        const float_v min = xsimd::min(r, xsimd::min(g, b));
+        const float_v chroma = max - min;
+        const float_v light = (max + min) * float_v(0.5f);
+        const float_v div = float_v(1.0f) - xsimd::abs(float_v(2.0f) * light - float_v(1.0f));
+
+        return xsimd::select(div > float_v(std::numeric_limits<float>::epsilon()),
+                             chroma / div,
+                             float_v(1.0f));
+    }
+};
+
+template<>
+struct VectorHSX<HSVType> {
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getLightness(const float_v &r, const float_v &g, const float_v &b) {
+        return xsimd::max(r, xsimd::max(g, b));
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v getSaturation(const float_v &r, const float_v &g, const float_v &b) {
+        const float_v max = xsimd::max(r, xsimd::max(g, b));
+        const float_v min = xsimd::min(r, xsimd::min(g, b));
+
+        return xsimd::select(max == float_v(0.0f), float_v(0.0f), (max - min) / max);
+    }
+};
+
+template<class HSXType, typename float_v>
+ALWAYS_INLINE void addLightness(float_v &r, float_v &g, float_v &b, const float_v &light)
+{
+    const float_v zero(0.0f);
+    const float_v unit(1.0f);
+
+    r += light;
+    g += light;
+    b += light;
+
+    /**
+     * NOTE: the scalar version calculates all the three values
+     *       before the first correction, so do we
+     */
+    const float_v l = VectorHSX<HSXType>::getLightness(r, g, b);
+    const float_v n = xsimd::min(r, xsimd::min(g, b));
+    const float_v x = xsimd::max(r, xsimd::max(g, b));
+
+    const auto belowZero = n < zero;
+
+    if (xsimd::any(belowZero)) {
+        const float_v iln = unit / (l - n);
+        r = xsimd::select(belowZero, l + ((r - l) * l) * iln, r);
+        g = xsimd::select(belowZero, l + ((g - l) * l) * iln, g);
+        b = xsimd::select(belowZero, l + ((b - l) * l) * iln, b);
+    }
+
+    const auto aboveUnit = (x > unit) & ((x - l) > float_v(std::numeric_limits<float>::epsilon()));
+
+    if (xsimd::any(aboveUnit)) {
+        const float_v il = unit - l;
+        const float_v ixl = unit / (x - l);
+        r = xsimd::select(aboveUnit, l + ((r - l) * il) * ixl, r);
+        g = xsimd::select(aboveUnit, l + ((g - l) * il) * ixl, g);
+        b = xsimd::select(aboveUnit, l + ((b - l) * il) * ixl, b);
+    }
+}
+
+template<class HSXType, typename float_v>
+ALWAYS_INLINE void setLightness(float_v &r, float_v &g, float_v &b, const float_v &light)
+{
+    addLightness<HSXType>(r, g, b, light - VectorHSX<HSXType>::getLightness(r, g, b));
+}
+
+template<typename float_v>
+ALWAYS_INLINE void swapIf(const typename float_v::batch_bool_type &cond,
+                          float_v &v1, float_v &v2, float_v &i1, float_v &i2)
+{
+    const float_v tmpV = v1;
+    v1 = xsimd::select(cond, v2, v1);
+    v2 = xsimd::select(cond, tmpV, v2);
+
+    const float_v tmpI = i1;
+    i1 = xsimd::select(cond, i2, i1);
+    i2 = xsimd::select(cond, tmpI, i2);
+}
+
+template<typename float_v>
+ALWAYS_INLINE void setSaturation(float_v &r, float_v &g, float_v &b, const float_v &sat)
+{
+    /**
+     * The channels are sorted with exactly the same sequence of
+     * compare-and-swap operations as in the scalar version, and the
+     * position of every channel is tracked in a separate vector.
+     * It makes the equal channels be assigned exactly the same
+     * roles as in the scalar code.
+     */
+    float_v min = r;
+    float_v mid = g;
+    float_v max = b;
+
+    float_v minIdx(0.0f);
+    float_v midIdx(1.0f);
+    float_v maxIdx(2.0f);
+
+    swapIf(mid < min, min, mid, minIdx, midIdx);
+    swapIf(max < mid, mid, max, midIdx, maxIdx);
+    swapIf(mid < min, min, mid, minIdx, midIdx);
+
+    const float_v zero(0.0f);
+    const auto nonFlat = (max - min) > zero;
+    const float_v newMid = ((mid - min) * sat) / (max - min);
+
+    r = xsimd::select(nonFlat & (maxIdx == float_v(0.0f)), sat,
+                      xsimd::select(nonFlat & (midIdx == float_v(0.0f)), newMid, zero));
+    g = xsimd::select(nonFlat & (maxIdx == float_v(1.0f)), sat,
+                      xsimd::select(nonFlat & (midIdx == float_v(1.0f)), newMid, zero));
+    b = xsimd::select(nonFlat & (maxIdx == float_v(2.0f)), sat,
+                      xsimd::select(nonFlat & (midIdx == float_v(2.0f)), newMid, zero));
+}
+
+template<class HSXType>
+struct Color {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfColor<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        const float_v lum = VectorHSX<HSXType>::getLightness(dr, dg, db);
+        dr = sr;
+        dg = sg;
+        db = sb;
+        setLightness<HSXType>(dr, dg, db, lum);
+    }
+};
+
+template<class HSXType>
+struct Hue {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfHue<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        const float_v sat = VectorHSX<HSXType>::getSaturation(dr, dg, db);
+        const float_v lum = VectorHSX<HSXType>::getLightness(dr, dg, db);
+        dr = sr;
+        dg = sg;
+        db = sb;
+        setSaturation(dr, dg, db, sat);
+        setLightness<HSXType>(dr, dg, db, lum);
+    }
+};
+
+template<class HSXType>
+struct Saturation {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfSaturation<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        const float_v sat = VectorHSX<HSXType>::getSaturation(sr, sg, sb);
+        const float_v light = VectorHSX<HSXType>::getLightness(dr, dg, db);
+        setSaturation(dr, dg, db, sat);
+        setLightness<HSXType>(dr, dg, db, light);
+    }
+};
+
+template<class HSXType>
+struct IncreaseSaturation {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfIncreaseSaturation<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        // lerp(dstSat, 1.0, srcSat)
+        const float_v dstSat = VectorHSX<HSXType>::getSaturation(dr, dg, db);
+        const float_v sat = (float_v(1.0f) - dstSat) * VectorHSX<HSXType>::getSaturation(sr, sg, sb) + dstSat;
+        const float_v light = VectorHSX<HSXType>::getLightness(dr, dg, db);
+        setSaturation(dr, dg, db, sat);
+        setLightness<HSXType>(dr, dg, db, light);
+    }
+};
+
+template<class HSXType>
+struct DecreaseSaturation {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfDecreaseSaturation<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        // lerp(0.0, dstSat, srcSat)
+        const float_v sat = VectorHSX<HSXType>::getSaturation(dr, dg, db) * VectorHSX<HSXType>::getSaturation(sr, sg, sb);
+        const float_v light = VectorHSX<HSXType>::getLightness(dr, dg, db);
+        setSaturation(dr, dg, db, sat);
+        setLightness<HSXType>(dr, dg, db, light);
+    }
+};
+
+template<class HSXType>
+struct Lightness {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfLightness<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        setLightness<HSXType>(dr, dg, db, VectorHSX<HSXType>::getLightness(sr, sg, sb));
+    }
+};
+
+template<class HSXType>
+struct IncreaseLightness {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfIncreaseLightness<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        addLightness<HSXType>(dr, dg, db, VectorHSX<HSXType>::getLightness(sr, sg, sb));
+    }
+};
+
+template<class HSXType>
+struct DecreaseLightness {
+    static void scalar(float sr, float sg, float sb, float &dr, float &dg, float &db) {
+        cfDecreaseLightness<HSXType>(sr, sg, sb, dr, dg, db);
+    }
+
+    template<typename float_v>
+    static ALWAYS_INLINE void vector(const float_v &sr, const float_v &sg, const float_v &sb,
+                                     float_v &dr, float_v &dg, float_v &db)
+    {
+        addLightness<HSXType>(dr, dg, db, VectorHSX<HSXType>::getLightness(sr, sg, sb) - float_v(1.0f));
+    }
+};
+
+}
+
+/**
+ * An optimized version of KoCompositeOpGenericHSL for the use in
+ * RGBA colorspaces of any channel type.
+ *
+ * The pixels are processed in batches of float_v::size pixels. The
+ * color channels of a batch are converted into float and transposed
+ * into three vectors (R, G and B), then the blending function is
+ * applied to the whole batch at once.
+ *
+ * The conversion and the final alpha-blending are the same scalar
+ * code as in KoCompositeOpGenericHSL: they are cheap, compared to the
+ * blending function itself, and it guarantees that the integer
+ * colorspaces round the results exactly like the generic op does.
+ *
+ * Only the compositing with all the channels enabled is vectorized,
+ * the alpha-locked or channel-masked compositing falls back to the
+ * scalar generic op.
+ */
+template<typename _impl, class Traits, class Function>
+class KoOptimizedCompositeOpGenericHSL : public KoCompositeOp
+{
+    using channels_type = typename Traits::channels_type;
+    using float_v = xsimd::batch<float, _impl>;
+    using ScalarOp = KoCompositeOpGenericHSL<Traits, &Function::scalar>;
+
+    static const qint32 channels_nb = Traits::channels_nb;
+    static const qint32 alpha_pos = Traits::alpha_pos;
+    static const qint32 red_pos = Traits::red_pos;
+    static const qint32 green_pos = Traits::green_pos;
+    static const qint32 blue_pos = Traits::blue_pos;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+public:
+    KoOptimizedCompositeOpGenericHSL(const KoColorSpace* cs, const QString& id, const QString& category)
+        : KoCompositeOp(cs, id, category)
+        , m_scalarOp(cs, id, category)
+    {
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(channels_nb, true)) {
+
+            if (params.maskRowStart) {
+                genericComposite<true>(params);
+            } else {
+                genericComposite<false>(params);
+            }
+        } else {
+            m_scalarOp.composite(params);
+        }
+    }
+
+private:
+    template <bool useMask>
+    void genericComposite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        using namespace Arithmetic;
+
+        const qint32 srcInc = (params.srcRowStride == 0) ? 0 : channels_nb;
+        const channels_type opacity = scale<channels_type>(params.opacity);
+
+        quint8 *dstRowStart = params.dstRowStart;
+        const quint8 *srcRowStart = params.srcRowStart;
+        const quint8 *maskRowStart = params.maskRowStart;
+
+        float srcR[vectorSize];
+        float srcG[vectorSize];
+        float srcB[vectorSize];
+        float dstR[vectorSize];
+        float dstG[vectorSize];
+        float dstB[vectorSize];
+
+        for (qint32 r = 0; r < params.rows; ++r) {
+            const channels_type *src = reinterpret_cast<const channels_type*>(srcRowStart);
+            channels_type *dst = reinterpret_cast<channels_type*>(dstRowStart);
+            const quint8 *mask = maskRowStart;
+
+            for (qint32 c = 0; c < params.cols; c += vectorSize) {
+                const int numPixels = qMin(vectorSize, params.cols - c);
+
+                for (int i = 0; i < numPixels; i++) {
+                    const channels_type *s = src + i * srcInc;
+                    const channels_type *d = dst + i * channels_nb;
+
+                    srcR[i] = scale<float>(s[red_pos]);
+                    srcG[i] = scale<float>(s[green_pos]);
+                    srcB[i] = scale<float>(s[blue_pos]);
+                    dstR[i] = scale<float>(d[red_pos]);
+                    dstG[i] = scale<float>(d[green_pos]);
+                    dstB[i] = scale<float>(d[blue_pos]);
+                }
+
+                for (int i = numPixels; i < vectorSize; i++) {
+                    srcR[i] = srcG[i] = srcB[i] = 0.0f;
+                    dstR[i] = dstG[i] = dstB[i] = 0.0f;
+                }
+
+                float_v dr = xsimd::load_unaligned<_impl>(dstR);
+                float_v dg = xsimd::load_unaligned<_impl>(dstG);
+                float_v db = xsimd::load_unaligned<_impl>(dstB);
+
+                Function::vector(xsimd::load_unaligned<_impl>(srcR),
+                                 xsimd::load_unaligned<_impl>(srcG),
+                                 xsimd::load_unaligned<_impl>(srcB),
+                                 dr, dg, db);
+
+                dr.store_unaligned(dstR);
+                dg.store_unaligned(dstG);
+                db.store_unaligned(dstB);
+
+                for (int i = 0; i < numPixels; i++) {
+                    const channels_type *s = src + i * srcInc;
+                    channels_type *d = dst + i * channels_nb;
+
+                    const channels_type mskAlpha = useMask ? scale<channels_type>(mask[i]) : unitValue<channels_type>();
+                    const channels_type srcAlpha = mul(s[alpha_pos], mskAlpha, opacity);
+                    const channels_type dstAlpha = d[alpha_pos];
+                    const channels_type newDstAlpha = unionShapeOpacity(srcAlpha, dstAlpha);
+
+                    if (newDstAlpha != zeroValue<channels_type>()) {
+                        d[red_pos] = div(blend(s[red_pos], srcAlpha, d[red_pos], dstAlpha, scale<channels_type>(dstR[i])), newDstAlpha);
+                        d[green_pos] = div(blend(s[green_pos], srcAlpha, d[green_pos], dstAlpha, scale<channels_type>(dstG[i])), newDstAlpha);
+                        d[blue_pos] = div(blend(s[blue_pos], srcAlpha, d[blue_pos], dstAlpha, scale<channels_type>(dstB[i])), newDstAlpha);
+                    }
+
+                    d[alpha_pos] = newDstAlpha;
+                }
+
+                src += numPixels * srcInc;
+                dst += numPixels * channels_nb;
+
+                if (useMask) {
+                    mask += numPixels;
+                }
+            }
+
+            srcRowStart += params.srcRowStride;
+            dstRowStart += params.dstRowStride;
+            maskRowStart += params.maskRowStride;
+        }
+    }
+
+private:
+    ScalarOp m_scalarOp;
+};
+
+/**
+ * Creates the optimized version of the non-separable composite op
+ * \p id. Returns nullptr if the op has no optimized version, then the
+ * caller should create the usual KoCompositeOpGenericHSL.
+ *
+ * NOTE: the functions used here must match the ones used for the
+ *       same ids in AddRGBOps (KoCompositeOps.h)
+ */
+template<typename _impl, class Traits>
+KoCompositeOp* createOptimizedCompositeOpGenericHSL(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    using namespace KoStreamedHSXFunctions;
+
+    if (id == COMPOSITE_COLOR) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Color<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_HUE) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Hue<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_SATURATION) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Saturation<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_SATURATION) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseSaturation<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_SATURATION) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseSaturation<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_LUMINIZE) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Lightness<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_LUMINOSITY) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseLightness<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_LUMINOSITY) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseLightness<HSYType>>(cs, id, category);
+    } else if (id == COMPOSITE_COLOR_HSI) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Color<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_HUE_HSI) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Hue<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_SATURATION_HSI) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Saturation<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_SATURATION_HSI) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseSaturation<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_SATURATION_HSI) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseSaturation<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_INTENSITY) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Lightness<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_INTENSITY) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseLightness<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_INTENSITY) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseLightness<HSIType>>(cs, id, category);
+    } else if (id == COMPOSITE_COLOR_HSL) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Color<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_HUE_HSL) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Hue<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_SATURATION_HSL) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Saturation<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_SATURATION_HSL) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseSaturation<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_SATURATION_HSL) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseSaturation<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_LIGHTNESS) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Lightness<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_LIGHTNESS) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseLightness<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_LIGHTNESS) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseLightness<HSLType>>(cs, id, category);
+    } else if (id == COMPOSITE_COLOR_HSV) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Color<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_HUE_HSV) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Hue<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_SATURATION_HSV) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Saturation<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_SATURATION_HSV) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseSaturation<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_SATURATION_HSV) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseSaturation<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_VALUE) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, Lightness<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_INC_VALUE) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, IncreaseLightness<HSVType>>(cs, id, category);
+    } else if (id == COMPOSITE_DEC_VALUE) {
+        return new KoOptimizedCompositeOpGenericHSL<_impl, Traits, DecreaseLightness<HSVType>>(cs, id, category);
+    }
+
+    return nullptr;
+}
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICHSL_H
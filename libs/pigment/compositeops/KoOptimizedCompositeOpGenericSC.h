@@ -0,0 +1,527 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+
+#include "KoColorSpaceBlendingPolicy.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Vector versions of the separable blending functions from
+ * KoCompositeOpFunctions.h.
+ *
+ * vector() works with the channel values normalized into [0; 1]
+ * range (or the raw values for floating point colorspaces), scalar()
+ * is just the original cfXXX() function.
+ *
+ * The results of vector() are not clamped, the integer colorspaces
+ * clamp them in GenericSCCompositor. It lets the floating point
+ * colorspaces keep the out-of-range values exactly like the
+ * scalar versions do.
+ */
+namespace KoStreamedBlendFunctions
+{
+
+struct Multiply {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfMultiply(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return src * dst;
+    }
+};
+
+struct Screen {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfScreen(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return src + dst - src * dst;
+    }
+};
+
+struct HardLight {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfHardLight(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        const float_v src2 = src + src;
+        const float_v screenSrc = src2 - float_v(1.0f);
+
+        return xsimd::select(src > float_v(0.5f),
+                             screenSrc + dst - screenSrc * dst,
+                             src2 * dst);
+    }
+};
+
+struct Overlay {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfOverlay(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return HardLight::vector(dst, src);
+    }
+};
+
+struct SoftLight {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfSoftLight(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        const float_v unit(1.0f);
+        const float_v src2 = src + src;
+
+        return xsimd::select(src > float_v(0.5f),
+                             dst + (src2 - unit) * (xsimd::sqrt(dst) - dst),
+                             dst - (unit - src2) * dst * (unit - dst));
+    }
+};
+
+struct SoftLightSvg {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfSoftLightSvg(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        const float_v unit(1.0f);
+        const float_v src2 = src + src;
+
+        const float_v D = xsimd::select(dst > float_v(0.25f),
+                                        xsimd::sqrt(dst),
+                                        ((float_v(16.0f) * dst - float_v(12.0f)) * dst + float_v(4.0f)) * dst);
+
+        return xsimd::select(src > float_v(0.5f),
+                             dst + (src2 - unit) * (D - dst),
+                             dst - (unit - src2) * dst * (unit - dst));
+    }
+};
+
+struct ColorDodge {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfColorDodge(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        const float_v zero(0.0f);
+        const float_v unit(1.0f);
+        const float_v max(KoColorSpaceMathsTraits<float>::max);
+
+        float_v result = dst / (unit - src);
+        result = xsimd::select(src == unit, xsimd::select(dst == zero, zero, max), result);
+
+        // the same "kind of clamping" of inf and NaN as in cfColorDodge
+        return xsimd::select(xsimd::abs(result) <= max, result, max);
+    }
+};
+
+struct ColorBurn {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfColorBurn(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        const float_v zero(0.0f);
+        const float_v unit(1.0f);
+        const float_v max(KoColorSpaceMathsTraits<float>::max);
+
+        float_v result = (unit - dst) / src;
+        result = xsimd::select(src == zero, xsimd::select(dst == unit, zero, max), result);
+        result = xsimd::select(xsimd::abs(result) <= max, result, max);
+
+        return unit - result;
+    }
+};
+
+struct LinearBurn {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfLinearBurn(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return src + dst - float_v(1.0f);
+    }
+};
+
+struct LinearLight {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfLinearLight(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return src + src + dst - float_v(1.0f);
+    }
+};
+
+struct Addition {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfAddition(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return src + dst;
+    }
+};
+
+struct Subtract {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfSubtract(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return dst - src;
+    }
+};
+
+struct DarkenOnly {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfDarkenOnly(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return xsimd::min(src, dst);
+    }
+};
+
+struct LightenOnly {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfLightenOnly(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return xsimd::max(src, dst);
+    }
+};
+
+struct Difference {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfDifference(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        return xsimd::max(src, dst) - xsimd::min(src, dst);
+    }
+};
+
+struct Exclusion {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfExclusion(src, dst); }
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v vector(const float_v &src, const float_v &dst)
+    {
+        const float_v x = src * dst;
+        return dst + src - (x + x);
+    }
+};
+
+}
+
+/**
+ * Composes the pixels the same way as KoCompositeOpGenericSC does,
+ * but processes float_v::size pixels at once. The pixel should have
+ * three color channels and the alpha channel at the last position.
+ *
+ * Only the case of all-channels-enabled and unlocked alpha is
+ * implemented, the rest is delegated to KoCompositeOpGenericSC by
+ * KoOptimizedCompositeOpGenericSC itself.
+ */
+template<typename channels_type, class BlendFunction>
+struct GenericSCCompositor {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : opacity(Arithmetic::scale<channels_type>(params.opacity))
+        {
+        }
+        const channels_type opacity;
+    };
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        float_v src_alpha;
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        /**
+         * With zero source alpha the result of the blending
+         * is exactly the destination pixel
+         */
+        if (xsimd::all(src_alpha == zeroValue)) {
+            return;
+        }
+
+        float_v dst_alpha;
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        if (isIntegerChannel) {
+            const float_v unitRec1(1.0f / channelUnitValue);
+
+            src_c1 *= unitRec1;
+            src_c2 *= unitRec1;
+            src_c3 *= unitRec1;
+
+            dst_c1 *= unitRec1;
+            dst_c2 *= unitRec1;
+            dst_c3 *= unitRec1;
+        }
+
+        const float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+
+        const float_v srcFactor = src_alpha * (oneValue - dst_alpha);
+        const float_v dstFactor = dst_alpha * (oneValue - src_alpha);
+        const float_v blendFactor = src_alpha * dst_alpha;
+
+        /**
+         * The value of new_alpha can have *some* zero values,
+         * which will result in NaN values while division. The
+         * scalar version keeps the color of such pixels intact.
+         */
+        const auto nonZeroAlpha = new_alpha != zeroValue;
+        const float_v new_alpha_rec = oneValue / xsimd::select(nonZeroAlpha, new_alpha, oneValue);
+
+        dst_c1 = xsimd::select(nonZeroAlpha, blendChannel(src_c1, dst_c1, srcFactor, dstFactor, blendFactor) * new_alpha_rec, dst_c1);
+        dst_c2 = xsimd::select(nonZeroAlpha, blendChannel(src_c2, dst_c2, srcFactor, dstFactor, blendFactor) * new_alpha_rec, dst_c2);
+        dst_c3 = xsimd::select(nonZeroAlpha, blendChannel(src_c3, dst_c3, srcFactor, dstFactor, blendFactor) * new_alpha_rec, dst_c3);
+
+        if (isIntegerChannel) {
+            const float_v unit(channelUnitValue);
+
+            /**
+             * The integer pixel wrappers just mask out the higher
+             * bits, so the values should be clamped explicitly
+             */
+            dst_c1 = xsimd::min(xsimd::max(dst_c1 * unit, zeroValue), unit);
+            dst_c2 = xsimd::min(xsimd::max(dst_c2 * unit, zeroValue), unit);
+            dst_c3 = xsimd::min(xsimd::max(dst_c3 * unit, zeroValue), unit);
+        }
+
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, new_alpha);
+    }
+
+    /**
+     * Exactly the same math as in KoCompositeOpGenericSC, so the
+     * pixels not covered by the vector part are bit-exact with the
+     * scalar op
+     */
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        Q_UNUSED(opacity);
+
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        const channels_type mskAlpha = haveMask ? scale<channels_type>(*mask) : unitValue<channels_type>();
+        const channels_type srcAlpha = mul(s[alpha_pos], mskAlpha, oparams.opacity);
+        const channels_type dstAlpha = d[alpha_pos];
+
+        const channels_type newDstAlpha = unionShapeOpacity(srcAlpha, dstAlpha);
+
+        if (newDstAlpha != zeroValue<channels_type>()) {
+            for (int i = 0; i < alpha_pos; i++) {
+                const channels_type result =
+                    blend(s[i], srcAlpha, d[i], dstAlpha,
+                          BlendFunction::template scalar<channels_type>(s[i], d[i]));
+                d[i] = div(result, newDstAlpha);
+            }
+        }
+
+        d[alpha_pos] = newDstAlpha;
+    }
+
+private:
+    static constexpr bool isIntegerChannel = std::numeric_limits<channels_type>::is_integer;
+    static constexpr float channelUnitValue = float(std::numeric_limits<channels_type>::is_integer ?
+                                             std::numeric_limits<channels_type>::max() : 1);
+
+    template<typename float_v>
+    static ALWAYS_INLINE float_v blendChannel(const float_v &src, const float_v &dst,
+                                              const float_v &srcFactor,
+                                              const float_v &dstFactor,
+                                              const float_v &blendFactor)
+    {
+        float_v result = BlendFunction::vector(src, dst);
+
+        if (isIntegerChannel) {
+            result = xsimd::min(xsimd::max(result, float_v(0.0f)), float_v(1.0f));
+        }
+
+        return dstFactor * dst + srcFactor * src + blendFactor * result;
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in
+ * RGBA colorspaces with 8-bit, 16-bit integer or 32-bit float
+ * channels and the alpha channel placed at the last position
+ * of the pixel: C1_C2_C3_A.
+ *
+ * Only the compositing with all the channels enabled is vectorized,
+ * the alpha-locked or channel-masked compositing falls back to the
+ * scalar generic op.
+ *
+ * The result is *not* bit-exact with KoCompositeOpGenericSC. The
+ * vector pixels are blended in floating point and rounded once,
+ * while the scalar op rounds every intermediate product, so the
+ * integer channels may differ by a few steps (the premultiplied
+ * colors by four at most). Only the unaligned head and tail pixels
+ * of the rows use the same integer math as the scalar op.
+ */
+template<typename _impl, class Traits, class BlendFunction>
+class KoOptimizedCompositeOpGenericSC : public KoCompositeOp
+{
+    using channels_type = typename Traits::channels_type;
+    using Compositor = GenericSCCompositor<channels_type, BlendFunction>;
+    using ScalarOp = KoCompositeOpGenericSC<Traits,
+                                            &BlendFunction::template scalar<channels_type>,
+                                            KoAdditiveBlendingPolicy<Traits>>;
+
+    static_assert(Traits::channels_nb == 4 && Traits::alpha_pos == 3,
+                  "KoOptimizedCompositeOpGenericSC supports C1_C2_C3_A pixels only");
+
+public:
+    KoOptimizedCompositeOpGenericSC(const KoColorSpace* cs, const QString& id, const QString& category)
+        : KoCompositeOp(cs, id, category)
+        , m_scalarOp(cs, id, category)
+    {
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            if (params.maskRowStart) {
+                composite<true>(params);
+            } else {
+                composite<false>(params);
+            }
+        } else {
+            m_scalarOp.composite(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (Traits::pixelSize == 4) {
+            KoStreamedMath<_impl>::template genericComposite32<haveMask, false, Compositor>(params);
+        } else if (Traits::pixelSize == 8) {
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, Compositor>(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite128<haveMask, false, Compositor>(params);
+        }
+    }
+
+private:
+    ScalarOp m_scalarOp;
+};
+
+/**
+ * Creates the optimized version of the separable composite op \p id.
+ * Returns nullptr if the op has no optimized version, then the caller
+ * should create the usual KoCompositeOpGenericSC.
+ *
+ * NOTE: the functions used here must match the ones used for the
+ *       same ids in AddGeneralOps (KoCompositeOps.h)
+ */
+template<typename _impl, class Traits>
+KoCompositeOp* createOptimizedCompositeOpGenericSC(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    using namespace KoStreamedBlendFunctions;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Multiply>(cs, id, category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Screen>(cs, id, category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Overlay>(cs, id, category);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, HardLight>(cs, id, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, SoftLight>(cs, id, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_SVG) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, SoftLightSvg>(cs, id, category);
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, ColorDodge>(cs, id, category);
+    } else if (id == COMPOSITE_BURN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, ColorBurn>(cs, id, category);
+    } else if (id == COMPOSITE_LINEAR_BURN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, LinearBurn>(cs, id, category);
+    } else if (id == COMPOSITE_LINEAR_LIGHT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, LinearLight>(cs, id, category);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Addition>(cs, id, category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Subtract>(cs, id, category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, DarkenOnly>(cs, id, category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, LightenOnly>(cs, id, category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Difference>(cs, id, category);
+    } else if (id == COMPOSITE_EXCLUSION) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, Traits, Exclusion>(cs, id, category);
+    }
+
+    return nullptr;
+}
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
@@ -77,6 +77,7 @@
 #include "kis_document_aware_spin_box_unit_manager.h"
 #include "KisViewManager.h"
 #include <KisUsageLogger.h>
+#include <KisUpdateTracer.h>
 
 #include <KritaVersionWrapper.h>
 #include <dialogs/KisSessionManagerDialog.h>
@@ -548,6 +549,14 @@ bool KisApplication::start(const KisApplicationArguments &args)
     connect(this, &KisApplication::aboutToQuit, &KisSpinBoxUnitManagerFactory::clearUnitManagerBuilder); //ensure the builder is destroyed when the application leave.
     //the new syntax slot syntax allow to connect to a non q_object static method.
 
+    const QString updateTraceFileName = args.updateTraceFileName();
+    if (!updateTraceFileName.isEmpty()) {
+        KisUpdateTracer::instance()->setEnabled(true);
+        connect(this, &KisApplication::aboutToQuit, [updateTraceFileName] () {
+            KisUpdateTracer::instance()->saveChromeTrace(updateTraceFileName);
+        });
+    }
+
     // Create a new image, if needed
     if (doNewImage) {
         KisDocument *doc = args.createDocumentFromArguments();
@@ -40,6 +40,7 @@ struct Q_DECL_HIDDEN KisApplicationArguments::Private
     bool canvasOnly {false};
     bool noSplash {false};
     bool fullScreen {false};
+    QString updateTraceFileName;
 
     bool newImage {false};
     QString colorModel {"RGBA"};
@@ -97,6 +98,7 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-filename"), i18n("Filename for export"), QLatin1String("filename")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("file-layer"), i18n("File layer to be added to existing or new file"), QLatin1String("file-layer")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("resource-location"), i18n("A location that overrides the configured location for Krita's resources"), QLatin1String("file-layer")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("trace-updates"), i18n("Record the timings of the image updates and save them in Chrome Trace format on exit"), QLatin1String("filename")));
     parser.addPositionalArgument(QLatin1String("[file(s)]"), i18n("File(s) or URL(s) to open"));
 
     QStringList filteredArgs;
@@ -185,6 +187,7 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     d->canvasOnly = parser.isSet("canvasonly");
     d->noSplash = parser.isSet("nosplash");
     d->fullScreen = parser.isSet("fullscreen");
+    d->updateTraceFileName = parser.value("trace-updates");
 
     KoResourcePaths::s_overrideAppDataLocation = parser.value("resource-location");
 
@@ -209,6 +212,7 @@ KisApplicationArguments::KisApplicationArguments(const KisApplicationArguments &
     d->session = rhs.session();
     d->noSplash = rhs.noSplash();
     d->fullScreen = rhs.fullScreen();
+    d->updateTraceFileName = rhs.updateTraceFileName();
 
 }
 
@@ -226,6 +230,7 @@ void KisApplicationArguments::operator=(const KisApplicationArguments &rhs)
     d->session = rhs.session();
     d->noSplash = rhs.noSplash();
     d->fullScreen = rhs.fullScreen();
+    d->updateTraceFileName = rhs.updateTraceFileName();
 }
 
 QByteArray KisApplicationArguments::serialize()
@@ -361,6 +366,11 @@ bool KisApplicationArguments::fullScreen() const
     return d->fullScreen;
 }
 
+QString KisApplicationArguments::updateTraceFileName() const
+{
+    return d->updateTraceFileName;
+}
+
 bool KisApplicationArguments::doNewImage() const
 {
     return d->newImage;
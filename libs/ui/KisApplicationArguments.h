@@ -40,6 +40,12 @@ public:
     bool canvasOnly() const;
     bool noSplash() const;
     bool fullScreen() const;
+
+    /**
+     * The file where KisUpdateTracer should save its events on
+     * exit, empty if the tracing was not requested
+     */
+    QString updateTraceFileName() const;
     bool doNewImage() const;
     KisDocument *createDocumentFromArguments() const;
 
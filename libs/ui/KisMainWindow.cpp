@@ -141,6 +141,7 @@
 #include "dialogs/kis_dlg_import_image_sequence.h"
 #include "animation/KisDlgImportVideoAnimation.h"
 #include <KisImageConfigNotifier.h>
+#include <KisUpdateTracer.h>
 #include "KisWindowLayoutManager.h"
 #include <KisUndoActionsUpdateManager.h>
 #include "KisWelcomePageWidget.h"
@@ -249,6 +250,7 @@ public:
     KisAction *mdiPreviousWindow {nullptr};
     KisAction *toggleDockers {nullptr};
     KisAction *resetConfigurations {nullptr};
+    KisAction *recordUpdateTrace {nullptr};
     KisAction *toggleDockerTitleBars {nullptr};
 #ifndef Q_OS_ANDROID
     KisAction *toggleDetachCanvas {nullptr};
@@ -2300,6 +2302,32 @@ void KisMainWindow::slotResetConfigurations()
     kisApp->askResetConfig();
 }
 
+void KisMainWindow::slotRecordUpdateTrace(bool value)
+{
+    KisUpdateTracer *tracer = KisUpdateTracer::instance();
+
+    if (value) {
+        tracer->clear();
+        tracer->setEnabled(true);
+        return;
+    }
+
+    tracer->setEnabled(false);
+
+    KoFileDialog dialog(this, KoFileDialog::SaveFile, "UpdateTrace");
+    dialog.setCaption(i18n("Save Update Trace"));
+    dialog.setDefaultDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+    dialog.setMimeTypeFilters(QStringList() << "application/json", "application/json");
+
+    const QString filename = dialog.filename();
+    if (filename.isEmpty()) return;
+
+    if (!tracer->saveChromeTrace(filename)) {
+        QMessageBox::warning(this, i18nc("@title:window", "Krita"),
+                             i18n("Could not save the update trace to %1", filename));
+    }
+}
+
 void KisMainWindow::slotNewToolbarConfig()
 {
     applyMainWindowSettings(d->windowStateConfig);
@@ -3014,6 +3042,10 @@ void KisMainWindow::createActions()
     d->resetConfigurations  = actionManager->createAction("reset_configurations");
     connect(d->resetConfigurations, SIGNAL(triggered()), this, SLOT(slotResetConfigurations()));
 
+    d->recordUpdateTrace = actionManager->createAction("record_update_trace");
+    d->recordUpdateTrace->setChecked(KisUpdateTracer::isEnabled());
+    connect(d->recordUpdateTrace, SIGNAL(toggled(bool)), this, SLOT(slotRecordUpdateTrace(bool)));
+
 #ifndef Q_OS_ANDROID
     d->toggleDetachCanvas = actionManager->createAction("view_detached_canvas");
     d->toggleDetachCanvas->setChecked(false);
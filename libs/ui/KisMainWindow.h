@@ -362,6 +362,12 @@ private Q_SLOTS:
      */
     void slotResetConfigurations();
 
+    /**
+     * Starts recording the update trace or, when stopping,
+     * saves the recorded events into a file
+     */
+    void slotRecordUpdateTrace(bool value);
+
     /**
      *  Shows or hides a toolbar
      */
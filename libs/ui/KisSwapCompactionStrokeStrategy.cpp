@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisSwapCompactionStrokeStrategy.h"
+
+#include "KisRunnableStrokeJobUtils.h"
+#include "KisRunnableStrokeJobsInterface.h"
+#include "kis_memory_statistics_server.h"
+#include "tiles3/kis_tile_data_store.h"
+
+namespace {
+/**
+ * The amount of data moved by a single job. The job can be
+ * cancelled only between the jobs, so keep it small.
+ */
+const qint64 bytesPerJob = 16 * MiB;
+const int maxJobs = 64;
+}
+
+KisSwapCompactionStrokeStrategy::KisSwapCompactionStrokeStrategy()
+    : KisIdleTaskStrokeStrategy(QLatin1String("SwapCompaction"), kundo2_i18n("Compact swap file"))
+{
+}
+
+KisSwapCompactionStrokeStrategy::~KisSwapCompactionStrokeStrategy()
+{
+}
+
+void KisSwapCompactionStrokeStrategy::initStrokeCallback()
+{
+    using KritaUtils::addJobSequential;
+    KisIdleTaskStrokeStrategy::initStrokeCallback();
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    if (!store->swapFileNeedsCompaction()) return;
+
+    QVector<KisRunnableStrokeJobData*> jobs;
+
+    for (int i = 0; i < maxJobs; i++) {
+        addJobSequential(jobs, [this, store] () {
+            if (!store->swapFileNeedsCompaction()) return;
+            m_reclaimedSize += store->compactSwapFile(bytesPerJob);
+        });
+    }
+
+    runnableJobsInterface()->addRunnableJobs(jobs);
+}
+
+void KisSwapCompactionStrokeStrategy::finishStrokeCallback()
+{
+    if (m_reclaimedSize > 0) {
+        QMetaObject::invokeMethod(KisMemoryStatisticsServer::instance(),
+                                  "notifyImageChanged",
+                                  Qt::QueuedConnection);
+    }
+
+    KisIdleTaskStrokeStrategy::finishStrokeCallback();
+}
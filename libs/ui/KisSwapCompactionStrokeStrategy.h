@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISSWAPCOMPACTIONSTROKESTRATEGY_H
+#define KISSWAPCOMPACTIONSTROKESTRATEGY_H
+
+#include <KisIdleTaskStrokeStrategy.h>
+
+/**
+ * An idle task that compacts the swap file: moves the swapped tiles
+ * into the holes left by the freed ones and truncates the file. The
+ * work is split into small sequential jobs, so the task can be
+ * cancelled quickly when the user starts painting.
+ *
+ * The task does nothing if the swap file is not fragmented enough
+ * (see KisTileDataStore::swapFileNeedsCompaction()).
+ */
+class KRITAUI_EXPORT KisSwapCompactionStrokeStrategy : public KisIdleTaskStrokeStrategy
+{
+    Q_OBJECT
+public:
+    KisSwapCompactionStrokeStrategy();
+    ~KisSwapCompactionStrokeStrategy() override;
+
+private:
+    void initStrokeCallback() override;
+    void finishStrokeCallback() override;
+
+private:
+    qint64 m_reclaimedSize {0};
+};
+
+#endif // KISSWAPCOMPACTIONSTROKESTRATEGY_H
@@ -123,6 +123,7 @@
 #include "imagesize/imagesize.h"
 #include <KoToolDocker.h>
 #include <KisIdleTasksManager.h>
+#include <KisSwapCompactionStrokeStrategy.h>
 #include <KisImageBarrierLock.h>
 
 #include "kis_filter_configuration.h"
@@ -233,6 +234,7 @@ public:
     KisMirrorManager mirrorManager;
     KisInputManager inputManager;
     KisIdleTasksManager idleTasksManager;
+    KisIdleTasksManager::TaskGuard swapCompactionTaskGuard;
 
     KisSignalAutoConnectionsStore viewConnections;
     KSelectAction *actionAuthor {nullptr}; // Select action for author profile.
@@ -308,6 +310,12 @@ KisViewManager::KisViewManager(QWidget *parent, KisKActionCollection *_actionCol
 
     d->controlFrame.setup(parent);
 
+    d->swapCompactionTaskGuard =
+        d->idleTasksManager.addIdleTaskWithGuard([] (KisImageSP image) {
+            Q_UNUSED(image);
+            return new KisSwapCompactionStrokeStrategy();
+        });
+
 
     //Check to draw scrollbars after "Canvas only mode" toggle is created.
     this->showHideScrollbars();
@@ -619,6 +619,7 @@ void KisCanvas2::initializeImage()
     connect(image->signalRouter(), SIGNAL(sigRequestLodPlanesSyncBlocked(bool)), SLOT(slotSetLodUpdatesBlocked(bool)), Qt::DirectConnection);
 
     connect(image, SIGNAL(sigProofingConfigChanged()), SLOT(slotChangeProofingConfig()));
+    connect(image, &KisImage::sigAdaptiveLevelOfDetailChanged, this, &KisCanvas2::notifyLevelOfDetailChange);
     connect(image, SIGNAL(sigSizeChanged(QPointF,QPointF)), SLOT(startResizingImage()), Qt::DirectConnection);
     connect(image->undoAdapter(), SIGNAL(selectionChanged()), SLOT(slotTrySwitchShapeManager()));
 
@@ -643,6 +644,8 @@ void KisCanvas2::disconnectImage()
     image->immediateLockForReadOnly();
     disconnect(image.data(), 0, this, 0);
     image->unlock();
+
+    image->removeViewportRect(this);
 }
 
 void KisCanvas2::connectCurrentCanvas()
@@ -1114,6 +1117,21 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         emit sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
+
+    /**
+     * Let the image process the updates of the visible area first. In
+     * wrap-around mode the whole image may be visible in several copies.
+     * A canvas scrolled away from the image passes an empty rect, so it
+     * doesn't ask for any priority.
+     */
+    KisImageSP image = this->image();
+    if (image) {
+        const QRect viewportRect = !wrapAroundViewingMode() ?
+            m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect() & imageRect :
+            imageRect;
+
+        image->setViewportRect(this, viewportRect);
+    }
 }
 
 void KisCanvas2::slotReferenceImagesChanged()
@@ -1157,11 +1175,17 @@ void KisCanvas2::notifyLevelOfDetailChange()
 
         KisConfig cfg(true);
         const int maxLod = cfg.numMipmapLevels();
-        const int lod = KisLodTransform::scaleToLod(effectiveZoom, maxLod);
+        int lod = KisLodTransform::scaleToLod(effectiveZoom, maxLod);
         KisLodPreferences::PreferenceFlags flags = KisLodPreferences::LodSupported;
 
         if (m_d->lodPreferredInImage) {
             flags |= KisLodPreferences::LodPreferred;
+
+            /**
+             * When the updates cannot keep up with the user, the image
+             * asks us to lower the resolution of the next strokes
+             */
+            lod = qMin(maxLod, lod + image->adaptiveLevelOfDetailOffset());
         }
         image->setLodPreferences(KisLodPreferences(flags, lod));
     }
@@ -1360,6 +1384,7 @@ void KisCanvas2::setWrapAroundViewingMode(bool value)
     }
 
     m_d->canvasWidget->setWrapAroundViewingMode(value);
+    m_d->regionOfInterestUpdateCompressor.start();
 }
 
 bool KisCanvas2::wrapAroundViewingMode() const
@@ -52,6 +52,7 @@
 #include "KoID.h"
 #include <KoVBox.h>
 #include <KisSpinBoxPluralHelper.h>
+#include <kis_int_parse_spin_box.h>
 
 #include <KTitleWidget>
 #include <KoResourcePaths.h>
@@ -77,6 +78,7 @@
 #include "kis_config.h"
 #include "kis_cursor.h"
 #include "kis_image_config.h"
+#include "KisThreadAffinity.h"
 #include "kis_preference_set_registry.h"
 #include "KisMainWindow.h"
 
@@ -1471,9 +1473,82 @@ PerformanceTab::PerformanceTab(QWidget *parent, const char *name)
     chkDisableAVXOptimizations->setVisible(false);
 #endif
 
+    createThreadAffinityWidgets();
+    createAdaptiveLevelOfDetailWidgets();
+
     load(false);
 }
 
+void PerformanceTab::createThreadAffinityWidgets()
+{
+    QWidget *page = sliderThreadsLimit->parentWidget();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(page && page->layout());
+
+    QGroupBox *box = new QGroupBox(i18n("Update Threads Affinity"), page);
+    QFormLayout *layout = new QFormLayout(box);
+
+    m_chkPinUpdateThreads = new QCheckBox(i18n("Pin update threads to CPU cores"), box);
+    m_chkPinUpdateThreads->setToolTip(i18n("Bind every update thread to a single CPU core, "
+                                           "so the image data stays in the caches of that core"));
+
+    m_chkKeepGuiCoreFree = new QCheckBox(i18n("Keep one core free for the user interface"), box);
+
+    m_chkPreferPerformanceCores = new QCheckBox(i18n("Prefer performance cores for the strokes"), box);
+    m_chkPreferPerformanceCores->setToolTip(i18n("On CPUs with performance and efficient cores, "
+                                                 "run the brush strokes on the performance ones"));
+
+    m_txtUpdateThreadsCores = new QLineEdit(box);
+    m_txtUpdateThreadsCores->setPlaceholderText(i18n("All cores"));
+    m_txtUpdateThreadsCores->setToolTip(i18n("Comma-separated list of the cores and ranges of the cores "
+                                             "the update threads may use, e.g. \"2-7,10\""));
+
+    layout->addRow(m_chkPinUpdateThreads);
+    layout->addRow(m_chkKeepGuiCoreFree);
+    layout->addRow(m_chkPreferPerformanceCores);
+    layout->addRow(i18n("Allowed cores:"), m_txtUpdateThreadsCores);
+
+    page->layout()->addWidget(box);
+
+    if (!KisThreadAffinity::isSupported()) {
+        box->setEnabled(false);
+        box->setToolTip(i18n("Pinning the threads is not supported on this platform"));
+    }
+
+    connect(m_chkPinUpdateThreads, SIGNAL(toggled(bool)), SLOT(slotPinUpdateThreadsToggled(bool)));
+}
+
+void PerformanceTab::createAdaptiveLevelOfDetailWidgets()
+{
+    QWidget *page = sliderThreadsLimit->parentWidget();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(page && page->layout());
+
+    QGroupBox *box = new QGroupBox(i18n("Adaptive Level of Detail"), page);
+    QFormLayout *layout = new QFormLayout(box);
+
+    m_chkAdaptiveLevelOfDetail = new QCheckBox(i18n("Lower the preview resolution when the updates are slow"), box);
+    m_chkAdaptiveLevelOfDetail->setToolTip(i18n("While painting, show a preview of lower resolution "
+                                                "when the canvas cannot be updated in time"));
+
+    m_intAdaptiveLevelOfDetailLatency = new KisIntParseSpinBox(box);
+    m_intAdaptiveLevelOfDetailLatency->setRange(10, 500);
+    m_intAdaptiveLevelOfDetailLatency->setSingleStep(5);
+    m_intAdaptiveLevelOfDetailLatency->setSuffix(i18nc("suffix for \"milliseconds\"", " ms"));
+    m_intAdaptiveLevelOfDetailLatency->setToolTip(i18n("The lower resolution is used when an update "
+                                                       "of the canvas takes longer than this time"));
+
+    m_intAdaptiveLevelOfDetailMaxOffset = new KisIntParseSpinBox(box);
+    m_intAdaptiveLevelOfDetailMaxOffset->setRange(1, 4);
+    m_intAdaptiveLevelOfDetailMaxOffset->setToolTip(i18n("How many times the resolution can be halved"));
+
+    layout->addRow(m_chkAdaptiveLevelOfDetail);
+    layout->addRow(i18n("Update latency budget:"), m_intAdaptiveLevelOfDetailLatency);
+    layout->addRow(i18n("Maximum resolution reduction:"), m_intAdaptiveLevelOfDetailMaxOffset);
+
+    page->layout()->addWidget(box);
+
+    connect(m_chkAdaptiveLevelOfDetail, SIGNAL(toggled(bool)), SLOT(slotAdaptiveLevelOfDetailToggled(bool)));
+}
+
 PerformanceTab::~PerformanceTab()
 {
     qDeleteAll(m_syncs);
@@ -1501,6 +1576,21 @@ void PerformanceTab::load(bool requestDefault)
 
     sliderFpsLimit->setValue(cfg.fpsLimit(requestDefault));
 
+    if (m_chkPinUpdateThreads) {
+        m_chkPinUpdateThreads->setChecked(cfg.pinUpdateThreads(requestDefault));
+        m_chkKeepGuiCoreFree->setChecked(cfg.keepGuiCoreFree(requestDefault));
+        m_chkPreferPerformanceCores->setChecked(cfg.preferPerformanceCores(requestDefault));
+        m_txtUpdateThreadsCores->setText(cfg.updateThreadsCores(requestDefault));
+        slotPinUpdateThreadsToggled(m_chkPinUpdateThreads->isChecked());
+    }
+
+    if (m_chkAdaptiveLevelOfDetail) {
+        m_chkAdaptiveLevelOfDetail->setChecked(cfg.adaptiveLevelOfDetail(requestDefault));
+        m_intAdaptiveLevelOfDetailLatency->setValue(cfg.adaptiveLevelOfDetailLatency(requestDefault));
+        m_intAdaptiveLevelOfDetailMaxOffset->setValue(cfg.adaptiveLevelOfDetailMaxOffset(requestDefault));
+        slotAdaptiveLevelOfDetailToggled(m_chkAdaptiveLevelOfDetail->isChecked());
+    }
+
     {
         KisConfig cfg2(true);
         chkOpenGLFramerateLogging->setChecked(cfg2.enableOpenGLFramerateLogging(requestDefault));
@@ -1564,6 +1654,21 @@ void PerformanceTab::save()
     cfg.setFrameRenderingTimeout(sliderFrameTimeout->value() * 1000);
     cfg.setFpsLimit(sliderFpsLimit->value());
 
+    if (m_chkPinUpdateThreads) {
+        cfg.setPinUpdateThreads(m_chkPinUpdateThreads->isChecked());
+        cfg.setKeepGuiCoreFree(m_chkKeepGuiCoreFree->isChecked());
+        cfg.setPreferPerformanceCores(m_chkPreferPerformanceCores->isChecked());
+        cfg.setUpdateThreadsCores(
+            KisThreadAffinity::formatCpuList(
+                KisThreadAffinity::parseCpuList(m_txtUpdateThreadsCores->text())));
+    }
+
+    if (m_chkAdaptiveLevelOfDetail) {
+        cfg.setAdaptiveLevelOfDetail(m_chkAdaptiveLevelOfDetail->isChecked());
+        cfg.setAdaptiveLevelOfDetailLatency(m_intAdaptiveLevelOfDetailLatency->value());
+        cfg.setAdaptiveLevelOfDetailMaxOffset(m_intAdaptiveLevelOfDetailMaxOffset->value());
+    }
+
     {
         KisConfig cfg2(true);
         cfg2.setEnableOpenGLFramerateLogging(chkOpenGLFramerateLogging->isChecked());
@@ -1615,6 +1720,21 @@ void PerformanceTab::slotFrameClonesLimitChanged(int value)
     m_lastUsedClonesLimit = value;
 }
 
+void PerformanceTab::slotPinUpdateThreadsToggled(bool value)
+{
+    const bool isHybridCpu = !KisThreadAffinity::cpuTopology().performanceCores.isEmpty();
+
+    m_chkKeepGuiCoreFree->setEnabled(value);
+    m_chkPreferPerformanceCores->setEnabled(value && isHybridCpu);
+    m_txtUpdateThreadsCores->setEnabled(value);
+}
+
+void PerformanceTab::slotAdaptiveLevelOfDetailToggled(bool value)
+{
+    m_intAdaptiveLevelOfDetailLatency->setEnabled(value);
+    m_intAdaptiveLevelOfDetailMaxOffset->setEnabled(value);
+}
+
 //---------------------------------------------------------------------------------------------------
 
 #include "KoColor.h"
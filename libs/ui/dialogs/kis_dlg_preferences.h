@@ -223,6 +223,7 @@ public:
  */
 
 class SliderAndSpinBoxSync;
+class KisIntParseSpinBox;
 
 class WdgPerformanceSettings : public QWidget, public Ui::WdgPerformanceSettings
 {
@@ -249,14 +250,27 @@ public:
 private Q_SLOTS:
     void slotThreadsLimitChanged(int value);
     void slotFrameClonesLimitChanged(int value);
+    void slotPinUpdateThreadsToggled(bool value);
+    void slotAdaptiveLevelOfDetailToggled(bool value);
 
 private:
     int realTilesRAM();
+    void createThreadAffinityWidgets();
+    void createAdaptiveLevelOfDetailWidgets();
 
 private:
     QVector<SliderAndSpinBoxSync*> m_syncs;
     int m_lastUsedThreadsLimit;
     int m_lastUsedClonesLimit;
+
+    QCheckBox *m_chkPinUpdateThreads = 0;
+    QCheckBox *m_chkKeepGuiCoreFree = 0;
+    QCheckBox *m_chkPreferPerformanceCores = 0;
+    QLineEdit *m_txtUpdateThreadsCores = 0;
+
+    QCheckBox *m_chkAdaptiveLevelOfDetail = 0;
+    KisIntParseSpinBox *m_intAdaptiveLevelOfDetailLatency = 0;
+    KisIntParseSpinBox *m_intAdaptiveLevelOfDetailMaxOffset = 0;
 };
 
 //=======================
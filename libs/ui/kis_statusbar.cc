@@ -300,8 +300,8 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.poolSize),
                   format.formatByteSize(stats.tilesPoolLimit),
 
-                  format.formatByteSize(stats.historicalMemorySize),
-                  format.formatByteSize(stats.swapSize));
+                  format.formatByteSize(stats.historicalMemorySize + stats.historicalDeltaSize),
+                  format.formatByteSize(stats.swapSize + stats.historicalSwapSize));
 
     QString longStats = imageStatsMsg + "\n" + memoryStatsMsg;
 
@@ -32,6 +32,7 @@
 #include <QVector3D>
 #include "kis_painting_tweaks.h"
 #include "KisOpenGLBufferCreationGuard.h"
+#include "KisUpdateTracer.h"
 
 #ifdef HAVE_OPENEXR
 #include <half.h>
@@ -333,6 +334,8 @@ void KisOpenGLImageTextures::recalculateCache(KisUpdateInfoSP info, bool blockMi
     KisOpenGLUpdateInfoSP glInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
     if(!glInfo) return;
 
+    KisUpdateTraceScope traceScope(KisUpdateTracer::TextureUpload, glInfo->dirtyImageRect());
+
     QScopedPointer<KisOpenGLSync> sync;
     int numProcessedTiles = 0;
 
@@ -7,12 +7,33 @@
 
 #include "IccColorSpaceEngine.h"
 
+#include <QCache>
+#include <QMutex>
+
 #include <klocalizedstring.h>
+#include <ksharedconfig.h>
+#include <kconfiggroup.h>
 
 #include <KoColorModelStandardIds.h>
 #include <kis_assert.h>
 
 #include "LcmsColorSpace.h"
+#include "LcmsLut3DColorConversionTransformation.h"
+
+namespace {
+
+/**
+ * The LUT conversions are not exact, so they are used only when the
+ * user has explicitly enabled them. The option is read on every call,
+ * the transformations are cached by KoColorConversionCache anyway.
+ */
+bool useLut3DColorConversion()
+{
+    KConfigGroup cfg = KSharedConfig::openConfig()->group("");
+    return cfg.readEntry("useLut3DColorConversion", false);
+}
+
+}
 
 // -- KoLcmsColorConversionTransformation --
 
@@ -135,8 +156,70 @@ private:
 };
 
 struct IccColorSpaceEngine::Private {
+    /**
+     * The LUTs are shared by all the instances of a conversion, e.g.
+     * the ones used by different threads or created for different
+     * color depths. An empty LUT means that it is not accurate enough
+     * for the conversion.
+     *
+     * Every pair of profiles gets its own LUT, so the cache drops the
+     * least recently used LUTs when their total size exceeds the limit
+     * (the cost of an entry is its size in bytes).
+     */
+    static const int lut3DCacheLimit = 64 * 1024 * 1024;
+
+    QCache<QByteArray, QVector<float>> lut3DCache {lut3DCacheLimit};
+    QMutex lut3DCacheMutex;
+
+    QVector<float> lut3D(const KoColorSpace *srcColorSpace, LcmsColorProfileContainer *srcProfile,
+                         const KoColorSpace *dstColorSpace, LcmsColorProfileContainer *dstProfile,
+                         KoColorConversionTransformation::Intent renderingIntent,
+                         KoColorConversionTransformation::ConversionFlags conversionFlags);
 };
 
+QVector<float> IccColorSpaceEngine::Private::lut3D(const KoColorSpace *srcColorSpace, LcmsColorProfileContainer *srcProfile,
+                                                   const KoColorSpace *dstColorSpace, LcmsColorProfileContainer *dstProfile,
+                                                   KoColorConversionTransformation::Intent renderingIntent,
+                                                   KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    const QByteArray key =
+        srcColorSpace->profile()->uniqueId() + ':' +
+        dstColorSpace->profile()->uniqueId() + ':' +
+        dstColorSpace->colorModelId().id().toLatin1() + ':' +
+        QByteArray::number(renderingIntent) + ':' +
+        QByteArray::number(int(conversionFlags));
+
+    {
+        QMutexLocker l(&lut3DCacheMutex);
+
+        if (QVector<float> *lut = lut3DCache.object(key)) {
+            return *lut;
+        }
+    }
+
+    /**
+     * Building a LUT means converting every node of its grid with
+     * lcms, so it is done without holding the lock. If some other
+     * thread has built the same LUT in the meantime, its copy is
+     * used and ours is dropped.
+     */
+    const QVector<float> lut =
+        LcmsLut3DColorConversionTransformation::createLut(
+            srcProfile, dstColorSpace, dstProfile,
+            renderingIntent, conversionFlags);
+
+    QMutexLocker l(&lut3DCacheMutex);
+
+    if (QVector<float> *cachedLut = lut3DCache.object(key)) {
+        return *cachedLut;
+    }
+
+    lut3DCache.insert(key, new QVector<float>(lut),
+                      qMax(1, lut.size() * int(sizeof(float))));
+
+    return lut;
+}
+
 IccColorSpaceEngine::IccColorSpaceEngine() : KoColorSpaceEngine("icc", i18n("ICC Engine")), d(new Private)
 {
 }
@@ -253,10 +336,29 @@ KoColorConversionTransformation *IccColorSpaceEngine::createColorTransformation(
     KIS_ASSERT(dynamic_cast<const IccColorProfile *>(srcColorSpace->profile()));
     KIS_ASSERT(dynamic_cast<const IccColorProfile *>(dstColorSpace->profile()));
 
+    LcmsColorProfileContainer *srcProfile = dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms();
+    LcmsColorProfileContainer *dstProfile = dynamic_cast<const IccColorProfile *>(dstColorSpace->profile())->asLcms();
+
+    if (useLut3DColorConversion() &&
+        LcmsLut3DColorConversionTransformation::isSupported(srcColorSpace, srcProfile,
+                                                           dstColorSpace, dstProfile,
+                                                           conversionFlags)) {
+
+        const QVector<float> lut = d->lut3D(srcColorSpace, srcProfile,
+                                            dstColorSpace, dstProfile,
+                                            renderingIntent, conversionFlags);
+
+        if (!lut.isEmpty()) {
+            return new LcmsLut3DColorConversionTransformation(
+                        srcColorSpace, dstColorSpace,
+                        renderingIntent, conversionFlags, lut);
+        }
+    }
+
     return new KoLcmsColorConversionTransformation(
                 srcColorSpace, computeColorSpaceType(srcColorSpace),
-                dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
-                dynamic_cast<const IccColorProfile *>(dstColorSpace->profile())->asLcms(), renderingIntent, conversionFlags);
+                srcProfile, dstColorSpace, computeColorSpaceType(dstColorSpace),
+                dstProfile, renderingIntent, conversionFlags);
 
 }
 KoColorProofingConversionTransformation *IccColorSpaceEngine::createColorProofingTransformation(const KoColorSpace *srcColorSpace,
@@ -273,6 +375,10 @@ KoColorProofingConversionTransformation *IccColorSpaceEngine::createColorProofin
     KIS_ASSERT(dynamic_cast<const IccColorProfile *>(srcColorSpace->profile()));
     KIS_ASSERT(dynamic_cast<const IccColorProfile *>(dstColorSpace->profile()));
 
+    /**
+     * The proofing transformations always go through lcms, the LUT
+     * cannot represent the gamut check and the proofing profile
+     */
     return new KoLcmsColorProofingConversionTransformation(
                 srcColorSpace, computeColorSpaceType(srcColorSpace),
                 dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
@@ -0,0 +1,310 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "LcmsLut3DColorConversionTransformation.h"
+
+#include <lcms2.h>
+
+#include <limits>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceMaths.h>
+#include <KoOptimizedLut3DInterpolatorFactory.h>
+#include <kis_assert.h>
+
+#include "colorprofiles/LcmsColorProfileContainer.h"
+
+namespace {
+
+/**
+ * lcms uses grids of the same size for its own
+ * optimization of 16-bit conversions
+ */
+const int LUT_GRID_SIZE = 33;
+
+/**
+ * The accuracy is checked in LUT_ACCURACY_SAMPLES^3 points,
+ * none of them lies on a node of the grid
+ */
+const int LUT_ACCURACY_SAMPLES = 16;
+
+const double LUT_MAX_DELTA_E = 1.0;
+
+/**
+ * The size of the buffers the pixels are unpacked into,
+ * before being passed to the interpolator
+ */
+const int CONVERSION_CHUNK_SIZE = 256;
+
+bool isIntegerDepth(const KoColorSpace *cs)
+{
+    return cs->colorDepthId() == Integer8BitsColorDepthID ||
+        cs->colorDepthId() == Integer16BitsColorDepthID;
+}
+
+double measureMaxDeltaE(cmsHTRANSFORM exactTransform,
+                        cmsHPROFILE dstProfile, cmsUInt32Number dstFormat, int numDstChannels,
+                        const QVector<float> &lut)
+{
+    const int numSamples = LUT_ACCURACY_SAMPLES * LUT_ACCURACY_SAMPLES * LUT_ACCURACY_SAMPLES;
+
+    QVector<quint16> samples(numSamples * 3);
+    QVector<float> r(numSamples);
+    QVector<float> g(numSamples);
+    QVector<float> b(numSamples);
+
+    auto sampleValue = [] (int i) {
+        return quint16(qRound((i + 0.37) / LUT_ACCURACY_SAMPLES * 65535.0));
+    };
+
+    int n = 0;
+    for (int ri = 0; ri < LUT_ACCURACY_SAMPLES; ri++) {
+        for (int gi = 0; gi < LUT_ACCURACY_SAMPLES; gi++) {
+            for (int bi = 0; bi < LUT_ACCURACY_SAMPLES; bi++) {
+                samples[3 * n + 0] = sampleValue(ri);
+                samples[3 * n + 1] = sampleValue(gi);
+                samples[3 * n + 2] = sampleValue(bi);
+
+                r[n] = KoColorSpaceMaths<quint16, float>::scaleToA(samples[3 * n + 0]);
+                g[n] = KoColorSpaceMaths<quint16, float>::scaleToA(samples[3 * n + 1]);
+                b[n] = KoColorSpaceMaths<quint16, float>::scaleToA(samples[3 * n + 2]);
+                n++;
+            }
+        }
+    }
+
+    QVector<quint16> exact(numSamples * numDstChannels);
+    cmsDoTransform(exactTransform, samples.data(), exact.data(), numSamples);
+
+    QScopedPointer<KoOptimizedLut3DInterpolatorBase> interpolator(KoOptimizedLut3DInterpolatorFactory::create());
+
+    QVector<float> planes(numSamples * numDstChannels);
+    interpolator->interpolate(lut.constData(), LUT_GRID_SIZE, numDstChannels,
+                              r.constData(), g.constData(), b.constData(),
+                              planes.data(), numSamples);
+
+    QVector<quint16> interpolated(numSamples * numDstChannels);
+    for (int i = 0; i < numSamples; i++) {
+        for (int ch = 0; ch < numDstChannels; ch++) {
+            interpolated[i * numDstChannels + ch] =
+                KoColorSpaceMaths<float, quint16>::scaleToA(planes[ch * numSamples + i]);
+        }
+    }
+
+    cmsHPROFILE labProfile = cmsCreateLab4Profile(0);
+    cmsHTRANSFORM toLab = cmsCreateTransform(dstProfile, dstFormat,
+                                             labProfile, TYPE_Lab_DBL,
+                                             INTENT_RELATIVE_COLORIMETRIC,
+                                             cmsFLAGS_NOOPTIMIZE);
+    cmsCloseProfile(labProfile);
+
+    KIS_SAFE_ASSERT_RECOVER(toLab) {
+        return std::numeric_limits<double>::max();
+    }
+
+    QVector<cmsCIELab> exactLab(numSamples);
+    QVector<cmsCIELab> interpolatedLab(numSamples);
+
+    cmsDoTransform(toLab, exact.data(), exactLab.data(), numSamples);
+    cmsDoTransform(toLab, interpolated.data(), interpolatedLab.data(), numSamples);
+    cmsDeleteTransform(toLab);
+
+    double maxDeltaE = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        maxDeltaE = qMax(maxDeltaE, cmsDeltaE(&exactLab[i], &interpolatedLab[i]));
+    }
+
+    return maxDeltaE;
+}
+
+}
+
+LcmsLut3DColorConversionTransformation::LcmsLut3DColorConversionTransformation(const KoColorSpace *srcCs,
+                                                                               const KoColorSpace *dstCs,
+                                                                               Intent renderingIntent,
+                                                                               ConversionFlags conversionFlags,
+                                                                               const QVector<float> &lut)
+    : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
+    , m_numDstChannels(dstCs->colorModelId() == CMYKAColorModelID ? 4 : 3)
+    , m_srcIsU8(srcCs->colorDepthId() == Integer8BitsColorDepthID)
+    , m_dstIsU8(dstCs->colorDepthId() == Integer8BitsColorDepthID)
+    , m_lut(lut)
+    , m_interpolator(KoOptimizedLut3DInterpolatorFactory::create())
+{
+    KIS_ASSERT(m_lut.size() == LUT_GRID_SIZE * LUT_GRID_SIZE * LUT_GRID_SIZE * m_numDstChannels);
+}
+
+LcmsLut3DColorConversionTransformation::~LcmsLut3DColorConversionTransformation()
+{
+}
+
+bool LcmsLut3DColorConversionTransformation::isSupported(const KoColorSpace *srcCs, LcmsColorProfileContainer *srcProfile,
+                                                         const KoColorSpace *dstCs, LcmsColorProfileContainer *dstProfile,
+                                                         ConversionFlags conversionFlags)
+{
+    /**
+     * HighQuality (used by the display conversions) is fine, the LUT
+     * is rejected anyway if it is not accurate enough, see createLut()
+     */
+    if (conversionFlags.testFlag(NoOptimization) ||
+        conversionFlags.testFlag(GamutCheck) ||
+        conversionFlags.testFlag(SoftProofing)) {
+
+        return false;
+    }
+
+    /**
+     * Linear data needs much more nodes in dark areas than the
+     * uniform grid can provide, lcms itself doesn't optimize
+     * such conversions (see KoLcmsColorConversionTransformation)
+     */
+    if (srcProfile->isLinear() || dstProfile->isLinear()) return false;
+
+    return srcCs->colorModelId() == RGBAColorModelID &&
+        (dstCs->colorModelId() == RGBAColorModelID || dstCs->colorModelId() == CMYKAColorModelID) &&
+        isIntegerDepth(srcCs) && isIntegerDepth(dstCs);
+}
+
+QVector<float> LcmsLut3DColorConversionTransformation::createLut(LcmsColorProfileContainer *srcProfile,
+                                                                 const KoColorSpace *dstCs, LcmsColorProfileContainer *dstProfile,
+                                                                 Intent renderingIntent,
+                                                                 ConversionFlags conversionFlags)
+{
+    const bool dstIsCmyk = dstCs->colorModelId() == CMYKAColorModelID;
+    const int numDstChannels = dstIsCmyk ? 4 : 3;
+    const cmsUInt32Number dstFormat = dstIsCmyk ? TYPE_CMYK_16 : TYPE_RGB_16;
+
+    /**
+     * The nodes are calculated with the full precision of lcms,
+     * the alpha channel is copied by the transformation itself
+     */
+    const cmsUInt32Number lcmsFlags =
+        cmsUInt32Number(conversionFlags & ~CopyAlpha) | cmsFLAGS_NOOPTIMIZE;
+
+    cmsHTRANSFORM exactTransform = cmsCreateTransform(srcProfile->lcmsProfile(), TYPE_RGB_16,
+                                                      dstProfile->lcmsProfile(), dstFormat,
+                                                      renderingIntent, lcmsFlags);
+    if (!exactTransform) return QVector<float>();
+
+    const int numNodes = LUT_GRID_SIZE * LUT_GRID_SIZE * LUT_GRID_SIZE;
+
+    auto nodeValue = [] (int i) {
+        return quint16(qRound(i * 65535.0 / (LUT_GRID_SIZE - 1)));
+    };
+
+    QVector<quint16> nodes(numNodes * 3);
+
+    int n = 0;
+    for (int ri = 0; ri < LUT_GRID_SIZE; ri++) {
+        for (int gi = 0; gi < LUT_GRID_SIZE; gi++) {
+            for (int bi = 0; bi < LUT_GRID_SIZE; bi++) {
+                nodes[3 * n + 0] = nodeValue(ri);
+                nodes[3 * n + 1] = nodeValue(gi);
+                nodes[3 * n + 2] = nodeValue(bi);
+                n++;
+            }
+        }
+    }
+
+    QVector<quint16> nodeValues(numNodes * numDstChannels);
+    cmsDoTransform(exactTransform, nodes.data(), nodeValues.data(), numNodes);
+
+    QVector<float> lut(numNodes * numDstChannels);
+    for (int i = 0; i < lut.size(); i++) {
+        lut[i] = KoColorSpaceMaths<quint16, float>::scaleToA(nodeValues[i]);
+    }
+
+    const double deltaE = measureMaxDeltaE(exactTransform,
+                                           dstProfile->lcmsProfile(), dstFormat, numDstChannels,
+                                           lut);
+    cmsDeleteTransform(exactTransform);
+
+    return deltaE <= LUT_MAX_DELTA_E ? lut : QVector<float>();
+}
+
+double LcmsLut3DColorConversionTransformation::maxDeltaE()
+{
+    return LUT_MAX_DELTA_E;
+}
+
+void LcmsLut3DColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 numPixels) const
+{
+    if (m_srcIsU8) {
+        if (m_dstIsU8) {
+            transformImpl<quint8, quint8>(src, dst, numPixels);
+        } else {
+            transformImpl<quint8, quint16>(src, dst, numPixels);
+        }
+    } else {
+        if (m_dstIsU8) {
+            transformImpl<quint16, quint8>(src, dst, numPixels);
+        } else {
+            transformImpl<quint16, quint16>(src, dst, numPixels);
+        }
+    }
+}
+
+template<typename src_channel_type, typename dst_channel_type>
+void LcmsLut3DColorConversionTransformation::transformImpl(const quint8 *src, quint8 *dst, qint32 numPixels) const
+{
+    // Krita stores RGB data in BGRA order
+    const int srcBluePos = 0;
+    const int srcGreenPos = 1;
+    const int srcRedPos = 2;
+    const int srcAlphaPos = 3;
+    const int srcChannels = 4;
+
+    const int dstChannels = m_numDstChannels + 1;
+    const bool dstIsCmyk = m_numDstChannels == 4;
+
+    float r[CONVERSION_CHUNK_SIZE];
+    float g[CONVERSION_CHUNK_SIZE];
+    float b[CONVERSION_CHUNK_SIZE];
+    src_channel_type alpha[CONVERSION_CHUNK_SIZE];
+    float planes[4 * CONVERSION_CHUNK_SIZE];
+
+    const src_channel_type *srcPtr = reinterpret_cast<const src_channel_type*>(src);
+    dst_channel_type *dstPtr = reinterpret_cast<dst_channel_type*>(dst);
+
+    while (numPixels > 0) {
+        const int chunkSize = qMin(numPixels, CONVERSION_CHUNK_SIZE);
+
+        // the conversion may happen in-place, so the source is read before writing
+        for (int i = 0; i < chunkSize; i++) {
+            const src_channel_type *pixel = srcPtr + i * srcChannels;
+
+            r[i] = KoColorSpaceMaths<src_channel_type, float>::scaleToA(pixel[srcRedPos]);
+            g[i] = KoColorSpaceMaths<src_channel_type, float>::scaleToA(pixel[srcGreenPos]);
+            b[i] = KoColorSpaceMaths<src_channel_type, float>::scaleToA(pixel[srcBluePos]);
+            alpha[i] = pixel[srcAlphaPos];
+        }
+
+        m_interpolator->interpolate(m_lut.constData(), LUT_GRID_SIZE, m_numDstChannels,
+                                    r, g, b, planes, chunkSize);
+
+        for (int i = 0; i < chunkSize; i++) {
+            dst_channel_type *pixel = dstPtr + i * dstChannels;
+
+            if (dstIsCmyk) {
+                for (int ch = 0; ch < 4; ch++) {
+                    pixel[ch] = KoColorSpaceMaths<float, dst_channel_type>::scaleToA(planes[ch * chunkSize + i]);
+                }
+            } else {
+                // the LUT stores RGB data in RGB order
+                pixel[2] = KoColorSpaceMaths<float, dst_channel_type>::scaleToA(planes[i]);
+                pixel[1] = KoColorSpaceMaths<float, dst_channel_type>::scaleToA(planes[chunkSize + i]);
+                pixel[0] = KoColorSpaceMaths<float, dst_channel_type>::scaleToA(planes[2 * chunkSize + i]);
+            }
+
+            pixel[m_numDstChannels] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(alpha[i]);
+        }
+
+        srcPtr += chunkSize * srcChannels;
+        dstPtr += chunkSize * dstChannels;
+        numPixels -= chunkSize;
+    }
+}
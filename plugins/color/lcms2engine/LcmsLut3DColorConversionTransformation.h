@@ -0,0 +1,85 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef LCMSLUT3DCOLORCONVERSIONTRANSFORMATION_H
+#define LCMSLUT3DCOLORCONVERSIONTRANSFORMATION_H
+
+#include <KoColorConversionTransformation.h>
+
+#include <QScopedPointer>
+#include <QVector>
+
+class LcmsColorProfileContainer;
+class KoOptimizedLut3DInterpolatorBase;
+
+/**
+ * A color conversion that replaces the full lcms pipeline with
+ * a precomputed 3D LUT and tetrahedral interpolation (see
+ * KoOptimizedLut3DInterpolatorBase).
+ *
+ * Only U8 and U16 RGB->RGB and RGB->CMYK conversions are supported.
+ * The LUT is filled by lcms with the same profiles, intent and flags
+ * as the exact conversion, then the interpolated values are checked
+ * against the exact ones on a set of points lying between the nodes
+ * of the grid. If the color difference exceeds maxDeltaE(), the LUT
+ * is rejected and the exact conversion should be used instead.
+ *
+ * The LUT doesn't depend on the color depth, so the same LUT can be
+ * shared by the transformations of all the supported depths.
+ *
+ * The LUT is optional, IccColorSpaceEngine uses it only when the
+ * "useLut3DColorConversion" option is enabled in kritarc. The soft
+ * proofing transformations are never replaced with the LUT.
+ */
+class LcmsLut3DColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    LcmsLut3DColorConversionTransformation(const KoColorSpace *srcCs,
+                                           const KoColorSpace *dstCs,
+                                           Intent renderingIntent,
+                                           ConversionFlags conversionFlags,
+                                           const QVector<float> &lut);
+    ~LcmsLut3DColorConversionTransformation() override;
+
+    /**
+     * Returns true if the conversion can be done via the LUT at all,
+     * e.g. it is not the case when the caller explicitly asked for
+     * an unoptimized conversion or one of the profiles is linear
+     */
+    static bool isSupported(const KoColorSpace *srcCs, LcmsColorProfileContainer *srcProfile,
+                            const KoColorSpace *dstCs, LcmsColorProfileContainer *dstProfile,
+                            ConversionFlags conversionFlags);
+
+    /**
+     * Calculates the LUT for a supported conversion. Returns an empty
+     * vector if the LUT is not accurate enough for the conversion.
+     */
+    static QVector<float> createLut(LcmsColorProfileContainer *srcProfile,
+                                    const KoColorSpace *dstCs, LcmsColorProfileContainer *dstProfile,
+                                    Intent renderingIntent,
+                                    ConversionFlags conversionFlags);
+
+    /**
+     * The maximum CIE76 color difference between the interpolated
+     * and the exact conversion
+     */
+    static double maxDeltaE();
+
+    void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const override;
+
+private:
+    template<typename src_channel_type, typename dst_channel_type>
+    void transformImpl(const quint8 *src, quint8 *dst, qint32 numPixels) const;
+
+private:
+    int m_numDstChannels;
+    bool m_srcIsU8;
+    bool m_dstIsU8;
+    QVector<float> m_lut;
+    QScopedPointer<KoOptimizedLut3DInterpolatorBase> m_interpolator;
+};
+
+#endif // LCMSLUT3DCOLORCONVERSIONTRANSFORMATION_H
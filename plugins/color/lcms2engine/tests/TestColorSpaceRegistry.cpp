@@ -6,11 +6,15 @@
 
 #include <lcms2.h>
 
+#include <QThreadPool>
+
+#include <KoColorModelStandardIds.h>
 #include <KoColorProfile.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <simpletest.h>
 #include <testpigment.h>
+#include <color_conversion_test_util.h>
 
 
 void TestColorSpaceRegistry::testConstruction()
@@ -90,4 +94,52 @@ void TestColorSpaceRegistry::testLab()
 
 }
 
+void TestColorSpaceRegistry::testParallelConversion()
+{
+    const int numThreads = 8;
+    const int numChunks = 4096;
+    const int chunkSize = 64;
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    const QVector<const KoColorSpace*> dstColorSpaces({
+        KoColorSpaceRegistry::instance()->lab16(),
+        KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(), Integer8BitsColorDepthID.id(), 0),
+        KoColorSpaceRegistry::instance()->rgb16()
+    });
+
+    int dstPixelSize = 0;
+    Q_FOREACH (const KoColorSpace *cs, dstColorSpaces) {
+        QVERIFY(cs);
+        dstPixelSize = qMax(dstPixelSize, int(cs->pixelSize()));
+    }
+
+    const int srcBufferSize = numChunks * chunkSize * srcColorSpace->pixelSize();
+    const int dstBufferSize = numChunks * chunkSize * dstPixelSize;
+
+    QVector<quint8> src(srcBufferSize);
+    for (int i = 0; i < srcBufferSize; i++) {
+        src[i] = quint8(i * 7 + i / 13);
+    }
+
+    QVector<quint8> reference(dstBufferSize, 0);
+    TestUtil::ColorConversionRunnable(srcColorSpace, dstColorSpaces,
+                                      src.constData(), reference.data(), dstPixelSize,
+                                      numChunks, chunkSize, 0, 1).run();
+
+    // every thread switches between all the conversions all the time
+    QVector<quint8> result(dstBufferSize, 0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    for (int i = 0; i < numThreads; i++) {
+        pool.start(new TestUtil::ColorConversionRunnable(srcColorSpace, dstColorSpaces,
+                                                         src.constData(), result.data(), dstPixelSize,
+                                                         numChunks, chunkSize, i, numThreads));
+    }
+    pool.waitForDone();
+
+    QVERIFY(result == reference);
+}
+
 KISTEST_MAIN(TestColorSpaceRegistry)
@@ -15,6 +15,7 @@ private Q_SLOTS:
     void testRgbU8();
     void testRgbU16();
     void testLab();
+    void testParallelConversion();
 };
 
 #endif
@@ -0,0 +1,334 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestLut3DColorConversion.h"
+
+#include <simpletest.h>
+#include <testpigment.h>
+
+#include <typeinfo>
+
+#include <QScopedPointer>
+
+#include <lcms2.h>
+#include <ksharedconfig.h>
+#include <kconfiggroup.h>
+
+#include "KoColorConversionTransformation.h"
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+
+
+namespace {
+
+/**
+ * The formats Krita uses for its RGBA and CMYKA color spaces,
+ * see IccColorSpaceEngine::computeColorSpaceType()
+ */
+cmsUInt32Number lcmsFormat(const KoColorSpace *cs)
+{
+    const cmsUInt32Number bytes = cs->colorDepthId() == Integer8BitsColorDepthID ? 1 : 2;
+
+    if (cs->colorModelId() == RGBAColorModelID) {
+        return COLORSPACE_SH(PT_RGB) | EXTRA_SH(1) | CHANNELS_SH(3) |
+            DOSWAP_SH(1) | SWAPFIRST_SH(1) | BYTES_SH(bytes);
+    }
+
+    return COLORSPACE_SH(PT_CMYK) | EXTRA_SH(1) | CHANNELS_SH(4) | BYTES_SH(bytes);
+}
+
+cmsHPROFILE lcmsProfile(const KoColorSpace *cs)
+{
+    const QByteArray rawData = cs->profile()->rawData();
+    return cmsOpenProfileFromMem(rawData.constData(), rawData.size());
+}
+
+/**
+ * A non-linear RGB profile with Rec. 2020 primaries, so that the
+ * conversion from sRGB needs both the curves and the matrix
+ */
+const KoColorSpace *rec2020Gamma22ColorSpace(const QString &depthId)
+{
+    cmsCIExyY whitePoint;
+    cmsWhitePointFromTemp(&whitePoint, 6504);
+
+    cmsCIExyYTRIPLE primaries = {
+        {0.708, 0.292, 1.0},
+        {0.170, 0.797, 1.0},
+        {0.131, 0.046, 1.0}
+    };
+
+    cmsToneCurve *curve = cmsBuildGamma(0, 2.2);
+    cmsToneCurve *curves[3] = {curve, curve, curve};
+
+    cmsHPROFILE profile = cmsCreateRGBProfile(&whitePoint, &primaries, curves);
+    cmsFreeToneCurve(curve);
+
+    cmsMLU *description = cmsMLUalloc(0, 1);
+    cmsMLUsetASCII(description, "en", "US", "Rec2020 gamma 2.2 (LUT test)");
+    cmsWriteTag(profile, cmsSigProfileDescriptionTag, description);
+    cmsMLUfree(description);
+
+    cmsUInt32Number size = 0;
+    cmsSaveProfileToMem(profile, 0, &size);
+    QByteArray rawData(size, 0);
+    cmsSaveProfileToMem(profile, rawData.data(), &size);
+    cmsCloseProfile(profile);
+
+    const KoColorProfile *koProfile =
+        KoColorSpaceRegistry::instance()->createColorProfile(RGBAColorModelID.id(), depthId, rawData);
+
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, koProfile);
+}
+
+const KoColorSpace *colorSpace(const QString &modelId, const QString &depthId, const QString &profile)
+{
+    if (profile == "rec2020-g22") {
+        return rec2020Gamma22ColorSpace(depthId);
+    }
+
+    return KoColorSpaceRegistry::instance()->colorSpace(modelId, depthId, profile);
+}
+
+/**
+ * A grid of colors that doesn't coincide with the nodes of the LUT
+ */
+QByteArray createSourcePixels(const KoColorSpace *cs, int gridSize)
+{
+    const int numPixels = gridSize * gridSize * gridSize;
+    QByteArray pixels(numPixels * cs->pixelSize(), 0);
+
+    QVector<float> channels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        channels[0] = float(i % gridSize) / (gridSize - 1);
+        channels[1] = float((i / gridSize) % gridSize) / (gridSize - 1);
+        channels[2] = float(i / (gridSize * gridSize)) / (gridSize - 1);
+        channels[3] = float(i % 7) / 6;
+
+        cs->fromNormalisedChannelsValue(reinterpret_cast<quint8*>(pixels.data()) + i * cs->pixelSize(), channels);
+    }
+
+    return pixels;
+}
+
+/**
+ * The transformation class lives in the engine plugin, which the test
+ * doesn't link to, so dynamic_cast is not available. Check the dynamic
+ * type by its name instead.
+ */
+bool isLut3DTransformation(const KoColorConversionTransformation *transformation)
+{
+    return QByteArray(typeid(*transformation).name()).contains("LcmsLut3DColorConversionTransformation");
+}
+
+void setLut3DEnabled(bool value)
+{
+    KConfigGroup cfg = KSharedConfig::openConfig()->group("");
+    cfg.writeEntry("useLut3DColorConversion", value);
+}
+
+void checkConversion(const KoColorSpace *srcCs, const KoColorSpace *dstCs,
+                     KoColorConversionTransformation::ConversionFlags flags,
+                     double maxAllowedDeltaE)
+{
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    const int numPixels = 31 * 31 * 31;
+    const QByteArray src = createSourcePixels(srcCs, 31);
+
+    QByteArray dst(numPixels * dstCs->pixelSize(), 0);
+    QByteArray reference(numPixels * dstCs->pixelSize(), 0);
+
+    QScopedPointer<KoColorConversionTransformation> transformation(
+        KoColorSpaceRegistry::instance()->createColorConverter(
+            srcCs, dstCs,
+            KoColorConversionTransformation::internalRenderingIntent(),
+            flags));
+
+    QVERIFY(isLut3DTransformation(transformation.data()));
+
+    transformation->transform(reinterpret_cast<const quint8*>(src.constData()),
+                              reinterpret_cast<quint8*>(dst.data()),
+                              numPixels);
+
+    cmsHPROFILE srcProfile = lcmsProfile(srcCs);
+    cmsHPROFILE dstProfile = lcmsProfile(dstCs);
+    cmsHPROFILE labProfile = cmsCreateLab4Profile(0);
+
+    // the exact result of LCMS without any precalculation
+    cmsHTRANSFORM exactTransform =
+        cmsCreateTransform(srcProfile, lcmsFormat(srcCs),
+                           dstProfile, lcmsFormat(dstCs),
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           flags | cmsFLAGS_NOOPTIMIZE);
+    QVERIFY(exactTransform);
+    cmsDoTransform(exactTransform, src.constData(), reference.data(), numPixels);
+
+    cmsHTRANSFORM toLabTransform =
+        cmsCreateTransform(dstProfile, lcmsFormat(dstCs),
+                           labProfile, TYPE_Lab_DBL,
+                           INTENT_RELATIVE_COLORIMETRIC, cmsFLAGS_NOOPTIMIZE);
+    QVERIFY(toLabTransform);
+
+    QVector<cmsCIELab> dstLab(numPixels);
+    QVector<cmsCIELab> referenceLab(numPixels);
+    cmsDoTransform(toLabTransform, dst.constData(), dstLab.data(), numPixels);
+    cmsDoTransform(toLabTransform, reference.constData(), referenceLab.data(), numPixels);
+
+    double maxDeltaE = 0.0;
+    for (int i = 0; i < numPixels; i++) {
+        maxDeltaE = qMax(maxDeltaE, cmsDeltaE(&dstLab[i], &referenceLab[i]));
+    }
+
+    cmsDeleteTransform(toLabTransform);
+    cmsDeleteTransform(exactTransform);
+    cmsCloseProfile(labProfile);
+    cmsCloseProfile(dstProfile);
+    cmsCloseProfile(srcProfile);
+
+    QVERIFY2(maxDeltaE <= maxAllowedDeltaE,
+             QString("max delta E %1 exceeds %2").arg(maxDeltaE).arg(maxAllowedDeltaE).toLatin1());
+}
+
+}
+
+void TestLut3DColorConversion::initTestCase()
+{
+    setLut3DEnabled(true);
+}
+
+void TestLut3DColorConversion::cleanupTestCase()
+{
+    setLut3DEnabled(false);
+}
+
+void TestLut3DColorConversion::testRgbToRgb_data()
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<double>("maxDeltaE");
+
+    // the rounding to 8 bits adds its own error on top of the LUT one
+    QTest::newRow("u8->u16") << Integer8BitsColorDepthID.id() << Integer16BitsColorDepthID.id() << 1.0;
+    QTest::newRow("u16->u16") << Integer16BitsColorDepthID.id() << Integer16BitsColorDepthID.id() << 1.0;
+    QTest::newRow("u16->u8") << Integer16BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << 2.0;
+    QTest::newRow("u8->u8") << Integer8BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << 2.0;
+}
+
+void TestLut3DColorConversion::testRgbToRgb()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstDepth);
+    QFETCH(double, maxDeltaE);
+
+    const KoColorSpace *srcCs = colorSpace(RGBAColorModelID.id(), srcDepth, "sRGB-elle-V2-srgbtrc.icc");
+    const KoColorSpace *dstCs = colorSpace(RGBAColorModelID.id(), dstDepth, "rec2020-g22");
+
+    checkConversion(srcCs, dstCs, KoColorConversionTransformation::internalConversionFlags(), maxDeltaE);
+}
+
+void TestLut3DColorConversion::testRgbToCmyk_data()
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<double>("maxDeltaE");
+
+    QTest::newRow("u8->u8") << Integer8BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << 2.0;
+    QTest::newRow("u16->u16") << Integer16BitsColorDepthID.id() << Integer16BitsColorDepthID.id() << 1.0;
+}
+
+void TestLut3DColorConversion::testRgbToCmyk()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstDepth);
+    QFETCH(double, maxDeltaE);
+
+    const KoColorSpace *srcCs = colorSpace(RGBAColorModelID.id(), srcDepth, "rec2020-g22");
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(), dstDepth, 0);
+
+    checkConversion(srcCs, dstCs, KoColorConversionTransformation::internalConversionFlags(), maxDeltaE);
+}
+
+void TestLut3DColorConversion::testDisplayFlags()
+{
+    const KoColorSpace *srcCs = colorSpace(RGBAColorModelID.id(), Integer16BitsColorDepthID.id(), "rec2020-g22");
+    const KoColorSpace *dstCs = colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), "sRGB-elle-V2-srgbtrc.icc");
+
+    // the flags of KisDisplayColorConverter::conversionFlags()
+    const KoColorConversionTransformation::ConversionFlags flags =
+        KoColorConversionTransformation::HighQuality |
+        KoColorConversionTransformation::BlackpointCompensation;
+
+    checkConversion(srcCs, dstCs, flags, 2.0);
+}
+
+void TestLut3DColorConversion::testDisabled()
+{
+    const KoColorSpace *srcCs = colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), "sRGB-elle-V2-srgbtrc.icc");
+    const KoColorSpace *dstCs = colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), "rec2020-g22");
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    setLut3DEnabled(false);
+
+    QScopedPointer<KoColorConversionTransformation> transformation(
+        KoColorSpaceRegistry::instance()->createColorConverter(
+            srcCs, dstCs,
+            KoColorConversionTransformation::internalRenderingIntent(),
+            KoColorConversionTransformation::internalConversionFlags()));
+
+    setLut3DEnabled(true);
+
+    QVERIFY(!isLut3DTransformation(transformation.data()));
+}
+
+void TestLut3DColorConversion::testNoOptimization()
+{
+    const KoColorSpace *srcCs = colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), "sRGB-elle-V2-srgbtrc.icc");
+    const KoColorSpace *dstCs = colorSpace(RGBAColorModelID.id(), Integer16BitsColorDepthID.id(), "rec2020-g22");
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    const int numPixels = 17 * 17 * 17;
+    const QByteArray src = createSourcePixels(srcCs, 17);
+
+    QByteArray dst(numPixels * dstCs->pixelSize(), 0);
+    QByteArray reference(numPixels * dstCs->pixelSize(), 0);
+
+    const KoColorConversionTransformation::ConversionFlags flags =
+        KoColorConversionTransformation::internalConversionFlags() |
+        KoColorConversionTransformation::NoOptimization;
+
+    srcCs->convertPixelsTo(reinterpret_cast<const quint8*>(src.constData()),
+                           reinterpret_cast<quint8*>(dst.data()),
+                           dstCs, numPixels,
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           flags);
+
+    cmsHPROFILE srcProfile = lcmsProfile(srcCs);
+    cmsHPROFILE dstProfile = lcmsProfile(dstCs);
+
+    cmsHTRANSFORM exactTransform =
+        cmsCreateTransform(srcProfile, lcmsFormat(srcCs),
+                           dstProfile, lcmsFormat(dstCs),
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           flags | cmsFLAGS_COPY_ALPHA);
+    QVERIFY(exactTransform);
+    cmsDoTransform(exactTransform, src.constData(), reference.data(), numPixels);
+
+    cmsDeleteTransform(exactTransform);
+    cmsCloseProfile(dstProfile);
+    cmsCloseProfile(srcProfile);
+
+    // NoOptimization should never pick the LUT
+    QCOMPARE(dst, reference);
+}
+
+KISTEST_MAIN(TestLut3DColorConversion)
@@ -0,0 +1,27 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTLUT3DCOLORCONVERSION_H
+#define TESTLUT3DCOLORCONVERSION_H
+#include <QObject>
+
+class TestLut3DColorConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testRgbToRgb_data();
+    void testRgbToRgb();
+    void testRgbToCmyk_data();
+    void testRgbToCmyk();
+    void testDisplayFlags();
+    void testDisabled();
+    void testNoOptimization();
+};
+
+#endif // TESTLUT3DCOLORCONVERSION_H
@@ -0,0 +1,73 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef COLOR_CONVERSION_TEST_UTIL_H
+#define COLOR_CONVERSION_TEST_UTIL_H
+
+#include <QRunnable>
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoColorConversionTransformation.h>
+
+
+namespace TestUtil {
+
+/**
+ * Converts the buffer \p src in chunks of \p chunkSize pixels, the
+ * way the paint device converts its tiles. The runnable handles every
+ * \p chunkStep chunk starting from \p firstChunk, so several of them
+ * can convert the same buffer in parallel. The destination color space
+ * is switched on every chunk, if \p dstColorSpaces has more than one
+ * of them.
+ */
+class ColorConversionRunnable : public QRunnable
+{
+public:
+    ColorConversionRunnable(const KoColorSpace *srcColorSpace,
+                            const QVector<const KoColorSpace*> &dstColorSpaces,
+                            const quint8 *src, quint8 *dst, int dstPixelSize,
+                            int numChunks, int chunkSize, int firstChunk, int chunkStep)
+        : m_srcColorSpace(srcColorSpace),
+          m_dstColorSpaces(dstColorSpaces),
+          m_src(src),
+          m_dst(dst),
+          m_dstPixelSize(dstPixelSize),
+          m_numChunks(numChunks),
+          m_chunkSize(chunkSize),
+          m_firstChunk(firstChunk),
+          m_chunkStep(chunkStep)
+    {
+    }
+
+    void run() override {
+        const int srcPixelSize = m_srcColorSpace->pixelSize();
+
+        for (int i = m_firstChunk; i < m_numChunks; i += m_chunkStep) {
+            m_srcColorSpace->convertPixelsTo(m_src + i * m_chunkSize * srcPixelSize,
+                                             m_dst + i * m_chunkSize * m_dstPixelSize,
+                                             m_dstColorSpaces[i % m_dstColorSpaces.size()],
+                                             m_chunkSize,
+                                             KoColorConversionTransformation::internalRenderingIntent(),
+                                             KoColorConversionTransformation::internalConversionFlags());
+        }
+    }
+
+private:
+    const KoColorSpace *m_srcColorSpace;
+    QVector<const KoColorSpace*> m_dstColorSpaces;
+    const quint8 *m_src;
+    quint8 *m_dst;
+    int m_dstPixelSize;
+    int m_numChunks;
+    int m_chunkSize;
+    int m_firstChunk;
+    int m_chunkStep;
+};
+
+}
+
+#endif // COLOR_CONVERSION_TEST_UTIL_H